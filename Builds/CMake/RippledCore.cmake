@@ -353,6 +353,7 @@ target_sources (rippled PRIVATE
   src/ripple/app/ledger/OrderBookDB.cpp
   src/ripple/app/ledger/TransactionStateSF.cpp
   src/ripple/app/ledger/impl/BuildLedger.cpp
+  src/ripple/app/ledger/impl/FetchPackCache.cpp
   src/ripple/app/ledger/impl/InboundLedger.cpp
   src/ripple/app/ledger/impl/InboundLedgers.cpp
   src/ripple/app/ledger/impl/InboundTransactions.cpp
@@ -362,6 +363,8 @@ target_sources (rippled PRIVATE
   src/ripple/app/ledger/impl/LedgerToJson.cpp
   src/ripple/app/ledger/impl/LocalTxs.cpp
   src/ripple/app/ledger/impl/OpenLedger.cpp
+  src/ripple/app/ledger/impl/ParallelApply.cpp
+  src/ripple/app/ledger/impl/PeerScoreboard.cpp
   src/ripple/app/ledger/impl/TransactionAcquire.cpp
   src/ripple/app/ledger/impl/TransactionMaster.cpp
   src/ripple/app/main/Application.cpp
@@ -377,10 +380,12 @@ target_sources (rippled PRIVATE
   src/ripple/app/misc/HashRouter.cpp
   src/ripple/app/misc/NetworkOPs.cpp
   src/ripple/app/misc/SHAMapStoreImp.cpp
+  src/ripple/app/misc/impl/AccountTxIndex.cpp
   src/ripple/app/misc/impl/AccountTxPaging.cpp
   src/ripple/app/misc/impl/AmendmentTable.cpp
   src/ripple/app/misc/impl/LoadFeeTrack.cpp
   src/ripple/app/misc/impl/Manifest.cpp
+  src/ripple/app/misc/impl/TopOfBookCache.cpp
   src/ripple/app/misc/impl/Transaction.cpp
   src/ripple/app/misc/impl/TxQ.cpp
   src/ripple/app/misc/impl/ValidatorKeys.cpp
@@ -389,12 +394,14 @@ target_sources (rippled PRIVATE
   src/ripple/app/paths/AccountCurrencies.cpp
   src/ripple/app/paths/Credit.cpp
   src/ripple/app/paths/Flow.cpp
+  src/ripple/app/paths/PathFindQueue.cpp
   src/ripple/app/paths/PathRequest.cpp
   src/ripple/app/paths/PathRequests.cpp
   src/ripple/app/paths/Pathfinder.cpp
   src/ripple/app/paths/RippleCalc.cpp
   src/ripple/app/paths/RippleLineCache.cpp
   src/ripple/app/paths/RippleState.cpp
+  src/ripple/app/paths/TrustLineGraph.cpp
   src/ripple/app/paths/impl/BookStep.cpp
   src/ripple/app/paths/impl/DirectStep.cpp
   src/ripple/app/paths/impl/PaySteps.cpp
@@ -416,6 +423,7 @@ target_sources (rippled PRIVATE
   src/ripple/app/tx/impl/OfferStream.cpp
   src/ripple/app/tx/impl/PayChan.cpp
   src/ripple/app/tx/impl/Payment.cpp
+  src/ripple/app/tx/impl/PreclaimCache.cpp
   src/ripple/app/tx/impl/SetAccount.cpp
   src/ripple/app/tx/impl/SetRegularKey.cpp
   src/ripple/app/tx/impl/SetSignerList.cpp
@@ -423,6 +431,7 @@ target_sources (rippled PRIVATE
   src/ripple/app/tx/impl/SignerEntries.cpp
   src/ripple/app/tx/impl/Taker.cpp
   src/ripple/app/tx/impl/Transactor.cpp
+  src/ripple/app/tx/impl/TxMetrics.cpp
   src/ripple/app/tx/impl/apply.cpp
   src/ripple/app/tx/impl/applySteps.cpp
   #[===============================[
@@ -450,6 +459,7 @@ target_sources (rippled PRIVATE
   #]===============================]
   src/ripple/core/impl/Config.cpp
   src/ripple/core/impl/DatabaseCon.cpp
+  src/ripple/core/impl/IOContextPool.cpp
   src/ripple/core/impl/Job.cpp
   src/ripple/core/impl/JobQueue.cpp
   src/ripple/core/impl/LoadEvent.cpp
@@ -646,30 +656,41 @@ target_sources (rippled PRIVATE
        subdir: app
   #]===============================]
   src/test/app/AccountDelete_test.cpp
+  src/test/app/AccountTxIndex_test.cpp
   src/test/app/AccountTxPaging_test.cpp
   src/test/app/AmendmentTable_test.cpp
+  src/test/app/CanonicalTXSet_test.cpp
   src/test/app/Check_test.cpp
   src/test/app/CrossingLimits_test.cpp
   src/test/app/DeliverMin_test.cpp
   src/test/app/DepositAuth_test.cpp
   src/test/app/Discrepancy_test.cpp
   src/test/app/Escrow_test.cpp
+  src/test/app/FetchPackCache_test.cpp
   src/test/app/FeeVote_test.cpp
   src/test/app/Flow_test.cpp
   src/test/app/Freeze_test.cpp
   src/test/app/HashRouter_test.cpp
   src/test/app/LedgerHistory_test.cpp
   src/test/app/LedgerLoad_test.cpp
+  src/test/app/LedgerReplayBench_test.cpp
   src/test/app/LedgerReplay_test.cpp
   src/test/app/LoadFeeTrack_test.cpp
   src/test/app/Manifest_test.cpp
   src/test/app/MultiSign_test.cpp
   src/test/app/OfferStream_test.cpp
   src/test/app/Offer_test.cpp
+  src/test/app/OpenLedgerApply_test.cpp
   src/test/app/OversizeMeta_test.cpp
+  src/test/app/ParallelApply_test.cpp
+  src/test/app/PeerScoreboard_test.cpp
+  src/test/app/PathApply_test.cpp
+  src/test/app/PathFindBench_test.cpp
+  src/test/app/PathFindQueue_test.cpp
   src/test/app/Path_test.cpp
   src/test/app/PayChan_test.cpp
   src/test/app/PayStrand_test.cpp
+  src/test/app/PreclaimCache_test.cpp
   src/test/app/PseudoTx_test.cpp
   src/test/app/RCLCensorshipDetector_test.cpp
   src/test/app/RCLValidations_test.cpp
@@ -681,8 +702,10 @@ target_sources (rippled PRIVATE
   src/test/app/Taker_test.cpp
   src/test/app/TheoreticalQuality_test.cpp
   src/test/app/Ticket_test.cpp
+  src/test/app/TopOfBookCache_test.cpp
   src/test/app/Transaction_ordering_test.cpp
   src/test/app/TrustAndBalance_test.cpp
+  src/test/app/TrustLineGraph_test.cpp
   src/test/app/TxQ_test.cpp
   src/test/app/ValidatorKeys_test.cpp
   src/test/app/ValidatorList_test.cpp
@@ -692,12 +715,14 @@ target_sources (rippled PRIVATE
      test sources:
        subdir: basics
   #]===============================]
+  src/test/basics/Arena_test.cpp
   src/test/basics/Buffer_test.cpp
   src/test/basics/DetectCrash_test.cpp
   src/test/basics/FileUtilities_test.cpp
   src/test/basics/IOUAmount_test.cpp
   src/test/basics/KeyCache_test.cpp
   src/test/basics/PerfLog_test.cpp
+  src/test/basics/PersistentMap_test.cpp
   src/test/basics/RangeSet_test.cpp
   src/test/basics/Slice_test.cpp
   src/test/basics/StringUtilities_test.cpp
@@ -751,6 +776,7 @@ target_sources (rippled PRIVATE
   src/test/core/Config_test.cpp
   src/test/core/Coroutine_test.cpp
   src/test/core/CryptoPRNG_test.cpp
+  src/test/core/IOContextPool_test.cpp
   src/test/core/JobQueue_test.cpp
   src/test/core/SociDB_test.cpp
   src/test/core/Stoppable_test.cpp
@@ -837,6 +863,7 @@ target_sources (rippled PRIVATE
        subdir: net
   #]===============================]
   src/test/net/SSLHTTPDownloader_test.cpp
+  src/test/net/StreamMessage_test.cpp
   #[===============================[
      test sources:
        subdir: nodestore
@@ -852,6 +879,7 @@ target_sources (rippled PRIVATE
        subdir: overlay
   #]===============================]
   src/test/overlay/ProtocolVersion_test.cpp
+  src/test/overlay/SendQueue_test.cpp
   src/test/overlay/cluster_test.cpp
   src/test/overlay/short_read_test.cpp
   src/test/overlay/compression_test.cpp
@@ -865,6 +893,7 @@ target_sources (rippled PRIVATE
      test sources:
        subdir: protocol
   #]===============================]
+  src/test/protocol/AmountArithmetic_test.cpp
   src/test/protocol/InnerObjectFormats_test.cpp
   src/test/protocol/Issue_test.cpp
   src/test/protocol/PublicKey_test.cpp
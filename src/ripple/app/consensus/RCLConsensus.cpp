@@ -448,7 +448,6 @@ RCLConsensus::Adaptor::doAccept(
     // We want to put transactions in an unpredictable but deterministic order:
     // we use the hash of the set.
     //
-    // FIXME: Use a std::vector and a custom sorter instead of CanonicalTXSet?
     CanonicalTXSet retriableTxs{result.txns.map_->getHash().as_uint256()};
 
     JLOG(j_.debug()) << "Building canonical tx set: " << retriableTxs.key();
@@ -0,0 +1,210 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_FETCHPACKCACHE_H_INCLUDED
+#define RIPPLE_APP_LEDGER_FETCHPACKCACHE_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/json/json_value.h>
+#include <ripple/protocol/Protocol.h>
+#include <ripple/protocol/messages.h>
+#include <boost/optional.hpp>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+class Ledger;
+
+/** Prebuilt fetch packs for recent ledgers.
+
+    A fetch pack for a ledger L, requested by a peer that has L, holds the
+    header of L's parent, the state nodes the parent has but L does not,
+    and the parent's transaction nodes. Peers syncing at the same time ask
+    for the same packs, so each one is built once, kept in a compact
+    segment, and served from there. Segments are keyed by the hash of the
+    ledger the peer has, and the oldest ledgers are evicted first.
+
+    This class is thread-safe.
+*/
+class FetchPackCache
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    /** The objects of one ledger's fetch pack, stored contiguously. */
+    class Segment
+    {
+    public:
+        Segment(LedgerIndex seq, uint256 const& hash, uint256 const& parent);
+
+        /** Add an object to the segment. */
+        void
+        add(uint256 const& hash, void const* data, std::size_t size);
+
+        /** Append objects to a reply, starting with object `first`.
+
+            @return The index of the first object not appended; at most
+                    `limit` objects are appended.
+        */
+        std::size_t
+        append(
+            protocol::TMGetObjectByHash& reply,
+            std::size_t first,
+            std::size_t limit) const;
+
+        /** The sequence of the ledger whose nodes this holds */
+        LedgerIndex
+        seq() const
+        {
+            return seq_;
+        }
+
+        /** The hash of the ledger whose nodes this holds */
+        uint256 const&
+        hash() const
+        {
+            return hash_;
+        }
+
+        /** The hash of the ledger the next segment would hold */
+        uint256 const&
+        parent() const
+        {
+            return parent_;
+        }
+
+        std::size_t
+        size() const
+        {
+            return objects_.size();
+        }
+
+        /** Approximate memory used */
+        std::size_t
+        bytes() const
+        {
+            return data_.size() + objects_.size() * sizeof(Object);
+        }
+
+    private:
+        struct Object
+        {
+            uint256 hash;
+            std::uint32_t offset;
+            std::uint32_t size;
+        };
+
+        LedgerIndex const seq_;
+        uint256 const hash_;
+        uint256 const parent_;
+        std::vector<Object> objects_;
+        Blob data_;
+    };
+
+    FetchPackCache(std::size_t maxSegments, std::size_t maxBytes);
+
+    FetchPackCache(FetchPackCache const&) = delete;
+    FetchPackCache&
+    operator=(FetchPackCache const&) = delete;
+
+    /** Build the segment served to a peer that has ledger `have`.
+
+        @param want The parent of `have`.
+    */
+    static std::shared_ptr<Segment const>
+    build(Ledger const& want, Ledger const& have);
+
+    /** Returns the segment served to peers that have the given ledger.
+
+        @return nullptr if the segment has not been built.
+    */
+    std::shared_ptr<Segment const>
+    fetch(uint256 const& have);
+
+    /** Returns `true` if the segment for the given ledger is cached. */
+    bool
+    contains(uint256 const& have) const;
+
+    /** Add a segment, evicting the oldest ones if over the limits.
+
+        @param buildTime How long it took to build the segment.
+    */
+    void
+    insert(
+        uint256 const& have,
+        std::shared_ptr<Segment const> const& segment,
+        clock_type::duration buildTime);
+
+    /** Record that some objects were sent to a peer.
+
+        @param serveTime How long it took to assemble the messages.
+    */
+    void
+    onServed(
+        std::size_t objects,
+        std::size_t messages,
+        clock_type::duration serveTime);
+
+    /** Returns `true` if a fetch pack was served within the window. */
+    bool
+    recentlyServed(clock_type::duration window) const;
+
+    /** Number of cached segments */
+    std::size_t
+    size() const;
+
+    /** Report cache contents and build and serve throughput. */
+    Json::Value
+    getJson() const;
+
+private:
+    struct Counter
+    {
+        std::uint64_t count = 0;
+        std::uint64_t objects = 0;
+        std::uint64_t messages = 0;
+        clock_type::duration time{0};
+    };
+
+    std::size_t const maxSegments_;
+    std::size_t const maxBytes_;
+
+    std::mutex mutable mutex_;
+    hash_map<uint256, std::shared_ptr<Segment const>> segments_;
+    // Keys of cached segments, oldest ledger first
+    std::map<std::pair<LedgerIndex, uint256>, uint256> age_;
+    std::size_t bytes_ = 0;
+
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+    Counter built_;
+    Counter served_;
+    boost::optional<clock_type::time_point> lastServed_;
+};
+
+}  // namespace ripple
+
+#endif
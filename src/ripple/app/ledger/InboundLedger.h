@@ -122,6 +122,13 @@ private:
     void
     trigger(std::shared_ptr<Peer> const&, TriggerReason);
 
+    void
+    requestNodes(
+        protocol::TMGetLedger& tmGL,
+        std::vector<std::pair<SHAMapNodeID, uint256>> const& nodes,
+        std::shared_ptr<Peer> const& peer,
+        TriggerReason reason);
+
     std::vector<neededHash_t>
     getNeededHashes();
 
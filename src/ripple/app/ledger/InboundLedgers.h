@@ -21,6 +21,7 @@
 #define RIPPLE_APP_LEDGER_INBOUNDLEDGERS_H_INCLUDED
 
 #include <ripple/app/ledger/InboundLedger.h>
+#include <ripple/app/ledger/PeerScoreboard.h>
 #include <ripple/core/Stoppable.h>
 #include <ripple/protocol/RippleLedgerHash.h>
 #include <memory>
@@ -88,6 +89,10 @@ public:
     virtual void
     sweep() = 0;
 
+    /** How well each peer has been serving ledger data. */
+    virtual PeerScoreboard&
+    peerScores() = 0;
+
     virtual void
     onStop() = 0;
 };
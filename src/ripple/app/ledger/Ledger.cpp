@@ -26,6 +26,7 @@
 #include <ripple/app/ledger/PendingSaves.h>
 #include <ripple/app/ledger/TransactionMaster.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/misc/AccountTxIndex.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
@@ -816,13 +817,20 @@ saveValidatedLedger(
         *db << boost::str(deleteLedger % seq);
     }
 
+    // Once the account transaction index holds everything, it replaces
+    // the AccountTransactions table
+    auto const accountTxIndex = app.getAccountTxIndex();
+    bool const useTable = !accountTxIndex || !accountTxIndex->ready();
+    std::vector<AccountTxIndex::Entry> accountTxs;
+
     {
         auto db = app.getTxnDB().checkoutDb();
 
         soci::transaction tr(*db);
 
         *db << boost::str(deleteTrans1 % seq);
-        *db << boost::str(deleteTrans2 % seq);
+        if (useTable)
+            *db << boost::str(deleteTrans2 % seq);
 
         std::string const ledgerSeq(std::to_string(seq));
 
@@ -837,11 +845,26 @@ saveValidatedLedger(
             std::string const txnSeq(
                 std::to_string(acceptedLedgerTx->getTxnSeq()));
 
-            *db << boost::str(deleteAcctTrans % transactionID);
+            if (useTable)
+                *db << boost::str(deleteAcctTrans % transactionID);
 
             auto const& accts = acceptedLedgerTx->getAffected();
 
-            if (!accts.empty())
+            if (accountTxIndex)
+            {
+                auto const txnIndex = acceptedLedgerTx->getTxnSeq();
+                for (auto const& account : accts)
+                    accountTxs.push_back({account, txnIndex, transactionID});
+            }
+
+            if (accts.empty())
+            {
+                JLOG(j.warn()) << "Transaction in ledger " << seq
+                               << " affects no accounts";
+                JLOG(j.warn())
+                    << acceptedLedgerTx->getTxn()->getJson(JsonOptions::none);
+            }
+            else if (useTable)
             {
                 std::string sql(
                     "INSERT INTO AccountTransactions "
@@ -876,13 +899,6 @@ saveValidatedLedger(
                 JLOG(j.trace()) << "ActTx: " << sql;
                 *db << sql;
             }
-            else
-            {
-                JLOG(j.warn()) << "Transaction in ledger " << seq
-                               << " affects no accounts";
-                JLOG(j.warn())
-                    << acceptedLedgerTx->getTxn()->getJson(JsonOptions::none);
-            }
 
             *db
                 << (STTx::getMetaSQLInsertReplaceHeader() +
@@ -894,6 +910,9 @@ saveValidatedLedger(
         tr.commit();
     }
 
+    if (accountTxIndex)
+        accountTxIndex->saveLedger(seq, accountTxs);
+
     {
         static std::string addLedger(
             R"sql(INSERT OR REPLACE INTO Ledgers
@@ -21,6 +21,7 @@
 #define RIPPLE_APP_LEDGER_LEDGERMASTER_H_INCLUDED
 
 #include <ripple/app/ledger/AbstractFetchPackContainer.h>
+#include <ripple/app/ledger/FetchPackCache.h>
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/ledger/LedgerCleaner.h>
@@ -283,6 +284,13 @@ public:
     std::size_t
     getFetchPackCacheSize() const;
 
+    /** Prebuilt fetch packs we serve to peers */
+    FetchPackCache const&
+    getPrebuiltFetchPacks() const
+    {
+        return prebuiltFetchPacks_;
+    }
+
     //! Whether we have ever fully validated a ledger.
     bool
     haveValidated()
@@ -294,6 +302,10 @@ private:
     void
     setValidLedger(std::shared_ptr<Ledger const> const& l);
     void
+    prebuildFetchPack(std::shared_ptr<Ledger const> const& l);
+    std::shared_ptr<FetchPackCache::Segment const>
+    buildFetchPack(Ledger const& want, Ledger const& have);
+    void
     setPubLedger(std::shared_ptr<Ledger const> const& l);
 
     void
@@ -401,6 +413,9 @@ private:
 
     TaggedCache<uint256, Blob> fetch_packs_;
 
+    // Fetch packs built for peers, kept to serve other peers
+    FetchPackCache prebuiltFetchPacks_;
+
     std::uint32_t fetch_seq_{0};
 
     // Try to keep a validator from switching from test to live network
@@ -248,7 +248,7 @@ void
 OrderBookDB::processTxn(
     std::shared_ptr<ReadView const> const& ledger,
     const AcceptedLedgerTx& alTx,
-    Json::Value const& jvObj)
+    std::shared_ptr<StreamMessage const> const& msg)
 {
     std::lock_guard sl(mLock);
     if (alTx.getResult() == tesSUCCESS)
@@ -296,7 +296,7 @@ OrderBookDB::processTxn(
                             auto listeners = getBookListeners(b);
                             if (listeners)
                             {
-                                listeners->publish(jvObj, havePublished);
+                                listeners->publish(msg, havePublished);
                             }
                         }
                     }
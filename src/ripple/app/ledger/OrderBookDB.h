@@ -66,7 +66,7 @@ public:
     processTxn(
         std::shared_ptr<ReadView const> const& ledger,
         const AcceptedLedgerTx& alTx,
-        Json::Value const& jvObj);
+        std::shared_ptr<StreamMessage const> const& msg);
 
     using IssueToOrderBook = hash_map<Issue, OrderBook::List>;
 
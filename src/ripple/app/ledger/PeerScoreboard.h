@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_PEERSCOREBOARD_H_INCLUDED
+#define RIPPLE_APP_LEDGER_PEERSCOREBOARD_H_INCLUDED
+
+#include <ripple/beast/clock/abstract_clock.h>
+#include <ripple/overlay/Peer.h>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** Learns how well each peer serves ledger data and spreads fetches.
+
+    For every peer and request type (the TMLedgerInfoType of a TMGetLedger)
+    the scoreboard keeps a smoothed reply latency, a smoothed throughput
+    in bytes per second and time per node, and an in-flight window measured
+    in nodes. The window grows as replies arrive and is halved when a request
+    times out, so a slow or overloaded peer is asked for less.
+
+    schedule() splits a batch of missing nodes across a set of candidate
+    peers so that the batch is expected to finish soonest, without
+    exceeding any peer's window.
+
+    Replies are matched to requests in the order they were sent; the
+    overlay delivers messages from a single peer in order.
+
+    This class is thread-safe.
+*/
+class PeerScoreboard
+{
+public:
+    using clock_type = beast::abstract_clock<std::chrono::steady_clock>;
+    using id_t = Peer::id_t;
+
+    /** What we currently believe about one peer and request type. */
+    struct Estimate
+    {
+        // Smoothed time from request to reply
+        std::chrono::milliseconds latency{0};
+
+        // Smoothed reply throughput
+        std::uint64_t bytesPerSecond = 0;
+
+        // Smoothed time per requested node, in microseconds
+        std::uint64_t perNode = 0;
+
+        // Nodes we may have outstanding with this peer
+        std::size_t window = 0;
+
+        // Nodes currently outstanding with this peer
+        std::size_t inFlight = 0;
+
+        // Number of replies the estimate is based on
+        std::uint64_t replies = 0;
+
+        // Number of requests that went unanswered
+        std::uint64_t timeouts = 0;
+    };
+
+    explicit PeerScoreboard(clock_type& clock);
+
+    PeerScoreboard(PeerScoreboard const&) = delete;
+    PeerScoreboard&
+    operator=(PeerScoreboard const&) = delete;
+
+    /** Record that we asked a peer for some nodes. */
+    void
+    onRequest(id_t peer, int type, std::size_t nodes);
+
+    /** Record a reply from a peer.
+
+        @param nodes The number of nodes in the reply.
+        @param bytes The serialized size of the reply.
+    */
+    void
+    onReply(id_t peer, int type, std::size_t nodes, std::size_t bytes);
+
+    /** Treat requests outstanding for longer than timeout as lost. */
+    void
+    expire(std::chrono::milliseconds timeout);
+
+    /** Forget peers we have not exchanged data with for a while. */
+    void
+    sweep();
+
+    /** Returns the current estimate for a peer and request type. */
+    Estimate
+    estimate(id_t peer, int type) const;
+
+    /** Split a batch of nodes across peers.
+
+        @param peers The candidate peers.
+        @param type The request type.
+        @param nodes The number of nodes to request.
+        @return The number of nodes to request from each peer, best peer
+                first. Peers that get nothing are omitted. The counts may
+                add up to less than nodes if every window is full, but at
+                least one node is assigned if there are candidates.
+    */
+    std::vector<std::pair<id_t, std::size_t>>
+    schedule(std::vector<id_t> const& peers, int type, std::size_t nodes)
+        const;
+
+private:
+    struct Outstanding
+    {
+        clock_type::time_point sent;
+        std::size_t nodes;
+    };
+
+    struct Entry
+    {
+        Estimate est;
+        std::deque<Outstanding> outstanding;
+        clock_type::time_point lastUsed;
+    };
+
+    using key_type = std::pair<id_t, int>;
+
+    Entry&
+    get(key_type const& key);
+
+    clock_type& clock_;
+    std::mutex mutable mutex_;
+    std::map<key_type, Entry> entries_;
+};
+
+}  // namespace ripple
+
+#endif
@@ -21,6 +21,7 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/ledger/LedgerReplay.h>
 #include <ripple/app/ledger/OpenLedger.h>
+#include <ripple/app/ledger/impl/ParallelApply.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/CanonicalTXSet.h>
 #include <ripple/app/tx/apply.h>
@@ -107,42 +108,52 @@ applyTransactions(
                         << " begins (" << txns.size() << " transactions)";
         int changes = 0;
 
-        auto it = txns.begin();
-
-        while (it != txns.end())
+        // The first pass sees every transaction and is the bulk of the work
+        auto const threads = app.config().LEDGER_APPLY_THREADS;
+        if (pass == 0 && threads > 1)
+        {
+            changes = applyTransactionsParallel(
+                app, built, txns, failed, view, certainRetry, threads, j);
+        }
+        else
         {
-            auto const txid = it->first.getTXID();
+            auto it = txns.begin();
 
-            try
+            while (it != txns.end())
             {
-                if (pass == 0 && built->txExists(txid))
-                {
-                    it = txns.erase(it);
-                    continue;
-                }
+                auto const txid = it->first.getTXID();
 
-                switch (applyTransaction(
-                    app, view, *it->second, certainRetry, tapNONE, j))
+                try
                 {
-                    case ApplyResult::Success:
-                        it = txns.erase(it);
-                        ++changes;
-                        break;
-
-                    case ApplyResult::Fail:
-                        failed.insert(txid);
+                    if (pass == 0 && built->txExists(txid))
+                    {
                         it = txns.erase(it);
-                        break;
-
-                    case ApplyResult::Retry:
-                        ++it;
+                        continue;
+                    }
+
+                    switch (applyTransaction(
+                        app, view, *it->second, certainRetry, tapNONE, j))
+                    {
+                        case ApplyResult::Success:
+                            it = txns.erase(it);
+                            ++changes;
+                            break;
+
+                        case ApplyResult::Fail:
+                            failed.insert(txid);
+                            it = txns.erase(it);
+                            break;
+
+                        case ApplyResult::Retry:
+                            ++it;
+                    }
+                }
+                catch (std::exception const&)
+                {
+                    JLOG(j.warn()) << "Transaction " << txid << " throws";
+                    failed.insert(txid);
+                    it = txns.erase(it);
                 }
-            }
-            catch (std::exception const&)
-            {
-                JLOG(j.warn()) << "Transaction " << txid << " throws";
-                failed.insert(txid);
-                it = txns.erase(it);
             }
         }
 
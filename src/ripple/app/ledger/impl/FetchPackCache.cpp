@@ -0,0 +1,234 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/FetchPackCache.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <ripple/protocol/jss.h>
+#include <cassert>
+
+namespace ripple {
+
+namespace {
+
+enum {
+    // Most state nodes added for a single ledger
+    maxStateNodes = 16384
+
+    // Most transaction nodes added for a single ledger
+    ,
+    maxTxNodes = 512
+};
+
+template <class Duration>
+std::uint64_t
+perSecond(std::uint64_t n, Duration d)
+{
+    using namespace std::chrono;
+    auto const us = duration_cast<microseconds>(d).count();
+    if (us <= 0)
+        return 0;
+    return n * 1000000 / us;
+}
+
+}  // namespace
+
+FetchPackCache::Segment::Segment(
+    LedgerIndex seq,
+    uint256 const& hash,
+    uint256 const& parent)
+    : seq_(seq), hash_(hash), parent_(parent)
+{
+}
+
+void
+FetchPackCache::Segment::add(
+    uint256 const& hash,
+    void const* data,
+    std::size_t size)
+{
+    auto const offset = data_.size();
+    auto const p = static_cast<std::uint8_t const*>(data);
+    data_.insert(data_.end(), p, p + size);
+    objects_.push_back(
+        {hash,
+         static_cast<std::uint32_t>(offset),
+         static_cast<std::uint32_t>(size)});
+}
+
+std::size_t
+FetchPackCache::Segment::append(
+    protocol::TMGetObjectByHash& reply,
+    std::size_t first,
+    std::size_t limit) const
+{
+    auto const last = std::min(objects_.size(), first + limit);
+    for (auto i = first; i < last; ++i)
+    {
+        auto const& o = objects_[i];
+        protocol::TMIndexedObject& newObj = *reply.add_objects();
+        newObj.set_ledgerseq(seq_);
+        newObj.set_hash(o.hash.data(), o.hash.size());
+        newObj.set_data(data_.data() + o.offset, o.size);
+    }
+    return last;
+}
+
+FetchPackCache::FetchPackCache(std::size_t maxSegments, std::size_t maxBytes)
+    : maxSegments_(maxSegments), maxBytes_(maxBytes)
+{
+}
+
+std::shared_ptr<FetchPackCache::Segment const>
+FetchPackCache::build(Ledger const& want, Ledger const& have)
+{
+    assert(want.info().hash == have.info().parentHash);
+
+    auto segment = std::make_shared<Segment>(
+        want.info().seq, want.info().hash, want.info().parentHash);
+
+    Serializer s(256);
+    s.add32(HashPrefix::ledgerMaster);
+    addRaw(want.info(), s);
+    segment->add(want.info().hash, s.getDataPtr(), s.getLength());
+
+    auto appender = [&segment](SHAMapHash const& hash, Blob const& blob) {
+        segment->add(hash.as_uint256(), blob.data(), blob.size());
+    };
+
+    want.stateMap().getFetchPack(
+        &have.stateMap(), true, maxStateNodes, appender);
+
+    if (want.info().txHash.isNonZero())
+        want.txMap().getFetchPack(nullptr, true, maxTxNodes, appender);
+
+    return segment;
+}
+
+std::shared_ptr<FetchPackCache::Segment const>
+FetchPackCache::fetch(uint256 const& have)
+{
+    std::lock_guard lock(mutex_);
+    auto const it = segments_.find(have);
+    if (it == segments_.end())
+    {
+        ++misses_;
+        return nullptr;
+    }
+    ++hits_;
+    return it->second;
+}
+
+bool
+FetchPackCache::contains(uint256 const& have) const
+{
+    std::lock_guard lock(mutex_);
+    return segments_.find(have) != segments_.end();
+}
+
+void
+FetchPackCache::insert(
+    uint256 const& have,
+    std::shared_ptr<Segment const> const& segment,
+    clock_type::duration buildTime)
+{
+    std::lock_guard lock(mutex_);
+
+    ++built_.count;
+    built_.objects += segment->size();
+    built_.time += buildTime;
+
+    if (!segments_.emplace(have, segment).second)
+        return;
+    age_.emplace(std::make_pair(segment->seq(), have), have);
+    bytes_ += segment->bytes();
+
+    while (!age_.empty() &&
+           (segments_.size() > maxSegments_ || bytes_ > maxBytes_))
+    {
+        auto const oldest = age_.begin();
+        auto const it = segments_.find(oldest->second);
+        bytes_ -= it->second->bytes();
+        segments_.erase(it);
+        age_.erase(oldest);
+    }
+}
+
+void
+FetchPackCache::onServed(
+    std::size_t objects,
+    std::size_t messages,
+    clock_type::duration serveTime)
+{
+    std::lock_guard lock(mutex_);
+    ++served_.count;
+    served_.objects += objects;
+    served_.messages += messages;
+    served_.time += serveTime;
+    lastServed_ = clock_type::now();
+}
+
+bool
+FetchPackCache::recentlyServed(clock_type::duration window) const
+{
+    std::lock_guard lock(mutex_);
+    return lastServed_ && (*lastServed_ + window) > clock_type::now();
+}
+
+std::size_t
+FetchPackCache::size() const
+{
+    std::lock_guard lock(mutex_);
+    return segments_.size();
+}
+
+Json::Value
+FetchPackCache::getJson() const
+{
+    using namespace std::chrono;
+
+    std::lock_guard lock(mutex_);
+
+    Json::Value ret(Json::objectValue);
+    ret[jss::segments] = static_cast<Json::UInt>(segments_.size());
+    ret[jss::bytes] = static_cast<Json::UInt>(bytes_);
+    ret[jss::hits] = std::to_string(hits_);
+    ret[jss::misses] = std::to_string(misses_);
+
+    auto& build = ret[jss::build] = Json::objectValue;
+    build[jss::count] = std::to_string(built_.count);
+    build[jss::objects] = std::to_string(built_.objects);
+    build[jss::time_us] =
+        std::to_string(duration_cast<microseconds>(built_.time).count());
+    build[jss::objects_per_sec] =
+        std::to_string(perSecond(built_.objects, built_.time));
+
+    auto& serve = ret[jss::serve] = Json::objectValue;
+    serve[jss::count] = std::to_string(served_.count);
+    serve[jss::objects] = std::to_string(served_.objects);
+    serve[jss::messages] = std::to_string(served_.messages);
+    serve[jss::time_us] =
+        std::to_string(duration_cast<microseconds>(served_.time).count());
+    serve[jss::objects_per_sec] =
+        std::to_string(perSecond(served_.objects, served_.time));
+
+    return ret;
+}
+
+}  // namespace ripple
@@ -390,6 +390,7 @@ void
 InboundLedger::onTimer(bool wasProgress, ScopedLockType&)
 {
     mRecentNodes.clear();
+    app_.getInboundLedgers().peerScores().expire(ledgerAcquireTimeout);
 
     if (isDone())
     {
@@ -683,16 +684,10 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
                     if (!nodes.empty())
                     {
                         tmGL.set_itype(protocol::liAS_NODE);
-                        for (auto const& id : nodes)
-                        {
-                            *(tmGL.add_nodeids()) = id.first.getRawString();
-                        }
-
                         JLOG(m_journal.trace())
                             << "Sending AS node request (" << nodes.size()
-                            << ") to "
-                            << (peer ? "selected peer" : "all peers");
-                        sendRequest(tmGL, peer);
+                            << ")";
+                        requestNodes(tmGL, nodes, peer, reason);
                         return;
                     }
                     else
@@ -749,14 +744,9 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
                 if (!nodes.empty())
                 {
                     tmGL.set_itype(protocol::liTX_NODE);
-                    for (auto const& n : nodes)
-                    {
-                        *(tmGL.add_nodeids()) = n.first.getRawString();
-                    }
                     JLOG(m_journal.trace())
-                        << "Sending TX node request (" << nodes.size()
-                        << ") to " << (peer ? "selected peer" : "all peers");
-                    sendRequest(tmGL, peer);
+                        << "Sending TX node request (" << nodes.size() << ")";
+                    requestNodes(tmGL, nodes, peer, reason);
                     return;
                 }
                 else
@@ -777,6 +767,89 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
     }
 }
 
+/** Send requests for missing nodes.
+
+    On a timeout every peer is asked for every node, as before. Otherwise
+    the nodes are split across our peers according to how quickly each has
+    been replying, so a slow peer does not hold up the whole batch. Nodes
+    no peer has room for are left to the next trigger.
+*/
+void
+InboundLedger::requestNodes(
+    protocol::TMGetLedger& tmGL,
+    std::vector<std::pair<SHAMapNodeID, uint256>> const& nodes,
+    std::shared_ptr<Peer> const& peer,
+    TriggerReason reason)
+{
+    auto& scores = app_.getInboundLedgers().peerScores();
+    auto const type = tmGL.itype();
+
+    if (reason == TriggerReason::timeout)
+    {
+        for (auto const& n : nodes)
+            *(tmGL.add_nodeids()) = n.first.getRawString();
+
+        auto packet = std::make_shared<Message>(tmGL, protocol::mtGET_LEDGER);
+        auto sendTo = [&](std::shared_ptr<Peer> const& p) {
+            scores.onRequest(p->id(), type, nodes.size());
+            p->send(packet);
+        };
+
+        if (peer)
+            sendTo(peer);
+        else
+        {
+            for (auto id : mPeers)
+            {
+                if (auto p = app_.overlay().findPeerByShortID(id))
+                    sendTo(p);
+            }
+        }
+        return;
+    }
+
+    std::vector<std::shared_ptr<Peer>> peers;
+    std::vector<Peer::id_t> ids;
+    peers.reserve(mPeers.size());
+    ids.reserve(mPeers.size());
+    for (auto id : mPeers)
+    {
+        if (auto p = app_.overlay().findPeerByShortID(id))
+        {
+            ids.push_back(id);
+            peers.push_back(std::move(p));
+        }
+    }
+
+    // The peer we were triggered by may have just been added
+    if (peer && std::find(ids.begin(), ids.end(), peer->id()) == ids.end())
+    {
+        ids.push_back(peer->id());
+        peers.push_back(peer);
+    }
+
+    auto next = nodes.begin();
+    for (auto const& [id, count] : scores.schedule(ids, type, nodes.size()))
+    {
+        auto const p = peers[std::distance(
+            ids.begin(), std::find(ids.begin(), ids.end(), id))];
+
+        protocol::TMGetLedger request(tmGL);
+        auto const last = next + count;
+        for (; next != last; ++next)
+            *(request.add_nodeids()) = next->first.getRawString();
+
+        JLOG(m_journal.trace())
+            << "Requesting " << count << " nodes from " << p->id();
+        scores.onRequest(id, type, count);
+        p->send(std::make_shared<Message>(request, protocol::mtGET_LEDGER));
+    }
+
+    // Forget the nodes we did not ask for, so they are asked for next time
+    for (; next != nodes.end(); ++next)
+        mRecentNodes.erase(next->second);
+}
+
 void
 InboundLedger::filterNodes(
     std::vector<std::pair<SHAMapNodeID, uint256>>& nodes,
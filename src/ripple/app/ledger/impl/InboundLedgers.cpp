@@ -60,6 +60,7 @@ public:
         , m_clock(clock)
         , mRecentFailures(clock)
         , mCounter(collector->make_counter("ledger_fetches"))
+        , peerScores_(clock)
     {
     }
 
@@ -173,6 +174,15 @@ public:
         JLOG(j_.trace()) << "Got data (" << packet.nodes().size()
                          << ") for acquiring ledger: " << hash;
 
+        if (peer)
+        {
+            std::size_t bytes = 0;
+            for (auto const& node : packet.nodes())
+                bytes += node.nodedata().size();
+            peerScores_.onReply(
+                peer->id(), packet.type(), packet.nodes().size(), bytes);
+        }
+
         auto ledger = find(hash);
 
         if (!ledger)
@@ -425,10 +435,18 @@ public:
             beast::expire(mRecentFailures, kReacquireInterval);
         }
 
+        peerScores_.sweep();
+
         JLOG(j_.debug()) << "Swept " << stuffToSweep.size() << " out of "
                          << total << " inbound ledgers.";
     }
 
+    PeerScoreboard&
+    peerScores() override
+    {
+        return peerScores_;
+    }
+
     void
     onStop() override
     {
@@ -452,6 +470,8 @@ private:
     beast::aged_map<uint256, std::uint32_t> mRecentFailures;
 
     beast::insight::Counter mCounter;
+
+    PeerScoreboard peerScores_;
 };
 
 //------------------------------------------------------------------------------
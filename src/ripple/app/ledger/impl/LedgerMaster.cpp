@@ -143,6 +143,21 @@ static constexpr std::chrono::minutes MAX_LEDGER_AGE_ACQUIRE{1};
 // Don't acquire history if write load is too high
 static constexpr int MAX_WRITE_LOAD_ACQUIRE{8192};
 
+// Keep prebuilt fetch packs for at most this many ledgers
+static constexpr std::size_t FETCH_PACK_SEGMENTS{256};
+
+// Send fetch packs in messages of at most this many objects
+static constexpr int FETCH_PACK_CHUNK{256};
+
+// Stop adding ledgers to a fetch pack once it has this many objects
+static constexpr std::size_t FETCH_PACK_OBJECTS{2048};
+
+// Stop sending a fetch pack while the peer has this many messages queued
+static constexpr std::size_t FETCH_PACK_MAX_QUEUE{32};
+
+// Keep prebuilding fetch packs while peers asked for one this recently
+static constexpr std::chrono::minutes FETCH_PACK_PREBUILD{5};
+
 // Helper function for LedgerMaster::doAdvance()
 // Returns the minimum ledger sequence in SQL database, if any.
 static boost::optional<LedgerIndex>
@@ -213,6 +228,10 @@ LedgerMaster::LedgerMaster(
           std::chrono::seconds{45},
           stopwatch,
           app_.journal("TaggedCache"))
+    , prebuiltFetchPacks_(
+          FETCH_PACK_SEGMENTS,
+          app_.config().getValueFor(SizedItem::fetchPackCacheSize) * 1024 *
+              1024)
     , m_stats(std::bind(&LedgerMaster::collect_metrics, this), collector)
 {
 }
@@ -365,6 +384,7 @@ LedgerMaster::setValidLedger(std::shared_ptr<Ledger const> const& l)
 
     app_.getOPs().updateLocalTx(*l);
     app_.getSHAMapStore().onLedgerClosed(getValidatedLedger());
+    prebuildFetchPack(l);
     mLedgerHistory.validatedLedger(l, consensusHash);
     app_.getAmendmentTable().doValidatedLedger(l);
     if (!app_.getOPs().isAmendmentBlocked())
@@ -504,6 +524,8 @@ LedgerMaster::switchLCL(std::shared_ptr<Ledger const> const& lastClosed)
         mClosedLedger.set(lastClosed);
     }
 
+    app_.getPathRequests().updateTrustLines(lastClosed);
+
     if (standalone_)
     {
         setFullLedger(lastClosed, true, false);
@@ -2059,19 +2081,15 @@ LedgerMaster::makeFetchPack(
         return;
     }
 
-    auto fpAppender = [](protocol::TMGetObjectByHash* reply,
-                         std::uint32_t ledgerSeq,
-                         SHAMapHash const& hash,
-                         const Blob& blob) {
-        protocol::TMIndexedObject& newObj = *(reply->add_objects());
-        newObj.set_ledgerseq(ledgerSeq);
-        newObj.set_hash(hash.as_uint256().begin(), 256 / 8);
-        newObj.set_data(&blob[0], blob.size());
-    };
+    protocol::TMGetObjectByHash reply;
+    std::size_t objects = 0;
+    std::size_t messages = 0;
 
-    try
-    {
-        protocol::TMGetObjectByHash reply;
+    auto const start = FetchPackCache::clock_type::now();
+    FetchPackCache::clock_type::duration building{0};
+
+    auto reset = [&reply, &request]() {
+        reply.Clear();
         reply.set_query(false);
 
         if (request->has_seq())
@@ -2079,6 +2097,20 @@ LedgerMaster::makeFetchPack(
 
         reply.set_ledgerhash(request->ledgerhash());
         reply.set_type(protocol::TMGetObjectByHash::otFETCH_PACK);
+    };
+
+    auto flush = [&]() {
+        if (reply.objects_size() == 0)
+            return;
+        objects += reply.objects_size();
+        ++messages;
+        peer->send(std::make_shared<Message>(reply, protocol::mtGET_OBJECTS));
+        reset();
+    };
+
+    try
+    {
+        reset();
 
         // Building a fetch pack:
         //  1. Add the header for the requested ledger.
@@ -2086,56 +2118,72 @@ LedgerMaster::makeFetchPack(
         //  3. If there are transactions, add the nodes for the
         //     transactions of the ledger.
         //  4. If the FetchPack now contains greater than or equal to
-        //     256 entries then stop.
+        //     FETCH_PACK_OBJECTS entries then stop.
         //  5. If not very much time has elapsed, then loop back and repeat
         //     the same process adding the previous ledger to the FetchPack.
+        //
+        // The objects for each ledger are built once and kept, since peers
+        // that are syncing tend to ask for the same ledgers. They are sent
+        // in chunks, and we stop early if the peer is not keeping up.
+        uint256 haveHash = haveLedger->info().hash;
+        bool congested = false;
         do
         {
-            std::uint32_t lSeq = wantLedger->info().seq;
-
-            protocol::TMIndexedObject& newObj = *reply.add_objects();
-            newObj.set_hash(wantLedger->info().hash.data(), 256 / 8);
-            Serializer s(256);
-            s.add32(HashPrefix::ledgerMaster);
-            addRaw(wantLedger->info(), s);
-            newObj.set_data(s.getDataPtr(), s.getLength());
-            newObj.set_ledgerseq(lSeq);
-
-            wantLedger->stateMap().getFetchPack(
-                &haveLedger->stateMap(),
-                true,
-                16384,
-                std::bind(
-                    fpAppender,
-                    &reply,
-                    lSeq,
-                    std::placeholders::_1,
-                    std::placeholders::_2));
-
-            if (wantLedger->info().txHash.isNonZero())
-                wantLedger->txMap().getFetchPack(
-                    nullptr,
-                    true,
-                    512,
-                    std::bind(
-                        fpAppender,
-                        &reply,
-                        lSeq,
-                        std::placeholders::_1,
-                        std::placeholders::_2));
-
-            if (reply.objects().size() >= 512)
+            auto segment = prebuiltFetchPacks_.fetch(haveHash);
+
+            if (!segment)
+            {
+                if (!wantLedger)
+                {
+                    haveLedger = getLedgerByHash(haveHash);
+                    if (!haveLedger)
+                        break;
+                    wantLedger = getLedgerByHash(haveLedger->info().parentHash);
+                    if (!wantLedger)
+                        break;
+                }
+
+                auto const buildStart = FetchPackCache::clock_type::now();
+                segment = buildFetchPack(*wantLedger, *haveLedger);
+                building += FetchPackCache::clock_type::now() - buildStart;
+            }
+
+            haveLedger.reset();
+            wantLedger.reset();
+
+            for (std::size_t i = 0; i < segment->size();)
+            {
+                i = segment->append(
+                    reply, i, FETCH_PACK_CHUNK - reply.objects_size());
+
+                if (reply.objects_size() >= FETCH_PACK_CHUNK)
+                {
+                    flush();
+                    if (peer->sendQueueSize() > FETCH_PACK_MAX_QUEUE)
+                    {
+                        congested = true;
+                        break;
+                    }
+                }
+            }
+
+            if (congested ||
+                (objects + reply.objects_size()) >= FETCH_PACK_OBJECTS)
                 break;
 
-            // move may save a ref/unref
-            haveLedger = std::move(wantLedger);
-            wantLedger = getLedgerByHash(haveLedger->info().parentHash);
-        } while (wantLedger && UptimeClock::now() <= uptime + 1s);
+            haveHash = segment->hash();
+        } while (UptimeClock::now() <= uptime + 1s);
+
+        flush();
+
+        prebuiltFetchPacks_.onServed(
+            objects,
+            messages,
+            FetchPackCache::clock_type::now() - start - building);
 
         JLOG(m_journal.info())
-            << "Built fetch pack with " << reply.objects().size() << " nodes";
-        auto msg = std::make_shared<Message>(reply, protocol::mtGET_OBJECTS);
-        peer->send(msg);
+            << "Sent fetch pack with " << objects << " nodes in " << messages
+            << " messages" << (congested ? " (peer congested)" : "");
     }
     catch (std::exception const&)
     {
@@ -2143,6 +2191,43 @@ LedgerMaster::makeFetchPack(
     }
 }
 
+std::shared_ptr<FetchPackCache::Segment const>
+LedgerMaster::buildFetchPack(Ledger const& want, Ledger const& have)
+{
+    auto const start = FetchPackCache::clock_type::now();
+    auto segment = FetchPackCache::build(want, have);
+    prebuiltFetchPacks_.insert(
+        have.info().hash,
+        segment,
+        FetchPackCache::clock_type::now() - start);
+    return segment;
+}
+
+void
+LedgerMaster::prebuildFetchPack(std::shared_ptr<Ledger const> const& l)
+{
+    // Only do the work while peers are actually asking for fetch packs
+    if (standalone_ || app_.getFeeTrack().isLoadedLocal() ||
+        !prebuiltFetchPacks_.recentlyServed(FETCH_PACK_PREBUILD) ||
+        prebuiltFetchPacks_.contains(l->info().hash))
+        return;
+
+    app_.getJobQueue().addJob(jtPACK, "prebuildFetchPack", [this, l](Job&) {
+        auto const parent = getLedgerByHash(l->info().parentHash);
+        if (!parent || prebuiltFetchPacks_.contains(l->info().hash))
+            return;
+
+        try
+        {
+            buildFetchPack(*parent, *l);
+        }
+        catch (std::exception const&)
+        {
+            JLOG(m_journal.warn()) << "Exception prebuilding fetch pack";
+        }
+    });
+}
+
 std::size_t
 LedgerMaster::getFetchPackCacheSize() const
 {
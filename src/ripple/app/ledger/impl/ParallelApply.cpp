@@ -0,0 +1,325 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/impl/ParallelApply.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/basics/Log.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/ledger/RecordingView.h>
+#include <ripple/protocol/STObject.h>
+#include <ripple/protocol/STTx.h>
+#include <algorithm>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+/** Returns metadata whose sfTransactionIndex is changed to index.
+
+    A transaction applied on its own view is numbered as if it were the
+    first one in the ledger.
+*/
+std::shared_ptr<Serializer const>
+renumber(std::shared_ptr<Serializer const> const& meta, std::uint32_t index)
+{
+    auto ret = std::make_shared<Serializer>(meta->data(), meta->size());
+
+    // The index is the first field of the serialized metadata, as it sorts
+    // before every other field: patch it in place when it is found there.
+    SerialIter sit(ret->slice());
+    int type;
+    int name;
+    sit.getFieldID(type, name);
+    if (type == STI_UINT32 && name == sfTransactionIndex.fieldValue &&
+        sit.getBytesLeft() >= 4)
+    {
+        auto const p = ret->size() - sit.getBytesLeft();
+        auto& data = ret->modData();
+        data[p] = static_cast<std::uint8_t>(index >> 24);
+        data[p + 1] = static_cast<std::uint8_t>(index >> 16);
+        data[p + 2] = static_cast<std::uint8_t>(index >> 8);
+        data[p + 3] = static_cast<std::uint8_t>(index);
+        return ret;
+    }
+
+    SerialIter it(meta->slice());
+    STObject obj(it, sfMetadata);
+    obj.setFieldU32(sfTransactionIndex, index);
+    ret = std::make_shared<Serializer>();
+    obj.add(*ret);
+    return ret;
+}
+
+/** Commits the changes of a transaction's own view to the shared view.
+
+    Remembers the keys of the entries it changes, and numbers the
+    transaction by its position in the shared view.
+*/
+class Committer : public TxsRawView
+{
+public:
+    Committer(OpenView& to, hash_set<uint256>& dirty) : to_(to), dirty_(dirty)
+    {
+    }
+
+    void
+    rawErase(std::shared_ptr<SLE> const& sle) override
+    {
+        dirty_.insert(sle->key());
+        to_.rawErase(sle);
+    }
+
+    void
+    rawInsert(std::shared_ptr<SLE> const& sle) override
+    {
+        dirty_.insert(sle->key());
+        to_.rawInsert(sle);
+    }
+
+    void
+    rawReplace(std::shared_ptr<SLE> const& sle) override
+    {
+        dirty_.insert(sle->key());
+        to_.rawReplace(sle);
+    }
+
+    void
+    rawDestroyXRP(XRPAmount const& fee) override
+    {
+        to_.rawDestroyXRP(fee);
+    }
+
+    void
+    rawTxInsert(
+        ReadView::key_type const& key,
+        std::shared_ptr<Serializer const> const& txn,
+        std::shared_ptr<Serializer const> const& metaData) override
+    {
+        to_.rawTxInsert(key, txn, renumber(metaData, to_.txCount()));
+    }
+
+private:
+    OpenView& to_;
+    hash_set<uint256>& dirty_;
+};
+
+/** Records the keys of the entries a transaction's own view changes. */
+class WriteSet : public TxsRawView
+{
+public:
+    explicit WriteSet(std::vector<uint256>& keys) : keys_(keys)
+    {
+    }
+
+    void
+    rawErase(std::shared_ptr<SLE> const& sle) override
+    {
+        keys_.push_back(sle->key());
+    }
+
+    void
+    rawInsert(std::shared_ptr<SLE> const& sle) override
+    {
+        keys_.push_back(sle->key());
+    }
+
+    void
+    rawReplace(std::shared_ptr<SLE> const& sle) override
+    {
+        keys_.push_back(sle->key());
+    }
+
+    void
+    rawDestroyXRP(XRPAmount const&) override
+    {
+    }
+
+    void
+    rawTxInsert(
+        ReadView::key_type const&,
+        std::shared_ptr<Serializer const> const&,
+        std::shared_ptr<Serializer const> const&) override
+    {
+    }
+
+private:
+    std::vector<uint256>& keys_;
+};
+
+// A transaction and the outcome of applying it on its own
+struct Speculation
+{
+    std::shared_ptr<STTx const> tx;
+    std::unique_ptr<RecordingView> reads;
+    std::unique_ptr<OpenView> view;
+    // Entries the speculation changes. An entry that is created need not
+    // have been read first.
+    std::vector<uint256> writes;
+    ApplyResult result = ApplyResult::Retry;
+    bool valid = false;
+};
+
+}  // namespace
+
+std::size_t
+applyTransactionsParallel(
+    Application& app,
+    std::shared_ptr<Ledger const> const& built,
+    CanonicalTXSet& txns,
+    std::set<TxID>& failed,
+    OpenView& view,
+    bool certainRetry,
+    std::size_t threads,
+    beast::Journal j)
+{
+    assert(!view.open());
+
+    std::vector<CanonicalTXSet::const_iterator> order;
+    order.reserve(txns.size());
+    for (auto it = txns.begin(); it != txns.end();)
+    {
+        auto const txid = it->first.getTXID();
+        try
+        {
+            if (built->txExists(txid))
+            {
+                it = txns.erase(it);
+                continue;
+            }
+        }
+        catch (std::exception const&)
+        {
+            JLOG(j.warn()) << "Transaction " << txid << " throws";
+            failed.insert(txid);
+            it = txns.erase(it);
+            continue;
+        }
+        order.push_back(it++);
+    }
+
+    // Speculate against a frozen copy of the view, which costs nothing to
+    // take, so that the commits below do not race with the workers.
+    OpenView const snapshot(view);
+    std::vector<Speculation> specs(order.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+        specs[i].tx = order[i]->second;
+
+    // The workers only read the snapshot and the ledger under it, which
+    // nothing changes until they are done. A SHAMap may be read from
+    // several threads at once whether or not it is mutable: a node loaded
+    // on the way is hooked up under its parent's lock.
+    auto speculate = [&](std::size_t i) {
+        auto& s = specs[i];
+
+        // Pseudo-transactions are rare and change ledger-wide state
+        if (isPseudoTx(*s.tx))
+            return;
+
+        try
+        {
+            s.reads = std::make_unique<RecordingView>(snapshot);
+            s.view = std::make_unique<OpenView>(s.reads.get());
+            s.result =
+                applyTransaction(app, *s.view, *s.tx, certainRetry, tapNONE, j);
+            WriteSet writes(s.writes);
+            s.view->apply(writes);
+            s.valid = !s.reads->ranged();
+        }
+        catch (std::exception const&)
+        {
+            // Applied again below, where it fails the same way
+            s.valid = false;
+        }
+    };
+
+    app.getJobQueue().parallelFor(
+        jtTXN_SPECULATE, "speculate", specs.size(), threads, speculate);
+
+    hash_set<uint256> dirty;
+    Committer committer(view, dirty);
+    std::size_t changes = 0;
+    std::size_t reapplied = 0;
+
+    for (std::size_t i = 0; i < specs.size(); ++i)
+    {
+        auto& s = specs[i];
+        auto const it = order[i];
+        auto const txid = it->first.getTXID();
+
+        try
+        {
+            // Valid unless an earlier transaction changed what it read or
+            // what it writes
+            bool const valid = s.valid &&
+                std::none_of(
+                    s.reads->reads().begin(),
+                    s.reads->reads().end(),
+                    [&](auto const& read) {
+                        return dirty.count(read.first) != 0;
+                    }) &&
+                std::none_of(
+                    s.writes.begin(), s.writes.end(), [&](auto const& key) {
+                        return dirty.count(key) != 0;
+                    });
+
+            if (!valid)
+            {
+                ++reapplied;
+                s.view = std::make_unique<OpenView>(&view);
+                s.result = applyTransaction(
+                    app, *s.view, *s.tx, certainRetry, tapNONE, j);
+            }
+
+            switch (s.result)
+            {
+                case ApplyResult::Success:
+                    s.view->apply(committer);
+                    txns.erase(it);
+                    ++changes;
+                    break;
+
+                case ApplyResult::Fail:
+                    failed.insert(txid);
+                    txns.erase(it);
+                    break;
+
+                case ApplyResult::Retry:
+                    break;
+            }
+        }
+        catch (std::exception const&)
+        {
+            JLOG(j.warn()) << "Transaction " << txid << " throws";
+            failed.insert(txid);
+            txns.erase(it);
+        }
+
+        s.view.reset();
+        s.reads.reset();
+    }
+
+    JLOG(j.debug()) << "Parallel pass: " << specs.size() << " transactions, "
+                    << reapplied << " applied again serially";
+
+    return changes;
+}
+
+}  // namespace ripple
@@ -0,0 +1,67 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_IMPL_PARALLELAPPLY_H_INCLUDED
+#define RIPPLE_APP_LEDGER_IMPL_PARALLELAPPLY_H_INCLUDED
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/app/misc/CanonicalTXSet.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/ledger/OpenView.h>
+#include <cstddef>
+#include <memory>
+#include <set>
+
+namespace ripple {
+
+/** Apply consensus transactions speculatively in parallel, once each.
+
+    Every transaction is first applied on its own against a snapshot of
+    the view, by the calling thread and up to threads - 1 jobs, recording
+    the keys of the ledger entries it reads and changes. The results are
+    then committed to the view in canonical order. A transaction whose
+    speculation read or changed an entry that an earlier transaction in
+    the same batch changed, or that walked a range of the ledger, is
+    applied again against the view as it stands, exactly as the serial
+    loop would apply it. Entries that are created are checked too, since
+    creating one need not read it first. So the view ends up identical to
+    the one applying every transaction serially produces.
+
+    This replaces the first pass of the serial loop: transactions already
+    in the built ledger are dropped, those that succeed or fail are
+    removed from txns (failures are added to failed) and those to retry are
+    left in txns, in canonical order.
+
+    @return The number of transactions that succeeded.
+*/
+std::size_t
+applyTransactionsParallel(
+    Application& app,
+    std::shared_ptr<Ledger const> const& built,
+    CanonicalTXSet& txns,
+    std::set<TxID>& failed,
+    OpenView& view,
+    bool certainRetry,
+    std::size_t threads,
+    beast::Journal j);
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,312 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/PeerScoreboard.h>
+#include <algorithm>
+#include <limits>
+
+namespace ripple {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+enum {
+    // Nodes a peer we know nothing about may have outstanding
+    initialWindow = 32
+
+    // The window never shrinks below this
+    ,
+    minWindow = 8
+
+    // The window never grows beyond this
+    ,
+    maxWindow = 1024
+
+    // Nodes handed out at a time when splitting a batch
+    ,
+    scheduleChunk = 8
+
+    // Assumed time per node, in microseconds, before we have measured any
+    // peer
+    ,
+    defaultPerNode = 2000
+};
+
+// Forget a peer after this long without requests or replies
+auto constexpr idleTimeout = 5min;
+
+template <class T>
+T
+smooth(T average, T sample, std::uint64_t samples)
+{
+    if (samples == 0)
+        return sample;
+    return (average * 7 + sample) / 8;
+}
+
+}  // namespace
+
+PeerScoreboard::PeerScoreboard(clock_type& clock) : clock_(clock)
+{
+}
+
+PeerScoreboard::Entry&
+PeerScoreboard::get(key_type const& key)
+{
+    auto [it, inserted] = entries_.try_emplace(key);
+    if (inserted)
+        it->second.est.window = initialWindow;
+    return it->second;
+}
+
+void
+PeerScoreboard::onRequest(id_t peer, int type, std::size_t nodes)
+{
+    auto const now = clock_.now();
+
+    std::lock_guard lock(mutex_);
+    auto& e = get({peer, type});
+    e.outstanding.push_back({now, nodes});
+    e.est.inFlight += nodes;
+    e.lastUsed = now;
+}
+
+void
+PeerScoreboard::onReply(
+    id_t peer,
+    int type,
+    std::size_t nodes,
+    std::size_t bytes)
+{
+    using namespace std::chrono;
+
+    auto const now = clock_.now();
+
+    std::lock_guard lock(mutex_);
+    auto& e = get({peer, type});
+    e.lastUsed = now;
+
+    // An unsolicited reply, or one to a request we already gave up on,
+    // tells us nothing about latency.
+    if (e.outstanding.empty())
+        return;
+
+    auto const req = e.outstanding.front();
+    e.outstanding.pop_front();
+    e.est.inFlight -= std::min(e.est.inFlight, req.nodes);
+
+    auto const elapsed = std::max<microseconds>(
+        duration_cast<microseconds>(now - req.sent), 1us);
+    auto const us = static_cast<std::uint64_t>(elapsed.count());
+
+    auto& est = e.est;
+    est.latency = smooth(
+        est.latency, duration_cast<milliseconds>(elapsed), est.replies);
+    est.bytesPerSecond = smooth<std::uint64_t>(
+        est.bytesPerSecond, bytes * 1000000 / us, est.replies);
+    est.perNode = smooth<std::uint64_t>(
+        est.perNode,
+        us / std::max<std::size_t>(std::min(nodes, req.nodes), 1),
+        est.replies);
+    ++est.replies;
+
+    // Open the window while the peer keeps up
+    est.window = std::min<std::size_t>(
+        maxWindow, est.window + std::max<std::size_t>(nodes / 2, 1));
+}
+
+void
+PeerScoreboard::expire(std::chrono::milliseconds timeout)
+{
+    using namespace std::chrono;
+
+    auto const now = clock_.now();
+
+    std::lock_guard lock(mutex_);
+    for (auto& entry : entries_)
+    {
+        auto& e = entry.second;
+        bool lost = false;
+        while (!e.outstanding.empty() &&
+               (e.outstanding.front().sent + timeout) <= now)
+        {
+            auto const& req = e.outstanding.front();
+            e.est.inFlight -= std::min(e.est.inFlight, req.nodes);
+
+            // Charge the peer as if it had taken the whole timeout
+            e.est.perNode = smooth<std::uint64_t>(
+                e.est.perNode,
+                duration_cast<microseconds>(timeout).count() /
+                    std::max<std::size_t>(req.nodes, 1),
+                e.est.replies);
+            ++e.est.timeouts;
+            e.outstanding.pop_front();
+            lost = true;
+        }
+
+        if (lost)
+            e.est.window = std::max<std::size_t>(minWindow, e.est.window / 2);
+    }
+}
+
+void
+PeerScoreboard::sweep()
+{
+    auto const now = clock_.now();
+
+    std::lock_guard lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();)
+    {
+        if ((it->second.lastUsed + idleTimeout) < now)
+            it = entries_.erase(it);
+        else
+            ++it;
+    }
+}
+
+PeerScoreboard::Estimate
+PeerScoreboard::estimate(id_t peer, int type) const
+{
+    std::lock_guard lock(mutex_);
+    auto const it = entries_.find({peer, type});
+    if (it == entries_.end())
+    {
+        Estimate est;
+        est.window = initialWindow;
+        return est;
+    }
+    return it->second.est;
+}
+
+std::vector<std::pair<PeerScoreboard::id_t, std::size_t>>
+PeerScoreboard::schedule(
+    std::vector<id_t> const& peers,
+    int type,
+    std::size_t nodes) const
+{
+    struct Candidate
+    {
+        id_t id;
+        std::uint64_t perNode;
+        std::size_t queued;
+        std::size_t free;
+        std::size_t assigned = 0;
+    };
+
+    std::vector<Candidate> candidates;
+    candidates.reserve(peers.size());
+
+    {
+        std::lock_guard lock(mutex_);
+
+        // Peers we have not measured yet are assumed to be as good as the
+        // best peer we know, so that they get probed; their small initial
+        // window bounds the cost of being wrong.
+        std::uint64_t best = std::numeric_limits<std::uint64_t>::max();
+        for (auto const id : peers)
+        {
+            auto const it = entries_.find({id, type});
+            if (it != entries_.end() && it->second.est.replies != 0)
+                best = std::min<std::uint64_t>(
+                    best, std::max<std::uint64_t>(it->second.est.perNode, 1));
+        }
+        if (best == std::numeric_limits<std::uint64_t>::max())
+            best = defaultPerNode;
+
+        for (auto const id : peers)
+        {
+            Candidate c{id, best, 0, initialWindow};
+            auto const it = entries_.find({id, type});
+            if (it != entries_.end())
+            {
+                auto const& est = it->second.est;
+                if (est.replies != 0)
+                    c.perNode = std::max<std::uint64_t>(est.perNode, 1);
+                c.queued = est.inFlight;
+                c.free = (est.window > est.inFlight)
+                    ? (est.window - est.inFlight)
+                    : 0;
+            }
+            candidates.push_back(c);
+        }
+    }
+
+    if (candidates.empty() || nodes == 0)
+        return {};
+
+    // Hand out chunks one at a time to whichever peer is expected to be
+    // done with them first, given what it already has queued.
+    std::size_t remaining = nodes;
+    while (remaining != 0)
+    {
+        Candidate* pick = nullptr;
+        std::uint64_t pickFinish = 0;
+        for (auto& c : candidates)
+        {
+            if (c.assigned >= c.free)
+                continue;
+            auto const n = std::min<std::size_t>(
+                {scheduleChunk, remaining, c.free - c.assigned});
+            auto const finish = (c.queued + c.assigned + n) * c.perNode;
+            if (!pick || finish < pickFinish)
+            {
+                pick = &c;
+                pickFinish = finish;
+            }
+        }
+
+        if (!pick)
+            break;
+
+        auto const n = std::min<std::size_t>(
+            {scheduleChunk, remaining, pick->free - pick->assigned});
+        pick->assigned += n;
+        remaining -= n;
+    }
+
+    // Always make some progress, even if every window is full
+    if (remaining == nodes)
+    {
+        auto best = std::min_element(
+            candidates.begin(),
+            candidates.end(),
+            [](Candidate const& a, Candidate const& b) {
+                return a.perNode < b.perNode;
+            });
+        best->assigned = std::min<std::size_t>(scheduleChunk, nodes);
+    }
+
+    std::stable_sort(
+        candidates.begin(),
+        candidates.end(),
+        [](Candidate const& a, Candidate const& b) {
+            return a.perNode < b.perNode;
+        });
+
+    std::vector<std::pair<id_t, std::size_t>> ret;
+    for (auto const& c : candidates)
+    {
+        if (c.assigned != 0)
+            ret.emplace_back(c.id, c.assigned);
+    }
+    return ret;
+}
+
+}  // namespace ripple
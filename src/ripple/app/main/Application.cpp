@@ -33,6 +33,7 @@
 #include <ripple/app/main/NodeIdentity.h>
 #include <ripple/app/main/NodeStoreScheduler.h>
 #include <ripple/app/main/Tuning.h>
+#include <ripple/app/misc/AccountTxIndex.h>
 #include <ripple/app/misc/AmendmentTable.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
@@ -41,7 +42,10 @@
 #include <ripple/app/misc/TxQ.h>
 #include <ripple/app/misc/ValidatorKeys.h>
 #include <ripple/app/misc/ValidatorSite.h>
+#include <ripple/app/misc/impl/AccountTxPaging.h>
 #include <ripple/app/paths/PathRequests.h>
+#include <ripple/app/tx/PreclaimCache.h>
+#include <ripple/app/tx/TxMetrics.h>
 #include <ripple/app/tx/apply.h>
 #include <ripple/basics/ByteUtilities.h>
 #include <ripple/basics/PerfLog.h>
@@ -373,6 +377,8 @@ public:
     RCLValidations mValidations;
     std::unique_ptr<LoadManager> m_loadManager;
     std::unique_ptr<TxQ> txQ_;
+    PreclaimCache preclaimCache_;
+    TxMetrics txMetrics_;
     ClosureCounter<void, boost::system::error_code const&> waitHandlerCounter_;
     boost::asio::steady_timer sweepTimer_;
     boost::asio::steady_timer entropyTimer_;
@@ -381,6 +387,7 @@ public:
     std::unique_ptr<DatabaseCon> mTxnDB;
     std::unique_ptr<DatabaseCon> mLedgerDB;
     std::unique_ptr<DatabaseCon> mWalletDB;
+    std::unique_ptr<AccountTxIndex> accountTxIndex_;
     std::unique_ptr<Overlay> overlay_;
     std::vector<std::unique_ptr<Stoppable>> websocketServers_;
 
@@ -418,6 +425,12 @@ public:
 #endif
     }
 
+    static std::size_t
+    peerIOThreads(Config const& config)
+    {
+        return get<std::size_t>(config.section("overlay"), "io_threads", 0);
+    }
+
     //--------------------------------------------------------------------------
 
     ApplicationImp(
@@ -425,7 +438,7 @@ public:
         std::unique_ptr<Logs> logs,
         std::unique_ptr<TimeKeeper> timeKeeper)
         : RootStoppable("Application")
-        , BasicApp(numberOfThreads(*config))
+        , BasicApp(numberOfThreads(*config), peerIOThreads(*config))
         , config_(std::move(config))
         , logs_(std::move(logs))
         , timeKeeper_(std::move(timeKeeper))
@@ -593,6 +606,8 @@ public:
 
         , txQ_(make_TxQ(setup_TxQ(*config_), logs_->journal("TxQ")))
 
+        , txMetrics_(*perfLog_, m_collectorManager->group("tx"))
+
         , sweepTimer_(get_io_service())
 
         , entropyTimer_(get_io_service())
@@ -930,6 +945,18 @@ public:
         return *txQ_;
     }
 
+    PreclaimCache&
+    getPreclaimCache() override
+    {
+        return preclaimCache_;
+    }
+
+    TxMetrics&
+    getTxMetrics() override
+    {
+        return txMetrics_;
+    }
+
     DatabaseCon&
     getTxnDB() override
     {
@@ -948,6 +975,11 @@ public:
         assert(mWalletDB.get() != nullptr);
         return *mWalletDB;
     }
+    AccountTxIndex*
+    getAccountTxIndex() override
+    {
+        return accountTxIndex_.get();
+    }
 
     bool
     serverOkay(std::string& reason) override;
@@ -1032,6 +1064,65 @@ public:
         return true;
     }
 
+    bool
+    initAccountTxIndex()
+    {
+        if (!config_->exists("account_tx_index"))
+        {
+            // The table is missing whatever was saved while the index
+            // replaced it
+            if (auto const cutover = accountTxIndexCutover(*mTxnDB))
+            {
+                JLOG(m_journal.fatal())
+                    << "The AccountTransactions table was replaced by the "
+                       "account transaction index after ledger "
+                    << *cutover << ": configure [account_tx_index]";
+                return false;
+            }
+            return true;
+        }
+
+        auto const& section = config_->section("account_tx_index");
+        if (boost::iequals(get<std::string>(section, "type"), "memory") &&
+            !config_->standalone())
+        {
+            JLOG(m_journal.fatal())
+                << "An account transaction index kept in memory is only "
+                   "for standalone servers";
+            return false;
+        }
+
+        try
+        {
+            accountTxIndex_ = std::make_unique<AccountTxIndex>(
+                make_AccountTxBackend(
+                    section, logs_->journal("AccountTxIndex")),
+                logs_->journal("AccountTxIndex"));
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(m_journal.fatal())
+                << "Failed to open the account transaction index: "
+                << e.what();
+            return false;
+        }
+
+        if (!openAccountTxIndex(
+                *accountTxIndex_, *mTxnDB, logs_->journal("AccountTxIndex")))
+            return false;
+
+        // Copy what the AccountTransactions table holds, if it has not
+        // been copied yet
+        if (!accountTxIndex_->ready())
+        {
+            m_jobQueue->addJob(
+                jtCOPY_ACCT_TX, "copyAccountTransactions", [this](Job&) {
+                    copyAccountTransactions(*this);
+                });
+        }
+        return true;
+    }
+
     bool
     initNodeStore()
     {
@@ -1442,7 +1533,7 @@ ApplicationImp::setup()
     if (!config_->standalone())
         timeKeeper_->run(config_->SNTP_SERVERS);
 
-    if (!initSQLiteDBs() || !initNodeStore())
+    if (!initSQLiteDBs() || !initAccountTxIndex() || !initNodeStore())
         return false;
 
     if (shardStore_)
@@ -1599,6 +1690,7 @@ ApplicationImp::setup()
         *m_resourceManager,
         *m_resolver,
         get_io_service(),
+        get_peer_io(),
         *config_,
         m_collectorManager->collector());
     add(*overlay_);  // add to PropertyStream
@@ -1629,6 +1721,18 @@ ApplicationImp::setup()
             auto setup = setup_ServerHandler(
                 *config_, beast::logstream{m_journal.error()});
             setup.makeContexts();
+
+            // Accept peer connections straight onto the peer io_contexts
+            if (auto const peerIO = get_peer_io())
+            {
+                for (auto& port : setup.ports)
+                {
+                    if (port.protocol.count("peer") != 0)
+                        port.io_context = [peerIO]() -> auto& {
+                            return peerIO->next();
+                        };
+                }
+            }
             serverHandler_->setup(setup, m_journal);
         }
         catch (std::exception const& e)
@@ -59,6 +59,7 @@ class JobQueue;
 class InboundLedgers;
 class InboundTransactions;
 class AcceptedLedger;
+class AccountTxIndex;
 class LedgerMaster;
 class LoadManager;
 class ManifestCache;
@@ -69,12 +70,14 @@ class OrderBookDB;
 class Overlay;
 class PathRequests;
 class PendingSaves;
+class PreclaimCache;
 class PublicKey;
 class SecretKey;
 class AccountIDCache;
 class STLedgerEntry;
 class TimeKeeper;
 class TransactionMaster;
+class TxMetrics;
 class TxQ;
 
 class ValidatorList;
@@ -167,6 +170,10 @@ public:
     overlay() = 0;
     virtual TxQ&
     getTxQ() = 0;
+    virtual PreclaimCache&
+    getPreclaimCache() = 0;
+    virtual TxMetrics&
+    getTxMetrics() = 0;
     virtual ValidatorList&
     validators() = 0;
     virtual ValidatorSite&
@@ -228,6 +235,9 @@ public:
     getTxnDB() = 0;
     virtual DatabaseCon&
     getLedgerDB() = 0;
+    /** The account transaction index, or nullptr if none is configured. */
+    virtual AccountTxIndex*
+    getAccountTxIndex() = 0;
 
     virtual std::chrono::milliseconds
     getIOLatency() = 0;
@@ -20,8 +20,12 @@
 #include <ripple/app/main/BasicApp.h>
 #include <ripple/beast/core/CurrentThreadName.h>
 
-BasicApp::BasicApp(std::size_t numberOfThreads)
+BasicApp::BasicApp(std::size_t numberOfThreads, std::size_t peerThreads)
 {
+    if (peerThreads != 0)
+        peerIO_ = std::make_unique<ripple::IOContextPool>(
+            peerThreads, true, "peer io");
+
     work_.emplace(io_service_);
     threads_.reserve(numberOfThreads);
 
@@ -41,4 +45,6 @@ BasicApp::~BasicApp()
 
     for (auto& t : threads_)
         t.join();
+
+    peerIO_.reset();
 }
@@ -20,8 +20,10 @@
 #ifndef RIPPLE_APP_BASICAPP_H_INCLUDED
 #define RIPPLE_APP_BASICAPP_H_INCLUDED
 
+#include <ripple/core/IOContextPool.h>
 #include <boost/asio/io_service.hpp>
 #include <boost/optional.hpp>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -32,9 +34,17 @@ private:
     boost::optional<boost::asio::io_service::work> work_;
     std::vector<std::thread> threads_;
     boost::asio::io_service io_service_;
+    std::unique_ptr<ripple::IOContextPool> peerIO_;
 
 protected:
-    BasicApp(std::size_t numberOfThreads);
+    /** Create the application's I/O threads.
+
+        @param numberOfThreads Threads running the main io_service.
+        @param peerThreads If non-zero, the number of io_contexts, each run
+                           by a thread pinned to a core, that peer
+                           connections are spread over.
+    */
+    BasicApp(std::size_t numberOfThreads, std::size_t peerThreads = 0);
     ~BasicApp();
 
 public:
@@ -43,6 +53,15 @@ public:
     {
         return io_service_;
     }
+
+    /** The io_contexts for peer connections, or nullptr if peer
+        connections use the main io_service.
+    */
+    ripple::IOContextPool*
+    get_peer_io()
+    {
+        return peerIO_.get();
+    }
 };
 
 #endif
@@ -79,7 +79,7 @@ inline constexpr
     }
 };
 
-inline constexpr std::array<char const*, 8> TxDBInit{
+inline constexpr std::array<char const*, 9> TxDBInit{
     {"BEGIN TRANSACTION;",
 
      "CREATE TABLE IF NOT EXISTS Transactions (          \
@@ -108,6 +108,13 @@ inline constexpr std::array<char const*, 8> TxDBInit{
      "CREATE INDEX IF NOT EXISTS AcctLgrIndex ON         \
         AccountTransactions(LedgerSeq, Account, TransID);",
 
+     // Holds a row once the account transaction index has replaced the
+     // AccountTransactions table, which is no longer written to after
+     // the ledger it names
+     "CREATE TABLE IF NOT EXISTS AccountTxIndex (        \
+        LedgerSeq   BIGINT UNSIGNED                     \
+    );",
+
      "END TRANSACTION;"}};
 
 ////////////////////////////////////////////////////////////////////////////////
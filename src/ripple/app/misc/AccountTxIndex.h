@@ -0,0 +1,214 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_ACCOUNTTXINDEX_H_INCLUDED
+#define RIPPLE_APP_MISC_ACCOUNTTXINDEX_H_INCLUDED
+
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/RangeSet.h>
+#include <ripple/basics/Slice.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/protocol/AccountID.h>
+#include <ripple/protocol/Protocol.h>
+#include <boost/optional.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** The transactions which affected each account, in ledger order.
+
+    This holds what the AccountTransactions table of the transaction
+    database holds, in an ordered key value store of its own: for each
+    account, and each (ledger sequence, transaction sequence) of a
+    transaction which affected it, the transaction's ID. The entries of
+    an account are stored next to each other, so a page of them is found
+    with one seek and read in either direction, however many the account
+    has, where SQLite has to skip over every row before an OFFSET.
+
+    Each entry is also kept under its ledger, so the entries of a ledger
+    can be replaced when it is saved again and those of old ledgers can
+    be deleted.
+
+    The index remembers which ledgers it holds the entries of. Those of
+    a database which kept them in SQLite are copied over while the server
+    runs, for every ledger the table holds and the index does not. Until
+    the copy is done, the index is written to alongside the table but not
+    read from; after it, the table is no longer written to, and the index
+    must be kept.
+*/
+class AccountTxIndex
+{
+public:
+    /** An ordered store of binary keys and values. */
+    class Backend
+    {
+    public:
+        /** Keys to write, with no value for those to delete. */
+        using Batch =
+            std::vector<std::pair<std::string, boost::optional<std::string>>>;
+
+        virtual ~Backend() = default;
+
+        virtual boost::optional<std::string>
+        get(std::string const& key) = 0;
+
+        /** Apply every change of a batch, or none of them. */
+        virtual void
+        write(Batch const& batch) = 0;
+
+        /** Visit the keys from first to last inclusive.
+
+            Visits them in ascending order if forward is true, when first
+            is the lowest, and in descending order if it is not. Stops at
+            the first key for which f returns false.
+        */
+        virtual void
+        scan(
+            std::string const& first,
+            std::string const& last,
+            bool forward,
+            std::function<bool(Slice key, Slice value)> const& f) = 0;
+    };
+
+    /** A transaction which affected an account. */
+    struct Entry
+    {
+        AccountID account;
+        std::uint32_t txnSeq;
+        uint256 txID;
+    };
+
+    /** The position of an entry among those of an account. */
+    using Position = std::pair<LedgerIndex, std::uint32_t>;
+
+    AccountTxIndex(std::unique_ptr<Backend> backend, beast::Journal journal);
+
+    /** Replace whatever is held for a ledger with its entries. */
+    void
+    saveLedger(LedgerIndex seq, std::vector<Entry> const& entries);
+
+    /** Delete the entries of every ledger before seq. */
+    void
+    deleteBefore(LedgerIndex seq);
+
+    /** Visit the transactions which affected an account.
+
+        Visits those in ledgers from minLedger to maxLedger, in ascending
+        or descending order, starting at start if it is seated. Stops at
+        the first transaction for which f returns false.
+    */
+    void
+    forEach(
+        AccountID const& account,
+        LedgerIndex minLedger,
+        LedgerIndex maxLedger,
+        bool forward,
+        boost::optional<Position> const& start,
+        std::function<bool(Position const&, uint256 const&)> const& f) const;
+
+    /** Returns the ledgers the index holds the entries of. */
+    RangeSet<LedgerIndex>
+    saved() const;
+
+    /** Save ledgers copied from the table.
+
+        Each ledger from first to last which the index does not hold yet
+        is given its entries in ledgers, or none if ledgers has none for
+        it. Those it holds were saved since the table was read, and are
+        kept.
+    */
+    void
+    saveCopied(
+        LedgerIndex first,
+        LedgerIndex last,
+        std::map<LedgerIndex, std::vector<Entry>> const& ledgers);
+
+    /** Returns the newest ledger the table held when the index replaced
+        it, if it has.
+    */
+    boost::optional<LedgerIndex>
+    cutover() const;
+
+    /** Record that the index replaces the table after a ledger. */
+    void
+    setCutover(LedgerIndex seq);
+
+    /** True if the index is used in place of the table.
+
+        The index only replaces the table once it holds everything the
+        table held, and the transaction database records that the table
+        is no longer written to.
+    */
+    bool
+    ready() const
+    {
+        return ready_;
+    }
+
+    /** Use the index in place of the table. */
+    void
+    markReady()
+    {
+        ready_ = true;
+    }
+
+private:
+    // Adds to a batch what replaces the entries of a ledger
+    void
+    replaceLedger(
+        Backend::Batch& batch,
+        LedgerIndex seq,
+        std::vector<Entry> const& entries) const;
+
+    std::unique_ptr<Backend> const backend_;
+    beast::Journal const j_;
+
+    // Keeps writes which replace what they read from overlapping, and
+    // guards what the index knows of itself
+    mutable std::mutex writeMutex_;
+
+    RangeSet<LedgerIndex> saved_;
+    boost::optional<LedgerIndex> cutover_;
+    std::atomic<bool> ready_{false};
+};
+
+/** Create the store of an index as configured.
+
+    The section names the type of store, "rocksdb" or "memory", and for
+    RocksDB the path of its database and any tuning it has.
+*/
+std::unique_ptr<AccountTxIndex::Backend>
+make_AccountTxBackend(Section const& section, beast::Journal journal);
+
+/** A store kept only in memory, for unit tests and standalone servers. */
+std::unique_ptr<AccountTxIndex::Backend>
+make_MemoryAccountTxBackend();
+
+}  // namespace ripple
+
+#endif
@@ -18,80 +18,36 @@
 //==============================================================================
 
 #include <ripple/app/misc/CanonicalTXSet.h>
-#include <boost/range/adaptor/transformed.hpp>
+#include <algorithm>
+#include <cassert>
 
 namespace ripple {
 
-bool
-CanonicalTXSet::Key::operator<(Key const& rhs) const
-{
-    if (mAccount < rhs.mAccount)
-        return true;
-
-    if (mAccount > rhs.mAccount)
-        return false;
-
-    if (mSeq < rhs.mSeq)
-        return true;
-
-    if (mSeq > rhs.mSeq)
-        return false;
-
-    return mTXid < rhs.mTXid;
-}
-
-bool
-CanonicalTXSet::Key::operator>(Key const& rhs) const
-{
-    if (mAccount > rhs.mAccount)
-        return true;
-
-    if (mAccount < rhs.mAccount)
-        return false;
-
-    if (mSeq > rhs.mSeq)
-        return true;
-
-    if (mSeq < rhs.mSeq)
-        return false;
-
-    return mTXid > rhs.mTXid;
-}
-
-bool
-CanonicalTXSet::Key::operator<=(Key const& rhs) const
+CanonicalTXSet::Key::Key(
+    uint256 const& account,
+    std::uint32_t seq,
+    uint256 const& id)
+    : mPrefix(0), mAccount(account), mTXid(id), mSeq(seq)
 {
-    if (mAccount < rhs.mAccount)
-        return true;
-
-    if (mAccount > rhs.mAccount)
-        return false;
-
-    if (mSeq < rhs.mSeq)
-        return true;
-
-    if (mSeq > rhs.mSeq)
-        return false;
-
-    return mTXid <= rhs.mTXid;
+    // Big-endian, so the prefixes order the same way as the accounts
+    auto const p = account.begin();
+    for (std::size_t i = 0; i < sizeof(mPrefix); ++i)
+        mPrefix = (mPrefix << 8) | p[i];
 }
 
 bool
-CanonicalTXSet::Key::operator>=(Key const& rhs) const
+CanonicalTXSet::Key::operator<(Key const& rhs) const
 {
-    if (mAccount > rhs.mAccount)
-        return true;
+    if (mPrefix != rhs.mPrefix)
+        return mPrefix < rhs.mPrefix;
 
-    if (mAccount < rhs.mAccount)
-        return false;
+    if (auto const c = compare(mAccount, rhs.mAccount); c != 0)
+        return c < 0;
 
-    if (mSeq > rhs.mSeq)
-        return true;
+    if (mSeq != rhs.mSeq)
+        return mSeq < rhs.mSeq;
 
-    if (mSeq < rhs.mSeq)
-        return false;
-
-    return mTXid >= rhs.mTXid;
+    return mTXid < rhs.mTXid;
 }
 
 uint256
@@ -106,31 +62,83 @@ CanonicalTXSet::accountKey(AccountID const& account)
 void
 CanonicalTXSet::insert(std::shared_ptr<STTx const> const& txn)
 {
-    map_.insert(std::make_pair(
+    txs_.emplace_back(
         Key(accountKey(txn->getAccountID(sfAccount)),
             txn->getSequence(),
             txn->getTransactionID()),
-        txn));
+        txn);
+    sorted_ = false;
 }
 
 std::vector<std::shared_ptr<STTx const>>
 CanonicalTXSet::prune(AccountID const& account, std::uint32_t const seq)
 {
+    sort();
+
     auto effectiveAccount = accountKey(account);
 
     Key keyLow(effectiveAccount, seq, beast::zero);
     Key keyHigh(effectiveAccount, seq + 1, beast::zero);
 
-    auto range = boost::make_iterator_range(
-        map_.lower_bound(keyLow), map_.lower_bound(keyHigh));
-    auto txRange = boost::adaptors::transform(
-        range, [](auto const& p) { return p.second; });
+    auto const less = [](value_type const& v, Key const& k) {
+        return v.first < k;
+    };
+    auto const first =
+        std::lower_bound(txs_.begin(), txs_.end(), keyLow, less);
+    auto const last = std::lower_bound(first, txs_.end(), keyHigh, less);
+
+    std::vector<std::shared_ptr<STTx const>> result;
+    for (auto it = first; it != last; ++it)
+    {
+        if (it->second)
+        {
+            result.push_back(std::move(it->second));
+            --size_;
+        }
+    }
+    return result;
+}
 
-    std::vector<std::shared_ptr<STTx const>> result(
-        txRange.begin(), txRange.end());
+CanonicalTXSet::const_iterator
+CanonicalTXSet::erase(const_iterator const& it)
+{
+    auto& slot = txs_[it.p_ - txs_.data()];
+    assert(slot.second);
+    slot.second.reset();
+    --size_;
+    return {it.p_ + 1, it.end_};
+}
 
-    map_.erase(range.begin(), range.end());
-    return result;
+void
+CanonicalTXSet::sort() const
+{
+    if (sorted_)
+        return;
+
+    txs_.erase(
+        std::remove_if(
+            txs_.begin(),
+            txs_.end(),
+            [](value_type const& v) { return !v.second; }),
+        txs_.end());
+
+    // Stable, so that of two copies of a transaction the first one
+    // inserted is kept.
+    std::stable_sort(
+        txs_.begin(), txs_.end(), [](value_type const& a, value_type const& b) {
+            return a.first < b.first;
+        });
+    txs_.erase(
+        std::unique(
+            txs_.begin(),
+            txs_.end(),
+            [](value_type const& a, value_type const& b) {
+                return a.first == b.first;
+            }),
+        txs_.end());
+
+    size_ = txs_.size();
+    sorted_ = true;
 }
 
 }  // namespace ripple
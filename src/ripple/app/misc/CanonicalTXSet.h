@@ -22,6 +22,11 @@
 
 #include <ripple/protocol/RippleLedgerHash.h>
 #include <ripple/protocol/STTx.h>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -31,6 +36,11 @@ namespace ripple {
 
     - Puts transactions from the same account in sequence order
 
+    The transactions are kept in a flat vector which is sorted, once, the
+    first time the set is read after an insertion. Erasing a transaction
+    only marks its slot empty, so erasing is cheap and never invalidates
+    iterators to other transactions; iteration skips the empty slots, and
+    they are reclaimed when the set is next sorted.
 */
 // VFALCO TODO rename to SortedTxSet
 class CanonicalTXSet
@@ -39,19 +49,10 @@ private:
     class Key
     {
     public:
-        Key(uint256 const& account, std::uint32_t seq, uint256 const& id)
-            : mAccount(account), mTXid(id), mSeq(seq)
-        {
-        }
+        Key(uint256 const& account, std::uint32_t seq, uint256 const& id);
 
         bool
         operator<(Key const& rhs) const;
-        bool
-        operator>(Key const& rhs) const;
-        bool
-        operator<=(Key const& rhs) const;
-        bool
-        operator>=(Key const& rhs) const;
 
         bool
         operator==(Key const& rhs) const
@@ -71,27 +72,105 @@ private:
         }
 
     private:
+        // The leading bytes of the salted account, which decide nearly
+        // every comparison without touching the rest of the key.
+        std::uint64_t mPrefix;
         uint256 mAccount;
         uint256 mTXid;
         std::uint32_t mSeq;
     };
 
+    using value_type = std::pair<Key, std::shared_ptr<STTx const>>;
+
     // Calculate the salted key for the given account
     uint256
     accountKey(AccountID const& account);
 
 public:
-    using const_iterator =
-        std::map<Key, std::shared_ptr<STTx const>>::const_iterator;
+    /** Visits the transactions in canonical order, skipping erased ones. */
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = CanonicalTXSet::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type const*;
+        using reference = value_type const&;
+
+        const_iterator() = default;
+
+        reference
+        operator*() const
+        {
+            return *p_;
+        }
+
+        pointer
+        operator->() const
+        {
+            return p_;
+        }
+
+        const_iterator&
+        operator++()
+        {
+            ++p_;
+            skip();
+            return *this;
+        }
+
+        const_iterator
+        operator++(int)
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        friend bool
+        operator==(const_iterator const& a, const_iterator const& b)
+        {
+            return a.p_ == b.p_;
+        }
+
+        friend bool
+        operator!=(const_iterator const& a, const_iterator const& b)
+        {
+            return a.p_ != b.p_;
+        }
+
+    private:
+        friend class CanonicalTXSet;
+
+        const_iterator(pointer p, pointer end) : p_(p), end_(end)
+        {
+            skip();
+        }
+
+        void
+        skip()
+        {
+            while (p_ != end_ && !p_->second)
+                ++p_;
+        }
+
+        pointer p_ = nullptr;
+        pointer end_ = nullptr;
+    };
 
 public:
     explicit CanonicalTXSet(LedgerHash const& saltHash) : salt_(saltHash)
     {
     }
 
+    /** Add a transaction. Invalidates every iterator.
+
+        A transaction which is already in the set is ignored.
+    */
     void
     insert(std::shared_ptr<STTx const> const& txn);
 
+    /** Remove and return the transactions of an account with a sequence. */
     std::vector<std::shared_ptr<STTx const>>
     prune(AccountID const& account, std::uint32_t const seq);
 
@@ -100,36 +179,42 @@ public:
     reset(LedgerHash const& salt)
     {
         salt_ = salt;
-        map_.clear();
+        txs_.clear();
+        size_ = 0;
+        sorted_ = true;
     }
 
+    /** Remove a transaction.
+
+        @return An iterator to the transaction following it.
+    */
     const_iterator
-    erase(const_iterator const& it)
-    {
-        return map_.erase(it);
-    }
+    erase(const_iterator const& it);
 
     const_iterator
     begin() const
     {
-        return map_.begin();
+        sort();
+        return {txs_.data(), txs_.data() + txs_.size()};
     }
 
     const_iterator
     end() const
     {
-        return map_.end();
+        sort();
+        return {txs_.data() + txs_.size(), txs_.data() + txs_.size()};
     }
 
     size_t
     size() const
     {
-        return map_.size();
+        sort();
+        return size_;
     }
     bool
     empty() const
     {
-        return map_.empty();
+        return size() == 0;
     }
 
     uint256 const&
@@ -139,7 +224,17 @@ public:
     }
 
 private:
-    std::map<Key, std::shared_ptr<STTx const>> map_;
+    // Puts the transactions inserted since the last call in order,
+    // dropping duplicates and the slots of erased transactions.
+    void
+    sort() const;
+
+    std::vector<value_type> mutable txs_;
+
+    // The number of transactions, not counting erased slots
+    std::size_t mutable size_ = 0;
+
+    bool mutable sorted_ = true;
 
     // Used to salt the accounts so people can't mine for low account numbers
     uint256 salt_;
@@ -18,41 +18,130 @@
 //==============================================================================
 
 #include <ripple/app/misc/HashRouter.h>
+#include <algorithm>
 
 namespace ripple {
 
+namespace {
+
+// Time buckets per hold time
+constexpr int bucketsPerHoldTime = 16;
+
+}  // namespace
+
+HashRouter::HashRouter(
+    Stopwatch& clock,
+    std::chrono::seconds entryHoldTimeInSeconds,
+    std::uint32_t recoverLimit)
+    : clock_(clock)
+    , lastInsert_(clock.now().time_since_epoch().count())
+    , holdTime_(entryHoldTimeInSeconds)
+    , bucketInterval_(std::max<Stopwatch::duration>(
+          holdTime_ / bucketsPerHoldTime,
+          std::chrono::seconds(1)))
+    , recoverLimit_(recoverLimit + 1u)
+{
+}
+
 auto
-HashRouter::emplace(uint256 const& key) -> std::pair<Entry&, bool>
+HashRouter::partition(uint256 const& key) -> Partition&
 {
-    auto iter = suppressionMap_.find(key);
+    // Use the high bits; the low bits pick the bucket within the map.
+    return partitions_
+        [hash_(key) >>
+         (std::numeric_limits<std::size_t>::digits - partitionBits)];
+}
 
-    if (iter != suppressionMap_.end())
+auto
+HashRouter::emplace(Partition& p, uint256 const& key, Stopwatch::time_point now)
+    -> std::pair<Entry&, bool>
+{
+    // Buckets cover (index - 1, index] intervals so that a bucket can be
+    // dropped as soon as its newest possible entry expires.
+    auto const interval = bucketInterval_.count();
+    auto const since = now.time_since_epoch().count();
+    auto const index = since / interval + (since % interval > 0 ? 1 : 0);
+
+    auto touch = [&](Entry& e) {
+        e.touched = now;
+        if (e.bucket == index)
+            return;
+        if (p.buckets.empty() || p.buckets.back().index < index)
+            p.buckets.push_back({index, {}});
+        p.buckets.back().keys.push_back(key);
+        e.bucket = p.buckets.back().index;
+    };
+
+    auto iter = p.map.find(key);
+
+    if (iter != p.map.end())
     {
-        suppressionMap_.touch(iter);
-        return std::make_pair(std::ref(iter->second), false);
+        auto const lastInsert =
+            Stopwatch::time_point(Stopwatch::duration(lastInsert_.load()));
+
+        // The entry would have been expired by the last insertion
+        if (iter->second.touched + holdTime_ > lastInsert)
+        {
+            touch(iter->second);
+            return std::make_pair(std::ref(iter->second), false);
+        }
     }
 
-    // See if any supressions need to be expired
-    expire(suppressionMap_, holdTime_);
+    auto last = lastInsert_.load();
+    while (last < since && !lastInsert_.compare_exchange_weak(last, since))
+        ;
+
+    // See if any suppressions need to be expired
+    reclaim(p, now);
 
-    return std::make_pair(
-        std::ref(suppressionMap_.emplace(key, Entry()).first->second), true);
+    iter = p.map.find(key);
+    if (iter == p.map.end())
+        iter = p.map.emplace(key, Entry()).first;
+    else
+        iter->second = Entry();
+
+    touch(iter->second);
+    return std::make_pair(std::ref(iter->second), true);
+}
+
+void
+HashRouter::reclaim(Partition& p, Stopwatch::time_point now)
+{
+    auto const expired = now - holdTime_;
+
+    while (!p.buckets.empty() &&
+           Stopwatch::time_point(p.buckets.front().index * bucketInterval_) <=
+               expired)
+    {
+        for (auto const& key : p.buckets.front().keys)
+        {
+            auto const iter = p.map.find(key);
+
+            // Entries touched since are also held by a later bucket
+            if (iter != p.map.end() && iter->second.touched <= expired)
+                p.map.erase(iter);
+        }
+
+        p.buckets.pop_front();
+    }
 }
 
 void
 HashRouter::addSuppression(uint256 const& key)
 {
-    std::lock_guard lock(mutex_);
+    auto& p = partition(key);
+    std::lock_guard lock(p.mutex);
 
-    emplace(key);
+    emplace(p, key, clock_.now());
 }
 
 bool
 HashRouter::addSuppressionPeer(uint256 const& key, PeerShortID peer)
 {
-    std::lock_guard lock(mutex_);
+    auto& p = partition(key);
+    std::lock_guard lock(p.mutex);
 
-    auto result = emplace(key);
+    auto result = emplace(p, key, clock_.now());
     result.first.addPeer(peer);
     return result.second;
 }
@@ -60,9 +149,10 @@ HashRouter::addSuppressionPeer(uint256 const& key, PeerShortID peer)
 bool
 HashRouter::addSuppressionPeer(uint256 const& key, PeerShortID peer, int& flags)
 {
-    std::lock_guard lock(mutex_);
+    auto& p = partition(key);
+    std::lock_guard lock(p.mutex);
 
-    auto [s, created] = emplace(key);
+    auto [s, created] = emplace(p, key, clock_.now());
     s.addPeer(peer);
     flags = s.getFlags();
     return created;
@@ -75,21 +165,24 @@ HashRouter::shouldProcess(
     int& flags,
     std::chrono::seconds tx_interval)
 {
-    std::lock_guard lock(mutex_);
+    auto& p = partition(key);
+    std::lock_guard lock(p.mutex);
 
-    auto result = emplace(key);
+    auto const now = clock_.now();
+    auto result = emplace(p, key, now);
     auto& s = result.first;
     s.addPeer(peer);
     flags = s.getFlags();
-    return s.shouldProcess(suppressionMap_.clock().now(), tx_interval);
+    return s.shouldProcess(now, tx_interval);
 }
 
 int
 HashRouter::getFlags(uint256 const& key)
 {
-    std::lock_guard lock(mutex_);
+    auto& p = partition(key);
+    std::lock_guard lock(p.mutex);
 
-    return emplace(key).first.getFlags();
+    return emplace(p, key, clock_.now()).first.getFlags();
 }
 
 bool
@@ -97,9 +190,10 @@ HashRouter::setFlags(uint256 const& key, int flags)
 {
     assert(flags != 0);
 
-    std::lock_guard lock(mutex_);
+    auto& p = partition(key);
+    std::lock_guard lock(p.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = emplace(p, key, clock_.now()).first;
 
     if ((s.getFlags() & flags) == flags)
         return false;
@@ -109,14 +203,15 @@ HashRouter::setFlags(uint256 const& key, int flags)
 }
 
 auto
-HashRouter::shouldRelay(uint256 const& key)
-    -> boost::optional<std::set<PeerShortID>>
+HashRouter::shouldRelay(uint256 const& key) -> boost::optional<PeerShortIDSet>
 {
-    std::lock_guard lock(mutex_);
+    auto& p = partition(key);
+    std::lock_guard lock(p.mutex);
 
-    auto& s = emplace(key).first;
+    auto const now = clock_.now();
+    auto& s = emplace(p, key, now).first;
 
-    if (!s.shouldRelay(suppressionMap_.clock().now(), holdTime_))
+    if (!s.shouldRelay(now, holdTime_))
         return boost::none;
 
     return s.releasePeerSet();
@@ -125,11 +220,24 @@ HashRouter::shouldRelay(uint256 const& key)
 bool
 HashRouter::shouldRecover(uint256 const& key)
 {
-    std::lock_guard lock(mutex_);
+    auto& p = partition(key);
+    std::lock_guard lock(p.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = emplace(p, key, clock_.now()).first;
 
     return s.shouldRecover(recoverLimit_);
 }
 
+std::size_t
+HashRouter::size() const
+{
+    std::size_t ret = 0;
+    for (auto& p : partitions_)
+    {
+        std::lock_guard lock(p.mutex);
+        ret += p.map.size();
+    }
+    return ret;
+}
+
 }  // namespace ripple
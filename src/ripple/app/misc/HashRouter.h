@@ -24,8 +24,15 @@
 #include <ripple/basics/UnorderedContainers.h>
 #include <ripple/basics/base_uint.h>
 #include <ripple/basics/chrono.h>
-#include <ripple/beast/container/aged_unordered_map.h>
+#include <boost/container/flat_set.hpp>
+#include <boost/container/small_vector.hpp>
 #include <boost/optional.hpp>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <vector>
 
 namespace ripple {
 
@@ -49,6 +56,16 @@ namespace ripple {
     This table keeps track of which hashes have been received by which peers.
     It is used to manage the routing and broadcasting of messages in the peer
     to peer overlay.
+
+    Every message received from every peer passes through here, so the
+    table is split into partitions by key, each with its own lock, and the
+    set of peers an entry was received from is kept inline for the common
+    case of a handful of peers.
+
+    Entries expire once they have not been touched for the hold time.
+    Expiry is checked when an entry is looked up, and the memory of expired
+    entries is reclaimed a whole time bucket at a time whenever a new entry
+    is inserted into the partition.
 */
 class HashRouter
 {
@@ -56,6 +73,12 @@ public:
     // The type here *MUST* match the type of Peer::id_t
     using PeerShortID = std::uint32_t;
 
+    /** A set of peers, stored inline while it is small. */
+    using PeerShortIDSet = boost::container::flat_set<
+        PeerShortID,
+        std::less<PeerShortID>,
+        boost::container::small_vector<PeerShortID, 8>>;
+
 private:
     /** An entry in the routing table.
      */
@@ -92,10 +115,12 @@ private:
         }
 
         /** Return set of peers we've relayed to and reset tracking */
-        std::set<PeerShortID>
+        PeerShortIDSet
         releasePeerSet()
         {
-            return std::move(peers_);
+            PeerShortIDSet ret;
+            ret.swap(peers_);
+            return ret;
         }
 
         /** Determines if this item should be relayed.
@@ -138,9 +163,14 @@ private:
             return true;
         }
 
+        Stopwatch::time_point touched;
+
+        // The most recent time bucket holding this entry's key
+        std::int64_t bucket = std::numeric_limits<std::int64_t>::min();
+
     private:
         int flags_ = 0;
-        std::set<PeerShortID> peers_;
+        PeerShortIDSet peers_;
         // This could be generalized to a map, if more
         // than one flag needs to expire independently.
         boost::optional<Stopwatch::time_point> relayed_;
@@ -166,12 +196,7 @@ public:
     HashRouter(
         Stopwatch& clock,
         std::chrono::seconds entryHoldTimeInSeconds,
-        std::uint32_t recoverLimit)
-        : suppressionMap_(clock)
-        , holdTime_(entryHoldTimeInSeconds)
-        , recoverLimit_(recoverLimit + 1u)
-    {
-    }
+        std::uint32_t recoverLimit);
 
     HashRouter&
     operator=(HashRouter const&) = delete;
@@ -219,7 +244,7 @@ public:
             relayed to. If the result is uninitialized, the item should
             _not_ be relayed.
     */
-    boost::optional<std::set<PeerShortID>>
+    boost::optional<PeerShortIDSet>
     shouldRelay(uint256 const& key);
 
     /** Determines whether the hashed item should be recovered
@@ -231,23 +256,58 @@ public:
     bool
     shouldRecover(uint256 const& key);
 
+    /** Returns the number of entries in the table.
+
+        This includes expired entries whose memory has not been reclaimed
+        yet.
+    */
+    std::size_t
+    size() const;
+
 private:
+    // Keys whose entries were last touched within one bucket interval
+    struct Bucket
+    {
+        std::int64_t index;
+        std::vector<uint256> keys;
+    };
+
+    struct alignas(64) Partition
+    {
+        std::mutex mutable mutex;
+        hardened_hash_map<uint256, Entry, hardened_hash<strong_hash>> map;
+        // Oldest first
+        std::deque<Bucket> buckets;
+    };
+
+    static constexpr std::size_t partitionBits = 4;
+    static constexpr std::size_t partitions = 1 << partitionBits;
+
+    Partition&
+    partition(uint256 const& key);
+
     // pair.second indicates whether the entry was created
     std::pair<Entry&, bool>
-    emplace(uint256 const&);
+    emplace(Partition& p, uint256 const& key, Stopwatch::time_point now);
 
-    std::mutex mutable mutex_;
+    // Reclaim every bucket whose entries have all expired
+    void
+    reclaim(Partition& p, Stopwatch::time_point now);
+
+    Stopwatch& clock_;
+
+    hardened_hash<strong_hash> const hash_;
 
-    // Stores all suppressed hashes and their expiration time
-    beast::aged_unordered_map<
-        uint256,
-        Entry,
-        Stopwatch::clock_type,
-        hardened_hash<strong_hash>>
-        suppressionMap_;
+    std::array<Partition, partitions> partitions_;
+
+    // An entry last touched before the most recent insertion, by at least
+    // the hold time, has expired.
+    std::atomic<Stopwatch::rep> lastInsert_;
 
     std::chrono::seconds const holdTime_;
 
+    Stopwatch::duration const bucketInterval_;
+
     std::uint32_t const recoverLimit_;
 };
 
@@ -32,6 +32,7 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/TopOfBookCache.h>
 #include <ripple/app/misc/Transaction.h>
 #include <ripple/app/misc/TxQ.h>
 #include <ripple/app/misc/ValidatorKeys.h>
@@ -58,6 +59,7 @@
 #include <ripple/protocol/BuildInfo.h>
 #include <ripple/resource/ResourceManager.h>
 #include <ripple/rpc/DeliveredAmount.h>
+#include <ripple/rpc/impl/Tuning.h>
 #include <boost/asio/ip/host_name.hpp>
 #include <boost/asio/steady_timer.hpp>
 
@@ -83,6 +85,8 @@ class NetworkOPsImp final : public NetworkOPs
         FailHard const failType;
         bool applied;
         TER result;
+        // Set by the preflight stage, if the transaction went through it
+        boost::optional<PreflightResult> pfresult;
 
         TransactionStatus(
             std::shared_ptr<Transaction> t,
@@ -93,6 +97,42 @@ class NetworkOPsImp final : public NetworkOPs
         {
             assert(local || failType == FailHard::no);
         }
+
+        ApplyFlags
+        applyFlags() const
+        {
+            ApplyFlags flags = tapNONE;
+            if (admin)
+                flags |= tapUNLIMITED;
+
+            if (failType == FailHard::yes)
+                flags |= tapFAIL_HARD;
+            return flags;
+        }
+    };
+
+    /**
+     * Throughput and latency of one stage of transaction processing. May be
+     * updated and read from any thread.
+     */
+    class PipelineStats
+    {
+        std::atomic<std::uint64_t> transactions_{0};
+        std::atomic<std::uint64_t> batches_{0};
+        // Exponentially weighted, in microseconds
+        std::atomic<std::uint64_t> avgLatency_{0};
+        std::atomic<std::uint64_t> maxLatency_{0};
+
+    public:
+        /** Record a batch of transactions that spent elapsed in the stage */
+        void
+        record(
+            std::chrono::steady_clock::duration elapsed,
+            std::size_t transactions = 1);
+
+        /** Add the counters of the stage to obj */
+        void
+        json(Json::Value& obj, bool batched) const;
     };
 
     /**
@@ -246,6 +286,10 @@ public:
         , m_job_queue(job_queue)
         , m_standalone(standalone)
         , minPeerCount_(start_valid ? 0 : minPeerCount)
+        , bookCache_(
+              RPC::Tuning::bookOffers.rmax,
+              RPC::Tuning::bookOffersCached,
+              app_.logs().journal("TopOfBookCache"))
         , m_stats(std::bind(&NetworkOPsImp::collect_metrics, this), collector)
     {
     }
@@ -305,8 +349,8 @@ public:
 
     /**
      * For transactions not submitted by a locally connected client, fire and
-     * forget. Add to batch and trigger it to be processed if there's no batch
-     * currently being applied.
+     * forget. Check the transaction on the job queue, then add it to the
+     * batch.
      *
      * @param transaction Transaction object
      * @param bUnlimited Whether a privileged client connection submitted it.
@@ -318,6 +362,26 @@ public:
         bool bUnlimited,
         FailHard failtype);
 
+    /**
+     * Run preflight for a transaction, before it is added to a batch. This
+     * does the work of checking the transaction, including its signature,
+     * outside the locks held while the batch is applied.
+     *
+     * @param e Transaction to check; the result is kept in it.
+     * @param queued When the transaction entered the preflight stage.
+     */
+    void
+    preflightTransaction(
+        TransactionStatus& e,
+        std::chrono::steady_clock::time_point queued);
+
+    /**
+     * Add a checked transaction to the batch and trigger it to be processed
+     * if there's no batch currently being applied.
+     */
+    void
+    addToBatch(TransactionStatus&& e);
+
     /**
      * Apply transactions in batches. Continue until none are queued.
      */
@@ -493,6 +557,18 @@ public:
         bool count,
         bool bUnlimited);
 
+    // How many transactions a page of the deprecated account_tx holds.
+    static std::uint32_t
+    accountTxsPageLength(int limit, bool binary, bool bUnlimited);
+
+    // The account transaction index, if it has replaced the table.
+    AccountTxIndex const*
+    accountTxIndex()
+    {
+        auto const index = app_.getAccountTxIndex();
+        return index && index->ready() ? index : nullptr;
+    }
+
     // Client information retrieval functions.
     using NetworkOPs::AccountTxMarker;
     using NetworkOPs::AccountTxs;
@@ -767,6 +843,13 @@ private:
     DispatchState mDispatchState = DispatchState::none;
     std::vector<TransactionStatus> mTransactions;
 
+    // Transactions checked ahead of the batch, and the batches applied.
+    PipelineStats preflightStats_;
+    PipelineStats applyStats_;
+
+    // The top offers of the books asked for in recent closed ledgers.
+    TopOfBookCache bookCache_;
+
     StateAccounting accounting_{};
 
 private:
@@ -1203,14 +1286,55 @@ NetworkOPsImp::doTransactionAsync(
     bool bUnlimited,
     FailHard failType)
 {
-    std::lock_guard lock(mMutex);
+    {
+        std::lock_guard lock(mMutex);
+
+        if (transaction->getApplying())
+            return;
+
+        transaction->setApplying();
+    }
 
-    if (transaction->getApplying())
+    // Transactions are checked in parallel, on as many job queue threads
+    // as are free, and only then added to the batch.
+    TransactionStatus e(transaction, bUnlimited, false, failType);
+    auto const queued = std::chrono::steady_clock::now();
+    if (m_job_queue.addJob(
+            jtTXN_PREFLIGHT, "preflight", [this, e, queued](Job&) mutable {
+                preflightTransaction(e, queued);
+                addToBatch(std::move(e));
+            }))
+    {
         return;
+    }
 
-    mTransactions.push_back(
-        TransactionStatus(transaction, bUnlimited, false, failType));
-    transaction->setApplying();
+    // The job queue is stopping; let the batch do the checking.
+    addToBatch(std::move(e));
+}
+
+void
+NetworkOPsImp::preflightTransaction(
+    TransactionStatus& e,
+    std::chrono::steady_clock::time_point queued)
+{
+    auto const& tx = e.transaction->getSTransaction();
+    e.pfresult.emplace(preflight(
+        app_,
+        m_ledgerMaster.getCurrentLedger()->rules(),
+        *tx,
+        e.applyFlags(),
+        m_journal));
+
+    preflightStats_.record(std::chrono::steady_clock::now() - queued);
+}
+
+void
+NetworkOPsImp::addToBatch(TransactionStatus&& e)
+{
+    std::lock_guard lock(mMutex);
+
+    mTransactions.push_back(std::move(e));
+    mCond.notify_all();
 
     if (mDispatchState == DispatchState::none)
     {
@@ -1229,12 +1353,15 @@ NetworkOPsImp::doTransactionSync(
     bool bUnlimited,
     FailHard failType)
 {
+    // A local transaction is checked on the submitting thread
+    TransactionStatus e(transaction, bUnlimited, true, failType);
+    preflightTransaction(e, std::chrono::steady_clock::now());
+
     std::unique_lock<std::mutex> lock(mMutex);
 
     if (!transaction->getApplying())
     {
-        mTransactions.push_back(
-            TransactionStatus(transaction, bUnlimited, true, failType));
+        mTransactions.push_back(std::move(e));
         transaction->setApplying();
     }
 
@@ -1245,6 +1372,11 @@ NetworkOPsImp::doTransactionSync(
             // A batch processing job is already running, so wait.
             mCond.wait(lock);
         }
+        else if (mTransactions.empty())
+        {
+            // The transaction is still in the preflight stage, so wait.
+            mCond.wait(lock);
+        }
         else
         {
             apply(lock);
@@ -1299,25 +1431,26 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
                 m_ledgerMaster.peekMutex(), std::defer_lock};
             std::lock(masterLock, ledgerLock);
 
+            auto const start = std::chrono::steady_clock::now();
             app_.openLedger().modify([&](OpenView& view, beast::Journal j) {
                 for (TransactionStatus& e : transactions)
                 {
                     // we check before adding to the batch
-                    ApplyFlags flags = tapNONE;
-                    if (e.admin)
-                        flags |= tapUNLIMITED;
-
-                    if (e.failType == FailHard::yes)
-                        flags |= tapFAIL_HARD;
+                    auto const flags = e.applyFlags();
+                    auto const& tx = e.transaction->getSTransaction();
 
-                    auto const result = app_.getTxQ().apply(
-                        app_, view, e.transaction->getSTransaction(), flags, j);
+                    auto const result = e.pfresult
+                        ? app_.getTxQ().apply(
+                              app_, view, tx, *e.pfresult, flags, j)
+                        : app_.getTxQ().apply(app_, view, tx, flags, j);
                     e.result = result.first;
                     e.applied = result.second;
                     changed = changed || result.second;
                 }
                 return changed;
             });
+            applyStats_.record(
+                std::chrono::steady_clock::now() - start, transactions.size());
         }
         if (changed)
             reportFeeChange();
@@ -1895,12 +2028,14 @@ NetworkOPsImp::pubManifest(Manifest const& mo)
             jvObj[jss::signature] = strHex(*sig);
         jvObj[jss::master_signature] = strHex(mo.getMasterSignature());
 
+        auto const msg =
+            std::make_shared<StreamMessage const>(std::move(jvObj));
         for (auto i = mStreamMaps[sManifests].begin();
              i != mStreamMaps[sManifests].end();)
         {
             if (auto p = i->second.lock())
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
                 ++i;
             }
             else
@@ -1998,6 +2133,8 @@ NetworkOPsImp::pubServer()
 
         mLastFeeSummary = f;
 
+        auto const msg =
+            std::make_shared<StreamMessage const>(std::move(jvObj));
         for (auto i = mStreamMaps[sServer].begin();
              i != mStreamMaps[sServer].end();)
         {
@@ -2008,7 +2145,7 @@ NetworkOPsImp::pubServer()
             //             sending of JSON data.
             if (p)
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
                 ++i;
             }
             else
@@ -2031,11 +2168,13 @@ NetworkOPsImp::pubConsensus(ConsensusPhase phase)
         jvObj[jss::type] = "consensusPhase";
         jvObj[jss::consensus] = to_string(phase);
 
+        auto const msg =
+            std::make_shared<StreamMessage const>(std::move(jvObj));
         for (auto i = streamMap.begin(); i != streamMap.end();)
         {
             if (auto p = i->second.lock())
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
                 ++i;
             }
             else
@@ -2098,12 +2237,14 @@ NetworkOPsImp::pubValidation(STValidation::ref val)
         if (auto const reserveInc = (*val)[~sfReserveIncrement])
             jvObj[jss::reserve_inc] = *reserveInc;
 
+        auto const msg =
+            std::make_shared<StreamMessage const>(std::move(jvObj));
         for (auto i = mStreamMaps[sValidations].begin();
              i != mStreamMaps[sValidations].end();)
         {
             if (auto p = i->second.lock())
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
                 ++i;
             }
             else
@@ -2125,6 +2266,8 @@ NetworkOPsImp::pubPeerStatus(std::function<Json::Value(void)> const& func)
 
         jvObj[jss::type] = "peerStatusChange";
 
+        auto const msg =
+            std::make_shared<StreamMessage const>(std::move(jvObj));
         for (auto i = mStreamMaps[sPeerStatus].begin();
              i != mStreamMaps[sPeerStatus].end();)
         {
@@ -2132,7 +2275,7 @@ NetworkOPsImp::pubPeerStatus(std::function<Json::Value(void)> const& func)
 
             if (p)
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
                 ++i;
             }
             else
@@ -2185,29 +2328,8 @@ NetworkOPsImp::transactionsSQL(
     bool count,
     bool bUnlimited)
 {
-    std::uint32_t NONBINARY_PAGE_LENGTH = 200;
-    std::uint32_t BINARY_PAGE_LENGTH = 500;
-
-    std::uint32_t numberOfResults;
-
-    if (count)
-    {
-        numberOfResults = 1000000000;
-    }
-    else if (limit < 0)
-    {
-        numberOfResults = binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH;
-    }
-    else if (!bUnlimited)
-    {
-        numberOfResults = std::min(
-            binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH,
-            static_cast<std::uint32_t>(limit));
-    }
-    else
-    {
-        numberOfResults = limit;
-    }
+    std::uint32_t const numberOfResults =
+        count ? 1000000000 : accountTxsPageLength(limit, binary, bUnlimited);
 
     std::string maxClause = "";
     std::string minClause = "";
@@ -2254,6 +2376,23 @@ NetworkOPsImp::transactionsSQL(
     return sql;
 }
 
+std::uint32_t
+NetworkOPsImp::accountTxsPageLength(int limit, bool binary, bool bUnlimited)
+{
+    std::uint32_t NONBINARY_PAGE_LENGTH = 200;
+    std::uint32_t BINARY_PAGE_LENGTH = 500;
+
+    if (limit < 0)
+        return binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH;
+
+    if (!bUnlimited)
+        return std::min(
+            binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH,
+            static_cast<std::uint32_t>(limit));
+
+    return limit;
+}
+
 NetworkOPs::AccountTxs
 NetworkOPsImp::getAccountTxs(
     AccountID const& account,
@@ -2267,6 +2406,30 @@ NetworkOPsImp::getAccountTxs(
     // can be called with no locks
     AccountTxs ret;
 
+    if (auto const index = accountTxIndex())
+    {
+        Application& app = app_;
+        accountTxOffsetPage(
+            *index,
+            app_.getTxnDB(),
+            std::bind(saveLedgerAsync, std::ref(app_), std::placeholders::_1),
+            [&ret, &app](
+                std::uint32_t ledgerIndex,
+                std::string const& status,
+                Blob const& rawTxn,
+                Blob const& rawMeta) {
+                convertBlobsToTxResult(
+                    ret, ledgerIndex, status, rawTxn, rawMeta, app);
+            },
+            account,
+            minLedger,
+            maxLedger,
+            descending,
+            offset,
+            accountTxsPageLength(limit, false, bUnlimited));
+        return ret;
+    }
+
     std::string sql = transactionsSQL(
         "AccountTransactions.LedgerSeq,Status,RawTxn,TxnMeta",
         account,
@@ -2347,6 +2510,28 @@ NetworkOPsImp::getAccountTxsB(
     // can be called with no locks
     std::vector<txnMetaLedgerType> ret;
 
+    if (auto const index = accountTxIndex())
+    {
+        accountTxOffsetPage(
+            *index,
+            app_.getTxnDB(),
+            [](std::uint32_t) {},
+            [&ret](
+                std::uint32_t ledgerIndex,
+                std::string const&,
+                Blob const& rawTxn,
+                Blob const& rawMeta) {
+                ret.emplace_back(rawTxn, rawMeta, ledgerIndex);
+            },
+            account,
+            minLedger,
+            maxLedger,
+            descending,
+            offset,
+            accountTxsPageLength(limit, true, bUnlimited));
+        return ret;
+    }
+
     std::string sql = transactionsSQL(
         "AccountTransactions.LedgerSeq,Status,RawTxn,TxnMeta",
         account,
@@ -2417,6 +2602,24 @@ NetworkOPsImp::getTxsAccount(
         convertBlobsToTxResult(ret, ledger_index, status, rawTxn, rawMeta, app);
     };
 
+    if (auto const index = accountTxIndex())
+    {
+        accountTxPage(
+            *index,
+            app_.getTxnDB(),
+            std::bind(saveLedgerAsync, std::ref(app_), std::placeholders::_1),
+            bound,
+            account,
+            minLedger,
+            maxLedger,
+            forward,
+            marker,
+            limit,
+            bUnlimited,
+            page_length);
+        return ret;
+    }
+
     accountTxPage(
         app_.getTxnDB(),
         app_.accountIDCache(),
@@ -2456,6 +2659,24 @@ NetworkOPsImp::getTxsAccountB(
         ret.emplace_back(std::move(rawTxn), std::move(rawMeta), ledgerIndex);
     };
 
+    if (auto const index = accountTxIndex())
+    {
+        accountTxPage(
+            *index,
+            app_.getTxnDB(),
+            std::bind(saveLedgerAsync, std::ref(app_), std::placeholders::_1),
+            bound,
+            account,
+            minLedger,
+            maxLedger,
+            forward,
+            marker,
+            limit,
+            bUnlimited,
+            page_length);
+        return ret;
+    }
+
     accountTxPage(
         app_.getTxnDB(),
         app_.accountIDCache(),
@@ -2786,6 +3007,21 @@ NetworkOPsImp::getServerInfo(bool human, bool admin, bool counters)
     info[jss::uptime] = UptimeClock::now().time_since_epoch().count();
     info[jss::jq_trans_overflow] =
         std::to_string(app_.overlay().getJqTransOverflow());
+
+    {
+        Json::Value& pipeline = info[jss::transaction_pipeline];
+
+        Json::Value& preflight = pipeline[jss::preflight];
+        preflight[jss::queued] = m_job_queue.getJobCount(jtTXN_PREFLIGHT);
+        preflightStats_.json(preflight, false);
+
+        Json::Value& batch = pipeline[jss::apply];
+        {
+            std::lock_guard lock(mMutex);
+            batch[jss::queued] = static_cast<Json::UInt>(mTransactions.size());
+        }
+        applyStats_.json(batch, true);
+    }
     info[jss::peer_disconnects] =
         std::to_string(app_.overlay().getPeerDisconnect());
     info[jss::peer_disconnects_resources] =
@@ -2812,7 +3048,8 @@ NetworkOPsImp::pubProposedTransaction(
     std::shared_ptr<STTx const> const& stTxn,
     TER terResult)
 {
-    Json::Value jvObj = transJson(*stTxn, terResult, false, lpCurrent);
+    auto const msg = std::make_shared<StreamMessage const>(
+        transJson(*stTxn, terResult, false, lpCurrent));
 
     {
         std::lock_guard sl(mSubLock);
@@ -2824,7 +3061,7 @@ NetworkOPsImp::pubProposedTransaction(
 
             if (p)
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
                 ++it;
             }
             else
@@ -2883,13 +3120,15 @@ NetworkOPsImp::pubLedger(std::shared_ptr<ReadView const> const& lpAccepted)
                     app_.getLedgerMaster().getCompleteLedgers();
             }
 
+            auto const msg =
+                std::make_shared<StreamMessage const>(std::move(jvObj));
             auto it = mStreamMaps[sLedger].begin();
             while (it != mStreamMaps[sLedger].end())
             {
                 InfoSub::pointer p = it->second.lock();
                 if (p)
                 {
-                    p->send(jvObj, true);
+                    p->send(msg, true);
                     ++it;
                 }
                 else
@@ -3009,6 +3248,8 @@ NetworkOPsImp::pubValidatedTransaction(
             jvObj[jss::meta], *alAccepted, stTxn, *txMeta);
     }
 
+    auto const msg = std::make_shared<StreamMessage const>(std::move(jvObj));
+
     {
         std::lock_guard sl(mSubLock);
 
@@ -3019,7 +3260,7 @@ NetworkOPsImp::pubValidatedTransaction(
 
             if (p)
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
                 ++it;
             }
             else
@@ -3034,14 +3275,14 @@ NetworkOPsImp::pubValidatedTransaction(
 
             if (p)
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
                 ++it;
             }
             else
                 it = mStreamMaps[sRTTransactions].erase(it);
         }
     }
-    app_.getOrderBookDB().processTxn(alAccepted, alTx, jvObj);
+    app_.getOrderBookDB().processTxn(alAccepted, alTx, msg);
     pubAccountTransaction(alAccepted, alTx, true);
 }
 
@@ -3130,8 +3371,10 @@ NetworkOPsImp::pubAccountTransaction(
             }
         }
 
+        auto const msg =
+            std::make_shared<StreamMessage const>(std::move(jvObj));
         for (InfoSub::ref isrListener : notify)
-            isrListener->send(jvObj, true);
+            isrListener->send(msg, true);
     }
 }
 
@@ -3502,201 +3745,28 @@ NetworkOPsImp::getBookPage(
     Json::Value& jvOffers =
         (jvResult[jss::offers] = Json::Value(Json::arrayValue));
 
-    std::map<AccountID, STAmount> umBalance;
-    const uint256 uBookBase = getBookBase(book);
-    const uint256 uBookEnd = getQualityNext(uBookBase);
-    uint256 uTipIndex = uBookBase;
+    JLOG(m_journal.trace()) << "getBookPage:" << book;
 
-    if (auto stream = m_journal.trace())
+    // The cached pages are read for a taker who is not the issuer
+    std::shared_ptr<BookPage const> cached;
+    if (uTakerID != book.out.account)
+        cached = bookCache_.get(lpLedger, book);
+
+    BookPage direct;
+    BookPage const* page = cached.get();
+    if (!page || (!page->complete && page->offers.size() < iLimit))
     {
-        stream << "getBookPage:" << book;
-        stream << "getBookPage: uBookBase=" << uBookBase;
-        stream << "getBookPage: uBookEnd=" << uBookEnd;
-        stream << "getBookPage: uTipIndex=" << uTipIndex;
+        direct = readBookPage(
+            *lpLedger, book, uTakerID, iLimit, app_.journal("View"));
+        page = &direct;
     }
 
-    ReadView const& view = *lpLedger;
-
-    bool const bGlobalFreeze = isGlobalFrozen(view, book.out.account) ||
-        isGlobalFrozen(view, book.in.account);
-
-    bool bDone = false;
-    bool bDirectAdvance = true;
-
-    std::shared_ptr<SLE const> sleOfferDir;
-    uint256 offerIndex;
-    unsigned int uBookEntry;
-    STAmount saDirRate;
-
-    auto const rate = transferRate(view, book.out.account);
-    auto viewJ = app_.journal("View");
-
-    while (!bDone && iLimit-- > 0)
+    auto const count = std::min<std::size_t>(iLimit, page->offers.size());
+    for (std::size_t i = 0; i < count; ++i)
     {
-        if (bDirectAdvance)
-        {
-            bDirectAdvance = false;
-
-            JLOG(m_journal.trace()) << "getBookPage: bDirectAdvance";
-
-            auto const ledgerIndex = view.succ(uTipIndex, uBookEnd);
-            if (ledgerIndex)
-                sleOfferDir = view.read(keylet::page(*ledgerIndex));
-            else
-                sleOfferDir.reset();
-
-            if (!sleOfferDir)
-            {
-                JLOG(m_journal.trace()) << "getBookPage: bDone";
-                bDone = true;
-            }
-            else
-            {
-                uTipIndex = sleOfferDir->key();
-                saDirRate = amountFromQuality(getQuality(uTipIndex));
-
-                cdirFirst(
-                    view,
-                    uTipIndex,
-                    sleOfferDir,
-                    uBookEntry,
-                    offerIndex,
-                    viewJ);
-
-                JLOG(m_journal.trace())
-                    << "getBookPage:   uTipIndex=" << uTipIndex;
-                JLOG(m_journal.trace())
-                    << "getBookPage: offerIndex=" << offerIndex;
-            }
-        }
-
-        if (!bDone)
-        {
-            auto sleOffer = view.read(keylet::offer(offerIndex));
-
-            if (sleOffer)
-            {
-                auto const uOfferOwnerID = sleOffer->getAccountID(sfAccount);
-                auto const& saTakerGets = sleOffer->getFieldAmount(sfTakerGets);
-                auto const& saTakerPays = sleOffer->getFieldAmount(sfTakerPays);
-                STAmount saOwnerFunds;
-                bool firstOwnerOffer(true);
-
-                if (book.out.account == uOfferOwnerID)
-                {
-                    // If an offer is selling issuer's own IOUs, it is fully
-                    // funded.
-                    saOwnerFunds = saTakerGets;
-                }
-                else if (bGlobalFreeze)
-                {
-                    // If either asset is globally frozen, consider all offers
-                    // that aren't ours to be totally unfunded
-                    saOwnerFunds.clear(book.out);
-                }
-                else
-                {
-                    auto umBalanceEntry = umBalance.find(uOfferOwnerID);
-                    if (umBalanceEntry != umBalance.end())
-                    {
-                        // Found in running balance table.
-
-                        saOwnerFunds = umBalanceEntry->second;
-                        firstOwnerOffer = false;
-                    }
-                    else
-                    {
-                        // Did not find balance in table.
-
-                        saOwnerFunds = accountHolds(
-                            view,
-                            uOfferOwnerID,
-                            book.out.currency,
-                            book.out.account,
-                            fhZERO_IF_FROZEN,
-                            viewJ);
-
-                        if (saOwnerFunds < beast::zero)
-                        {
-                            // Treat negative funds as zero.
-
-                            saOwnerFunds.clear();
-                        }
-                    }
-                }
-
-                Json::Value jvOffer = sleOffer->getJson(JsonOptions::none);
-
-                STAmount saTakerGetsFunded;
-                STAmount saOwnerFundsLimit = saOwnerFunds;
-                Rate offerRate = parityRate;
-
-                if (rate != parityRate
-                    // Have a tranfer fee.
-                    && uTakerID != book.out.account
-                    // Not taking offers of own IOUs.
-                    && book.out.account != uOfferOwnerID)
-                // Offer owner not issuing ownfunds
-                {
-                    // Need to charge a transfer fee to offer owner.
-                    offerRate = rate;
-                    saOwnerFundsLimit = divide(saOwnerFunds, offerRate);
-                }
-
-                if (saOwnerFundsLimit >= saTakerGets)
-                {
-                    // Sufficient funds no shenanigans.
-                    saTakerGetsFunded = saTakerGets;
-                }
-                else
-                {
-                    // Only provide, if not fully funded.
-
-                    saTakerGetsFunded = saOwnerFundsLimit;
-
-                    saTakerGetsFunded.setJson(jvOffer[jss::taker_gets_funded]);
-                    std::min(
-                        saTakerPays,
-                        multiply(
-                            saTakerGetsFunded, saDirRate, saTakerPays.issue()))
-                        .setJson(jvOffer[jss::taker_pays_funded]);
-                }
-
-                STAmount saOwnerPays = (parityRate == offerRate)
-                    ? saTakerGetsFunded
-                    : std::min(
-                          saOwnerFunds, multiply(saTakerGetsFunded, offerRate));
-
-                umBalance[uOfferOwnerID] = saOwnerFunds - saOwnerPays;
-
-                // Include all offers funded and unfunded
-                Json::Value& jvOf = jvOffers.append(jvOffer);
-                jvOf[jss::quality] = saDirRate.getText();
-
-                if (firstOwnerOffer)
-                    jvOf[jss::owner_funds] = saOwnerFunds.getText();
-            }
-            else
-            {
-                JLOG(m_journal.warn()) << "Missing offer";
-            }
-
-            if (!cdirNext(
-                    view,
-                    uTipIndex,
-                    sleOfferDir,
-                    uBookEntry,
-                    offerIndex,
-                    viewJ))
-            {
-                bDirectAdvance = true;
-            }
-            else
-            {
-                JLOG(m_journal.trace())
-                    << "getBookPage: offerIndex=" << offerIndex;
-            }
-        }
+        // Include all offers funded and unfunded
+        if (!page->offers[i].isNull())
+            jvOffers.append(page->offers[i]);
     }
 
     //  jvResult[jss::marker]  = Json::Value(Json::arrayValue);
@@ -3889,6 +3959,41 @@ NetworkOPsImp::StateAccounting::json() const
 
 //------------------------------------------------------------------------------
 
+void
+NetworkOPsImp::PipelineStats::record(
+    std::chrono::steady_clock::duration elapsed,
+    std::size_t transactions)
+{
+    using namespace std::chrono;
+
+    transactions_ += transactions;
+    ++batches_;
+
+    auto const us = static_cast<std::uint64_t>(
+        duration_cast<microseconds>(elapsed).count());
+    auto const avg = avgLatency_.load(std::memory_order_relaxed);
+    avgLatency_.store(
+        avg == 0 ? us : (avg * 7 + us) / 8, std::memory_order_relaxed);
+
+    auto max = maxLatency_.load(std::memory_order_relaxed);
+    while (us > max &&
+           !maxLatency_.compare_exchange_weak(
+               max, us, std::memory_order_relaxed))
+        ;
+}
+
+void
+NetworkOPsImp::PipelineStats::json(Json::Value& obj, bool batched) const
+{
+    obj[jss::transactions] = std::to_string(transactions_.load());
+    if (batched)
+        obj[jss::batches] = std::to_string(batches_.load());
+    obj[jss::avg_latency_us] = static_cast<Json::UInt>(avgLatency_.load());
+    obj[jss::max_latency_us] = static_cast<Json::UInt>(maxLatency_.load());
+}
+
+//------------------------------------------------------------------------------
+
 std::unique_ptr<NetworkOPs>
 make_NetworkOPs(
     Application& app,
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/app/ledger/TransactionMaster.h>
+#include <ripple/app/misc/AccountTxIndex.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/SHAMapStoreImp.h>
 #include <ripple/beast/core/CurrentThreadName.h>
@@ -651,6 +652,13 @@ SHAMapStoreImp::clearPrior(LedgerIndex lastRotated)
         "DELETE FROM AccountTransactions WHERE LedgerSeq < %u;");
     if (health())
         return;
+
+    if (auto const index = app_.getAccountTxIndex())
+    {
+        index->deleteBefore(lastRotated);
+        if (health())
+            return;
+    }
 }
 
 SHAMapStoreImp::Health
@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_TOPOFBOOKCACHE_H_INCLUDED
+#define RIPPLE_APP_MISC_TOPOFBOOKCACHE_H_INCLUDED
+
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/json/json_value.h>
+#include <ripple/ledger/ReadView.h>
+#include <ripple/protocol/Book.h>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+/** The best offers of a book, as book_offers returns them. */
+struct BookPage
+{
+    /** The offers in the order they are taken.
+
+        Each is rendered with its quality, its funded amounts if it is not
+        fully funded and, for the first offer of each owner, the funds of
+        the owner. An offer missing from the ledger is a null value.
+    */
+    std::vector<Json::Value> offers;
+
+    /** True if the page holds every offer in the book. */
+    bool complete = false;
+
+    /** The accounts whose state the funding of the offers depends on:
+        their owners and the issuers of the book.
+    */
+    std::vector<AccountID> accounts;
+};
+
+/** Read up to limit offers from the top of a book.
+
+    @param taker The account taking the offers. Owners pay no transfer fee
+                 to an issuer taking its own IOUs.
+*/
+BookPage
+readBookPage(
+    ReadView const& view,
+    Book const& book,
+    AccountID const& taker,
+    std::size_t limit,
+    beast::Journal j);
+
+/** The top offers of each book in recent closed ledgers.
+
+    A page is read from a ledger the first time one of its books is asked
+    for and is never modified afterwards, so the same page is handed to
+    any number of callers. Pages are read as for a taker who is not the
+    issuer of the book, the taker book subscriptions and almost every
+    book_offers request have.
+
+    When the pages of a ledger are first asked for, those of its parent
+    which were asked for in the parent are carried over to it, unless the
+    ledger's metadata shows that it changed an offer in the book, or the
+    state of an account the funding of the page depends on. A book asked
+    for once is therefore dropped after the next ledger, and at most
+    maxBooks pages are kept for each ledger; pages of further books are
+    read for each request.
+*/
+class TopOfBookCache
+{
+public:
+    /** @param depth The number of offers read from each book.
+        @param maxBooks The most books kept for each ledger.
+    */
+    TopOfBookCache(
+        std::size_t depth,
+        std::size_t maxBooks,
+        beast::Journal journal);
+
+    /** Returns the top of a book in a closed ledger.
+
+        @return The page, or nullptr if the ledger is open.
+    */
+    std::shared_ptr<BookPage const>
+    get(std::shared_ptr<ReadView const> const& ledger, Book const& book);
+
+    std::size_t
+    depth() const
+    {
+        return depth_;
+    }
+
+private:
+    // The page of a book, and whether it was asked for in the ledger
+    struct Entry
+    {
+        std::shared_ptr<BookPage const> page;
+        bool used = false;
+    };
+
+    // The pages of one ledger
+    struct Pages
+    {
+        LedgerIndex seq;
+        uint256 hash;
+        std::mutex mutex;
+        hash_map<Book, Entry> books;
+    };
+
+    std::shared_ptr<Pages>
+    pagesFor(ReadView const& ledger);
+
+    // Returns the pages of parent asked for in it that ledger did not
+    // invalidate
+    static hash_map<Book, Entry>
+    carryOver(Pages& parent, ReadView const& ledger);
+
+    std::size_t const depth_;
+    std::size_t const maxBooks_;
+    beast::Journal const j_;
+
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<Pages>> ledgers_;
+};
+
+}  // namespace ripple
+
+#endif
@@ -27,6 +27,7 @@
 #include <ripple/protocol/TER.h>
 #include <boost/circular_buffer.hpp>
 #include <boost/intrusive/set.hpp>
+#include <atomic>
 
 namespace ripple {
 
@@ -286,6 +287,23 @@ public:
         ApplyFlags flags,
         beast::Journal j);
 
+    /**
+        Like the overload above, for a transaction that has already been
+        through `preflight`, which is not repeated unless the rules or the
+        flags have changed since.
+
+        @param preflightResult The result of `preflight` for `tx`, which
+               must refer to the same `STTx` object.
+    */
+    std::pair<TER, bool>
+    apply(
+        Application& app,
+        OpenView& view,
+        std::shared_ptr<STTx const> const& tx,
+        PreflightResult const& preflightResult,
+        ApplyFlags flags,
+        beast::Journal j);
+
     /**
         Fill the new open ledger with transactions from the queue.
 
@@ -316,6 +334,11 @@ public:
     processClosedLedger(Application& app, ReadView const& view, bool timeLeap);
 
     /** Returns fee metrics in reference fee level units.
+
+        @note Does not take the queue's lock. The queue publishes its
+        size and fee metrics whenever they change, and this reads the
+        published values, so it can be called as often as needed
+        without slowing down transaction processing.
      */
     Metrics
     getMetrics(OpenView const& view) const;
@@ -504,6 +527,10 @@ private:
             std::size_t seriesSize);
     };
 
+    /// Hooks that remove their transaction from a set when it is destroyed
+    using UnlinkMode =
+        boost::intrusive::link_mode<boost::intrusive::auto_unlink>;
+
     /**
         Represents a transaction in the queue which may be applied
         later to the open ledger.
@@ -516,6 +543,16 @@ private:
         /// set without copies, pointers, etc.
         boost::intrusive::set_member_hook<> byFeeListHook;
 
+        /// Links the transaction into TxQ::byHead_ while it is the
+        /// first one queued for its account. Unlinks itself when
+        /// the transaction is destroyed.
+        boost::intrusive::set_member_hook<UnlinkMode> byHeadHook;
+
+        /// Links the transaction into TxQ::byLastValid_ if it has a
+        /// `LastLedgerSequence`. Unlinks itself when the transaction
+        /// is destroyed.
+        boost::intrusive::set_member_hook<UnlinkMode> byLastValidHook;
+
         /// The complete transaction.
         std::shared_ptr<STTx const> txn;
 
@@ -536,6 +573,9 @@ private:
         boost::optional<LedgerIndex> lastValid;
         /// Transaction sequence number (`sfSequence` field).
         TxSeq const sequence;
+        /// Order of arrival in the queue. Breaks ties between equal
+        /// fee levels, so that earlier transactions are tried first.
+        std::uint64_t arrival = 0;
         /**
             A transaction at the front of the queue will be given
             several attempts to succeed before being dropped from
@@ -603,11 +643,30 @@ private:
         /// Default constructor
         explicit GreaterFee() = default;
 
-        /// Is the fee level of `lhs` greater than the fee level of `rhs`?
+        /** Does `lhs` come before `rhs`: a greater fee level, or the
+            same fee level and an earlier arrival?
+        */
         bool
         operator()(const MaybeTx& lhs, const MaybeTx& rhs) const
         {
-            return lhs.feeLevel > rhs.feeLevel;
+            if (lhs.feeLevel != rhs.feeLevel)
+                return lhs.feeLevel > rhs.feeLevel;
+            return lhs.arrival < rhs.arrival;
+        }
+    };
+
+    /// Used for sorting @ref MaybeTx by `lastValid`
+    class EarlierLastValid
+    {
+    public:
+        /// Default constructor
+        explicit EarlierLastValid() = default;
+
+        /// Does `lhs` expire before `rhs`? Both must have a `lastValid`.
+        bool
+        operator()(const MaybeTx& lhs, const MaybeTx& rhs) const
+        {
+            return *lhs.lastValid < *rhs.lastValid;
         }
     };
 
@@ -679,8 +738,45 @@ private:
     using FeeMultiSet = boost::intrusive::
         multiset<MaybeTx, FeeHook, boost::intrusive::compare<GreaterFee>>;
 
+    using HeadHook = boost::intrusive::member_hook<
+        MaybeTx,
+        boost::intrusive::set_member_hook<UnlinkMode>,
+        &MaybeTx::byHeadHook>;
+
+    using HeadMultiSet = boost::intrusive::multiset<
+        MaybeTx,
+        HeadHook,
+        boost::intrusive::compare<GreaterFee>,
+        boost::intrusive::constant_time_size<false>>;
+
+    using LastValidHook = boost::intrusive::member_hook<
+        MaybeTx,
+        boost::intrusive::set_member_hook<UnlinkMode>,
+        &MaybeTx::byLastValidHook>;
+
+    using LastValidMultiSet = boost::intrusive::multiset<
+        MaybeTx,
+        LastValidHook,
+        boost::intrusive::compare<EarlierLastValid>,
+        boost::intrusive::constant_time_size<false>>;
+
     using AccountMap = std::map<AccountID, TxQAccount>;
 
+    /** Queue state published for readers that do not take mutex_.
+
+        Written under mutex_ whenever the values they are derived from
+        change, read without it by getMetrics().
+    */
+    struct PublishedMetrics
+    {
+        std::atomic<std::size_t> txCount{0};
+        /// Zero if the queue size is not limited yet
+        std::atomic<std::size_t> maxSize{0};
+        std::atomic<std::uint64_t> minProcessingFeeLevel{0};
+        std::atomic<std::size_t> txnsExpected{0};
+        std::atomic<std::uint64_t> escalationMultiplier{0};
+    };
+
     /// Setup parameters used to control the behavior of the queue
     Setup const setup_;
     /// Journal
@@ -697,6 +793,22 @@ private:
         locked mutex_
     */
     FeeMultiSet byFee_;
+    /** The first transaction queued for each account, ordered like
+        byFee_. Only these can be applied, so accept() walks this
+        instead of byFee_ and does not have to step over the rest of
+        every account's transactions.
+        @note This member must always and only be accessed under
+        locked mutex_
+    */
+    HeadMultiSet byHead_;
+    /** The transactions with a `LastLedgerSequence`, earliest first,
+        so that processClosedLedger() only visits the ones that expire.
+        @note This member must always and only be accessed under
+        locked mutex_
+    */
+    LastValidMultiSet byLastValid_;
+    /// Source of MaybeTx::arrival.
+    std::uint64_t arrivals_ = 0;
     /** All of the accounts which currently have any transactions
         in the queue. Entries are created and destroyed dynamically
         as transactions are added and removed.
@@ -704,6 +816,13 @@ private:
         locked mutex_
     */
     AccountMap byAccount_;
+    /** Accounts whose last queued transaction has been removed since
+        the last call to processClosedLedger(), which removes them
+        from byAccount_ if they are still empty. May hold duplicates.
+        @note This member must always and only be accessed under
+        locked mutex_
+    */
+    std::vector<AccountID> emptied_;
     /** Maximum number of transactions allowed in the queue based
         on the current metrics. If uninitialized, there is no limit,
         but that condition cannot last for long in practice.
@@ -717,6 +836,9 @@ private:
     */
     std::mutex mutable mutex_;
 
+    /// The values returned by getMetrics().
+    PublishedMetrics published_;
+
 private:
     /// Is the queue at least `fillPercentage` full?
     template <size_t fillPercentage = 100>
@@ -737,11 +859,11 @@ private:
     /// Erase and return the next entry in byFee_ (lower fee level)
     FeeMultiSet::iterator_type erase(FeeMultiSet::const_iterator_type);
     /** Erase and return the next entry for the account (if fee level
-        is higher), or next entry in byFee_ (lower fee level).
+        is higher), or next entry in byHead_ (lower fee level).
         Used to get the next "applyable" MaybeTx for accept().
     */
-    FeeMultiSet::iterator_type eraseAndAdvance(
-        FeeMultiSet::const_iterator_type);
+    HeadMultiSet::iterator
+    eraseAndAdvance(HeadMultiSet::iterator);
     /// Erase a range of items, based on TxQAccount::TxMap iterators
     TxQAccount::TxMap::iterator
     erase(
@@ -749,6 +871,16 @@ private:
         TxQAccount::TxMap::const_iterator begin,
         TxQAccount::TxMap::const_iterator end);
 
+    /** Bring byHead_ and emptied_ up to date after transactions were
+        added to or removed from an account.
+    */
+    void
+    updateHead(TxQAccount& txQAccount);
+
+    /// Update published_ from the current state of the queue.
+    void
+    publishMetrics();
+
     /**
         All-or-nothing attempt to try to apply all the queued txs for
        `accountIter` up to and including `tx`.
@@ -0,0 +1,544 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/AccountTxIndex.h>
+#include <ripple/basics/ByteUtilities.h>
+#include <ripple/basics/Log.h>
+#include <ripple/basics/contract.h>
+#include <ripple/unity/rocksdb.h>
+#include <boost/algorithm/string/predicate.hpp>
+#include <cassert>
+#include <shared_mutex>
+
+namespace ripple {
+
+namespace {
+
+// The keys of the store:
+//
+//  'a' account (20) ledger sequence (4) transaction sequence (4)
+//      The ID of the transaction, for each account it affected.
+//
+//  'l' ledger sequence (4) transaction sequence (4) account (20)
+//      Nothing, for each account of each transaction of a ledger.
+//
+//  'm' name
+//      What the index knows of itself: the ledgers it holds the entries
+//      of, and the ledger after which it replaced the table.
+//
+// Sequences are big endian, so the keys sort in ledger order.
+
+char const accountSpace = 'a';
+char const ledgerSpace = 'l';
+
+std::string const savedKey = "msaved";
+std::string const cutoverKey = "mcutover";
+
+std::size_t const accountKeySize = 1 + 20 + 4 + 4;
+
+// How many ledger keys are deleted with each write
+std::size_t const deleteBatchSize = 4096;
+
+void
+appendSeq(std::string& key, std::uint32_t seq)
+{
+    key.push_back(static_cast<char>(seq >> 24));
+    key.push_back(static_cast<char>((seq >> 16) & 0xff));
+    key.push_back(static_cast<char>((seq >> 8) & 0xff));
+    key.push_back(static_cast<char>(seq & 0xff));
+}
+
+std::uint32_t
+readSeq(std::uint8_t const* p)
+{
+    return (std::uint32_t{p[0]} << 24) | (std::uint32_t{p[1]} << 16) |
+        (std::uint32_t{p[2]} << 8) | std::uint32_t{p[3]};
+}
+
+std::string
+accountKey(AccountID const& account, LedgerIndex seq, std::uint32_t txnSeq)
+{
+    std::string key;
+    key.reserve(accountKeySize);
+    key.push_back(accountSpace);
+    key.append(reinterpret_cast<char const*>(account.data()), account.size());
+    appendSeq(key, seq);
+    appendSeq(key, txnSeq);
+    return key;
+}
+
+std::string
+ledgerKey(LedgerIndex seq, std::uint32_t txnSeq, AccountID const& account)
+{
+    std::string key;
+    key.reserve(accountKeySize);
+    key.push_back(ledgerSpace);
+    appendSeq(key, seq);
+    appendSeq(key, txnSeq);
+    key.append(reinterpret_cast<char const*>(account.data()), account.size());
+    return key;
+}
+
+// The account key of the same entry as a ledger key
+std::string
+accountKeyOf(Slice ledgerKey)
+{
+    assert(ledgerKey.size() == accountKeySize);
+    std::string key;
+    key.reserve(accountKeySize);
+    key.push_back(accountSpace);
+    key.append(reinterpret_cast<char const*>(ledgerKey.data()) + 9, 20);
+    key.append(reinterpret_cast<char const*>(ledgerKey.data()) + 1, 8);
+    return key;
+}
+
+std::string
+encodeSeq(std::uint32_t seq)
+{
+    std::string value;
+    appendSeq(value, seq);
+    return value;
+}
+
+LedgerIndex
+decodeSeq(std::string const& value)
+{
+    if (value.size() != 4)
+        Throw<std::runtime_error>(
+            "Account transaction index: corrupt sequence");
+    return readSeq(reinterpret_cast<std::uint8_t const*>(value.data()));
+}
+
+// An empty set is stored as an empty string, which to_string does not give
+std::string
+encodeSaved(RangeSet<LedgerIndex> const& saved)
+{
+    if (saved.empty())
+        return {};
+    return to_string(saved);
+}
+
+//------------------------------------------------------------------------------
+
+class MemoryBackend : public AccountTxIndex::Backend
+{
+public:
+    boost::optional<std::string>
+    get(std::string const& key) override
+    {
+        std::shared_lock lock(mutex_);
+        auto const it = map_.find(key);
+        if (it == map_.end())
+            return boost::none;
+        return it->second;
+    }
+
+    void
+    write(Batch const& batch) override
+    {
+        std::unique_lock lock(mutex_);
+        for (auto const& [key, value] : batch)
+        {
+            if (value)
+                map_[key] = *value;
+            else
+                map_.erase(key);
+        }
+    }
+
+    void
+    scan(
+        std::string const& first,
+        std::string const& last,
+        bool forward,
+        std::function<bool(Slice key, Slice value)> const& f) override
+    {
+        std::shared_lock lock(mutex_);
+        if (forward)
+        {
+            for (auto it = map_.lower_bound(first);
+                 it != map_.end() && it->first <= last;
+                 ++it)
+            {
+                if (!f(makeSlice(it->first), makeSlice(it->second)))
+                    return;
+            }
+        }
+        else
+        {
+            for (auto it = map_.upper_bound(first); it != map_.begin();)
+            {
+                --it;
+                if (it->first < last ||
+                    !f(makeSlice(it->first), makeSlice(it->second)))
+                    return;
+            }
+        }
+    }
+
+private:
+    std::shared_mutex mutex_;
+    std::map<std::string, std::string> map_;
+};
+
+//------------------------------------------------------------------------------
+
+#if RIPPLE_ROCKSDB_AVAILABLE
+
+class RocksDBBackend : public AccountTxIndex::Backend
+{
+public:
+    RocksDBBackend(Section const& section, beast::Journal journal)
+        : j_(journal)
+    {
+        std::string path;
+        if (!get_if_exists(section, "path", path))
+            Throw<std::runtime_error>(
+                "Missing path in [account_tx_index] section");
+
+        rocksdb::Options options;
+        rocksdb::BlockBasedTableOptions tableOptions;
+
+        if (section.exists("cache_mb"))
+            tableOptions.block_cache = rocksdb::NewLRUCache(
+                ripple::get<int>(section, "cache_mb") * megabytes(1));
+
+        options.table_factory.reset(
+            rocksdb::NewBlockBasedTableFactory(tableOptions));
+        options.compression = rocksdb::kSnappyCompression;
+        get_if_exists(section, "open_files", options.max_open_files);
+
+        if (section.exists("options"))
+        {
+            auto const s = rocksdb::GetOptionsFromString(
+                options,
+                ripple::get<std::string>(section, "options"),
+                &options);
+            if (!s.ok())
+                Throw<std::runtime_error>(
+                    std::string("Unable to set RocksDB options: ") +
+                    s.ToString());
+        }
+
+        options.create_if_missing = true;
+        rocksdb::DB* db = nullptr;
+        auto const status = rocksdb::DB::Open(options, path, &db);
+        if (!status.ok() || !db)
+            Throw<std::runtime_error>(
+                std::string("Unable to open/create RocksDB: ") +
+                status.ToString());
+        db_.reset(db);
+    }
+
+    boost::optional<std::string>
+    get(std::string const& key) override
+    {
+        std::string value;
+        auto const status = db_->Get(rocksdb::ReadOptions{}, key, &value);
+        if (status.IsNotFound())
+            return boost::none;
+        check(status);
+        return value;
+    }
+
+    void
+    write(Batch const& batch) override
+    {
+        rocksdb::WriteBatch wb;
+        for (auto const& [key, value] : batch)
+        {
+            if (value)
+                wb.Put(key, *value);
+            else
+                wb.Delete(key);
+        }
+        check(db_->Write(rocksdb::WriteOptions{}, &wb));
+    }
+
+    void
+    scan(
+        std::string const& first,
+        std::string const& last,
+        bool forward,
+        std::function<bool(Slice key, Slice value)> const& f) override
+    {
+        std::unique_ptr<rocksdb::Iterator> it(
+            db_->NewIterator(rocksdb::ReadOptions{}));
+
+        auto const visit = [&]() {
+            auto const key = it->key();
+            auto const value = it->value();
+            return f(
+                Slice(key.data(), key.size()),
+                Slice(value.data(), value.size()));
+        };
+
+        if (forward)
+        {
+            for (it->Seek(first); it->Valid(); it->Next())
+            {
+                if (it->key().compare(last) > 0 || !visit())
+                    break;
+            }
+        }
+        else
+        {
+            for (it->SeekForPrev(first); it->Valid(); it->Prev())
+            {
+                if (it->key().compare(last) < 0 || !visit())
+                    break;
+            }
+        }
+        check(it->status());
+    }
+
+private:
+    void
+    check(rocksdb::Status const& status)
+    {
+        if (!status.ok())
+        {
+            JLOG(j_.error()) << status.ToString();
+            Throw<std::runtime_error>(
+                "Account transaction index: " + status.ToString());
+        }
+    }
+
+    beast::Journal const j_;
+    std::unique_ptr<rocksdb::DB> db_;
+};
+
+#endif
+
+}  // namespace
+
+//------------------------------------------------------------------------------
+
+AccountTxIndex::AccountTxIndex(
+    std::unique_ptr<Backend> backend,
+    beast::Journal journal)
+    : backend_(std::move(backend)), j_(journal)
+{
+    if (auto const value = backend_->get(savedKey);
+        value && !value->empty() && !from_string(saved_, *value))
+        Throw<std::runtime_error>(
+            "Account transaction index: corrupt saved ledgers");
+    if (auto const value = backend_->get(cutoverKey))
+        cutover_ = decodeSeq(*value);
+}
+
+void
+AccountTxIndex::replaceLedger(
+    Backend::Batch& batch,
+    LedgerIndex seq,
+    std::vector<Entry> const& entries) const
+{
+    std::string first(1, ledgerSpace);
+    appendSeq(first, seq);
+    std::string last = first;
+    last.append(accountKeySize - last.size(), '\xff');
+
+    backend_->scan(first, last, true, [&batch](Slice key, Slice) {
+        if (key.size() == accountKeySize)
+            batch.emplace_back(accountKeyOf(key), boost::none);
+        batch.emplace_back(std::string(key.begin(), key.end()), boost::none);
+        return true;
+    });
+
+    // The writes of a batch are applied in order, so an entry the ledger
+    // still has is deleted and then written again.
+    for (auto const& entry : entries)
+    {
+        batch.emplace_back(
+            ledgerKey(seq, entry.txnSeq, entry.account), std::string{});
+        batch.emplace_back(
+            accountKey(entry.account, seq, entry.txnSeq),
+            std::string(
+                reinterpret_cast<char const*>(entry.txID.data()),
+                entry.txID.size()));
+    }
+}
+
+void
+AccountTxIndex::saveLedger(LedgerIndex seq, std::vector<Entry> const& entries)
+{
+    std::lock_guard lock(writeMutex_);
+    Backend::Batch batch;
+    replaceLedger(batch, seq, entries);
+    auto saved = saved_;
+    saved.insert(seq);
+    batch.emplace_back(savedKey, encodeSaved(saved));
+    backend_->write(batch);
+    saved_ = std::move(saved);
+}
+
+void
+AccountTxIndex::deleteBefore(LedgerIndex seq)
+{
+    if (seq == 0)
+        return;
+
+    // The ledgers stop being held before their entries are deleted, so
+    // any left behind by a failed delete are replaced if copied again
+    {
+        std::lock_guard lock(writeMutex_);
+        auto saved = saved_;
+        saved.erase(range<LedgerIndex>(0, seq - 1));
+        backend_->write({{savedKey, encodeSaved(saved)}});
+        saved_ = std::move(saved);
+    }
+
+    std::string first(1, ledgerSpace);
+    std::string last(1, ledgerSpace);
+    appendSeq(last, seq - 1);
+    last.append(accountKeySize - last.size(), '\xff');
+
+    std::size_t deleted = 0;
+    for (;;)
+    {
+        std::lock_guard lock(writeMutex_);
+        Backend::Batch batch;
+        std::size_t keys = 0;
+        backend_->scan(first, last, true, [&](Slice key, Slice) {
+            if (key.size() == accountKeySize)
+                batch.emplace_back(accountKeyOf(key), boost::none);
+            batch.emplace_back(
+                std::string(key.begin(), key.end()), boost::none);
+            return ++keys < deleteBatchSize;
+        });
+        if (keys == 0)
+            break;
+
+        backend_->write(batch);
+        deleted += keys;
+        if (keys < deleteBatchSize)
+            break;
+
+        // The next scan starts at the last key deleted, which is gone
+        first = batch.back().first;
+    }
+
+    JLOG(j_.debug()) << "Deleted " << deleted
+                     << " account transactions before ledger " << seq;
+}
+
+void
+AccountTxIndex::forEach(
+    AccountID const& account,
+    LedgerIndex minLedger,
+    LedgerIndex maxLedger,
+    bool forward,
+    boost::optional<Position> const& start,
+    std::function<bool(Position const&, uint256 const&)> const& f) const
+{
+    std::string const lowest = forward && start
+        ? accountKey(account, start->first, start->second)
+        : accountKey(account, minLedger, 0);
+    std::string const highest = !forward && start
+        ? accountKey(account, start->first, start->second)
+        : accountKey(account, maxLedger, ~std::uint32_t{0});
+
+    backend_->scan(
+        forward ? lowest : highest,
+        forward ? highest : lowest,
+        forward,
+        [&f](Slice key, Slice value) {
+            if (key.size() != accountKeySize || value.size() != uint256::size())
+                Throw<std::runtime_error>(
+                    "Account transaction index: corrupt entry");
+            Position const position{
+                readSeq(key.data() + 21), readSeq(key.data() + 25)};
+            return f(position, uint256::fromVoid(value.data()));
+        });
+}
+
+RangeSet<LedgerIndex>
+AccountTxIndex::saved() const
+{
+    std::lock_guard lock(writeMutex_);
+    return saved_;
+}
+
+void
+AccountTxIndex::saveCopied(
+    LedgerIndex first,
+    LedgerIndex last,
+    std::map<LedgerIndex, std::vector<Entry>> const& ledgers)
+{
+    assert(first <= last);
+    static std::vector<Entry> const none;
+
+    std::lock_guard lock(writeMutex_);
+    Backend::Batch batch;
+    for (auto seq = first;; ++seq)
+    {
+        if (!boost::icl::contains(saved_, seq))
+        {
+            auto const it = ledgers.find(seq);
+            replaceLedger(batch, seq, it == ledgers.end() ? none : it->second);
+        }
+        if (seq == last)
+            break;
+    }
+    auto saved = saved_;
+    saved.insert(range(first, last));
+    batch.emplace_back(savedKey, encodeSaved(saved));
+    backend_->write(batch);
+    saved_ = std::move(saved);
+}
+
+boost::optional<LedgerIndex>
+AccountTxIndex::cutover() const
+{
+    std::lock_guard lock(writeMutex_);
+    return cutover_;
+}
+
+void
+AccountTxIndex::setCutover(LedgerIndex seq)
+{
+    std::lock_guard lock(writeMutex_);
+    backend_->write({{cutoverKey, encodeSeq(seq)}});
+    cutover_ = seq;
+}
+
+//------------------------------------------------------------------------------
+
+std::unique_ptr<AccountTxIndex::Backend>
+make_MemoryAccountTxBackend()
+{
+    return std::make_unique<MemoryBackend>();
+}
+
+std::unique_ptr<AccountTxIndex::Backend>
+make_AccountTxBackend(Section const& section, beast::Journal journal)
+{
+    std::string const type = get<std::string>(section, "type");
+
+    if (boost::iequals(type, "memory"))
+        return make_MemoryAccountTxBackend();
+#if RIPPLE_ROCKSDB_AVAILABLE
+    if (boost::iequals(type, "rocksdb"))
+        return std::make_unique<RocksDBBackend>(section, journal);
+#endif
+    Throw<std::runtime_error>(
+        "Unknown type '" + type + "' in [account_tx_index] section");
+}
+
+}  // namespace ripple
@@ -21,10 +21,13 @@
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/Transaction.h>
+#include <ripple/basics/Log.h>
 #include <ripple/app/misc/impl/AccountTxPaging.h>
 #include <ripple/protocol/Serializer.h>
 #include <ripple/protocol/UintTypes.h>
 #include <boost/format.hpp>
+#include <limits>
+#include <map>
 #include <memory>
 
 namespace ripple {
@@ -259,4 +262,353 @@ accountTxPage(
 
     return;
 }
+
+// Reads count transactions of an account from the index, after skipping
+// skip of them, and returns the position of the one after the last read.
+//
+// Those skipped are counted from the index alone, without reading the
+// Transactions table, so one whose row online deletion has just removed
+// is counted where the join with AccountTransactions left it out.
+static boost::optional<AccountTxIndex::Position>
+readIndexed(
+    AccountTxIndex const& index,
+    DatabaseCon& connection,
+    std::function<void(std::uint32_t)> const& onUnsavedLedger,
+    std::function<void(
+        std::uint32_t,
+        std::string const&,
+        Blob const&,
+        Blob const&)> const& onTransaction,
+    AccountID const& account,
+    std::int32_t minLedger,
+    std::int32_t maxLedger,
+    bool forward,
+    boost::optional<AccountTxIndex::Position> const& start,
+    std::uint32_t skip,
+    std::uint32_t count)
+{
+    auto db(connection.checkoutDb());
+
+    std::string txID;
+    Blob rawData;
+    Blob rawMeta;
+
+    boost::optional<std::string> status;
+    soci::blob txnData(*db);
+    soci::blob txnMeta(*db);
+    soci::indicator dataPresent, metaPresent;
+
+    soci::statement st =
+        (db->prepare << "SELECT Status,RawTxn,TxnMeta "
+                        "FROM Transactions WHERE TransID = :id;",
+         soci::into(status),
+         soci::into(txnData, dataPresent),
+         soci::into(txnMeta, metaPresent),
+         soci::use(txID));
+
+    boost::optional<AccountTxIndex::Position> next;
+    index.forEach(
+        account,
+        minLedger < 0 ? 0 : minLedger,
+        maxLedger < 0 ? std::numeric_limits<LedgerIndex>::max() : maxLedger,
+        forward,
+        start,
+        [&](AccountTxIndex::Position const& position, uint256 const& id) {
+            if (skip != 0)
+            {
+                --skip;
+                return true;
+            }
+
+            // Leave out what the Transactions table does not hold, as
+            // joining it with AccountTransactions did
+            txID = to_string(id);
+            if (!st.execute(true))
+                return true;
+
+            if (count == 0)
+            {
+                next = position;
+                return false;
+            }
+
+            if (dataPresent == soci::i_ok)
+                convert(txnData, rawData);
+            else
+                rawData.clear();
+
+            if (metaPresent == soci::i_ok)
+                convert(txnMeta, rawMeta);
+            else
+                rawMeta.clear();
+
+            // Work around a bug that could leave the metadata missing
+            if (rawMeta.size() == 0)
+                onUnsavedLedger(position.first);
+
+            onTransaction(position.first, *status, rawData, rawMeta);
+            --count;
+            return true;
+        });
+
+    return next;
+}
+
+void
+accountTxPage(
+    AccountTxIndex const& index,
+    DatabaseCon& connection,
+    std::function<void(std::uint32_t)> const& onUnsavedLedger,
+    std::function<void(
+        std::uint32_t,
+        std::string const&,
+        Blob const&,
+        Blob const&)> const& onTransaction,
+    AccountID const& account,
+    std::int32_t minLedger,
+    std::int32_t maxLedger,
+    bool forward,
+    std::optional<NetworkOPs::AccountTxMarker>& marker,
+    int limit,
+    bool bAdmin,
+    std::uint32_t page_length)
+{
+    std::uint32_t numberOfResults;
+
+    if (limit <= 0 || (limit > page_length && !bAdmin))
+        numberOfResults = page_length;
+    else
+        numberOfResults = limit;
+
+    // The index is read from the marker on, rather than up to it.
+    boost::optional<AccountTxIndex::Position> start;
+    if (marker)
+        start.emplace(marker->ledgerSeq, marker->txnSeq);
+
+    // marker is also an output parameter, so need to reset
+    marker.reset();
+
+    if (auto const next = readIndexed(
+            index,
+            connection,
+            onUnsavedLedger,
+            onTransaction,
+            account,
+            minLedger,
+            maxLedger,
+            forward,
+            start,
+            0,
+            numberOfResults))
+        marker = {next->first, next->second};
+}
+
+void
+accountTxOffsetPage(
+    AccountTxIndex const& index,
+    DatabaseCon& connection,
+    std::function<void(std::uint32_t)> const& onUnsavedLedger,
+    std::function<void(
+        std::uint32_t,
+        std::string const&,
+        Blob const&,
+        Blob const&)> const& onTransaction,
+    AccountID const& account,
+    std::int32_t minLedger,
+    std::int32_t maxLedger,
+    bool descending,
+    std::uint32_t offset,
+    std::uint32_t numberOfResults)
+{
+    readIndexed(
+        index,
+        connection,
+        onUnsavedLedger,
+        onTransaction,
+        account,
+        minLedger,
+        maxLedger,
+        !descending,
+        boost::none,
+        offset,
+        numberOfResults);
+}
+
+boost::optional<LedgerIndex>
+accountTxIndexCutover(DatabaseCon& txnDB)
+{
+    auto db = txnDB.checkoutDb();
+    boost::optional<std::uint64_t> seq;
+    *db << "SELECT MAX(LedgerSeq) FROM AccountTxIndex;", soci::into(seq);
+    if (!seq)
+        return boost::none;
+    return rangeCheckedCast<LedgerIndex>(*seq);
+}
+
+// How many ledgers are copied at a time
+static LedgerIndex const copyChunk = 256;
+
+// Copies the newest ledgers, up to chunk of them, which the
+// AccountTransactions table holds and the index does not. Returns false
+// if there are none.
+static bool
+copyMissing(
+    AccountTxIndex& index,
+    DatabaseCon& txnDB,
+    LedgerIndex chunk,
+    beast::Journal j)
+{
+    LedgerIndex first;
+    LedgerIndex last;
+    std::map<LedgerIndex, std::vector<AccountTxIndex::Entry>> ledgers;
+    {
+        auto db = txnDB.checkoutDb();
+
+        boost::optional<std::uint64_t> oldest;
+        boost::optional<std::uint64_t> newest;
+        *db << "SELECT MIN(LedgerSeq),MAX(LedgerSeq) "
+               "FROM AccountTransactions;",
+            soci::into(oldest), soci::into(newest);
+        if (!oldest || !newest)
+            return false;
+
+        RangeSet<LedgerIndex> missing{range(
+            rangeCheckedCast<LedgerIndex>(*oldest),
+            rangeCheckedCast<LedgerIndex>(*newest))};
+        missing -= index.saved();
+        if (missing.empty())
+            return false;
+
+        auto const& newestMissing = *missing.rbegin();
+        last = newestMissing.last();
+        first = last - newestMissing.first() < chunk ? newestMissing.first()
+                                                     : last - (chunk - 1);
+
+        std::string txID;
+        std::string account;
+        std::uint64_t ledgerSeq;
+        std::uint32_t txnSeq;
+
+        soci::statement st =
+            (db->prepare << "SELECT TransID,Account,LedgerSeq,TxnSeq "
+                            "FROM AccountTransactions "
+                            "WHERE LedgerSeq BETWEEN :first AND :last;",
+             soci::into(txID),
+             soci::into(account),
+             soci::into(ledgerSeq),
+             soci::into(txnSeq),
+             soci::use(first),
+             soci::use(last));
+
+        st.execute();
+        while (st.fetch())
+        {
+            AccountTxIndex::Entry entry;
+            auto const id = parseBase58<AccountID>(account);
+            if (!id || !entry.txID.SetHexExact(txID))
+            {
+                JLOG(j.warn()) << "Not copying account transaction " << txID
+                               << " of " << account;
+                continue;
+            }
+            entry.account = *id;
+            entry.txnSeq = txnSeq;
+            ledgers[rangeCheckedCast<LedgerIndex>(ledgerSeq)].push_back(
+                std::move(entry));
+        }
+    }
+
+    index.saveCopied(first, last, ledgers);
+    JLOG(j.debug()) << "Copied account transactions of ledgers " << first
+                    << " to " << last;
+    return true;
+}
+
+bool
+openAccountTxIndex(
+    AccountTxIndex& index,
+    DatabaseCon& txnDB,
+    beast::Journal j)
+{
+    auto const cutover = accountTxIndexCutover(txnDB);
+    if (!cutover)
+        return true;
+
+    if (index.cutover() != cutover)
+    {
+        JLOG(j.fatal()) << "The account transaction index is not the one "
+                           "which replaced the AccountTransactions table "
+                           "after ledger "
+                        << *cutover;
+        return false;
+    }
+
+    // A ledger saved to the table just before the cutover was recorded
+    // may not have reached the index
+    while (copyMissing(index, txnDB, copyChunk, j))
+        ;
+    index.markReady();
+    return true;
+}
+
+bool
+copyAccountTransactions(
+    AccountTxIndex& index,
+    DatabaseCon& txnDB,
+    LedgerIndex chunk,
+    beast::Journal j)
+{
+    if (index.ready())
+        return false;
+
+    if (copyMissing(index, txnDB, chunk, j))
+        return true;
+
+    // The table must stop being written to only after the index holds all
+    // it held, and once it has stopped the index must be kept. A ledger
+    // saved meanwhile is saved to the index as well.
+    LedgerIndex last;
+    {
+        auto db = txnDB.checkoutDb();
+        boost::optional<std::uint64_t> seq;
+        *db << "SELECT MAX(LedgerSeq) FROM AccountTransactions;",
+            soci::into(seq);
+        last = rangeCheckedCast<LedgerIndex>(seq.value_or(0));
+    }
+
+    // The index learns of the cutover first, so that a transaction
+    // database which records it is only ever used with this index
+    index.setCutover(last);
+    {
+        auto db = txnDB.checkoutDb();
+        std::uint64_t const seq = last;
+        *db << "INSERT INTO AccountTxIndex (LedgerSeq) VALUES (:seq);",
+            soci::use(seq);
+    }
+    index.markReady();
+    JLOG(j.info()) << "The account transaction index replaces the "
+                      "AccountTransactions table after ledger "
+                   << last;
+    return false;
+}
+
+void
+copyAccountTransactions(Application& app)
+{
+    auto const index = app.getAccountTxIndex();
+    if (!index || index->ready())
+        return;
+
+    if (copyAccountTransactions(
+            *index,
+            app.getTxnDB(),
+            copyChunk,
+            app.journal("AccountTxIndex")))
+    {
+        app.getJobQueue().addJob(
+            jtCOPY_ACCT_TX, "copyAccountTransactions", [&app](Job&) {
+                copyAccountTransactions(app);
+            });
+    }
+}
 }  // namespace ripple
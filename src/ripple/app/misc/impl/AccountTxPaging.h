@@ -20,6 +20,7 @@
 #ifndef RIPPLE_APP_MISC_IMPL_ACCOUNTTXPAGING_H_INCLUDED
 #define RIPPLE_APP_MISC_IMPL_ACCOUNTTXPAGING_H_INCLUDED
 
+#include <ripple/app/misc/AccountTxIndex.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/core/DatabaseCon.h>
 #include <cstdint>
@@ -60,6 +61,95 @@ accountTxPage(
     int limit,
     bool bAdmin,
     std::uint32_t page_length);
+
+/** As accountTxPage, with the transactions of the account found in the
+    account transaction index and read from the Transactions table by ID.
+*/
+void
+accountTxPage(
+    AccountTxIndex const& index,
+    DatabaseCon& connection,
+    std::function<void(std::uint32_t)> const& onUnsavedLedger,
+    std::function<void(
+        std::uint32_t,
+        std::string const&,
+        Blob const&,
+        Blob const&)> const& onTransaction,
+    AccountID const& account,
+    std::int32_t minLedger,
+    std::int32_t maxLedger,
+    bool forward,
+    std::optional<NetworkOPs::AccountTxMarker>& marker,
+    int limit,
+    bool bAdmin,
+    std::uint32_t page_length);
+
+/** Read the transactions of an account from the account transaction
+    index, skipping offset of them, as the deprecated account_tx did.
+*/
+void
+accountTxOffsetPage(
+    AccountTxIndex const& index,
+    DatabaseCon& connection,
+    std::function<void(std::uint32_t)> const& onUnsavedLedger,
+    std::function<void(
+        std::uint32_t,
+        std::string const&,
+        Blob const&,
+        Blob const&)> const& onTransaction,
+    AccountID const& account,
+    std::int32_t minLedger,
+    std::int32_t maxLedger,
+    bool descending,
+    std::uint32_t offset,
+    std::uint32_t numberOfResults);
+
+/** Returns the newest ledger whose account transactions the
+    AccountTransactions table holds, if the account transaction index
+    has replaced it.
+*/
+boost::optional<LedgerIndex>
+accountTxIndexCutover(DatabaseCon& txnDB);
+
+/** Check an account transaction index as it is opened.
+
+    Once the transaction database records that the index replaced the
+    table, only the index which replaced it can be used: what the table
+    is missing was only ever written to the index. Any ledger the table
+    holds and the index does not, because the server stopped as the
+    cutover was recorded, is copied before the index is made ready.
+
+    @return false if the index cannot be used.
+*/
+bool
+openAccountTxIndex(
+    AccountTxIndex& index,
+    DatabaseCon& txnDB,
+    beast::Journal j);
+
+/** Copy the account transactions of up to chunk ledgers from the
+    AccountTransactions table to the index.
+
+    Copies the newest ledgers the table holds and the index does not,
+    whether the index was created after them or missed them while the
+    server ran without it. Once there are none, records in the index and
+    then the transaction database that the table is no longer written to,
+    and makes the index ready.
+
+    @return true if there is more to copy.
+*/
+bool
+copyAccountTransactions(
+    AccountTxIndex& index,
+    DatabaseCon& txnDB,
+    LedgerIndex chunk,
+    beast::Journal j);
+
+/** Copy a chunk of the AccountTransactions table to the account
+    transaction index, and schedule the next until all are copied.
+*/
+void
+copyAccountTransactions(Application& app);
 }  // namespace ripple
 
 #endif
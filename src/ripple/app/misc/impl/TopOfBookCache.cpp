@@ -0,0 +1,384 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/TopOfBookCache.h>
+#include <ripple/basics/Log.h>
+#include <ripple/ledger/View.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/jss.h>
+#include <algorithm>
+#include <map>
+
+namespace ripple {
+
+BookPage
+readBookPage(
+    ReadView const& view,
+    Book const& book,
+    AccountID const& taker,
+    std::size_t limit,
+    beast::Journal j)
+{
+    BookPage page;
+    std::map<AccountID, STAmount> umBalance;
+    const uint256 uBookBase = getBookBase(book);
+    const uint256 uBookEnd = getQualityNext(uBookBase);
+    uint256 uTipIndex = uBookBase;
+
+    bool const bGlobalFreeze = isGlobalFrozen(view, book.out.account) ||
+        isGlobalFrozen(view, book.in.account);
+
+    bool bDone = false;
+    bool bDirectAdvance = true;
+
+    std::shared_ptr<SLE const> sleOfferDir;
+    uint256 offerIndex;
+    unsigned int uBookEntry;
+    STAmount saDirRate;
+
+    auto const rate = transferRate(view, book.out.account);
+
+    while (!bDone && limit-- > 0)
+    {
+        if (bDirectAdvance)
+        {
+            bDirectAdvance = false;
+
+            auto const ledgerIndex = view.succ(uTipIndex, uBookEnd);
+            if (ledgerIndex)
+                sleOfferDir = view.read(keylet::page(*ledgerIndex));
+            else
+                sleOfferDir.reset();
+
+            if (!sleOfferDir)
+            {
+                bDone = true;
+            }
+            else
+            {
+                uTipIndex = sleOfferDir->key();
+                saDirRate = amountFromQuality(getQuality(uTipIndex));
+
+                cdirFirst(
+                    view, uTipIndex, sleOfferDir, uBookEntry, offerIndex, j);
+
+                JLOG(j.trace()) << "readBookPage:   uTipIndex=" << uTipIndex;
+            }
+        }
+
+        if (!bDone)
+        {
+            auto sleOffer = view.read(keylet::offer(offerIndex));
+
+            if (sleOffer)
+            {
+                auto const uOfferOwnerID = sleOffer->getAccountID(sfAccount);
+                auto const& saTakerGets = sleOffer->getFieldAmount(sfTakerGets);
+                auto const& saTakerPays = sleOffer->getFieldAmount(sfTakerPays);
+                STAmount saOwnerFunds;
+                bool firstOwnerOffer(true);
+
+                if (book.out.account == uOfferOwnerID)
+                {
+                    // If an offer is selling issuer's own IOUs, it is fully
+                    // funded.
+                    saOwnerFunds = saTakerGets;
+                }
+                else if (bGlobalFreeze)
+                {
+                    // If either asset is globally frozen, consider all offers
+                    // that aren't ours to be totally unfunded
+                    saOwnerFunds.clear(book.out);
+                }
+                else
+                {
+                    auto umBalanceEntry = umBalance.find(uOfferOwnerID);
+                    if (umBalanceEntry != umBalance.end())
+                    {
+                        // Found in running balance table.
+
+                        saOwnerFunds = umBalanceEntry->second;
+                        firstOwnerOffer = false;
+                    }
+                    else
+                    {
+                        // Did not find balance in table.
+
+                        saOwnerFunds = accountHolds(
+                            view,
+                            uOfferOwnerID,
+                            book.out.currency,
+                            book.out.account,
+                            fhZERO_IF_FROZEN,
+                            j);
+
+                        if (saOwnerFunds < beast::zero)
+                        {
+                            // Treat negative funds as zero.
+
+                            saOwnerFunds.clear();
+                        }
+                    }
+                }
+
+                Json::Value jvOffer = sleOffer->getJson(JsonOptions::none);
+
+                STAmount saTakerGetsFunded;
+                STAmount saOwnerFundsLimit = saOwnerFunds;
+                Rate offerRate = parityRate;
+
+                if (rate != parityRate
+                    // Have a tranfer fee.
+                    && taker != book.out.account
+                    // Not taking offers of own IOUs.
+                    && book.out.account != uOfferOwnerID)
+                // Offer owner not issuing ownfunds
+                {
+                    // Need to charge a transfer fee to offer owner.
+                    offerRate = rate;
+                    saOwnerFundsLimit = divide(saOwnerFunds, offerRate);
+                }
+
+                if (saOwnerFundsLimit >= saTakerGets)
+                {
+                    // Sufficient funds no shenanigans.
+                    saTakerGetsFunded = saTakerGets;
+                }
+                else
+                {
+                    // Only provide, if not fully funded.
+
+                    saTakerGetsFunded = saOwnerFundsLimit;
+
+                    saTakerGetsFunded.setJson(jvOffer[jss::taker_gets_funded]);
+                    std::min(
+                        saTakerPays,
+                        multiply(
+                            saTakerGetsFunded, saDirRate, saTakerPays.issue()))
+                        .setJson(jvOffer[jss::taker_pays_funded]);
+                }
+
+                STAmount saOwnerPays = (parityRate == offerRate)
+                    ? saTakerGetsFunded
+                    : std::min(
+                          saOwnerFunds, multiply(saTakerGetsFunded, offerRate));
+
+                umBalance[uOfferOwnerID] = saOwnerFunds - saOwnerPays;
+
+                // Include all offers funded and unfunded
+                jvOffer[jss::quality] = saDirRate.getText();
+
+                if (firstOwnerOffer)
+                    jvOffer[jss::owner_funds] = saOwnerFunds.getText();
+
+                page.offers.push_back(std::move(jvOffer));
+            }
+            else
+            {
+                JLOG(j.warn()) << "Missing offer";
+                page.offers.emplace_back();
+            }
+
+            if (!cdirNext(
+                    view, uTipIndex, sleOfferDir, uBookEntry, offerIndex, j))
+            {
+                bDirectAdvance = true;
+            }
+        }
+    }
+
+    page.complete = bDone;
+    page.accounts.reserve(umBalance.size() + 2);
+    for (auto const& [owner, balance] : umBalance)
+        page.accounts.push_back(owner);
+    page.accounts.push_back(book.in.account);
+    page.accounts.push_back(book.out.account);
+    return page;
+}
+
+//------------------------------------------------------------------------------
+
+// The pages of this many of the most recent ledgers are kept
+static std::size_t constexpr keepLedgers = 4;
+
+TopOfBookCache::TopOfBookCache(
+    std::size_t depth,
+    std::size_t maxBooks,
+    beast::Journal journal)
+    : depth_(depth), maxBooks_(maxBooks), j_(journal)
+{
+}
+
+std::shared_ptr<BookPage const>
+TopOfBookCache::get(
+    std::shared_ptr<ReadView const> const& ledger,
+    Book const& book)
+{
+    if (ledger->open())
+        return nullptr;
+
+    auto const pages = pagesFor(*ledger);
+    {
+        std::lock_guard lock(pages->mutex);
+        if (auto const it = pages->books.find(book); it != pages->books.end())
+        {
+            it->second.used = true;
+            return it->second.page;
+        }
+    }
+
+    // Readers of other books are not held up while this one is read. Two
+    // threads may read the same book; the page of the first one is kept.
+    auto page = std::make_shared<BookPage const>(
+        readBookPage(*ledger, book, noAccount(), depth_, j_));
+
+    std::lock_guard lock(pages->mutex);
+    if (auto const it = pages->books.find(book); it != pages->books.end())
+        return it->second.page;
+    if (pages->books.size() >= maxBooks_)
+        return page;
+    return pages->books.emplace(book, Entry{std::move(page), true})
+        .first->second.page;
+}
+
+std::shared_ptr<TopOfBookCache::Pages>
+TopOfBookCache::pagesFor(ReadView const& ledger)
+{
+    auto const& info = ledger.info();
+    std::shared_ptr<Pages> parent;
+    {
+        std::lock_guard lock(mutex_);
+        for (auto const& p : ledgers_)
+        {
+            if (p->hash == info.hash)
+                return p;
+            if (p->hash == info.parentHash)
+                parent = p;
+        }
+    }
+
+    auto pages = std::make_shared<Pages>();
+    pages->seq = info.seq;
+    pages->hash = info.hash;
+    if (parent)
+        pages->books = carryOver(*parent, ledger);
+
+    std::lock_guard lock(mutex_);
+    for (auto const& p : ledgers_)
+    {
+        if (p->hash == info.hash)
+            return p;
+    }
+
+    JLOG(j_.debug()) << "Top of book cache for ledger " << info.seq << ": "
+                     << pages->books.size() << " of "
+                     << (parent ? parent->books.size() : 0)
+                     << " pages carried over";
+
+    ledgers_.push_back(pages);
+    if (ledgers_.size() > keepLedgers)
+    {
+        ledgers_.erase(std::min_element(
+            ledgers_.begin(),
+            ledgers_.end(),
+            [](auto const& a, auto const& b) { return a->seq < b->seq; }));
+    }
+    return pages;
+}
+
+hash_map<Book, TopOfBookCache::Entry>
+TopOfBookCache::carryOver(Pages& parent, ReadView const& ledger)
+{
+    hash_map<Book, Entry> books;
+    {
+        std::lock_guard lock(parent.mutex);
+        for (auto const& [book, entry] : parent.books)
+        {
+            if (entry.used)
+                books.emplace(book, Entry{entry.page, false});
+        }
+    }
+    if (books.empty())
+        return books;
+
+    // The books whose offers changed, and the accounts whose balances,
+    // trust lines or flags may have changed.
+    hash_set<uint256> touchedBooks;
+    hash_set<AccountID> touchedAccounts;
+    for (auto const& [tx, meta] : ledger.txs)
+    {
+        if (!meta)
+            continue;
+
+        for (auto const& node : meta->getFieldArray(sfAffectedNodes))
+        {
+            auto const type = node.getFieldU16(sfLedgerEntryType);
+
+            // A change to the fees changes the reserves of every owner
+            if (type == ltFEE_SETTINGS)
+                return {};
+
+            for (auto const& field : {&sfNewFields, &sfFinalFields})
+            {
+                auto const index = node.getFieldIndex(*field);
+                if (index == -1)
+                    continue;
+                auto const fields =
+                    dynamic_cast<STObject const*>(&node.peekAtIndex(index));
+                if (!fields)
+                    continue;
+
+                if (fields->isFieldPresent(sfAccount))
+                    touchedAccounts.insert(fields->getAccountID(sfAccount));
+
+                if (type == ltOFFER && fields->isFieldPresent(sfBookDirectory))
+                {
+                    touchedBooks.insert(
+                        getQualityIndex(fields->getFieldH256(sfBookDirectory)));
+                }
+                else if (type == ltRIPPLE_STATE)
+                {
+                    touchedAccounts.insert(
+                        fields->getFieldAmount(sfLowLimit).getIssuer());
+                    touchedAccounts.insert(
+                        fields->getFieldAmount(sfHighLimit).getIssuer());
+                }
+            }
+        }
+    }
+
+    for (auto it = books.begin(); it != books.end();)
+    {
+        auto const& accounts = it->second.page->accounts;
+        if (touchedBooks.count(getBookBase(it->first)) ||
+            std::any_of(
+                accounts.begin(),
+                accounts.end(),
+                [&touchedAccounts](AccountID const& account) {
+                    return touchedAccounts.count(account) != 0;
+                }))
+            it = books.erase(it);
+        else
+            ++it;
+    }
+    return books;
+}
+
+}  // namespace ripple
@@ -313,10 +313,13 @@ TxQ::TxQAccount::remove(TxSeq const& sequence)
 TxQ::TxQ(Setup const& setup, beast::Journal j)
     : setup_(setup), j_(j), feeMetrics_(setup, j), maxSize_(boost::none)
 {
+    publishMetrics();
 }
 
 TxQ::~TxQ()
 {
+    byHead_.clear();
+    byLastValid_.clear();
     byFee_.clear();
 }
 
@@ -401,20 +404,23 @@ TxQ::erase(TxQ::FeeMultiSet::const_iterator_type candidateIter)
     auto const found = txQAccount.remove(sequence);
     (void)found;
     assert(found);
+    updateHead(txQAccount);
+    publishMetrics();
 
     return newCandidateIter;
 }
 
 auto
-TxQ::eraseAndAdvance(TxQ::FeeMultiSet::const_iterator_type candidateIter)
-    -> FeeMultiSet::iterator_type
+TxQ::eraseAndAdvance(TxQ::HeadMultiSet::iterator candidateIter)
+    -> HeadMultiSet::iterator
 {
     auto& txQAccount = byAccount_.at(candidateIter->account);
     auto const accountIter =
         txQAccount.transactions.find(candidateIter->sequence);
     assert(accountIter != txQAccount.transactions.end());
     assert(accountIter == txQAccount.transactions.begin());
-    assert(byFee_.iterator_to(accountIter->second) == candidateIter);
+    assert(byHead_.iterator_to(accountIter->second) == candidateIter);
+    auto const feeIter = byFee_.iterator_to(accountIter->second);
     auto const accountNextIter = std::next(accountIter);
     /* Check if the next transaction for this account has the
         next sequence number, and a higher fee level, which means
@@ -429,15 +435,27 @@ TxQ::eraseAndAdvance(TxQ::FeeMultiSet::const_iterator_type candidateIter)
             the latter case, continue through the fee queue anyway
             to head off potential ordering manipulation problems.
     */
-    auto const feeNextIter = std::next(candidateIter);
+    auto const feeNextIter = std::next(feeIter);
     bool const useAccountNext =
         accountNextIter != txQAccount.transactions.end() &&
         accountNextIter->first == candidateIter->sequence + 1 &&
         (feeNextIter == byFee_.end() ||
          accountNextIter->second.feeLevel > feeNextIter->feeLevel);
-    auto const candidateNextIter = byFee_.erase(candidateIter);
+    /* The account's next transaction becomes its head. Link it while
+        the candidate is still in byHead_, so that if it sorts after the
+        candidate, it is found by stepping past the candidate like any
+        other head with a lower fee level.
+    */
+    if (accountNextIter != txQAccount.transactions.end())
+        byHead_.insert(accountNextIter->second);
+    auto const candidateNextIter = std::next(candidateIter);
+    byFee_.erase(feeIter);
+    // Destroying the candidate takes it out of byHead_ and byLastValid_
     txQAccount.transactions.erase(accountIter);
-    return useAccountNext ? byFee_.iterator_to(accountNextIter->second)
+    if (txQAccount.empty())
+        emptied_.push_back(txQAccount.account);
+    publishMetrics();
+    return useAccountNext ? byHead_.iterator_to(accountNextIter->second)
                           : candidateNextIter;
 }
 
@@ -451,7 +469,44 @@ TxQ::erase(
     {
         byFee_.erase(byFee_.iterator_to(it->second));
     }
-    return txQAccount.transactions.erase(begin, end);
+    auto const result = txQAccount.transactions.erase(begin, end);
+    updateHead(txQAccount);
+    publishMetrics();
+    return result;
+}
+
+void
+TxQ::updateHead(TxQ::TxQAccount& txQAccount)
+{
+    if (txQAccount.empty())
+    {
+        emptied_.push_back(txQAccount.account);
+        return;
+    }
+
+    auto const first = txQAccount.transactions.begin();
+    if (first->second.byHeadHook.is_linked())
+        return;
+    // A transaction added in front of the old head takes its place
+    if (auto const second = std::next(first);
+        second != txQAccount.transactions.end() &&
+        second->second.byHeadHook.is_linked())
+        second->second.byHeadHook.unlink();
+    byHead_.insert(first->second);
+}
+
+void
+TxQ::publishMetrics()
+{
+    auto const snapshot = feeMetrics_.getSnapshot();
+
+    published_.txCount = byFee_.size();
+    published_.maxSize = maxSize_.value_or(0);
+    published_.minProcessingFeeLevel =
+        (isFull() ? byFee_.rbegin()->feeLevel + FeeLevel64{1} : baseLevel)
+            .fee();
+    published_.txnsExpected = snapshot.txnsExpected;
+    published_.escalationMultiplier = snapshot.escalationMultiplier.fee();
 }
 
 std::pair<TER, bool>
@@ -601,13 +656,38 @@ TxQ::apply(
     ApplyFlags flags,
     beast::Journal j)
 {
+    return apply(
+        app, view, tx, preflight(app, view.rules(), *tx, flags, j), flags, j);
+}
+
+std::pair<TER, bool>
+TxQ::apply(
+    Application& app,
+    OpenView& view,
+    std::shared_ptr<STTx const> const& tx,
+    PreflightResult const& preflightResult,
+    ApplyFlags flags,
+    beast::Journal j)
+{
+    assert(&preflightResult.tx == tx.get());
+
     auto const account = (*tx)[sfAccount];
     auto const transactionID = tx->getTransactionID();
     auto const tSeq = tx->getSequence();
+
+    // If the rules or flags changed since the transaction was checked,
+    // preflight again.
+    boost::optional<PreflightResult const> repeated;
+    if (preflightResult.rules != view.rules() ||
+        preflightResult.flags != flags)
+    {
+        repeated.emplace(preflight(app, view.rules(), *tx, flags, j));
+    }
+    auto const& pfresult = repeated ? *repeated : preflightResult;
+
     // See if the transaction is valid, properly formed,
     // etc. before doing potentially expensive queue
     // replace and multi-transaction operations.
-    auto const pfresult = preflight(app, view.rules(), *tx, flags, j);
     if (pfresult.ter != tesSUCCESS)
         return {pfresult.ter, false};
 
@@ -1103,8 +1183,13 @@ TxQ::apply(
     */
     if (consequences)
         candidate.consequences.emplace(*consequences);
-    // Then index it into the byFee lookup.
+    // Then index it into the byFee lookup, and the others.
+    candidate.arrival = arrivals_++;
     byFee_.insert(candidate);
+    if (candidate.lastValid)
+        byLastValid_.insert(candidate);
+    updateHead(accountIter->second);
+    publishMetrics();
     JLOG(j_.debug()) << "Added transaction " << candidate.txID
                      << " with result " << transToken(pfresult.ter) << " from "
                      << (accountExists ? "existing" : "new") << " account "
@@ -1141,40 +1226,36 @@ TxQ::processClosedLedger(Application& app, ReadView const& view, bool timeLeap)
             snapshot.txnsExpected * setup_.ledgersInQueue, setup_.queueSizeMin);
 
     // Remove any queued candidates whose LastLedgerSequence has gone by.
-    for (auto candidateIter = byFee_.begin(); candidateIter != byFee_.end();)
+    while (!byLastValid_.empty() &&
+           *byLastValid_.begin()->lastValid <= ledgerSeq)
     {
-        if (candidateIter->lastValid && *candidateIter->lastValid <= ledgerSeq)
-        {
-            byAccount_.at(candidateIter->account).dropPenalty = true;
-            candidateIter = erase(candidateIter);
-        }
-        else
-        {
-            ++candidateIter;
-        }
+        auto const& candidate = *byLastValid_.begin();
+        byAccount_.at(candidate.account).dropPenalty = true;
+        erase(byFee_.iterator_to(candidate));
     }
 
     // Remove any TxQAccounts that don't have candidates
     // under them
-    for (auto txQAccountIter = byAccount_.begin();
-         txQAccountIter != byAccount_.end();)
+    for (auto const& account : emptied_)
     {
-        if (txQAccountIter->second.empty())
-            txQAccountIter = byAccount_.erase(txQAccountIter);
-        else
-            ++txQAccountIter;
+        if (auto const iter = byAccount_.find(account);
+            iter != byAccount_.end() && iter->second.empty())
+            byAccount_.erase(iter);
     }
+    emptied_.clear();
+
+    publishMetrics();
 }
 
 /*
     How the txs are moved from the queue to the new open ledger.
 
-    1. Iterate over the txs from highest fee level to lowest.
+    1. Iterate over the txs from highest fee level to lowest,
+        considering only the first tx in the queue for each account.
+        The others can not succeed yet, and are tracked separately
+        (`byHead_`) so that they don't need to be skipped one by one.
         For each tx:
-        a) Is this the first tx in the queue for this account?
-            No: Skip this tx. We'll come back to it later.
-            Yes: Continue to the next sub-step.
-        b) Is the tx fee level less than the current required
+        a) Is the tx fee level less than the current required
                 fee level?
             Yes: Stop iterating. Continue to the next step.
             No: Try to apply the transaction. Did it apply?
@@ -1210,20 +1291,10 @@ TxQ::accept(Application& app, OpenView& view)
 
     auto const metricSnapshot = feeMetrics_.getSnapshot();
 
-    for (auto candidateIter = byFee_.begin(); candidateIter != byFee_.end();)
+    for (auto candidateIter = byHead_.begin(); candidateIter != byHead_.end();)
     {
         auto& account = byAccount_.at(candidateIter->account);
-        if (candidateIter->sequence > account.transactions.begin()->first)
-        {
-            // This is not the first transaction for this account, so skip it.
-            // It can not succeed yet.
-            JLOG(j_.trace())
-                << "Skipping queued transaction " << candidateIter->txID
-                << " from account " << candidateIter->account
-                << " as it is not the first.";
-            candidateIter++;
-            continue;
-        }
+        assert(candidateIter->sequence == account.transactions.begin()->first);
         auto const requiredFeeLevel =
             FeeMetrics::scaleFeeLevel(metricSnapshot, view);
         auto const feeLevelPaid = candidateIter->feeLevel;
@@ -1294,9 +1365,8 @@ TxQ::accept(Application& app, OpenView& view)
                                     << transToken(txnResult)
                                     << ". Removing last item of account "
                                     << account.account;
-                    auto endIter = byFee_.iterator_to(dropRIter->second);
-                    assert(endIter != candidateIter);
-                    erase(endIter);
+                    assert(&dropRIter->second != &*candidateIter);
+                    erase(byFee_.iterator_to(dropRIter->second));
                 }
                 ++candidateIter;
             }
@@ -1315,17 +1385,18 @@ TxQ::getMetrics(OpenView const& view) const
 {
     Metrics result;
 
-    std::lock_guard lock(mutex_);
-
-    auto const snapshot = feeMetrics_.getSnapshot();
+    FeeMetrics::Snapshot const snapshot{
+        published_.txnsExpected.load(),
+        FeeLevel64{published_.escalationMultiplier.load()}};
 
-    result.txCount = byFee_.size();
-    result.txQMaxSize = maxSize_;
+    result.txCount = published_.txCount.load();
+    if (auto const maxSize = published_.maxSize.load())
+        result.txQMaxSize = maxSize;
     result.txInLedger = view.txCount();
     result.txPerLedger = snapshot.txnsExpected;
     result.referenceFeeLevel = baseLevel;
     result.minProcessingFeeLevel =
-        isFull() ? byFee_.rbegin()->feeLevel + FeeLevel64{1} : baseLevel;
+        FeeLevel64{published_.minProcessingFeeLevel.load()};
     result.medFeeLevel = snapshot.escalationMultiplier;
     result.openLedgerFeeLevel = FeeMetrics::scaleFeeLevel(snapshot, view);
 
@@ -1355,15 +1426,14 @@ TxQ::getTxRequiredFeeAndSeq(
 
     auto availableSeq = accountSeq;
 
-    if (auto iter{byAccount_.find(account)}; iter != byAccount_.end())
+    if (auto iter{byAccount_.find(account)};
+        iter != byAccount_.end() && !iter->second.empty())
     {
-        auto& txQAcct = iter->second;
-        for (auto const& [seq, _] : txQAcct.transactions)
-        {
-            (void)_;
-            if (seq >= availableSeq)
-                availableSeq = seq + 1;
-        }
+        // The queued sequence numbers are in order, so only the last
+        // one can be past the account's sequence.
+        auto const lastSeq = iter->second.transactions.rbegin()->first;
+        if (lastSeq >= availableSeq)
+            availableSeq = lastSeq + 1;
     }
 
     return {mulDiv(fee, baseFee, baseLevel).second, accountSeq, availableSeq};
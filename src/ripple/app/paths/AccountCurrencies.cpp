@@ -33,6 +33,18 @@ accountSourceCurrencies(
     if (includeXRP)
         currencies.insert(xrpCurrency());
 
+    if (auto const& graph = lrCache->getGraph())
+    {
+        graph->forEachCurrency(
+            account,
+            [&currencies](Currency const& currency, auto const& totals) {
+                if (totals.sendable != 0)
+                    currencies.insert(currency);
+            });
+        currencies.erase(badCurrency());
+        return currencies;
+    }
+
     // List of ripple lines.
     auto& rippleLines = lrCache->getRippleLines(account);
 
@@ -72,6 +84,18 @@ accountDestCurrencies(
         currencies.insert(xrpCurrency());
     // Even if account doesn't exist
 
+    if (auto const& graph = lrCache->getGraph())
+    {
+        graph->forEachCurrency(
+            account,
+            [&currencies](Currency const& currency, auto const& totals) {
+                if (totals.receivable != 0)
+                    currencies.insert(currency);
+            });
+        currencies.erase(badCurrency());
+        return currencies;
+    }
+
     // List of ripple lines.
     auto& rippleLines = lrCache->getRippleLines(account);
 
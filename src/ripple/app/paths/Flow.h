@@ -32,6 +32,24 @@ struct FlowDebugInfo;
 }
 }  // namespace path
 
+/** The quality bounds of book steps a flow evaluated and reused.
+
+    While crossing offers, flow() bounds the quality of each strand on
+    every iteration, and keeps the bounds of book steps until an entry
+    they read is written. Payments do not bound their strands.
+*/
+struct QualityBoundReuse
+{
+    /** Whether bounds are kept; tests compare flows with and without. */
+    bool enabled = true;
+
+    /** The number of book step bounds evaluated. */
+    std::size_t evaluated = 0;
+
+    /** The number of book step bounds kept from a previous iteration. */
+    std::size_t reused = 0;
+};
+
 /**
   Make a payment from the src account to the dst account
 
@@ -50,6 +68,8 @@ struct FlowDebugInfo;
   @param sendMax Do not spend more than this amount
   @param j Journal to write journal messages to
   @param flowDebugInfo If non-null a pointer to FlowDebugInfo for debugging
+  @param boundReuse If non-null, whether to reuse quality bounds, and
+                    where to count those evaluated and reused
   @return Actual amount in and out, and the result code
 */
 path::RippleCalc::Output
@@ -66,7 +86,8 @@ flow(
     boost::optional<Quality> const& limitQuality,
     boost::optional<STAmount> const& sendMax,
     beast::Journal j,
-    path::detail::FlowDebugInfo* flowDebugInfo = nullptr);
+    path::detail::FlowDebugInfo* flowDebugInfo = nullptr,
+    QualityBoundReuse* boundReuse = nullptr);
 
 }  // namespace ripple
 
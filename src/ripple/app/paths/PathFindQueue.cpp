@@ -0,0 +1,177 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/paths/PathFindQueue.h>
+#include <ripple/basics/Log.h>
+#include <ripple/beast/core/CurrentThreadName.h>
+#include <ripple/core/Config.h>
+
+namespace ripple {
+
+PathFindQueue::PathFindQueue(
+    Setup const& setup,
+    std::function<LedgerIndex()> closedSeq,
+    beast::insight::Collector::ptr const& collector,
+    beast::Journal journal)
+    : setup_(setup), closedSeq_(std::move(closedSeq)), j_(journal)
+{
+    wait_ = collector->make_event("pathfind_wait");
+    queued_ = collector->make_gauge("pathfind_queued");
+
+    threads_.reserve(setup_.threads);
+    for (std::size_t i = 0; i < setup_.threads; ++i)
+    {
+        threads_.emplace_back([this, i]() {
+            beast::setCurrentThreadName("pathfind #" + std::to_string(i));
+            run();
+        });
+    }
+}
+
+PathFindQueue::~PathFindQueue()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    cond_.notify_all();
+    for (auto& t : threads_)
+        t.join();
+}
+
+bool
+PathFindQueue::post(
+    std::string const& client,
+    bool limited,
+    bool followsLedger,
+    Work work)
+{
+    auto const closedSeq = closedSeq_();
+
+    std::lock_guard lock(mutex_);
+    if (stopping_ || threads_.empty())
+        return false;
+
+    auto& items = clients_[client];
+    if (limited &&
+        (size_ >= setup_.maxQueued || items.size() >= setup_.maxPerClient))
+    {
+        JLOG(j_.debug()) << "Refused a search for " << client << ": "
+                         << items.size() << " of " << size_ << " waiting";
+        if (items.empty())
+            clients_.erase(client);
+        return false;
+    }
+
+    if (items.empty())
+        turns_.push_back(client);
+    items.push_back(
+        {std::move(work), clock_type::now(), followsLedger, closedSeq});
+    queued_ = ++size_;
+    cond_.notify_one();
+    return true;
+}
+
+std::size_t
+PathFindQueue::size() const
+{
+    std::lock_guard lock(mutex_);
+    return size_;
+}
+
+void
+PathFindQueue::run()
+{
+    using namespace std::chrono;
+
+    std::unique_lock lock(mutex_);
+    while (true)
+    {
+        cond_.wait(lock, [this] { return stopping_ || !turns_.empty(); });
+        if (turns_.empty())
+            return;
+
+        // Take the oldest search of the client whose turn it is, and let
+        // the client wait for its next turn if it has more.
+        auto const client = std::move(turns_.front());
+        turns_.pop_front();
+        auto const it = clients_.find(client);
+        auto item = std::move(it->second.front());
+        it->second.pop_front();
+        if (it->second.empty())
+            clients_.erase(it);
+        else
+            turns_.push_back(client);
+        queued_ = --size_;
+
+        bool const stopping = stopping_;
+        lock.unlock();
+
+        auto const waited =
+            duration_cast<milliseconds>(clock_type::now() - item.queued);
+        wait_.notify(waited);
+
+        auto status = Status::run;
+        if (stopping)
+            status = Status::stopped;
+        else if (waited > setup_.maxWait)
+            status = Status::expired;
+        else if (item.followsLedger && closedSeq_() != item.closedSeq)
+            status = Status::stale;
+
+        if (status != Status::run)
+        {
+            JLOG(j_.debug())
+                << "Not searching for " << client << " after " << waited.count()
+                << "ms: "
+                << (status == Status::stopped
+                        ? "stopping"
+                        : status == Status::expired ? "expired" : "stale");
+        }
+
+        try
+        {
+            item.work(status);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.error()) << "Path search for " << client
+                             << " failed: " << e.what();
+        }
+        item.work = nullptr;
+
+        lock.lock();
+    }
+}
+
+PathFindQueue::Setup
+setup_PathFindQueue(Config const& config)
+{
+    PathFindQueue::Setup setup;
+    auto const& section = config.section("path_find_queue");
+    set(setup.threads, "threads", section);
+    set(setup.maxQueued, "max_queued", section);
+    set(setup.maxPerClient, "max_per_client", section);
+    std::uint32_t maxWait;
+    if (set(maxWait, "max_wait_ms", section))
+        setup.maxWait = std::chrono::milliseconds{maxWait};
+    return setup;
+}
+
+}  // namespace ripple
@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_PATHS_PATHFINDQUEUE_H_INCLUDED
+#define RIPPLE_APP_PATHS_PATHFINDQUEUE_H_INCLUDED
+
+#include <ripple/beast/insight/Collector.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/protocol/Protocol.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+class Config;
+
+/** Runs path searches for clients on threads of their own.
+
+    Searches are kept off the job queue, so that a burst of them cannot
+    hold up the processing of transactions. Every client has a queue of
+    its own, and the threads take a search from each client in turn, so
+    that a client asking for many searches delays only itself.
+
+    A search which waited longer than the queue allows, or which was asked
+    for in whatever ledger was the latest when a newer one has closed since,
+    is not run: its work is told why instead, so that it can answer the
+    client.
+*/
+class PathFindQueue
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    /** What became of a search. */
+    enum class Status {
+        run,      // The search may run now
+        expired,  // It waited too long
+        stale,    // A newer ledger closed while it waited
+        stopped   // The queue is shutting down
+    };
+
+    using Work = std::function<void(Status)>;
+
+    struct Setup
+    {
+        // Searches running at once
+        std::size_t threads = 0;
+
+        // Searches waiting, in all and for any one client
+        std::size_t maxQueued = 100;
+        std::size_t maxPerClient = 2;
+
+        // The longest a search may wait
+        std::chrono::milliseconds maxWait = std::chrono::seconds{10};
+    };
+
+    /** @param closedSeq Returns the sequence of the last closed ledger. */
+    PathFindQueue(
+        Setup const& setup,
+        std::function<LedgerIndex()> closedSeq,
+        beast::insight::Collector::ptr const& collector,
+        beast::Journal journal);
+
+    ~PathFindQueue();
+
+    PathFindQueue(PathFindQueue const&) = delete;
+    PathFindQueue&
+    operator=(PathFindQueue const&) = delete;
+
+    /** True if there are threads to run searches on. */
+    bool
+    enabled() const
+    {
+        return !threads_.empty();
+    }
+
+    /** Queue a search.
+
+        @param client Identifies the client the search is for.
+        @param limited False to admit the search even if the queue is full.
+        @param followsLedger True if the search is for the latest ledger of
+                             its kind rather than for a given ledger.
+        @param work Called once on one of the threads, unless the search
+                    is refused.
+        @return false if the search was refused.
+    */
+    bool
+    post(
+        std::string const& client,
+        bool limited,
+        bool followsLedger,
+        Work work);
+
+    /** The number of searches waiting. */
+    std::size_t
+    size() const;
+
+private:
+    struct Item
+    {
+        Work work;
+        clock_type::time_point queued;
+        bool followsLedger;
+        LedgerIndex closedSeq;
+    };
+
+    void
+    run();
+
+    Setup const setup_;
+    std::function<LedgerIndex()> const closedSeq_;
+    beast::Journal const j_;
+
+    beast::insight::Event wait_;
+    beast::insight::Gauge queued_;
+
+    std::mutex mutable mutex_;
+    std::condition_variable cond_;
+    bool stopping_ = false;
+
+    // The waiting searches of each client, and the clients with searches
+    // waiting in the order they will be served.
+    std::map<std::string, std::deque<Item>> clients_;
+    std::deque<std::string> turns_;
+    std::size_t size_ = 0;
+
+    std::vector<std::thread> threads_;
+};
+
+/** Build the setup of the path finding queue from [path_find_queue]. */
+PathFindQueue::Setup
+setup_PathFindQueue(Config const& config);
+
+}  // namespace ripple
+
+#endif
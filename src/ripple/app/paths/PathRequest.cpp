@@ -438,6 +438,29 @@ PathRequest::parseJson(Json::Value const& jvParams)
     return PFR_PJ_NOCHANGE;
 }
 
+std::string
+PathRequest::searchKey()
+{
+    std::lock_guard sl(mLock);
+
+    if (!raSrcAccount || !raDstAccount)
+        return {};
+
+    std::string key = to_string(*raSrcAccount);
+    key += ' ';
+    key += to_string(*raDstAccount);
+    key += ' ';
+    key += saDstAmount.getFullText();
+    if (saSendMax)
+    {
+        key += ' ';
+        key += saSendMax->getFullText();
+    }
+    if (convert_all_)
+        key += " all";
+    return key;
+}
+
 Json::Value
 PathRequest::doClose(Json::Value const&)
 {
@@ -458,13 +481,13 @@ PathRequest::doStatus(Json::Value const&)
 std::unique_ptr<Pathfinder> const&
 PathRequest::getPathFinder(
     std::shared_ptr<RippleLineCache> const& cache,
-    hash_map<Currency, std::unique_ptr<Pathfinder>>& currency_map,
+    Pathfinders& pathfinders,
     Currency const& currency,
     STAmount const& dst_amount,
     int const level)
 {
-    auto i = currency_map.find(currency);
-    if (i != currency_map.end())
+    auto i = pathfinders.find({currency, level});
+    if (i != pathfinders.end())
         return i->second;
     auto pathfinder = std::make_unique<Pathfinder>(
         cache,
@@ -479,14 +502,15 @@ PathRequest::getPathFinder(
         pathfinder->computePathRanks(max_paths_);
     else
         pathfinder.reset();  // It's a bad request - clear it.
-    return currency_map[currency] = std::move(pathfinder);
+    return pathfinders[{currency, level}] = std::move(pathfinder);
 }
 
 bool
 PathRequest::findPaths(
     std::shared_ptr<RippleLineCache> const& cache,
     int const level,
-    Json::Value& jvArray)
+    Json::Value& jvArray,
+    Pathfinders* shared)
 {
     auto sourceCurrencies = sciSourceCurrencies;
     if (sourceCurrencies.empty())
@@ -509,7 +533,8 @@ PathRequest::findPaths(
         ? STAmount(
               saDstAmount.issue(), STAmount::cMaxValue, STAmount::cMaxOffset)
         : saDstAmount;
-    hash_map<Currency, std::unique_ptr<Pathfinder>> currency_map;
+    Pathfinders local;
+    auto& pathfinders = shared ? *shared : local;
     for (auto const& issue : sourceCurrencies)
     {
         JLOG(m_journal.debug())
@@ -517,7 +542,7 @@ PathRequest::findPaths(
             << " Trying to find paths: " << STAmount(issue, 1).getFullText();
 
         auto& pathfinder = getPathFinder(
-            cache, currency_map, issue.currency, dst_amount, level);
+            cache, pathfinders, issue.currency, dst_amount, level);
         if (!pathfinder)
         {
             assert(false);
@@ -626,7 +651,10 @@ PathRequest::findPaths(
 }
 
 Json::Value
-PathRequest::doUpdate(std::shared_ptr<RippleLineCache> const& cache, bool fast)
+PathRequest::doUpdate(
+    std::shared_ptr<RippleLineCache> const& cache,
+    bool fast,
+    Pathfinders* shared)
 {
     using namespace std::chrono;
     JLOG(m_journal.debug())
@@ -697,7 +725,11 @@ PathRequest::doUpdate(std::shared_ptr<RippleLineCache> const& cache, bool fast)
     JLOG(m_journal.debug()) << iIdentifier << " processing at level " << iLevel;
 
     Json::Value jvArray = Json::arrayValue;
-    if (findPaths(cache, iLevel, jvArray))
+    auto const searchStart = steady_clock::now();
+    bool const found = findPaths(cache, iLevel, jvArray, shared);
+    mOwner.reportSearch(
+        duration_cast<milliseconds>(steady_clock::now() - searchStart));
+    if (found)
     {
         bLastSuccess = jvArray.size() != 0;
         newStatus[jss::alternatives] = std::move(jvArray);
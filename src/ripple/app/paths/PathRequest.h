@@ -30,6 +30,7 @@
 #include <map>
 #include <mutex>
 #include <set>
+#include <string>
 #include <utility>
 
 namespace ripple {
@@ -60,6 +61,16 @@ public:
     using ref = const pointer&;
     using wref = const wptr&;
 
+    /** Pathfinders which have searched one ledger, by source currency and
+        search level.
+
+        Requests with the same searchKey() find the same paths, so while
+        they are updated one after another in the same ledger they can
+        share their Pathfinders instead of each repeating the search.
+    */
+    using Pathfinders =
+        std::map<std::pair<Currency, int>, std::unique_ptr<Pathfinder>>;
+
 public:
     // VFALCO TODO Break the cyclic dependency on InfoSub
 
@@ -103,7 +114,20 @@ public:
 
     // update jvStatus
     Json::Value
-    doUpdate(std::shared_ptr<RippleLineCache> const&, bool fast);
+    doUpdate(
+        std::shared_ptr<RippleLineCache> const&,
+        bool fast,
+        Pathfinders* shared = nullptr);
+
+    /** Identifies the paths the request searches for.
+
+        @return A key which is the same for any two requests that search
+                for the same paths, or an empty string if the request is
+                not valid.
+    */
+    std::string
+    searchKey();
+
     InfoSub::pointer
     getSubscriber();
     bool
@@ -118,7 +142,7 @@ private:
     std::unique_ptr<Pathfinder> const&
     getPathFinder(
         std::shared_ptr<RippleLineCache> const&,
-        hash_map<Currency, std::unique_ptr<Pathfinder>>&,
+        Pathfinders&,
         Currency const&,
         STAmount const&,
         int const);
@@ -127,7 +151,11 @@ private:
         Returns false if the source currencies are inavlid.
     */
     bool
-    findPaths(std::shared_ptr<RippleLineCache> const&, int const, Json::Value&);
+    findPaths(
+        std::shared_ptr<RippleLineCache> const&,
+        int const,
+        Json::Value&,
+        Pathfinders* shared);
 
     int
     parseJson(Json::Value const&);
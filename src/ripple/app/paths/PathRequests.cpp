@@ -49,11 +49,80 @@ PathRequests::getLineCache(
          ((lgrSeq + 8) < lineSeq)) ||  // we jumped way back for some reason
         (lgrSeq > (lineSeq + 8)))      // we jumped way forward for some reason
     {
-        mLineCache = std::make_shared<RippleLineCache>(ledger);
+        // The graph is brought up to each ledger as it closes, and is
+        // used only once it is there
+        mLineCache =
+            std::make_shared<RippleLineCache>(ledger, graph_.current());
     }
     return mLineCache;
 }
 
+std::shared_ptr<TrustLineGraph::Snapshot const>
+PathRequests::getTrustLines(ReadView const& ledger) const
+{
+    if (ledger.open())
+        return nullptr;
+    auto graph = graph_.current();
+    if (!graph || graph->hash() != ledger.info().hash)
+        return nullptr;
+    return graph;
+}
+
+void
+PathRequests::updateTrustLines(std::shared_ptr<ReadView const> const& ledger)
+{
+    if (!ledger || ledger->open())
+        return;
+
+    {
+        std::lock_guard sl(graphLock_);
+        graphPending_ = ledger;
+        if (graphUpdating_)
+            return;
+        graphUpdating_ = true;
+    }
+
+    if (!app_.getJobQueue().addJob(
+            jtTRUST_LINES, "PathRequests::updateTrustLines", [this](Job&) {
+                updateGraph();
+            }))
+    {
+        std::lock_guard sl(graphLock_);
+        graphPending_.reset();
+        graphUpdating_ = false;
+    }
+}
+
+void
+PathRequests::updateGraph()
+{
+    using namespace std::chrono;
+
+    for (;;)
+    {
+        std::shared_ptr<ReadView const> ledger;
+        {
+            std::lock_guard sl(graphLock_);
+            ledger = std::move(graphPending_);
+            graphPending_.reset();
+            if (!ledger)
+            {
+                graphUpdating_ = false;
+                return;
+            }
+        }
+
+        auto const start = steady_clock::now();
+        if (auto const graph = graph_.update(ledger))
+        {
+            mGraphUpdate.notify(
+                duration_cast<milliseconds>(steady_clock::now() - start));
+            mGraphLines.set(graph->size());
+            mGraphBytes.set(graph->bytes());
+        }
+    }
+}
+
 void
 PathRequests::updateAll(
     std::shared_ptr<ReadView const> const& inLedger,
@@ -73,18 +142,19 @@ PathRequests::updateAll(
     }
 
     bool newRequests = app_.getLedgerMaster().isNewPathRequest();
-    bool mustBreak = false;
+    std::atomic<bool> mustBreak{false};
 
     JLOG(mJournal.trace()) << "updateAll seq=" << cache->getLedger()->seq()
                            << ", " << requests.size() << " requests";
 
-    int processed = 0, removed = 0;
+    std::atomic<int> processed{0}, removed{0};
 
-    do
-    {
-        for (auto const& wr : requests)
+    // Update one group of requests, which share their Pathfinders
+    auto updateGroup = [&](std::vector<PathRequest::wptr> const& group) {
+        PathRequest::Pathfinders pathfinders;
+        for (auto const& wr : group)
         {
-            if (shouldCancel())
+            if (shouldCancel() || mustBreak)
                 break;
 
             auto request = wr.lock();
@@ -102,7 +172,7 @@ PathRequests::updateAll(
                         if (!ipSub->getConsumer().warn())
                         {
                             Json::Value update =
-                                request->doUpdate(cache, false);
+                                request->doUpdate(cache, false, &pathfinders);
                             request->updateComplete();
                             update[jss::type] = "path_find";
                             ipSub->send(update, false);
@@ -113,7 +183,7 @@ PathRequests::updateAll(
                     else if (request->hasCompletion())
                     {
                         // One-shot request with completion function
-                        request->doUpdate(cache, false);
+                        request->doUpdate(cache, false, &pathfinders);
                         request->updateComplete();
                         ++processed;
                     }
@@ -141,18 +211,30 @@ PathRequests::updateAll(
                 requests_.erase(ret, requests_.end());
             }
 
-            mustBreak =
-                !newRequests && app_.getLedgerMaster().isNewPathRequest();
-
             // We weren't handling new requests and then
             // there was a new request
-            if (mustBreak)
-                break;
+            if (!newRequests && app_.getLedgerMaster().isNewPathRequest())
+                mustBreak = true;
         }
+    };
+
+    auto const threads = app_.config().PATH_SEARCH_THREADS;
+
+    do
+    {
+        auto const groups = group(requests);
+
+        app_.getJobQueue().parallelFor(
+            jtPATH_SEARCH,
+            "PathRequest::updateGroup",
+            groups.size(),
+            threads,
+            [&](std::size_t i) { updateGroup(groups[i]); });
 
         if (mustBreak)
         {  // a new request came in while we were working
             newRequests = true;
+            mustBreak = false;
         }
         else if (newRequests)
         {  // we only did new requests, so we always need a last pass
@@ -180,6 +262,32 @@ PathRequests::updateAll(
                            << " processed and " << removed << " removed";
 }
 
+std::vector<std::vector<PathRequest::wptr>>
+PathRequests::group(std::vector<PathRequest::wptr> const& requests)
+{
+    std::vector<std::vector<PathRequest::wptr>> groups;
+    hash_map<std::string, std::size_t> keys;
+    for (auto const& wr : requests)
+    {
+        std::string key;
+        if (auto const request = wr.lock())
+            key = request->searchKey();
+
+        // Requests which are gone or not valid are not grouped
+        if (key.empty())
+        {
+            groups.push_back({wr});
+            continue;
+        }
+
+        auto const [it, inserted] = keys.emplace(key, groups.size());
+        if (inserted)
+            groups.emplace_back();
+        groups[it->second].push_back(wr);
+    }
+    return groups;
+}
+
 void
 PathRequests::insertPathRequest(PathRequest::pointer const& req)
 {
@@ -260,7 +368,7 @@ PathRequests::doLegacyPathRequest(
     std::shared_ptr<ReadView const> const& inLedger,
     Json::Value const& request)
 {
-    auto cache = std::make_shared<RippleLineCache>(inLedger);
+    auto cache = std::make_shared<RippleLineCache>(inLedger, graph_.current());
 
     auto req = std::make_shared<PathRequest>(
         app_, [] {}, consumer, ++mLastIdentifier, *this, mJournal);
@@ -271,4 +379,34 @@ PathRequests::doLegacyPathRequest(
     return std::move(jvRes);
 }
 
+bool
+PathRequests::queueLegacyPathRequest(
+    Resource::Consumer& consumer,
+    bool limited,
+    bool followsLedger,
+    std::shared_ptr<ReadView const> const& inLedger,
+    Json::Value const& request,
+    std::function<void(Json::Value)> done)
+{
+    return queue_.post(
+        consumer.to_string(),
+        limited,
+        followsLedger,
+        [this, &consumer, inLedger, request, done = std::move(done)](
+            PathFindQueue::Status status) {
+            if (status == PathFindQueue::Status::run)
+                done(doLegacyPathRequest(consumer, inLedger, request));
+            else
+                done(rpcError(rpcTOO_BUSY));
+        });
+}
+
+LedgerIndex
+PathRequests::closedSeq() const
+{
+    if (auto const ledger = app_.getLedgerMaster().getClosedLedger())
+        return ledger->info().seq;
+    return 0;
+}
+
 }  // namespace ripple
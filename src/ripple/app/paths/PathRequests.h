@@ -21,8 +21,10 @@
 #define RIPPLE_APP_PATHS_PATHREQUESTS_H_INCLUDED
 
 #include <ripple/app/main/Application.h>
+#include <ripple/app/paths/PathFindQueue.h>
 #include <ripple/app/paths/PathRequest.h>
 #include <ripple/app/paths/RippleLineCache.h>
+#include <ripple/app/paths/TrustLineGraph.h>
 #include <ripple/core/Job.h>
 #include <atomic>
 #include <mutex>
@@ -38,14 +40,31 @@ public:
         Application& app,
         beast::Journal journal,
         beast::insight::Collector::ptr const& collector)
-        : app_(app), mJournal(journal), mLastIdentifier(0)
+        : app_(app)
+        , mJournal(journal)
+        , graph_(app, journal)
+        , queue_(
+              setup_PathFindQueue(app.config()),
+              [this]() { return closedSeq(); },
+              collector,
+              journal)
+        , mLastIdentifier(0)
     {
         mFast = collector->make_event("pathfind_fast");
         mFull = collector->make_event("pathfind_full");
+        mSearch = collector->make_event("pathfind_search");
+        mGraphUpdate = collector->make_event("pathfind_graph_update");
+        mGraphLines = collector->make_gauge("pathfind_graph_lines");
+        mGraphBytes = collector->make_gauge("pathfind_graph_bytes");
     }
 
     /** Update all of the contained PathRequest instances.
 
+        Requests which search for the same paths are updated one after
+        another, sharing their Pathfinders, and with [path_search_threads]
+        configured different groups of requests are updated in parallel,
+        by the calling thread and jtPATH_SEARCH jobs.
+
         @param ledger Ledger we are pathfinding in.
         @param shouldCancel Invocable that returns whether to cancel.
      */
@@ -59,6 +78,24 @@ public:
         std::shared_ptr<ReadView const> const& ledger,
         bool authoritative);
 
+    /** Returns the trust line graph of a closed ledger if the graph has
+        been brought up to it, and nullptr otherwise.
+    */
+    std::shared_ptr<TrustLineGraph::Snapshot const>
+    getTrustLines(ReadView const& ledger) const;
+
+    /** Bring the trust line graph up to a closed ledger, on a job.
+
+        Called as each ledger closes, so that the graph is there for path
+        requests and gateway_balances whether or not either has been used.
+
+        Until the job is done the previous snapshot remains current. If
+        more ledgers close while it runs, only the newest is brought up to
+        next.
+    */
+    void
+    updateTrustLines(std::shared_ptr<ReadView const> const& ledger);
+
     // Create a new-style path request that pushes
     // updates to a subscriber
     Json::Value
@@ -86,6 +123,33 @@ public:
         std::shared_ptr<ReadView const> const& inLedger,
         Json::Value const& request);
 
+    /** True if searches in a given ledger run on threads of their own. */
+    bool
+    queueEnabled() const
+    {
+        return queue_.enabled();
+    }
+
+    /** Queue an old-style path request with the ledger specified by the
+        caller, to run on the path finding threads.
+
+        @param limited False if the client may queue any number of them.
+        @param followsLedger True if the ledger was chosen as the latest
+                             of its kind, so that the request is stale once
+                             a newer ledger has closed.
+        @param done Called with the result, or with an error if the request
+                    waited too long or became stale.
+        @return false if the request was refused; done is not called.
+    */
+    bool
+    queueLegacyPathRequest(
+        Resource::Consumer& consumer,
+        bool limited,
+        bool followsLedger,
+        std::shared_ptr<ReadView const> const& inLedger,
+        Json::Value const& request,
+        std::function<void(Json::Value)> done);
+
     void
     reportFast(std::chrono::milliseconds ms)
     {
@@ -98,15 +162,43 @@ public:
         mFull.notify(ms);
     }
 
+    /** Report how long one search for paths took. */
+    void
+    reportSearch(std::chrono::milliseconds ms)
+    {
+        mSearch.notify(ms);
+    }
+
 private:
     void
     insertPathRequest(PathRequest::pointer const&);
 
+    /** Split requests into groups which search for the same paths.
+
+        The groups are in the order of their first request, and the
+        requests of a group in the order given.
+    */
+    static std::vector<std::vector<PathRequest::wptr>>
+    group(std::vector<PathRequest::wptr> const& requests);
+
+    // The sequence of the last closed ledger, or zero if there is none
+    LedgerIndex
+    closedSeq() const;
+
+    // Bring the trust line graph up to each ledger given to
+    // updateTrustLines until there are no more
+    void
+    updateGraph();
+
     Application& app_;
     beast::Journal mJournal;
 
     beast::insight::Event mFast;
     beast::insight::Event mFull;
+    beast::insight::Event mSearch;
+    beast::insight::Event mGraphUpdate;
+    beast::insight::Gauge mGraphLines;
+    beast::insight::Gauge mGraphBytes;
 
     // Track all requests
     std::vector<PathRequest::wptr> requests_;
@@ -114,6 +206,19 @@ private:
     // Use a RippleLineCache
     std::shared_ptr<RippleLineCache> mLineCache;
 
+    // The trust lines of every account, shared by all the caches
+    TrustLineGraph graph_;
+
+    // The newest ledger the graph is to be brought up to, and whether a
+    // job is doing so. Kept apart from mLock, which is never held while
+    // the graph is updated.
+    std::mutex graphLock_;
+    std::shared_ptr<ReadView const> graphPending_;
+    bool graphUpdating_ = false;
+
+    // Runs the searches of old-style requests in a given ledger
+    PathFindQueue queue_;
+
     std::atomic<int> mLastIdentifier;
 
     std::recursive_mutex mLock;
@@ -23,11 +23,13 @@
 #include <ripple/app/paths/RippleCalc.h>
 #include <ripple/app/paths/RippleLineCache.h>
 #include <ripple/app/paths/Tuning.h>
+#include <ripple/app/paths/impl/StrandFlow.h>
 #include <ripple/basics/Log.h>
 #include <ripple/core/Config.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/json/to_string.h>
 #include <ripple/ledger/PaymentSandbox.h>
+#include <ripple/protocol/Feature.h>
 #include <tuple>
 
 /*
@@ -334,7 +336,72 @@ Pathfinder::getPathLiquidity(
     STAmount const& minDstAmount,  // IN:  The minimum output this path must
                                    //      deliver to be worth keeping.
     STAmount& amountOut,           // OUT: The actual liquidity along the path.
-    uint64_t& qualityOut) const    // OUT: The returned initial quality
+    uint64_t& qualityOut)          // OUT: The returned initial quality
+{
+    ++mRanked;
+    qualityOut = 0;
+
+    // Expand the path to the strand the payment engine builds for it, with
+    // the same arguments rippleCalculate passes to flow.
+    std::pair<TER, Strand> sp;
+    try
+    {
+        bool const useSendMax = mSrcAmount >= beast::zero ||
+            mSrcAmount.getCurrency() != mDstAmount.getCurrency() ||
+            mSrcAmount.getIssuer() != mSrcAccount;
+        sp = toStrand(
+            *mLedger,
+            mSrcAccount,
+            mDstAccount,
+            mDstAmount.issue(),
+            boost::none,
+            useSendMax ? boost::optional<Issue>(mSrcAmount.issue())
+                       : boost::none,
+            path,
+            mLedger->rules().enabled(featureOwnerPaysFee),
+            /* offerCrossing */ false,
+            j_);
+    }
+    catch (std::exception const&)
+    {
+        return computeLiquidity(path, minDstAmount, amountOut, qualityOut);
+    }
+
+    auto& [ter, strand] = sp;
+    if (ter != tesSUCCESS)
+        return ter;
+
+    // A strand through a book without any offers can deliver nothing
+    if (!qualityUpperBound(*mLedger, strand))
+    {
+        ++mDry;
+        return tecPATH_DRY;
+    }
+
+    for (auto const& sl : mStrandLiquidity)
+    {
+        if (sl.minDstAmount == minDstAmount && sl.strand == strand)
+        {
+            ++mReused;
+            amountOut = sl.amount;
+            qualityOut = sl.quality;
+            return sl.result;
+        }
+    }
+
+    auto const result =
+        computeLiquidity(path, minDstAmount, amountOut, qualityOut);
+    mStrandLiquidity.push_back(
+        {std::move(strand), minDstAmount, result, amountOut, qualityOut});
+    return result;
+}
+
+TER
+Pathfinder::computeLiquidity(
+    STPath const& path,
+    STAmount const& minDstAmount,
+    STAmount& amountOut,
+    uint64_t& qualityOut) const
 {
     STPathSet pathSet;
     pathSet.push_back(path);
@@ -536,6 +603,10 @@ Pathfinder::rankPaths(
         }
     }
 
+    JLOG(j_.debug()) << "rankPaths: " << mRanked << " paths ranked, "
+                     << mDry << " dry, " << mReused
+                     << " reusing an evaluated strand";
+
     // Sort paths by:
     //    cost of path (when considering quality)
     //    width of path
@@ -715,10 +786,22 @@ Pathfinder::getPathsOut(
     if (!inserted)
         return it->second;
 
+    // The destination only matters to the count in its own currency, so
+    // any search in this ledger which ends there may have counted it.
+    AccountID const dstKey = isDstCurrency ? dstAccount : AccountID();
+    if (auto const count = mRLCache->getPathsOut(issue, dstKey))
+    {
+        it->second = *count;
+        return *count;
+    }
+
     auto sleAccount = mLedger->read(keylet::account(account));
 
     if (!sleAccount)
+    {
+        mRLCache->setPathsOut(issue, dstKey, 0);
         return 0;
+    }
 
     int aFlags = sleAccount->getFieldU32(sfFlags);
     bool const bAuthRequired = (aFlags & lsfRequireAuth) != 0;
@@ -764,6 +847,7 @@ Pathfinder::getPathsOut(
         }
     }
     it->second = count;
+    mRLCache->setPathsOut(issue, dstKey, count);
     return count;
 }
 
@@ -22,6 +22,7 @@
 
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/paths/RippleLineCache.h>
+#include <ripple/app/paths/impl/Steps.h>
 #include <ripple/core/LoadEvent.h>
 #include <ripple/protocol/STAmount.h>
 #include <ripple/protocol/STPathSet.h>
@@ -120,6 +121,7 @@ private:
       computePathRanks:
           rippleCalculate
           getPathLiquidity:
+              toStrand
               rippleCalculate
 
       getBestPaths
@@ -160,7 +162,15 @@ private:
         STAmount const& minDstAmount,  // IN:  The minimum output this path must
                                        //      deliver to be worth keeping.
         STAmount& amountOut,           // OUT: The actual liquidity on the path.
-        uint64_t& qualityOut) const;   // OUT: The returned initial quality
+        uint64_t& qualityOut);         // OUT: The returned initial quality
+
+    // Run the payment engine over a single path.
+    TER
+    computeLiquidity(
+        STPath const& path,
+        STAmount const& minDstAmount,
+        STAmount& amountOut,
+        uint64_t& qualityOut) const;
 
     // Does this path end on an account-to-account link whose last account has
     // set the "no ripple" flag on the link?
@@ -203,6 +213,24 @@ private:
 
     hash_map<Issue, int> mPathsOutCountMap;
 
+    // The liquidity found for each strand. Different paths often expand to
+    // the same strand, which then only has to be evaluated once.
+    struct StrandLiquidity
+    {
+        Strand strand;
+        STAmount minDstAmount;
+        TER result;
+        STAmount amount;
+        std::uint64_t quality;
+    };
+    std::vector<StrandLiquidity> mStrandLiquidity;
+
+    // How many paths were ranked, found dry without running the payment
+    // engine, and found to expand to a strand already evaluated.
+    std::size_t mRanked = 0;
+    std::size_t mDry = 0;
+    std::size_t mReused = 0;
+
     Application& app_;
     beast::Journal const j_;
 
@@ -22,8 +22,13 @@
 
 namespace ripple {
 
-RippleLineCache::RippleLineCache(std::shared_ptr<ReadView const> const& ledger)
+RippleLineCache::RippleLineCache(
+    std::shared_ptr<ReadView const> const& ledger,
+    std::shared_ptr<TrustLineGraph::Snapshot const> graph)
 {
+    if (graph && !ledger->open() && graph->hash() == ledger->info().hash)
+        graph_ = std::move(graph);
+
     // We want the caching that OpenView provides
     // And we need to own a shared_ptr to the input view
     // VFALCO TODO This should be a CachedLedger
@@ -35,15 +40,58 @@ RippleLineCache::getRippleLines(AccountID const& accountID)
 {
     AccountKey key(accountID, hasher_(accountID));
 
-    std::lock_guard sl(mLock);
+    {
+        std::lock_guard sl(mLock);
+        if (auto const it = lines_.find(key); it != lines_.end())
+            return it->second;
+    }
 
-    auto [it, inserted] =
-        lines_.emplace(key, std::vector<RippleState::pointer>());
+    // Read the lines without holding the lock, so that Pathfinders working
+    // on other threads are not held up. If two of them read the lines of
+    // the same account, the first to finish is kept.
+    std::vector<RippleState::pointer> items;
+    if (graph_)
+    {
+        if (auto const lines = graph_->lines(accountID))
+        {
+            items.reserve(lines->size());
+            for (auto const& line : *lines)
+            {
+                auto item = RippleState::makeItem(
+                    accountID,
+                    mLedger->read(Keylet(ltRIPPLE_STATE, line.first.second)));
+                if (item)
+                    items.push_back(std::move(item));
+            }
+        }
+    }
+    else
+    {
+        items = getRippleStateItems(accountID, *mLedger);
+    }
 
-    if (inserted)
-        it->second = getRippleStateItems(accountID, *mLedger);
+    std::lock_guard sl(mLock);
+    return lines_.emplace(key, std::move(items)).first->second;
+}
 
+boost::optional<int>
+RippleLineCache::getPathsOut(Issue const& issue, AccountID const& dstAccount)
+{
+    std::lock_guard sl(pathsOutLock_);
+    auto const it = pathsOut_.find({issue, dstAccount});
+    if (it == pathsOut_.end())
+        return boost::none;
     return it->second;
 }
 
+void
+RippleLineCache::setPathsOut(
+    Issue const& issue,
+    AccountID const& dstAccount,
+    int count)
+{
+    std::lock_guard sl(pathsOutLock_);
+    pathsOut_.emplace(std::make_pair(issue, dstAccount), count);
+}
+
 }  // namespace ripple
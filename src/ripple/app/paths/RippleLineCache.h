@@ -22,7 +22,10 @@
 
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/paths/RippleState.h>
+#include <ripple/app/paths/TrustLineGraph.h>
 #include <ripple/basics/hardened_hash.h>
+#include <ripple/protocol/Issue.h>
+#include <boost/optional.hpp>
 #include <cstddef>
 #include <memory>
 #include <mutex>
@@ -34,7 +37,16 @@ namespace ripple {
 class RippleLineCache
 {
 public:
-    explicit RippleLineCache(std::shared_ptr<ReadView const> const& l);
+    /** Create a cache of the trust lines in a ledger.
+
+        @param l The ledger.
+        @param graph The trust line graph. If it is for this ledger, the
+                     lines of each account are found from it instead of
+                     the account's owner directory.
+    */
+    explicit RippleLineCache(
+        std::shared_ptr<ReadView const> const& l,
+        std::shared_ptr<TrustLineGraph::Snapshot const> graph = nullptr);
 
     std::shared_ptr<ReadView const> const&
     getLedger() const
@@ -45,11 +57,36 @@ public:
     std::vector<RippleState::pointer> const&
     getRippleLines(AccountID const& accountID);
 
+    /** Returns the trust line graph of the ledger, or nullptr if the cache
+        was not given one for it.
+    */
+    std::shared_ptr<TrustLineGraph::Snapshot const> const&
+    getGraph() const
+    {
+        return graph_;
+    }
+
+    /** Returns the number of useful paths out of an issue, if a Pathfinder
+        has already counted them in this ledger.
+
+        @param issue The currency and the account the paths leave from.
+        @param dstAccount The destination of the payment, if the currency
+                          is the destination currency, and zero otherwise.
+    */
+    boost::optional<int>
+    getPathsOut(Issue const& issue, AccountID const& dstAccount);
+
+    /** Remember the number of useful paths out of an issue. */
+    void
+    setPathsOut(Issue const& issue, AccountID const& dstAccount, int count);
+
 private:
     std::mutex mLock;
+    std::mutex pathsOutLock_;
 
     ripple::hardened_hash<> hasher_;
     std::shared_ptr<ReadView const> mLedger;
+    std::shared_ptr<TrustLineGraph::Snapshot const> graph_;
 
     struct AccountKey
     {
@@ -92,6 +129,8 @@ private:
 
     hash_map<AccountKey, std::vector<RippleState::pointer>, AccountKey::Hash>
         lines_;
+
+    hash_map<std::pair<Issue, AccountID>, int, beast::uhash<>> pathsOut_;
 };
 
 }  // namespace ripple
@@ -0,0 +1,355 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/app/paths/TrustLineGraph.h>
+#include <ripple/basics/Log.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/protocol/LedgerFormats.h>
+#include <ripple/protocol/STAmount.h>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+// How many ledgers the graph is brought forward through, one at a time,
+// before it is cheaper to build it again.
+constexpr LedgerIndex maxGap = 256;
+
+using Accounts = PersistentMap<AccountID, TrustLineGraph::Lines>;
+
+bool
+addLine(
+    Accounts& accounts,
+    AccountID const& account,
+    TrustLineGraph::Lines::key_type const& key,
+    AccountID const& peer)
+{
+    TrustLineGraph::Lines lines;
+    if (auto const p = accounts.lookup(account))
+        lines = *p;
+    if (!lines.insert(key, peer))
+        return false;
+    accounts.insert_or_assign(account, std::move(lines));
+    return true;
+}
+
+bool
+removeLine(
+    Accounts& accounts,
+    AccountID const& account,
+    TrustLineGraph::Lines::key_type const& key)
+{
+    auto const p = accounts.lookup(account);
+    if (!p || p->count(key) == 0)
+        return false;
+    if (p->size() == 1)
+    {
+        accounts.erase(account);
+        return true;
+    }
+    auto lines = *p;
+    lines.erase(key);
+    accounts.insert_or_assign(account, std::move(lines));
+    return true;
+}
+
+using AllTotals =
+    PersistentMap<std::pair<AccountID, Currency>, TrustLineGraph::Totals>;
+
+// The fields of a trust line the totals are kept from
+struct LineState
+{
+    STAmount balance;
+    STAmount lowLimit;
+    STAmount highLimit;
+};
+
+LineState
+lineState(STObject const& fields)
+{
+    return {fields[sfBalance], fields[sfLowLimit], fields[sfHighLimit]};
+}
+
+// Add one side of a trust line to the totals of its account, or take it
+// away from them
+void
+tally(AllTotals& totals, LineState const& line, bool high, bool add)
+{
+    // The same view of the line a RippleState gives the account
+    auto const& account = (high ? line.highLimit : line.lowLimit).getIssuer();
+    auto const& limit = high ? line.highLimit : line.lowLimit;
+    auto const& limitPeer = high ? line.lowLimit : line.highLimit;
+    STAmount const balance = high ? -line.balance : line.balance;
+
+    std::pair<AccountID, Currency> const at{
+        account, line.balance.getCurrency()};
+    TrustLineGraph::Totals t;
+    if (auto const p = totals.lookup(at))
+        t = *p;
+    assert(add || t.lines != 0);
+    if (!add && t.lines == 0)
+        return;
+
+    auto const count = [add](std::uint32_t& n) { add ? ++n : --n; };
+    count(t.lines);
+    if (balance > beast::zero || (limitPeer && -balance < limitPeer))
+        count(t.sendable);
+    if (balance < limit)
+        count(t.receivable);
+
+    if (t.lines == 0)
+        totals.erase(at);
+    else
+        totals.insert_or_assign(at, std::move(t));
+}
+
+// Returns one of the objects of an affected node, or nullptr
+STObject const*
+nodeFields(STObject const& node, SField const& field)
+{
+    auto const index = node.getFieldIndex(field);
+    if (index == -1)
+        return nullptr;
+    return dynamic_cast<STObject const*>(&node.peekAtIndex(index));
+}
+
+// A node of a PersistentMap holds its value, two children, a priority and
+// a reference count, and the allocator adds about two words to it.
+template <class Value>
+constexpr std::size_t nodeBytes = sizeof(Value) + 4 * sizeof(void*) +
+    sizeof(std::uint32_t) + sizeof(std::size_t);
+
+}  // namespace
+
+std::size_t
+TrustLineGraph::Snapshot::bytes() const
+{
+    // Every trust line is in the lines of both of its accounts
+    return accounts_.size() * nodeBytes<Accounts::value_type> +
+        2 * size_ * nodeBytes<Lines::value_type> +
+        totals_.size() * nodeBytes<AllTotals::value_type>;
+}
+
+TrustLineGraph::TrustLineGraph(Application& app, beast::Journal journal)
+    : app_(app), j_(journal)
+{
+}
+
+std::shared_ptr<TrustLineGraph::Snapshot const>
+TrustLineGraph::update(std::shared_ptr<ReadView const> const& ledger)
+{
+    using namespace std::chrono;
+
+    if (!ledger || ledger->open())
+        return nullptr;
+
+    std::lock_guard lock(updateLock_);
+
+    auto snap = current();
+    if (snap && snap->hash_ == ledger->info().hash)
+        return snap;
+
+    auto const start = steady_clock::now();
+
+    // The ledgers after the snapshot, up to this one, newest first
+    std::vector<std::shared_ptr<ReadView const>> chain;
+    if (snap && snap->seq_ < ledger->seq() &&
+        ledger->seq() - snap->seq_ <= maxGap)
+    {
+        chain.push_back(ledger);
+        while (chain.back()->seq() > snap->seq_ + 1)
+        {
+            auto const& child = chain.back()->info();
+            auto parent = app_.getLedgerMaster().getLedgerBySeq(child.seq - 1);
+            if (!parent || parent->info().hash != child.parentHash)
+                break;
+            chain.push_back(std::move(parent));
+        }
+        if (chain.back()->info().parentHash != snap->hash_)
+            chain.clear();
+    }
+
+    bool const rebuilt = chain.empty();
+    if (rebuilt)
+        snap = build(*ledger);
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+        snap = apply(*snap, **it);
+
+    std::atomic_store(&current_, snap);
+
+    JLOG(j_.debug()) << (rebuilt ? "Built" : "Updated")
+                     << " trust line graph for ledger " << snap->seq_
+                     << " in "
+                     << duration_cast<milliseconds>(
+                            steady_clock::now() - start)
+                            .count()
+                     << "ms: " << snap->accounts() << " accounts, "
+                     << snap->size() << " lines, about "
+                     << snap->bytes() / 1024 << "KB";
+    return snap;
+}
+
+std::shared_ptr<TrustLineGraph::Snapshot const>
+TrustLineGraph::build(ReadView const& ledger) const
+{
+    // Fill each account's lines while no other map shares them
+    hash_map<AccountID, Lines> lines;
+    std::size_t size = 0;
+    AllTotals totals;
+    for (auto const& sle : ledger.sles)
+    {
+        if (sle->getType() != ltRIPPLE_STATE)
+            continue;
+
+        auto const line = lineState(*sle);
+        auto const& low = line.lowLimit;
+        auto const& high = line.highLimit;
+        Lines::key_type const key{low.getCurrency(), sle->key()};
+        lines[low.getIssuer()].insert(key, high.getIssuer());
+        lines[high.getIssuer()].insert(key, low.getIssuer());
+        tally(totals, line, false, true);
+        tally(totals, line, true, true);
+        ++size;
+    }
+
+    auto snap = std::make_shared<Snapshot>();
+    snap->totals_ = std::move(totals);
+    snap->seq_ = ledger.seq();
+    snap->hash_ = ledger.info().hash;
+    snap->size_ = size;
+    for (auto& [account, l] : lines)
+        snap->accounts_.insert(account, std::move(l));
+    return snap;
+}
+
+std::shared_ptr<TrustLineGraph::Snapshot const>
+TrustLineGraph::apply(Snapshot const& parent, ReadView const& ledger)
+{
+    struct Change
+    {
+        std::uint32_t index;
+        uint256 key;
+        boost::optional<LineState> before;
+        boost::optional<LineState> after;
+    };
+
+    std::vector<Change> changes;
+    for (auto const& [tx, meta] : ledger.txs)
+    {
+        if (!meta)
+            continue;
+
+        auto const txIndex = meta->getFieldU32(sfTransactionIndex);
+        for (auto const& node : meta->getFieldArray(sfAffectedNodes))
+        {
+            if (node.getFieldU16(sfLedgerEntryType) != ltRIPPLE_STATE)
+                continue;
+
+            Change c{
+                txIndex,
+                node.getFieldH256(sfLedgerIndex),
+                boost::none,
+                boost::none};
+            if (node.getFName() == sfCreatedNode)
+            {
+                if (auto const fields = nodeFields(node, sfNewFields))
+                    c.after = lineState(*fields);
+            }
+            else if (auto const fields = nodeFields(node, sfFinalFields))
+            {
+                // The line as it was before the transaction is its final
+                // state with the fields it changed put back.
+                auto const prev = nodeFields(node, sfPreviousFields);
+                bool const deleted = node.getFName() == sfDeletedNode;
+                if (!deleted && !prev)
+                    continue;
+
+                c.before = lineState(*fields);
+                if (prev)
+                {
+                    if (auto const v = (*prev)[~sfBalance])
+                        c.before->balance = *v;
+                    if (auto const v = (*prev)[~sfLowLimit])
+                        c.before->lowLimit = *v;
+                    if (auto const v = (*prev)[~sfHighLimit])
+                        c.before->highLimit = *v;
+                }
+                if (!deleted)
+                    c.after = lineState(*fields);
+            }
+            if (c.before || c.after)
+                changes.push_back(std::move(c));
+        }
+    }
+
+    // A line may be deleted and created again within the ledger, so the
+    // changes are made in the order the transactions were applied.
+    std::stable_sort(
+        changes.begin(), changes.end(), [](Change const& a, Change const& b) {
+            return a.index < b.index;
+        });
+
+    auto snap = std::make_shared<Snapshot>(parent);
+    snap->seq_ = ledger.seq();
+    snap->hash_ = ledger.info().hash;
+    for (auto const& c : changes)
+    {
+        if (c.before)
+        {
+            tally(snap->totals_, *c.before, false, false);
+            tally(snap->totals_, *c.before, true, false);
+        }
+
+        if (c.before && !c.after)
+        {
+            auto const& low = c.before->lowLimit;
+            auto const& high = c.before->highLimit;
+            Lines::key_type const key{low.getCurrency(), c.key};
+            if (removeLine(snap->accounts_, low.getIssuer(), key))
+                --snap->size_;
+            removeLine(snap->accounts_, high.getIssuer(), key);
+        }
+        else if (!c.before && c.after)
+        {
+            auto const& low = c.after->lowLimit;
+            auto const& high = c.after->highLimit;
+            Lines::key_type const key{low.getCurrency(), c.key};
+            if (addLine(
+                    snap->accounts_, low.getIssuer(), key, high.getIssuer()))
+                ++snap->size_;
+            addLine(snap->accounts_, high.getIssuer(), key, low.getIssuer());
+        }
+
+        if (c.after)
+        {
+            tally(snap->totals_, *c.after, false, true);
+            tally(snap->totals_, *c.after, true, true);
+        }
+    }
+    return snap;
+}
+
+}  // namespace ripple
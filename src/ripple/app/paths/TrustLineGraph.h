@@ -0,0 +1,176 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_PATHS_TRUSTLINEGRAPH_H_INCLUDED
+#define RIPPLE_APP_PATHS_TRUSTLINEGRAPH_H_INCLUDED
+
+#include <ripple/basics/PersistentMap.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/ledger/ReadView.h>
+#include <ripple/protocol/RippleLedgerHash.h>
+#include <ripple/protocol/UintTypes.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace ripple {
+
+class Application;
+
+/** The trust lines of every account, for path finding.
+
+    Instead of walking the owner directory of each account it visits, as
+    it does when the lines are read from the ledger, the Pathfinder looks
+    up the keys of an account's trust lines here and reads only those.
+
+    It also keeps totals of the lines of each account in each currency, so
+    that the currencies an account can send or receive are found without
+    reading every one of its lines.
+
+    The graph is built from the state of a ledger once, and then brought
+    forward from the metadata of each following ledger. Snapshots of it
+    share everything which did not change, and are never modified, so any
+    number of threads can read them without taking a lock.
+*/
+class TrustLineGraph
+{
+public:
+    /** The trust lines of an account, by currency and key, to the peer. */
+    using Lines = PersistentMap<std::pair<Currency, uint256>, AccountID>;
+
+    /** The trust lines of an account in one currency, from its side. */
+    struct Totals
+    {
+        /** The number of lines. */
+        std::uint32_t lines = 0;
+
+        /** The lines the account holds IOUs on or has credit left on. */
+        std::uint32_t sendable = 0;
+
+        /** The lines the account can take more IOUs on. */
+        std::uint32_t receivable = 0;
+    };
+
+    /** The trust lines as of one closed ledger. */
+    class Snapshot
+    {
+    public:
+        LedgerIndex
+        seq() const
+        {
+            return seq_;
+        }
+
+        LedgerHash const&
+        hash() const
+        {
+            return hash_;
+        }
+
+        /** Returns the trust lines of an account, or nullptr if none. */
+        Lines const*
+        lines(AccountID const& account) const
+        {
+            return accounts_.lookup(account);
+        }
+
+        /** Calls f(currency, totals) for each currency the account has
+            trust lines in, in order.
+        */
+        template <class F>
+        void
+        forEachCurrency(AccountID const& account, F&& f) const
+        {
+            for (auto it = totals_.lower_bound({account, Currency{}});
+                 it != totals_.end() && it->first.first == account;
+                 ++it)
+                f(it->first.second, it->second);
+        }
+
+        /** The number of accounts with at least one trust line. */
+        std::size_t
+        accounts() const
+        {
+            return accounts_.size();
+        }
+
+        /** The number of trust lines. */
+        std::size_t
+        size() const
+        {
+            return size_;
+        }
+
+        /** An estimate of the memory used, in bytes. */
+        std::size_t
+        bytes() const;
+
+    private:
+        friend class TrustLineGraph;
+
+        LedgerIndex seq_ = 0;
+        LedgerHash hash_;
+        PersistentMap<AccountID, Lines> accounts_;
+        std::size_t size_ = 0;
+        PersistentMap<std::pair<AccountID, Currency>, Totals> totals_;
+    };
+
+    TrustLineGraph(Application& app, beast::Journal journal);
+
+    /** Bring the graph up to a closed ledger.
+
+        The metadata of the ledgers since the current snapshot are applied
+        to it if they can all be had; otherwise the graph is built again
+        from the state of the ledger.
+
+        @return The snapshot for the ledger, or nullptr if the ledger is
+                open and therefore has no metadata.
+    */
+    std::shared_ptr<Snapshot const>
+    update(std::shared_ptr<ReadView const> const& ledger);
+
+    /** Returns the most recent snapshot, which may be nullptr. */
+    std::shared_ptr<Snapshot const>
+    current() const
+    {
+        return std::atomic_load(&current_);
+    }
+
+private:
+    // Build a snapshot from the whole state of a ledger
+    std::shared_ptr<Snapshot const>
+    build(ReadView const& ledger) const;
+
+    // Apply the changes a ledger made to trust lines
+    static std::shared_ptr<Snapshot const>
+    apply(Snapshot const& parent, ReadView const& ledger);
+
+    Application& app_;
+    beast::Journal const j_;
+
+    // Serializes updates; readers only load current_
+    std::mutex updateLock_;
+    std::shared_ptr<Snapshot const> current_;
+};
+
+}  // namespace ripple
+
+#endif
@@ -36,6 +36,8 @@
 #include <iterator>
 #include <numeric>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 namespace ripple {
 
@@ -338,6 +340,145 @@ qualityUpperBound(ReadView const& v, Strand const& strand)
 };
 /// @endcond
 
+/// @cond INTERNAL
+/* Remember the quality upper bounds of book steps across the iterations of
+   a flow.
+
+   When crossing offers, every iteration bounds the quality of each active
+   strand, which walks the tip of each book the strand goes through. Most
+   iterations only change the books of the strand they take liquidity from.
+   The bound of a book step depends on nothing but the view and the debt
+   direction of the step before it, so it is kept, with the keys of the
+   entries it read, until one of those entries is written. Other steps keep
+   state of their own across iterations and are always evaluated.
+*/
+class StepQualityCache
+{
+    struct Entry
+    {
+        DebtDirection prevStepDir;
+        boost::optional<Quality> quality;
+        DebtDirection dir;
+        AccessedKeys reads;
+    };
+
+    PaymentSandbox& sb_;
+    std::unordered_map<Step const*, Entry> entries_;
+    AccessedKeys writes_;
+    std::size_t evaluated_ = 0;
+    std::size_t reused_ = 0;
+
+public:
+    /* True if an entry read, or a range searched, holds one of the sorted
+       keys written.
+
+       A range searched with succ(key, last) holds the keys after key and
+       before last, which includes keys that were not there to be found.
+    */
+    static bool
+    written(AccessedKeys const& reads, std::vector<uint256> const& writes)
+    {
+        for (auto const& key : reads.keys)
+        {
+            if (std::binary_search(writes.begin(), writes.end(), key))
+                return true;
+        }
+        for (auto const& [key, last] : reads.ranges)
+        {
+            auto const it = std::upper_bound(writes.begin(), writes.end(), key);
+            if (it != writes.end() && (!last || *it < *last))
+                return true;
+        }
+        return false;
+    }
+
+    explicit StepQualityCache(PaymentSandbox& sb) : sb_(sb)
+    {
+        sb_.recordWrites(&writes_);
+    }
+
+    StepQualityCache(StepQualityCache const&) = delete;
+    StepQualityCache&
+    operator=(StepQualityCache const&) = delete;
+
+    ~StepQualityCache()
+    {
+        sb_.recordWrites(nullptr);
+    }
+
+    // Same as the free function, given the view the cache was built on
+    boost::optional<Quality>
+    qualityUpperBound(Strand const& strand)
+    {
+        Quality q{STAmount::uRateOne};
+        boost::optional<Quality> stepQ;
+        DebtDirection dir = DebtDirection::issues;
+        for (auto const& step : strand)
+        {
+            if (!step->bookStepBook())
+            {
+                std::tie(stepQ, dir) = step->qualityUpperBound(sb_, dir);
+            }
+            else if (auto it = entries_.find(step.get());
+                     it != entries_.end() && it->second.prevStepDir == dir)
+            {
+                ++reused_;
+                stepQ = it->second.quality;
+                dir = it->second.dir;
+            }
+            else
+            {
+                ++evaluated_;
+                Entry e;
+                e.prevStepDir = dir;
+                sb_.recordReads(&e.reads);
+                std::tie(stepQ, dir) = step->qualityUpperBound(sb_, dir);
+                sb_.recordReads(nullptr);
+                e.quality = stepQ;
+                e.dir = dir;
+                entries_[step.get()] = std::move(e);
+            }
+
+            if (!stepQ)
+                return boost::none;
+            q = composed_quality(q, *stepQ);
+        }
+        return q;
+    }
+
+    // Forget the bounds read from entries written since the last call
+    void
+    invalidate()
+    {
+        auto& writes = writes_.keys;
+        if (writes.empty())
+            return;
+        std::sort(writes.begin(), writes.end());
+        writes.erase(std::unique(writes.begin(), writes.end()), writes.end());
+        for (auto it = entries_.begin(); it != entries_.end();)
+        {
+            if (written(it->second.reads, writes))
+                it = entries_.erase(it);
+            else
+                ++it;
+        }
+        writes_.clear();
+    }
+
+    std::size_t
+    evaluated() const
+    {
+        return evaluated_;
+    }
+
+    std::size_t
+    reused() const
+    {
+        return reused_;
+    }
+};
+/// @endcond
+
 /// @cond INTERNAL
 /* Track the non-dry strands
 
@@ -435,6 +576,8 @@ public:
    @param sendMaxST If present, the maximum STAmount to send
    @param j Journal to write journal messages to
    @param flowDebugInfo If pointer is non-null, write flow debug info here
+   @param boundReuse If pointer is non-null, whether to reuse quality bounds
+                     and where to count those evaluated and reused
    @return Actual amount in and out from the strands, errors, and payment
    sandbox
 */
@@ -449,7 +592,8 @@ flow(
     boost::optional<Quality> const& limitQuality,
     boost::optional<STAmount> const& sendMaxST,
     beast::Journal j,
-    path::detail::FlowDebugInfo* flowDebugInfo = nullptr)
+    path::detail::FlowDebugInfo* flowDebugInfo = nullptr,
+    QualityBoundReuse* boundReuse = nullptr)
 {
     // Used to track the strand that offers the best quality (output/input
     // ratio)
@@ -517,6 +661,11 @@ flow(
     // successful
     boost::container::flat_set<uint256> ofrsToRmOnFail;
 
+    // Only kept while crossing offers, as payments do not bound strands
+    boost::optional<StepQualityCache> qualityCache;
+    if (offerCrossing && limitQuality && (!boundReuse || boundReuse->enabled))
+        qualityCache.emplace(sb);
+
     while (remainingOut > beast::zero &&
            (!remainingIn || *remainingIn > beast::zero))
     {
@@ -541,7 +690,9 @@ flow(
         {
             if (offerCrossing && limitQuality)
             {
-                auto const strandQ = qualityUpperBound(sb, *strand);
+                auto const strandQ = qualityCache
+                    ? qualityCache->qualityUpperBound(*strand)
+                    : qualityUpperBound(sb, *strand);
                 if (!strandQ || *strandQ < *limitQuality)
                     continue;
             }
@@ -639,10 +790,27 @@ flow(
             }
         }
 
+        if (qualityCache)
+            qualityCache->invalidate();
+
         if (shouldBreak)
             break;
     }
 
+    if (qualityCache)
+    {
+        JLOG(j.debug()) << "Step quality bounds: " << qualityCache->evaluated()
+                        << " evaluated, " << qualityCache->reused()
+                        << " reused";
+        if (boundReuse)
+        {
+            boundReuse->evaluated += qualityCache->evaluated();
+            boundReuse->reused += qualityCache->reused();
+        }
+        // Stop recording writes before the view is handed back
+        qualityCache.reset();
+    }
+
     auto const actualOut = sum(savedOuts);
     auto const actualIn = sum(savedIns);
 
@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_TX_PRECLAIMCACHE_H_INCLUDED
+#define RIPPLE_TX_PRECLAIMCACHE_H_INCLUDED
+
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/json/json_value.h>
+#include <ripple/ledger/ApplyView.h>
+#include <ripple/ledger/RecordingView.h>
+#include <ripple/protocol/TER.h>
+#include <boost/optional.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+class LoadFeeTrack;
+class STTx;
+
+/** Remembers the results of `preclaim`, so that transactions which are
+    checked again and again, such as those held in the TxQ or retried
+    while a ledger is built, are not checked from scratch each time.
+
+    A result is reused only while everything it was computed from is
+    unchanged: the same parent ledger and sequence, the same flags and
+    fee load, and every state item that `preclaim` read still the same.
+    Results that depend on more than point reads, such as whether the
+    transaction is already in the ledger, are not cached.
+*/
+class PreclaimCache
+{
+public:
+    struct Counts
+    {
+        /// Lookups answered from the cache
+        std::uint64_t hits;
+        /// Lookups of transactions with no cached result
+        std::uint64_t misses;
+        /// Lookups whose cached result was no longer valid
+        std::uint64_t invalidations;
+        /// Cached results
+        std::size_t size;
+    };
+
+    /// Limit on the number of cached results
+    static constexpr std::size_t defaultCapacity = 16384;
+
+    explicit PreclaimCache(std::size_t capacity = defaultCapacity);
+
+    PreclaimCache(PreclaimCache const&) = delete;
+    PreclaimCache&
+    operator=(PreclaimCache const&) = delete;
+
+    /** Returns the cached result of checking the transaction against the
+        view, if there is one and it is still valid.
+    */
+    boost::optional<TER>
+    lookup(
+        ReadView const& view,
+        STTx const& tx,
+        ApplyFlags flags,
+        LoadFeeTrack const& feeTrack);
+
+    /** Remember the result of checking the transaction.
+
+        @param recorded The view `preclaim` read through, on top of view.
+    */
+    void
+    insert(
+        ReadView const& view,
+        STTx const& tx,
+        ApplyFlags flags,
+        LoadFeeTrack const& feeTrack,
+        RecordingView const& recorded,
+        TER ter);
+
+    Counts
+    counts() const;
+
+    Json::Value
+    getJson() const;
+
+private:
+    // Everything other than state items that a result depends on
+    struct Context
+    {
+        uint256 parentHash;
+        LedgerIndex seq;
+        bool open;
+        ApplyFlags flags;
+        std::pair<std::uint32_t, std::uint32_t> load;
+
+        Context(
+            ReadView const& view,
+            ApplyFlags flags,
+            LoadFeeTrack const& feeTrack);
+
+        bool
+        operator==(Context const& other) const;
+    };
+
+    struct Entry
+    {
+        Context context;
+        TER ter;
+        std::vector<RecordingView::Read> reads;
+    };
+
+    std::size_t const capacity_;
+
+    std::mutex mutable mutex_;
+    hash_map<uint256, std::shared_ptr<Entry const>> entries_;
+    // The highest ledger sequence a result was cached for
+    LedgerIndex seq_ = 0;
+
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+    std::atomic<std::uint64_t> invalidations_{0};
+};
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_TX_TXMETRICS_H_INCLUDED
+#define RIPPLE_TX_TXMETRICS_H_INCLUDED
+
+#include <ripple/basics/PerfLog.h>
+#include <ripple/beast/insight/Collector.h>
+#include <ripple/beast/insight/Counter.h>
+#include <ripple/beast/insight/Event.h>
+#include <ripple/protocol/TxFormats.h>
+#include <boost/container/flat_map.hpp>
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace ripple {
+
+/** Records how long each type of transaction spends in each stage of
+    being applied, and how many ledger entries it touches.
+
+    Every measurement goes to the PerfLog counters, and to a histogram per
+    transaction type and stage in the insight collector, so that the types
+    which make the open ledger slow can be picked out. The histograms of
+    durations are in microseconds.
+
+    May be used from any thread.
+*/
+class TxMetrics
+{
+public:
+    using Stage = perf::PerfLog::TxStage;
+
+    /** Times a stage from construction to destruction. */
+    class ScopedStage
+    {
+    public:
+        ScopedStage(TxMetrics& metrics, TxType type, Stage stage)
+            : metrics_(metrics)
+            , type_(type)
+            , stage_(stage)
+            , start_(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~ScopedStage()
+        {
+            metrics_.stage(
+                type_,
+                stage_,
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start_));
+        }
+
+        ScopedStage(ScopedStage const&) = delete;
+        ScopedStage&
+        operator=(ScopedStage const&) = delete;
+
+    private:
+        TxMetrics& metrics_;
+        TxType const type_;
+        Stage const stage_;
+        std::chrono::steady_clock::time_point const start_;
+    };
+
+    TxMetrics(
+        perf::PerfLog& perfLog,
+        beast::insight::Collector::ptr const& collector);
+
+    TxMetrics(TxMetrics const&) = delete;
+    TxMetrics&
+    operator=(TxMetrics const&) = delete;
+
+    void
+    stage(TxType type, Stage stage, std::chrono::microseconds dur);
+
+    /** Record the ledger entries read and written while applying */
+    void
+    access(TxType type, std::size_t reads, std::size_t writes);
+
+    /** Record the quality bounds of book steps evaluated and reused
+        while crossing an offer.
+    */
+    void
+    qualityBounds(std::size_t evaluated, std::size_t reused);
+
+private:
+    struct Events
+    {
+        std::array<beast::insight::Event, perf::PerfLog::txStages> stages;
+        beast::insight::Event reads;
+        beast::insight::Event writes;
+    };
+
+    perf::PerfLog& perfLog_;
+    beast::insight::Collector::ptr const collector_;
+
+    // Every type is added on construction, so no lock is needed
+    boost::container::flat_map<TxType, Events> events_;
+
+    beast::insight::Counter boundsEvaluated_;
+    beast::insight::Counter boundsReused_;
+};
+
+}  // namespace ripple
+
+#endif
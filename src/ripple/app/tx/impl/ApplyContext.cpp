@@ -65,6 +65,12 @@ ApplyContext::size()
     return view_->size();
 }
 
+std::size_t
+ApplyContext::reads() const
+{
+    return view_->reads();
+}
+
 void
 ApplyContext::visit(std::function<void(
                         uint256 const&,
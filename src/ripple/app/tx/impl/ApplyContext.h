@@ -87,6 +87,10 @@ public:
     std::size_t
     size();
 
+    /** Get the number of entries looked up since the last reset. */
+    std::size_t
+    reads() const;
+
     /** Visit unapplied changes. */
     void
     visit(std::function<void(
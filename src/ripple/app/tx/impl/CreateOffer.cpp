@@ -19,6 +19,7 @@
 
 #include <ripple/app/ledger/OrderBookDB.h>
 #include <ripple/app/paths/Flow.h>
+#include <ripple/app/tx/TxMetrics.h>
 #include <ripple/app/tx/impl/CreateOffer.h>
 #include <ripple/beast/utility/WrappedSink.h>
 #include <ripple/ledger/CashDiff.h>
@@ -762,6 +763,7 @@ CreateOffer::flowCross(
         }
 
         // Call the payment engine's flow() to do the actual work.
+        QualityBoundReuse boundReuse;
         auto const result = flow(
             psb,
             deliver,
@@ -774,7 +776,11 @@ CreateOffer::flowCross(
             true,                       // offer crossing
             threshold,
             sendMax,
-            j_);
+            j_,
+            nullptr,
+            &boundReuse);
+        ctx_.app.getTxMetrics().qualityBounds(
+            boundReuse.evaluated, boundReuse.reused);
 
         // If stale offers were found remove them.
         for (auto const& toRemove : result.removableOffers)
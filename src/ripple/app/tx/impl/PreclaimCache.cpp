@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/LoadFeeTrack.h>
+#include <ripple/app/tx/PreclaimCache.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/jss.h>
+#include <algorithm>
+
+namespace ripple {
+
+namespace {
+
+// Is the state item the same as the one that was read before?
+bool
+unchanged(
+    std::shared_ptr<SLE const> const& before,
+    std::shared_ptr<SLE const> const& now)
+{
+    if (before == now)
+        return true;
+    if (!before || !now)
+        return false;
+    return before->isEquivalent(*now);
+}
+
+}  // namespace
+
+PreclaimCache::Context::Context(
+    ReadView const& view,
+    ApplyFlags flags_,
+    LoadFeeTrack const& feeTrack)
+    : parentHash(view.info().parentHash)
+    , seq(view.seq())
+    , open(view.open())
+    , flags(flags_)
+    , load(feeTrack.getScalingFactors())
+{
+}
+
+bool
+PreclaimCache::Context::operator==(Context const& other) const
+{
+    return parentHash == other.parentHash && seq == other.seq &&
+        open == other.open && flags == other.flags && load == other.load;
+}
+
+PreclaimCache::PreclaimCache(std::size_t capacity) : capacity_(capacity)
+{
+}
+
+boost::optional<TER>
+PreclaimCache::lookup(
+    ReadView const& view,
+    STTx const& tx,
+    ApplyFlags flags,
+    LoadFeeTrack const& feeTrack)
+{
+    std::shared_ptr<Entry const> entry;
+    {
+        std::lock_guard lock(mutex_);
+        auto const iter = entries_.find(tx.getTransactionID());
+        if (iter != entries_.end())
+            entry = iter->second;
+    }
+
+    if (!entry)
+    {
+        ++misses_;
+        return boost::none;
+    }
+
+    // Read the items again outside the lock: reading may have to go to
+    // the ledger.
+    bool const valid = entry->context == Context(view, flags, feeTrack) &&
+        std::all_of(
+            entry->reads.begin(), entry->reads.end(), [&](auto const& read) {
+                return unchanged(
+                    read.second, view.read(keylet::unchecked(read.first)));
+            });
+
+    if (!valid)
+    {
+        ++invalidations_;
+        std::lock_guard lock(mutex_);
+        auto const iter = entries_.find(tx.getTransactionID());
+        if (iter != entries_.end() && iter->second == entry)
+            entries_.erase(iter);
+        return boost::none;
+    }
+
+    ++hits_;
+    return entry->ter;
+}
+
+void
+PreclaimCache::insert(
+    ReadView const& view,
+    STTx const& tx,
+    ApplyFlags flags,
+    LoadFeeTrack const& feeTrack,
+    RecordingView const& recorded,
+    TER ter)
+{
+    if (recorded.ranged() || ter == tefEXCEPTION)
+        return;
+
+    auto entry = std::make_shared<Entry const>(
+        Entry{Context(view, flags, feeTrack), ter, recorded.reads()});
+
+    std::lock_guard lock(mutex_);
+
+    // Results for ledgers before the previous one can't be used again
+    if (entry->context.seq > seq_)
+    {
+        seq_ = entry->context.seq;
+        for (auto iter = entries_.begin(); iter != entries_.end();)
+        {
+            if (iter->second->context.seq + 1 < seq_)
+                iter = entries_.erase(iter);
+            else
+                ++iter;
+        }
+    }
+
+    if (entries_.size() >= capacity_)
+        entries_.clear();
+
+    entries_[tx.getTransactionID()] = std::move(entry);
+}
+
+auto
+PreclaimCache::counts() const -> Counts
+{
+    std::size_t size;
+    {
+        std::lock_guard lock(mutex_);
+        size = entries_.size();
+    }
+    return {hits_.load(), misses_.load(), invalidations_.load(), size};
+}
+
+Json::Value
+PreclaimCache::getJson() const
+{
+    auto const c = counts();
+
+    Json::Value ret(Json::objectValue);
+    ret[jss::size] = static_cast<Json::UInt>(c.size);
+    ret[jss::hits] = std::to_string(c.hits);
+    ret[jss::misses] = std::to_string(c.misses);
+    ret[jss::invalidations] = std::to_string(c.invalidations);
+    return ret;
+}
+
+}  // namespace ripple
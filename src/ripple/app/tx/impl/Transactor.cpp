@@ -19,6 +19,7 @@
 
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
+#include <ripple/app/tx/TxMetrics.h>
 #include <ripple/app/tx/apply.h>
 #include <ripple/app/tx/impl/SignerEntries.h>
 #include <ripple/app/tx/impl/Transactor.h>
@@ -645,9 +646,19 @@ Transactor::operator()()
     }
 #endif
 
+    auto& metrics = ctx_.app.getTxMetrics();
+    auto const type = ctx_.tx.getTxnType();
+
     auto result = ctx_.preclaimResult;
     if (result == tesSUCCESS)
-        result = apply();
+    {
+        {
+            TxMetrics::ScopedStage const timer(
+                metrics, type, TxMetrics::Stage::apply);
+            result = apply();
+        }
+        metrics.access(type, ctx_.reads(), ctx_.size());
+    }
 
     // No transaction can return temUNKNOWN from apply,
     // and it can't be passed in from a preclaim.
@@ -712,6 +723,9 @@ Transactor::operator()()
 
     if (applied)
     {
+        TxMetrics::ScopedStage const timer(
+            metrics, type, TxMetrics::Stage::invariants);
+
         // Check invariants: if `tecINVARIANT_FAILED` is not returned, we can
         // proceed to apply the tx
         result = ctx_.checkInvariants(result, fee);
@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/tx/TxMetrics.h>
+
+namespace ripple {
+
+TxMetrics::TxMetrics(
+    perf::PerfLog& perfLog,
+    beast::insight::Collector::ptr const& collector)
+    : perfLog_(perfLog), collector_(collector)
+{
+    for (auto const& format : TxFormats::getInstance())
+    {
+        auto const& name = format.getName();
+        Events events;
+        for (std::size_t i = 0; i < perf::PerfLog::txStages; ++i)
+        {
+            events.stages[i] = collector_->make_event(
+                name, std::string(to_string(static_cast<Stage>(i))) + "_us");
+        }
+        events.reads = collector_->make_event(name, "reads");
+        events.writes = collector_->make_event(name, "writes");
+        events_.emplace(format.getType(), std::move(events));
+    }
+
+    boundsEvaluated_ = collector_->make_counter("flow", "bounds_evaluated");
+    boundsReused_ = collector_->make_counter("flow", "bounds_reused");
+}
+
+void
+TxMetrics::stage(TxType type, Stage stage, std::chrono::microseconds dur)
+{
+    perfLog_.txStage(type, stage, dur);
+
+    auto const iter = events_.find(type);
+    if (iter == events_.end())
+        return;
+    // Events are kept in milliseconds; pass the microseconds through as is
+    // so that fast stages do not all round up to one.
+    iter->second.stages[static_cast<std::size_t>(stage)].notify(
+        beast::insight::Event::value_type{dur.count()});
+}
+
+void
+TxMetrics::access(TxType type, std::size_t reads, std::size_t writes)
+{
+    perfLog_.txAccess(type, reads, writes);
+
+    auto const iter = events_.find(type);
+    if (iter == events_.end())
+        return;
+    iter->second.reads.notify(beast::insight::Event::value_type{reads});
+    iter->second.writes.notify(beast::insight::Event::value_type{writes});
+}
+
+void
+TxMetrics::qualityBounds(std::size_t evaluated, std::size_t reused)
+{
+    boundsEvaluated_.increment(evaluated);
+    boundsReused_.increment(reused);
+}
+
+}  // namespace ripple
@@ -17,6 +17,9 @@
 */
 //==============================================================================
 
+#include <ripple/app/main/Application.h>
+#include <ripple/app/tx/PreclaimCache.h>
+#include <ripple/app/tx/TxMetrics.h>
 #include <ripple/app/tx/applySteps.h>
 #include <ripple/app/tx/impl/ApplyContext.h>
 #include <ripple/app/tx/impl/CancelCheck.h>
@@ -411,6 +414,8 @@ preflight(
     PreflightContext const pfctx(app, tx, rules, flags, j);
     try
     {
+        TxMetrics::ScopedStage const timer(
+            app.getTxMetrics(), tx.getTxnType(), TxMetrics::Stage::preflight);
         return {pfctx, invoke_preflight(pfctx)};
     }
     catch (std::exception const& e)
@@ -457,7 +462,30 @@ preclaim(
     {
         if (ctx->preflightResult != tesSUCCESS)
             return {*ctx, ctx->preflightResult};
-        return {*ctx, invoke_preclaim(*ctx)};
+
+        TxMetrics::ScopedStage const timer(
+            app.getTxMetrics(),
+            ctx->tx.getTxnType(),
+            TxMetrics::Stage::preclaim);
+
+        auto& cache = app.getPreclaimCache();
+        auto const& feeTrack = app.getFeeTrack();
+        if (auto const ter = cache.lookup(view, ctx->tx, ctx->flags, feeTrack))
+            return {*ctx, *ter};
+
+        // Check through a view that records what is read, so that the
+        // result can be reused for as long as none of it changes.
+        RecordingView const recording(view);
+        PreclaimContext const recordingCtx(
+            app,
+            recording,
+            ctx->preflightResult,
+            ctx->tx,
+            ctx->flags,
+            ctx->j);
+        auto const ter = invoke_preclaim(recordingCtx);
+        cache.insert(view, ctx->tx, ctx->flags, feeTrack, recording, ter);
+        return {*ctx, ter};
     }
     catch (std::exception const& e)
     {
@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_ARENA_H_INCLUDED
+#define RIPPLE_BASICS_ARENA_H_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace ripple {
+
+/** Memory handed out by bumping a pointer, and released all at once.
+
+    Allocations come first from a small buffer inside the arena, so a
+    short-lived arena on the stack that serves only a few allocations
+    never touches the heap, then from heap blocks of doubling size.
+    Deallocating does nothing: the memory is reclaimed when the arena is
+    destroyed.
+
+    An arena is neither copyable nor movable, since memory handed out
+    from its inline buffer lives inside it.
+
+    Not thread-safe.
+*/
+class Arena
+{
+public:
+    /** Size of the buffer inside the arena */
+    static constexpr std::size_t inlineSize = 1024;
+
+    /** Size of the first heap block; each further one is twice as large */
+    static constexpr std::size_t blockSize = 4096;
+
+    Arena() = default;
+    Arena(Arena const&) = delete;
+    Arena&
+    operator=(Arena const&) = delete;
+
+    ~Arena()
+    {
+        while (blocks_)
+        {
+            auto const next = blocks_->next;
+            ::operator delete(blocks_);
+            blocks_ = next;
+        }
+    }
+
+    void*
+    allocate(std::size_t bytes, std::size_t align)
+    {
+        if (auto p = bump(bytes, align))
+            return p;
+
+        // The current buffer is exhausted; start a new block large enough
+        // for the request.
+        next_ = std::max(next_, bytes + align + sizeof(Block));
+        auto const block = static_cast<Block*>(::operator new(next_));
+        block->next = blocks_;
+        blocks_ = block;
+        free_ = reinterpret_cast<std::uint8_t*>(block + 1);
+        end_ = reinterpret_cast<std::uint8_t*>(block) + next_;
+        heapBytes_ += next_;
+        next_ *= 2;
+
+        auto const p = bump(bytes, align);
+        assert(p);
+        return p;
+    }
+
+    /** Bytes obtained from the heap so far */
+    std::size_t
+    heapBytes() const
+    {
+        return heapBytes_;
+    }
+
+private:
+    struct alignas(std::max_align_t) Block
+    {
+        Block* next;
+    };
+
+    void*
+    bump(std::size_t bytes, std::size_t align)
+    {
+        void* p = free_;
+        std::size_t space = end_ - free_;
+        if (!std::align(align, bytes, p, space))
+            return nullptr;
+        free_ = static_cast<std::uint8_t*>(p) + bytes;
+        return p;
+    }
+
+    alignas(std::max_align_t) std::uint8_t buffer_[inlineSize];
+    std::uint8_t* free_ = buffer_;
+    std::uint8_t* end_ = buffer_ + inlineSize;
+    Block* blocks_ = nullptr;
+    std::size_t next_ = blockSize;
+    std::size_t heapBytes_ = 0;
+};
+
+/** A standard allocator that takes its memory from an Arena.
+
+    Allocators are equal when they use the same arena. A container moved
+    to another arena therefore moves its elements one by one into memory
+    from the new arena.
+*/
+template <class T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena& arena) noexcept : arena_(&arena)
+    {
+    }
+
+    template <class U>
+    ArenaAllocator(ArenaAllocator<U> const& other) noexcept
+        : arena_(other.arena_)
+    {
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void
+    deallocate(T*, std::size_t) noexcept
+    {
+    }
+
+    template <class U>
+    bool
+    operator==(ArenaAllocator<U> const& other) const noexcept
+    {
+        return arena_ == other.arena_;
+    }
+
+    template <class U>
+    bool
+    operator!=(ArenaAllocator<U> const& other) const noexcept
+    {
+        return arena_ != other.arena_;
+    }
+
+private:
+    template <class>
+    friend class ArenaAllocator;
+
+    Arena* arena_;
+};
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_FIXEDPOINT_H_INCLUDED
+#define RIPPLE_BASICS_FIXEDPOINT_H_INCLUDED
+
+#include <ripple/basics/contract.h>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#ifndef __SIZEOF_INT128__
+#include <boost/multiprecision/cpp_int.hpp>
+#endif
+
+namespace ripple {
+namespace detail {
+
+/** An unsigned 128 bit integer.
+
+    The compiler's own type where there is one, which is much faster than
+    the portable one from boost.
+*/
+#ifdef __SIZEOF_INT128__
+using uint128 = unsigned __int128;
+#else
+using uint128 = boost::multiprecision::uint128_t;
+#endif
+
+/** n / d, truncated towards zero.
+
+    Throws std::overflow_error if d is zero, as boost's type does, where
+    the compiler's type would trap.
+*/
+inline uint128
+divide(uint128 n, std::uint64_t d)
+{
+    if (d == 0)
+        Throw<std::overflow_error>("Division by zero.");
+    return n / d;
+}
+
+/** 10^n, for every power of ten which fits in 64 bits. */
+constexpr std::uint64_t powerOfTen[20] = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull};
+
+/** The number of decimal digits in v, taking zero to have one. */
+inline int
+digits10(std::uint64_t v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    // The number of bits gives the number of digits, or one less than it,
+    // which the table tells apart. Setting the lowest bit, which changes
+    // the number of digits of no value but zero, keeps clz defined.
+    v |= 1;
+    int const bits = 64 - __builtin_clzll(v);
+    int const guess = (bits * 1233) >> 12;
+    return guess + (v >= powerOfTen[guess]);
+#else
+    int n = 1;
+    while (n < 20 && v >= powerOfTen[n])
+        ++n;
+    return n;
+#endif
+}
+
+/** v / 10^n, truncated towards zero as dividing by 10 n times would. */
+template <class Int>
+Int
+divPow10(Int v, int n)
+{
+    static_assert(std::is_integral_v<Int> && sizeof(Int) == 8);
+
+    // No 64 bit integer reaches 10^19 in magnitude if it is signed, or
+    // 10^20 if it is not.
+    if (n >= (std::is_signed_v<Int> ? 19 : 20))
+        return 0;
+    return v / static_cast<Int>(powerOfTen[n]);
+}
+
+/** v * 10^n modulo 2^64, as multiplying by 10 n times would be. */
+inline std::uint64_t
+mulPow10(std::uint64_t v, int n)
+{
+    for (; n > 19; n -= 19)
+        v *= powerOfTen[19];
+    return v * powerOfTen[n];
+}
+
+}  // namespace detail
+}  // namespace ripple
+
+#endif
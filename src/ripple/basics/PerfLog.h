@@ -22,8 +22,10 @@
 
 #include <ripple/core/JobTypes.h>
 #include <ripple/json/json_value.h>
+#include <ripple/protocol/TxFormats.h>
 #include <boost/filesystem.hpp>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -64,6 +66,14 @@ public:
         milliseconds logInterval{seconds(1)};
     };
 
+    /**
+     * Stages of processing a transaction that are timed separately.
+     */
+    enum class TxStage { preflight, preclaim, apply, invariants };
+
+    static constexpr std::size_t txStages =
+        static_cast<std::size_t>(TxStage::invariants) + 1;
+
     virtual ~PerfLog() = default;
 
     /**
@@ -126,6 +136,26 @@ public:
     virtual void
     jobFinish(JobType const type, microseconds dur, int instance) = 0;
 
+    /**
+     * Log a stage of processing a transaction
+     *
+     * @param type Transaction type
+     * @param stage Stage of processing
+     * @param dur Duration of the stage in microseconds
+     */
+    virtual void
+    txStage(TxType const type, TxStage const stage, microseconds dur) = 0;
+
+    /**
+     * Log the ledger entries a transaction touched while being applied
+     *
+     * @param type Transaction type
+     * @param reads Number of ledger entries read
+     * @param writes Number of ledger entries created, modified or deleted
+     */
+    virtual void
+    txAccess(TxType const type, std::size_t reads, std::size_t writes) = 0;
+
     /**
      * Render performance counters in Json
      *
@@ -159,6 +189,24 @@ public:
 
 }  // namespace perf
 
+/** Name under which a transaction processing stage is reported */
+inline char const*
+to_string(perf::PerfLog::TxStage stage)
+{
+    switch (stage)
+    {
+        case perf::PerfLog::TxStage::preflight:
+            return "preflight";
+        case perf::PerfLog::TxStage::preclaim:
+            return "preclaim";
+        case perf::PerfLog::TxStage::apply:
+            return "apply";
+        case perf::PerfLog::TxStage::invariants:
+            break;
+    }
+    return "invariants";
+}
+
 class Section;
 class Stoppable;
 
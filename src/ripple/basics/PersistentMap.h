@@ -0,0 +1,468 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_PERSISTENTMAP_H_INCLUDED
+#define RIPPLE_BASICS_PERSISTENTMAP_H_INCLUDED
+
+#include <ripple/basics/random.h>
+#include <boost/intrusive_ptr.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** An ordered map whose copies share structure.
+
+    The map is a treap of reference counted, immutable nodes. Copying a map
+    copies a single pointer, and a modification copies only the nodes on
+    the path from the root to the changed key, O(log n) of them, leaving
+    every other copy untouched. Nodes that are not shared with any other
+    copy are modified in place, so a map that is never copied costs about
+    the same as a std::map.
+
+    Copies may be read and modified by different threads, but a single
+    map is not thread-safe.
+
+    An iterator holds a reference to the version of the map it was
+    obtained from: the map may be modified while iterating, and the
+    iterator continues to see the contents as they were when it was
+    created.
+*/
+template <class Key, class T, class Compare = std::less<Key>>
+class PersistentMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key const, T>;
+    using size_type = std::size_t;
+    using key_compare = Compare;
+
+private:
+    struct Node;
+    using NodePtr = boost::intrusive_ptr<Node>;
+
+    struct Node
+    {
+        value_type value;
+        std::uint32_t const priority;
+        NodePtr left;
+        NodePtr right;
+        std::atomic<std::size_t> mutable refs{0};
+
+        Node(value_type v, std::uint32_t p) : value(std::move(v)), priority(p)
+        {
+        }
+
+        // A copy starts out unreferenced and shares the children
+        Node(Node const& other)
+            : value(other.value)
+            , priority(other.priority)
+            , left(other.left)
+            , right(other.right)
+        {
+        }
+
+        Node&
+        operator=(Node const&) = delete;
+
+        friend void
+        intrusive_ptr_add_ref(Node const* n)
+        {
+            n->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        friend void
+        intrusive_ptr_release(Node const* n)
+        {
+            if (n->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete n;
+        }
+    };
+
+public:
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PersistentMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type const*;
+        using reference = value_type const&;
+
+        const_iterator() = default;
+
+        reference
+        operator*() const
+        {
+            return stack_.back()->value;
+        }
+
+        pointer
+        operator->() const
+        {
+            return &stack_.back()->value;
+        }
+
+        const_iterator&
+        operator++()
+        {
+            Node const* n = stack_.back();
+            stack_.pop_back();
+            for (n = n->right.get(); n != nullptr; n = n->left.get())
+                stack_.push_back(n);
+            if (stack_.empty())
+                root_.reset();
+            return *this;
+        }
+
+        const_iterator
+        operator++(int)
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        friend bool
+        operator==(const_iterator const& a, const_iterator const& b)
+        {
+            if (a.stack_.empty() || b.stack_.empty())
+                return a.stack_.empty() == b.stack_.empty();
+            return a.stack_.back() == b.stack_.back();
+        }
+
+        friend bool
+        operator!=(const_iterator const& a, const_iterator const& b)
+        {
+            return !(a == b);
+        }
+
+    private:
+        friend class PersistentMap;
+
+        explicit const_iterator(NodePtr const& root) : root_(root)
+        {
+        }
+
+        // Keeps the version being iterated alive
+        NodePtr root_;
+
+        // The current node on top, below it the ancestors that come after
+        // it in key order.
+        std::vector<Node const*> stack_;
+    };
+
+    using iterator = const_iterator;
+
+    PersistentMap() = default;
+    PersistentMap(PersistentMap const&) = default;
+    PersistentMap(PersistentMap&&) = default;
+    PersistentMap&
+    operator=(PersistentMap const&) = default;
+    PersistentMap&
+    operator=(PersistentMap&&) = default;
+
+    size_type
+    size() const
+    {
+        return size_;
+    }
+
+    bool
+    empty() const
+    {
+        return size_ == 0;
+    }
+
+    void
+    clear()
+    {
+        root_.reset();
+        size_ = 0;
+    }
+
+    const_iterator
+    begin() const
+    {
+        const_iterator it(root_);
+        for (Node const* n = root_.get(); n != nullptr; n = n->left.get())
+            it.stack_.push_back(n);
+        return finish(std::move(it));
+    }
+
+    const_iterator
+    end() const
+    {
+        return {};
+    }
+
+    const_iterator
+    cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator
+    cend() const
+    {
+        return end();
+    }
+
+    /** Returns the first element whose key is not less than key. */
+    const_iterator
+    lower_bound(Key const& key) const
+    {
+        const_iterator it(root_);
+        for (Node const* n = root_.get(); n != nullptr;)
+        {
+            if (!comp_(n->value.first, key))
+            {
+                it.stack_.push_back(n);
+                n = n->left.get();
+            }
+            else
+            {
+                n = n->right.get();
+            }
+        }
+        return finish(std::move(it));
+    }
+
+    /** Returns the first element whose key is greater than key. */
+    const_iterator
+    upper_bound(Key const& key) const
+    {
+        const_iterator it(root_);
+        for (Node const* n = root_.get(); n != nullptr;)
+        {
+            if (comp_(key, n->value.first))
+            {
+                it.stack_.push_back(n);
+                n = n->left.get();
+            }
+            else
+            {
+                n = n->right.get();
+            }
+        }
+        return finish(std::move(it));
+    }
+
+    const_iterator
+    find(Key const& key) const
+    {
+        auto it = lower_bound(key);
+        if (it != end() && comp_(key, it->first))
+            return end();
+        return it;
+    }
+
+    /** Returns the value for a key, or nullptr if there is none.
+
+        Cheaper than find() when only the value is needed. The pointer is
+        invalidated by any modification of the map.
+    */
+    T const*
+    lookup(Key const& key) const
+    {
+        for (Node const* n = root_.get(); n != nullptr;)
+        {
+            if (comp_(key, n->value.first))
+                n = n->left.get();
+            else if (comp_(n->value.first, key))
+                n = n->right.get();
+            else
+                return &n->value.second;
+        }
+        return nullptr;
+    }
+
+    std::size_t
+    count(Key const& key) const
+    {
+        return lookup(key) != nullptr ? 1 : 0;
+    }
+
+    /** Insert a value if the key is not already present.
+
+        @return true if the value was inserted.
+    */
+    bool
+    insert(Key const& key, T value)
+    {
+        if (lookup(key) != nullptr)
+            return false;
+        root_ = insertNode(std::move(root_), key, std::move(value));
+        ++size_;
+        return true;
+    }
+
+    /** Insert a value, replacing the value of an existing key.
+
+        @return true if the key was not present before.
+    */
+    bool
+    insert_or_assign(Key const& key, T value)
+    {
+        bool const inserted = lookup(key) == nullptr;
+        root_ = insertNode(std::move(root_), key, std::move(value));
+        if (inserted)
+            ++size_;
+        return inserted;
+    }
+
+    /** Remove a key.
+
+        @return The number of elements removed, zero or one.
+    */
+    size_type
+    erase(Key const& key)
+    {
+        if (lookup(key) == nullptr)
+            return 0;
+        root_ = eraseNode(std::move(root_), key);
+        --size_;
+        return 1;
+    }
+
+private:
+    static const_iterator
+    finish(const_iterator&& it)
+    {
+        if (it.stack_.empty())
+            it.root_.reset();
+        return std::move(it);
+    }
+
+    // Returns n if it is referenced from nowhere else, so that it may be
+    // changed in place, and a copy of n otherwise.
+    static NodePtr
+    own(NodePtr n)
+    {
+        if (n->refs.load(std::memory_order_acquire) == 1)
+            return n;
+        return NodePtr(new Node(*n));
+    }
+
+    static NodePtr
+    rotateRight(NodePtr n)
+    {
+        NodePtr l = std::move(n->left);
+        n->left = std::move(l->right);
+        l->right = std::move(n);
+        return l;
+    }
+
+    static NodePtr
+    rotateLeft(NodePtr n)
+    {
+        NodePtr r = std::move(n->right);
+        n->right = std::move(r->left);
+        r->left = std::move(n);
+        return r;
+    }
+
+    // Every node returned by insertNode, eraseNode and merge may be changed in
+    // place by the caller.
+    NodePtr
+    insertNode(NodePtr n, Key const& key, T&& value)
+    {
+        if (!n)
+            return NodePtr(new Node(
+                value_type(key, std::move(value)),
+                rand_int<std::uint32_t>()));
+
+        n = own(std::move(n));
+        if (comp_(key, n->value.first))
+        {
+            n->left = insertNode(std::move(n->left), key, std::move(value));
+            if (n->left->priority > n->priority)
+                n = rotateRight(std::move(n));
+        }
+        else if (comp_(n->value.first, key))
+        {
+            n->right = insertNode(std::move(n->right), key, std::move(value));
+            if (n->right->priority > n->priority)
+                n = rotateLeft(std::move(n));
+        }
+        else
+        {
+            n->value.second = std::move(value);
+        }
+        return n;
+    }
+
+    // The key must be present
+    NodePtr
+    eraseNode(NodePtr n, Key const& key)
+    {
+        if (comp_(key, n->value.first))
+        {
+            n = own(std::move(n));
+            n->left = eraseNode(std::move(n->left), key);
+            return n;
+        }
+
+        if (comp_(n->value.first, key))
+        {
+            n = own(std::move(n));
+            n->right = eraseNode(std::move(n->right), key);
+            return n;
+        }
+
+        if (n->refs.load(std::memory_order_acquire) == 1)
+            return merge(std::move(n->left), std::move(n->right));
+        return merge(n->left, n->right);
+    }
+
+    // Join two trees, every key in a being less than every key in b
+    static NodePtr
+    merge(NodePtr a, NodePtr b)
+    {
+        if (!a)
+            return b;
+        if (!b)
+            return a;
+
+        if (a->priority > b->priority)
+        {
+            a = own(std::move(a));
+            a->right = merge(std::move(a->right), std::move(b));
+            return a;
+        }
+
+        b = own(std::move(b));
+        b->left = merge(std::move(a), std::move(b->left));
+        return b;
+    }
+
+    NodePtr root_;
+    size_type size_ = 0;
+    Compare comp_;
+};
+
+}  // namespace ripple
+
+#endif
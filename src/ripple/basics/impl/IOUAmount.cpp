@@ -17,11 +17,13 @@
 */
 //==============================================================================
 
+#include <ripple/basics/FixedPoint.h>
 #include <ripple/basics/IOUAmount.h>
 #include <ripple/basics/contract.h>
-#include <boost/multiprecision/cpp_int.hpp>
 #include <algorithm>
+#include <cassert>
 #include <iterator>
+#include <limits>
 #include <numeric>
 #include <stdexcept>
 
@@ -48,19 +50,23 @@ IOUAmount::normalize()
     if (negative)
         mantissa_ = -mantissa_;
 
-    while ((mantissa_ < minMantissa) && (exponent_ > minExponent))
+    // Scale by as many powers of ten at once as multiplying or dividing by
+    // ten one at a time until the mantissa is in range would.
+    if ((mantissa_ < minMantissa) && (exponent_ > minExponent))
     {
-        mantissa_ *= 10;
-        --exponent_;
+        int const shift = std::min(
+            16 - detail::digits10(mantissa_), exponent_ - minExponent);
+        mantissa_ *= static_cast<std::int64_t>(detail::powerOfTen[shift]);
+        exponent_ -= shift;
     }
-
-    while (mantissa_ > maxMantissa)
+    else if (mantissa_ > maxMantissa)
     {
-        if (exponent_ >= maxExponent)
+        int const shift = detail::digits10(mantissa_) - 16;
+        if (exponent_ + shift > maxExponent)
             Throw<std::overflow_error>("IOUAmount::normalize");
 
-        mantissa_ /= 10;
-        ++exponent_;
+        mantissa_ /= static_cast<std::int64_t>(detail::powerOfTen[shift]);
+        exponent_ += shift;
     }
 
     if ((exponent_ < minExponent) || (mantissa_ < minMantissa))
@@ -91,16 +97,15 @@ IOUAmount::operator+=(IOUAmount const& other)
     auto m = other.mantissa_;
     auto e = other.exponent_;
 
-    while (exponent_ < e)
+    if (exponent_ < e)
     {
-        mantissa_ /= 10;
-        ++exponent_;
+        mantissa_ = detail::divPow10(mantissa_, e - exponent_);
+        exponent_ = e;
     }
-
-    while (e < exponent_)
+    else if (e < exponent_)
     {
-        m /= 10;
-        ++e;
+        m = detail::divPow10(m, exponent_ - e);
+        e = exponent_;
     }
 
     // This addition cannot overflow an std::int64_t but we may throw from
@@ -245,7 +250,7 @@ mulRatio(
     std::uint32_t den,
     bool roundUp)
 {
-    using namespace boost::multiprecision;
+    using uint128_t = detail::uint128;
 
     if (!den)
         Throw<std::runtime_error>("division by zero");
@@ -338,7 +343,7 @@ mulRatio(
             hasRem = bool(sav - low * powerTable[mustShrink]);
     }
 
-    std::int64_t mantissa = low.convert_to<std::int64_t>();
+    std::int64_t mantissa = static_cast<std::int64_t>(low);
 
     // normalize before rounding
     if (neg)
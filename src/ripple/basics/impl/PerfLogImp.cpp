@@ -24,6 +24,7 @@
 #include <ripple/json/json_writer.h>
 #include <ripple/json/to_string.h>
 #include <boost/optional.hpp>
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <cstdlib>
@@ -40,7 +41,8 @@ namespace perf {
 
 PerfLogImp::Counters::Counters(
     std::vector<char const*> const& labels,
-    JobTypes const& jobTypes)
+    JobTypes const& jobTypes,
+    TxFormats const& txFormats)
 {
     {
         // populateRpc
@@ -69,6 +71,19 @@ PerfLogImp::Counters::Counters(
             }
         }
     }
+    {
+        // populateTx
+        for (auto const& format : txFormats)
+        {
+            auto const inserted =
+                tx_.emplace(format.getType(), Tx(format.getName())).second;
+            if (!inserted)
+            {
+                // Ensure that no other function populates this entry.
+                assert(false);
+            }
+        }
+    }
 }
 
 Json::Value
@@ -165,11 +180,47 @@ PerfLogImp::Counters::countersJson() const
         jqobj[jss::total] = totalJqJson;
     }
 
+    Json::Value txobj(Json::objectValue);
+    for (auto const& proc : tx_)
+    {
+        Json::Value t(Json::objectValue);
+        {
+            auto const sync = [&proc]() -> boost::optional<Counters::Tx::Sync> {
+                std::lock_guard lock(proc.second.mut);
+                auto const& s = proc.second.sync;
+                if (std::all_of(
+                        s.count.begin(),
+                        s.count.end(),
+                        [](std::uint64_t c) { return c == 0; }) &&
+                    !s.reads && !s.writes)
+                {
+                    return boost::none;
+                }
+                return s;
+            }();
+            if (!sync)
+                continue;
+
+            for (std::size_t i = 0; i < txStages; ++i)
+            {
+                Json::Value stage(Json::objectValue);
+                stage[jss::count] = std::to_string(sync->count[i]);
+                stage[jss::duration_us] =
+                    std::to_string(sync->duration[i].count());
+                t[to_string(static_cast<TxStage>(i))] = stage;
+            }
+            t[jss::reads] = std::to_string(sync->reads);
+            t[jss::writes] = std::to_string(sync->writes);
+        }
+        txobj[proc.second.label] = t;
+    }
+
     Json::Value counters(Json::objectValue);
-    // Be kind to reporting tools and let them expect rpc and jq objects
-    // even if empty.
+    // Be kind to reporting tools and let them expect rpc, jq and
+    // transaction objects even if empty.
     counters[jss::rpc] = rpcobj;
     counters[jss::job_queue] = jqobj;
+    counters[jss::transactions] = txobj;
     return counters;
 }
 
@@ -438,6 +489,29 @@ PerfLogImp::jobFinish(JobType const type, microseconds dur, int instance)
         counters_.jobs_[instance] = {jtINVALID, steady_time_point()};
 }
 
+void
+PerfLogImp::txStage(TxType const type, TxStage const stage, microseconds dur)
+{
+    auto counter = counters_.tx_.find(type);
+    if (counter == counters_.tx_.end())
+        return;
+    auto const i = static_cast<std::size_t>(stage);
+    std::lock_guard lock(counter->second.mut);
+    ++counter->second.sync.count[i];
+    counter->second.sync.duration[i] += dur;
+}
+
+void
+PerfLogImp::txAccess(TxType const type, std::size_t reads, std::size_t writes)
+{
+    auto counter = counters_.tx_.find(type);
+    if (counter == counters_.tx_.end())
+        return;
+    std::lock_guard lock(counter->second.mut);
+    counter->second.sync.reads += reads;
+    counter->second.sync.writes += writes;
+}
+
 void
 PerfLogImp::resizeJobs(int const resize)
 {
@@ -27,6 +27,7 @@
 #include <ripple/protocol/jss.h>
 #include <ripple/rpc/impl/Handler.h>
 #include <boost/asio/ip/host_name.hpp>
+#include <array>
 #include <condition_variable>
 #include <cstdint>
 #include <fstream>
@@ -114,10 +115,42 @@ class PerfLogImp : public PerfLog, Stoppable
             }
         };
 
-        // rpc_ and jq_ do not need mutex protection because all
+        /**
+         * Transaction processing performance counters.
+         */
+        struct Tx
+        {
+            // Keep all items that need to be synchronized in one place
+            // to minimize copy overhead while locked.
+            struct Sync
+            {
+                // Counters for each time a stage runs and the cumulative
+                // duration of all of its runs.
+                std::array<std::uint64_t, txStages> count{};
+                std::array<microseconds, txStages> duration{};
+                // Ledger entries read and written while applying.
+                std::uint64_t reads{0};
+                std::uint64_t writes{0};
+            };
+
+            Sync sync;
+            std::string const label;
+            mutable std::mutex mut;
+
+            Tx(std::string const& labelArg) : label(labelArg)
+            {
+            }
+
+            Tx(Tx const& orig) : sync(orig.sync), label(orig.label)
+            {
+            }
+        };
+
+        // rpc_, jq_ and tx_ do not need mutex protection because all
         // keys and values are created before more threads are started.
         std::unordered_map<std::string, Rpc> rpc_;
         std::unordered_map<std::underlying_type_t<JobType>, Jq> jq_;
+        std::unordered_map<std::underlying_type_t<TxType>, Tx> tx_;
         std::vector<std::pair<JobType, steady_time_point>> jobs_;
         int workers_{0};
         mutable std::mutex jobsMutex_;
@@ -126,7 +159,8 @@ class PerfLogImp : public PerfLog, Stoppable
 
         Counters(
             std::vector<char const*> const& labels,
-            JobTypes const& jobTypes);
+            JobTypes const& jobTypes,
+            TxFormats const& txFormats);
         Json::Value
         countersJson() const;
         Json::Value
@@ -136,7 +170,10 @@ class PerfLogImp : public PerfLog, Stoppable
     Setup const setup_;
     beast::Journal const j_;
     std::function<void()> const signalStop_;
-    Counters counters_{ripple::RPC::getHandlerNames(), JobTypes::instance()};
+    Counters counters_{
+        ripple::RPC::getHandlerNames(),
+        JobTypes::instance(),
+        TxFormats::getInstance()};
     std::ofstream logFile_;
     std::thread thread_;
     std::mutex mutex_;
@@ -192,6 +229,12 @@ public:
         int instance) override;
     void
     jobFinish(JobType const type, microseconds dur, int instance) override;
+    void
+    txStage(TxType const type, TxStage const stage, microseconds dur)
+        override;
+    void
+    txAccess(TxType const type, std::size_t reads, std::size_t writes)
+        override;
 
     Json::Value
     countersJson() const override
@@ -17,9 +17,8 @@
 */
 //==============================================================================
 
-#include <ripple/basics/contract.h>
+#include <ripple/basics/FixedPoint.h>
 #include <ripple/basics/mulDiv.h>
-#include <boost/multiprecision/cpp_int.hpp>
 #include <limits>
 #include <utility>
 
@@ -28,12 +27,7 @@ namespace ripple {
 std::pair<bool, std::uint64_t>
 mulDiv(std::uint64_t value, std::uint64_t mul, std::uint64_t div)
 {
-    using namespace boost::multiprecision;
-
-    uint128_t result;
-    result = multiply(result, value, mul);
-
-    result /= div;
+    auto const result = detail::divide(detail::uint128(value) * mul, div);
 
     auto constexpr limit = std::numeric_limits<std::uint64_t>::max();
 
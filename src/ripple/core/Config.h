@@ -55,7 +55,8 @@ enum class SizedItem : std::size_t {
     nodeCacheAge,
     hashNodeDBCache,
     txnDBCache,
-    lgrDBCache
+    lgrDBCache,
+    fetchPackCacheSize
 };
 
 //  This entire derived class is deprecated.
@@ -149,6 +150,10 @@ public:
     int PATH_SEARCH_FAST = 2;
     int PATH_SEARCH_MAX = 10;
 
+    // Threads used to update path requests in parallel; 0 or 1 updates
+    // them serially.
+    std::size_t PATH_SEARCH_THREADS = 0;
+
     // Validation
     boost::optional<std::size_t>
         VALIDATION_QUORUM;  // validations to consider ledger authoritative
@@ -173,6 +178,10 @@ public:
     // Thread pool configuration
     std::size_t WORKERS = 0;
 
+    // Threads used to apply consensus transactions speculatively in
+    // parallel; 0 or 1 applies them serially.
+    std::size_t LEDGER_APPLY_THREADS = 0;
+
     // These override the command line client settings
     boost::optional<beast::IP::Endpoint> rpc_ip;
 
@@ -56,6 +56,7 @@ struct ConfigSection
 #define SECTION_FEE_ACCOUNT_RESERVE "fee_account_reserve"
 #define SECTION_FEE_OWNER_RESERVE "fee_owner_reserve"
 #define SECTION_FETCH_DEPTH "fetch_depth"
+#define SECTION_LEDGER_APPLY_THREADS "ledger_apply_threads"
 #define SECTION_LEDGER_HISTORY "ledger_history"
 #define SECTION_INSIGHT "insight"
 #define SECTION_IPS "ips"
@@ -67,6 +68,7 @@ struct ConfigSection
 #define SECTION_PATH_SEARCH "path_search"
 #define SECTION_PATH_SEARCH_FAST "path_search_fast"
 #define SECTION_PATH_SEARCH_MAX "path_search_max"
+#define SECTION_PATH_SEARCH_THREADS "path_search_threads"
 #define SECTION_PEER_PRIVATE "peer_private"
 #define SECTION_PEERS_MAX "peers_max"
 #define SECTION_RPC_STARTUP "rpc_startup"
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_CORE_IOCONTEXTPOOL_H_INCLUDED
+#define RIPPLE_CORE_IOCONTEXTPOOL_H_INCLUDED
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+/** A set of io_contexts, each run by its own thread.
+
+    Sockets are spread over the contexts so that the work of reading,
+    writing and dispatching completion handlers for many connections is
+    shared by several threads without any of them contending on a single
+    io_context. Each connection stays on the context it was given for its
+    whole life, so a connection's handlers always run on the same thread.
+
+    Optionally each thread is pinned to its own core.
+*/
+class IOContextPool
+{
+public:
+    /** Create the pool and start its threads.
+
+        @param size The number of contexts, each with one thread.
+        @param pin Whether to pin each thread to a core.
+        @param name Prefix for the thread names.
+    */
+    IOContextPool(std::size_t size, bool pin, std::string const& name);
+
+    /** Wait for all work to complete and stop the threads. */
+    ~IOContextPool();
+
+    IOContextPool(IOContextPool const&) = delete;
+    IOContextPool&
+    operator=(IOContextPool const&) = delete;
+
+    std::size_t
+    size() const
+    {
+        return contexts_.size();
+    }
+
+    /** Returns the context to place the next connection on. */
+    boost::asio::io_context&
+    next();
+
+    boost::asio::io_context&
+    operator[](std::size_t i)
+    {
+        return contexts_[i]->ioc;
+    }
+
+private:
+    struct Context
+    {
+        boost::asio::io_context ioc{1};
+        boost::asio::executor_work_guard<
+            boost::asio::io_context::executor_type>
+            work{ioc.get_executor()};
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Context>> contexts_;
+    std::atomic<std::size_t> next_{0};
+};
+
+}  // namespace ripple
+
+#endif
@@ -38,6 +38,7 @@ enum JobType {
     // earlier jobs having lower priority than later jobs. If you wish to
     // insert a job at a specific priority, simply add it at the right location.
 
+    jtCOPY_ACCT_TX,   // Copy account transactions to their index
     jtPACK,           // Make a fetch pack for a peer
     jtPUBOLDLEDGER,   // An old ledger has been accepted
     jtVALIDATION_ut,  // A validation from an untrusted source
@@ -48,7 +49,10 @@ enum JobType {
     jtCLIENT,         // A websocket command from the client
     jtRPC,            // A websocket command from the client
     jtUPDATE_PF,      // Update pathfinding requests
+    jtPATH_SEARCH,    // Update a group of pathfinding requests
+    jtTRUST_LINES,    // Bring the trust line graph up to a closed ledger
     jtTRANSACTION,    // A transaction received from the network
+    jtTXN_PREFLIGHT,  // Check a transaction before it is batched
     jtBATCH,          // Apply batched transactions
     jtADVANCE,        // Advance validated/acquired ledgers
     jtPUBLEDGER,      // Publish a fully-accepted ledger
@@ -57,6 +61,7 @@ enum JobType {
     jtVALIDATION_t,   // A validation from a trusted source
     jtWRITE,          // Write out hashed objects
     jtACCEPT,         // Accept a consensus ledger
+    jtTXN_SPECULATE,  // Speculatively apply a consensus transaction set
     jtPROPOSAL_t,     // A proposal from a trusted source
     jtSWEEP,          // Sweep for stale structures
     jtNETOP_CLUSTER,  // NetworkOPs cluster peer report
@@ -228,6 +228,22 @@ public:
     void
     rendezvous();
 
+    /** Call f(i) for each i in [0, count), on up to `threads` threads.
+
+        The calling thread does part of the work, helped by up to
+        threads - 1 jobs of the given type, so no thread is created. A
+        helper that starts after every index has been taken returns at
+        once: when the queue is busy, the caller does more of the work
+        itself. Returns when every call to f has returned. f must not throw.
+    */
+    void
+    parallelFor(
+        JobType type,
+        std::string const& name,
+        std::size_t count,
+        std::size_t threads,
+        std::function<void(std::size_t)> const& f);
+
 private:
     friend class Coro;
 
@@ -48,6 +48,7 @@ private:
         using namespace std::chrono_literals;
         int maxLimit = std::numeric_limits<int>::max();
 
+        add(jtCOPY_ACCT_TX, "copyAccountTxs", 1, false, 0ms, 0ms);
         add(jtPACK, "makeFetchPack", 1, false, 0ms, 0ms);
         add(jtPUBOLDLEDGER, "publishAcqLedger", 2, false, 10000ms, 15000ms);
         add(jtVALIDATION_ut,
@@ -63,7 +64,15 @@ private:
         add(jtCLIENT, "clientCommand", maxLimit, false, 2000ms, 5000ms);
         add(jtRPC, "RPC", maxLimit, false, 0ms, 0ms);
         add(jtUPDATE_PF, "updatePaths", maxLimit, false, 0ms, 0ms);
+        add(jtPATH_SEARCH, "searchPaths", maxLimit, false, 0ms, 0ms);
+        add(jtTRUST_LINES, "updateTrustLines", 1, false, 0ms, 0ms);
         add(jtTRANSACTION, "transaction", maxLimit, false, 250ms, 1000ms);
+        add(jtTXN_PREFLIGHT,
+            "transactionPreflight",
+            maxLimit,
+            false,
+            250ms,
+            1000ms);
         add(jtBATCH, "batch", maxLimit, false, 250ms, 1000ms);
         add(jtADVANCE, "advanceLedger", maxLimit, false, 0ms, 0ms);
         add(jtPUBLEDGER, "publishNewLedger", maxLimit, false, 3000ms, 4500ms);
@@ -77,6 +86,12 @@ private:
             1500ms);
         add(jtWRITE, "writeObjects", maxLimit, false, 1750ms, 2500ms);
         add(jtACCEPT, "acceptLedger", maxLimit, false, 0ms, 0ms);
+        add(jtTXN_SPECULATE,
+            "speculateTransactions",
+            maxLimit,
+            false,
+            0ms,
+            0ms);
         add(jtPROPOSAL_t, "trustedProposal", maxLimit, false, 100ms, 500ms);
         add(jtSWEEP, "sweep", maxLimit, false, 0ms, 0ms);
         add(jtNETOP_CLUSTER, "clusterReport", 1, false, 9999ms, 9999ms);
@@ -39,7 +39,7 @@
 
 namespace ripple {
 
-inline constexpr std::array<std::pair<SizedItem, std::array<int, 5>>, 11>
+inline constexpr std::array<std::pair<SizedItem, std::array<int, 5>>, 12>
     sizedItems{{
         // FIXME: We should document each of these items, explaining exactly
         // what
@@ -56,6 +56,7 @@ inline constexpr std::array<std::pair<SizedItem, std::array<int, 5>>, 11>
         {SizedItem::hashNodeDBCache, {{4, 12, 24, 64, 128}}},
         {SizedItem::txnDBCache, {{4, 12, 24, 64, 128}}},
         {SizedItem::lgrDBCache, {{4, 8, 16, 32, 128}}},
+        {SizedItem::fetchPackCacheSize, {{8, 16, 32, 64, 256}}},
     }};
 
 // Ensure that the order of entries in the table corresponds to the
@@ -446,6 +447,8 @@ Config::loadFromString(std::string const& fileContents)
         PATH_SEARCH_FAST = beast::lexicalCastThrow<int>(strTemp);
     if (getSingleSection(secConfig, SECTION_PATH_SEARCH_MAX, strTemp, j_))
         PATH_SEARCH_MAX = beast::lexicalCastThrow<int>(strTemp);
+    if (getSingleSection(secConfig, SECTION_PATH_SEARCH_THREADS, strTemp, j_))
+        PATH_SEARCH_THREADS = beast::lexicalCastThrow<std::size_t>(strTemp);
 
     if (getSingleSection(secConfig, SECTION_DEBUG_LOGFILE, strTemp, j_))
         DEBUG_LOGFILE = strTemp;
@@ -453,6 +456,10 @@ Config::loadFromString(std::string const& fileContents)
     if (getSingleSection(secConfig, SECTION_WORKERS, strTemp, j_))
         WORKERS = beast::lexicalCastThrow<std::size_t>(strTemp);
 
+    if (getSingleSection(
+            secConfig, SECTION_LEDGER_APPLY_THREADS, strTemp, j_))
+        LEDGER_APPLY_THREADS = beast::lexicalCastThrow<std::size_t>(strTemp);
+
     if (getSingleSection(secConfig, SECTION_COMPRESSION, strTemp, j_))
         COMPRESSION = beast::lexicalCastThrow<bool>(strTemp);
 
@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/core/IOContextPool.h>
+#include <ripple/beast/core/CurrentThreadName.h>
+#include <cassert>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ripple {
+
+namespace {
+
+void
+pinToCore(std::thread& t, std::size_t index)
+{
+#ifdef __linux__
+    auto const cores = std::thread::hardware_concurrency();
+    if (cores == 0)
+        return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cores, &set);
+    pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+#else
+    (void)t;
+    (void)index;
+#endif
+}
+
+}  // namespace
+
+IOContextPool::IOContextPool(
+    std::size_t size,
+    bool pin,
+    std::string const& name)
+{
+    assert(size != 0);
+
+    contexts_.reserve(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        auto& c = *contexts_.emplace_back(std::make_unique<Context>());
+        c.thread = std::thread([&c, name, i]() {
+            beast::setCurrentThreadName(name + " #" + std::to_string(i));
+            c.ioc.run();
+        });
+        if (pin)
+            pinToCore(c.thread, i);
+    }
+}
+
+IOContextPool::~IOContextPool()
+{
+    for (auto& c : contexts_)
+        c->work.reset();
+
+    for (auto& c : contexts_)
+        c->thread.join();
+}
+
+boost::asio::io_context&
+IOContextPool::next()
+{
+    return contexts_[next_++ % contexts_.size()]->ioc;
+}
+
+}  // namespace ripple
@@ -20,6 +20,11 @@
 #include <ripple/basics/PerfLog.h>
 #include <ripple/basics/contract.h>
 #include <ripple/core/JobQueue.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 
 namespace ripple {
 
@@ -279,6 +284,57 @@ JobQueue::rendezvous()
     cv_.wait(lock, [&] { return m_processCount == 0 && m_jobSet.empty(); });
 }
 
+void
+JobQueue::parallelFor(
+    JobType type,
+    std::string const& name,
+    std::size_t count,
+    std::size_t threads,
+    std::function<void(std::size_t)> const& f)
+{
+    // Shared with the helper jobs, which may only start after we return
+    struct State
+    {
+        std::atomic<std::size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::size_t active = 0;
+        bool done = false;
+    };
+
+    auto const state = std::make_shared<State>();
+    auto const work = [&f, count](State& s) {
+        for (auto i = s.next++; i < count; i = s.next++)
+            f(i);
+    };
+
+    auto const n = std::min(threads, count);
+    for (std::size_t i = 1; i < n; ++i)
+    {
+        addJob(type, name, [state, &work](Job&) {
+            {
+                std::lock_guard lock(state->mutex);
+                if (state->done)
+                    return;
+                ++state->active;
+            }
+
+            work(*state);
+
+            std::lock_guard lock(state->mutex);
+            if (--state->active == 0)
+                state->cv.notify_all();
+        });
+    }
+
+    work(*state);
+
+    // Every index is taken: wait for the helpers still working on one
+    std::unique_lock lock(state->mutex);
+    state->done = true;
+    state->cv.wait(lock, [&state] { return state->active == 0; });
+}
+
 JobTypeData&
 JobQueue::getJobTypeData(JobType type)
 {
@@ -74,6 +74,11 @@ public:
     std::size_t
     size();
 
+    /** Get the number of entries looked up
+     */
+    std::size_t
+    reads() const;
+
     /** Visit modified entries
      */
     void
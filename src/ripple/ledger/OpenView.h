@@ -20,8 +20,8 @@
 #ifndef RIPPLE_LEDGER_OPENVIEW_H_INCLUDED
 #define RIPPLE_LEDGER_OPENVIEW_H_INCLUDED
 
+#include <ripple/basics/PersistentMap.h>
 #include <ripple/basics/XRPAmount.h>
-#include <ripple/basics/qalloc.h>
 #include <ripple/ledger/RawView.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/ledger/detail/RawStateTable.h>
@@ -54,20 +54,13 @@ class OpenView final : public ReadView, public TxsRawView
 private:
     class txs_iter_impl;
 
-    // List of tx, key order
-    using txs_map = std::map<
+    // List of tx, key order. Shares structure between copies, see
+    // RawStateTable.
+    using txs_map = PersistentMap<
         key_type,
         std::pair<
             std::shared_ptr<Serializer const>,
-            std::shared_ptr<Serializer const>>,
-        std::less<key_type>,
-        qalloc_type<
-            std::pair<
-                key_type const,
-                std::pair<
-                    std::shared_ptr<Serializer const>,
-                    std::shared_ptr<Serializer const>>>,
-            false>>;
+            std::shared_ptr<Serializer const>>>;
 
     Rules rules_;
     txs_map txs_;
@@ -93,6 +86,11 @@ public:
             Creates a new object with a copy of
             the modification state table.
 
+        The state table and the tx list share their
+        structure with the original, so the copy takes
+        constant time regardless of how much the view
+        holds.
+
         The objects managed by shared pointers are
         not duplicated but shared between instances.
         Since the SLEs are immutable, calls on the
@@ -26,6 +26,7 @@
 #include <ripple/protocol/AccountID.h>
 #include <map>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -97,6 +98,26 @@ private:
 
 //------------------------------------------------------------------------------
 
+/** The keys of ledger entries accessed through a PaymentSandbox.
+
+    @see PaymentSandbox::recordReads, PaymentSandbox::recordWrites
+*/
+struct AccessedKeys
+{
+    /** Entries read or written, by key. */
+    std::vector<uint256> keys;
+
+    /** Open ranges of keys searched with succ(), as (key, last). */
+    std::vector<std::pair<uint256, boost::optional<uint256>>> ranges;
+
+    void
+    clear()
+    {
+        keys.clear();
+        ranges.clear();
+    }
+};
+
 /** A wrapper which makes credits unavailable to balances.
 
     This is used for payments and pathfinding, so that consuming
@@ -202,9 +223,62 @@ public:
     XRPAmount
     xrpDestroyed() const;
 
+    /** Record the keys of the entries read from this view.
+
+        Reads answered by a view stacked on this one, without asking
+        this one, are not recorded. Pass nullptr to stop recording.
+    */
+    void
+    recordReads(AccessedKeys* keys)
+    {
+        reads_ = keys;
+    }
+
+    /** Record the keys of the entries written to this view.
+
+        Writes which reach this view through apply() are recorded too.
+        Pass nullptr to stop recording.
+    */
+    void
+    recordWrites(AccessedKeys* keys)
+    {
+        writes_ = keys;
+    }
+
+    bool
+    exists(Keylet const& k) const override;
+
+    boost::optional<key_type>
+    succ(
+        key_type const& key,
+        boost::optional<key_type> const& last = boost::none) const override;
+
+    std::shared_ptr<SLE const>
+    read(Keylet const& k) const override;
+
+    void
+    erase(std::shared_ptr<SLE> const& sle) override;
+
+    void
+    insert(std::shared_ptr<SLE> const& sle) override;
+
+    void
+    update(std::shared_ptr<SLE> const& sle) override;
+
+    void
+    rawErase(std::shared_ptr<SLE> const& sle) override;
+
+    void
+    rawInsert(std::shared_ptr<SLE> const& sle) override;
+
+    void
+    rawReplace(std::shared_ptr<SLE> const& sle) override;
+
 private:
     detail::DeferredCredits tab_;
     PaymentSandbox const* ps_ = nullptr;
+    AccessedKeys* reads_ = nullptr;
+    AccessedKeys* writes_ = nullptr;
 };
 
 }  // namespace ripple
@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_LEDGER_RECORDINGVIEW_H_INCLUDED
+#define RIPPLE_LEDGER_RECORDINGVIEW_H_INCLUDED
+
+#include <ripple/ledger/ReadView.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** A ReadView that records what is read through it.
+
+    Point reads are recorded by key, along with the state item that was
+    returned. Anything whose result depends on which keys exist in a
+    range, such as succ() or iterating the state or transaction maps,
+    only marks the view as ranged, since no key set can describe it.
+*/
+class RecordingView : public ReadView
+{
+public:
+    /// A key read, and the state item found there, if any
+    using Read = std::pair<key_type, std::shared_ptr<SLE const>>;
+
+    explicit RecordingView(ReadView const& base) : base_(base)
+    {
+    }
+
+    RecordingView(RecordingView const&) = delete;
+    RecordingView&
+    operator=(RecordingView const&) = delete;
+
+    /// Every point read, in order, possibly repeated
+    std::vector<Read> const&
+    reads() const
+    {
+        return reads_;
+    }
+
+    /// Whether anything was read that the recorded keys do not describe
+    bool
+    ranged() const
+    {
+        return ranged_;
+    }
+
+    LedgerInfo const&
+    info() const override
+    {
+        return base_.info();
+    }
+
+    bool
+    open() const override
+    {
+        return base_.open();
+    }
+
+    Fees const&
+    fees() const override
+    {
+        return base_.fees();
+    }
+
+    Rules const&
+    rules() const override
+    {
+        return base_.rules();
+    }
+
+    bool
+    exists(Keylet const& k) const override
+    {
+        // Read the item so that the recording says what was there
+        auto sle = base_.read(keylet::unchecked(k.key));
+        bool const found = static_cast<bool>(sle);
+        reads_.emplace_back(k.key, std::move(sle));
+        return found;
+    }
+
+    boost::optional<key_type>
+    succ(key_type const& key, boost::optional<key_type> const& last)
+        const override
+    {
+        ranged_ = true;
+        return base_.succ(key, last);
+    }
+
+    std::shared_ptr<SLE const>
+    read(Keylet const& k) const override
+    {
+        auto sle = base_.read(k);
+        reads_.emplace_back(k.key, sle);
+        return sle;
+    }
+
+    STAmount
+    balanceHook(
+        AccountID const& account,
+        AccountID const& issuer,
+        STAmount const& amount) const override
+    {
+        return base_.balanceHook(account, issuer, amount);
+    }
+
+    std::uint32_t
+    ownerCountHook(AccountID const& account, std::uint32_t count)
+        const override
+    {
+        return base_.ownerCountHook(account, count);
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesBegin() const override
+    {
+        ranged_ = true;
+        return base_.slesBegin();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesEnd() const override
+    {
+        ranged_ = true;
+        return base_.slesEnd();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesUpperBound(key_type const& key) const override
+    {
+        ranged_ = true;
+        return base_.slesUpperBound(key);
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsBegin() const override
+    {
+        ranged_ = true;
+        return base_.txsBegin();
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsEnd() const override
+    {
+        ranged_ = true;
+        return base_.txsEnd();
+    }
+
+    bool
+    txExists(key_type const& key) const override
+    {
+        ranged_ = true;
+        return base_.txExists(key);
+    }
+
+    tx_type
+    txRead(key_type const& key) const override
+    {
+        ranged_ = true;
+        return base_.txRead(key);
+    }
+
+private:
+    ReadView const& base_;
+    std::vector<Read> mutable reads_;
+    bool mutable ranged_ = false;
+};
+
+}  // namespace ripple
+
+#endif
@@ -20,6 +20,7 @@
 #ifndef RIPPLE_LEDGER_APPLYSTATETABLE_H_INCLUDED
 #define RIPPLE_LEDGER_APPLYSTATETABLE_H_INCLUDED
 
+#include <ripple/basics/Arena.h>
 #include <ripple/basics/XRPAmount.h>
 #include <ripple/beast/utility/Journal.h>
 #include <ripple/ledger/OpenView.h>
@@ -27,6 +28,7 @@
 #include <ripple/ledger/ReadView.h>
 #include <ripple/ledger/TxMeta.h>
 #include <ripple/protocol/TER.h>
+#include <boost/container/flat_map.hpp>
 #include <memory>
 
 namespace ripple {
@@ -46,14 +48,40 @@ private:
         modify,
     };
 
-    using items_t = std::map<key_type, std::pair<Action, std::shared_ptr<SLE>>>;
+    using item_t = std::pair<key_type, std::pair<Action, std::shared_ptr<SLE>>>;
 
+    // A sorted vector in memory from the arena. A transaction touches few
+    // entries, so lookups are cheap and, for a table on the stack, usually
+    // nothing is allocated from the heap. Dropping the table releases all
+    // of it at once.
+    using items_t = boost::container::flat_map<
+        key_type,
+        std::pair<Action, std::shared_ptr<SLE>>,
+        std::less<key_type>,
+        ArenaAllocator<item_t>>;
+
+    Arena arena_;
     items_t items_;
     XRPAmount dropsDestroyed_{0};
+    // Number of times an entry was looked up
+    std::size_t mutable reads_ = 0;
+
+    // Space reserved up front, as much as the arena holds inline
+    static constexpr std::size_t initialItems =
+        Arena::inlineSize / sizeof(item_t);
 
 public:
-    ApplyStateTable() = default;
-    ApplyStateTable(ApplyStateTable&&) = default;
+    ApplyStateTable() : items_(items_t::allocator_type(arena_))
+    {
+        items_.reserve(initialItems);
+    }
+
+    ApplyStateTable(ApplyStateTable&& other)
+        : items_(std::move(other.items_), items_t::allocator_type(arena_))
+        , dropsDestroyed_(other.dropsDestroyed_)
+        , reads_(other.reads_)
+    {
+    }
 
     ApplyStateTable(ApplyStateTable const&) = delete;
     ApplyStateTable&
@@ -90,6 +118,13 @@ public:
     std::size_t
     size() const;
 
+    /** Number of entries looked up through exists, read or peek */
+    std::size_t
+    reads() const
+    {
+        return reads_;
+    }
+
     void
     visit(
         ReadView const& base,
@@ -20,16 +20,18 @@
 #ifndef RIPPLE_LEDGER_RAWSTATETABLE_H_INCLUDED
 #define RIPPLE_LEDGER_RAWSTATETABLE_H_INCLUDED
 
-#include <ripple/basics/qalloc.h>
+#include <ripple/basics/PersistentMap.h>
 #include <ripple/ledger/RawView.h>
 #include <ripple/ledger/ReadView.h>
-#include <map>
 #include <utility>
 
 namespace ripple {
 namespace detail {
 
 // Helper class that buffers raw modifications
+//
+// Copies share the table's structure, so copying is constant time and a
+// copy only pays for the entries it changes afterwards.
 class RawStateTable
 {
 public:
@@ -89,13 +91,8 @@ private:
 
     class sles_iter_impl;
 
-    using items_t = std::map<
-        key_type,
-        std::pair<Action, std::shared_ptr<SLE>>,
-        std::less<key_type>,
-        qalloc_type<
-            std::pair<key_type const, std::pair<Action, std::shared_ptr<SLE>>>,
-            false>>;
+    using items_t =
+        PersistentMap<key_type, std::pair<Action, std::shared_ptr<SLE>>>;
 
     items_t items_;
     XRPAmount dropsDestroyed_{0};
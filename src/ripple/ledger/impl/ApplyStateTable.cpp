@@ -269,6 +269,7 @@ ApplyStateTable::apply(
 bool
 ApplyStateTable::exists(ReadView const& base, Keylet const& k) const
 {
+    ++reads_;
     auto const iter = items_.find(k.key);
     if (iter == items_.end())
         return base.exists(k);
@@ -326,6 +327,7 @@ ApplyStateTable::succ(
 std::shared_ptr<SLE const>
 ApplyStateTable::read(ReadView const& base, Keylet const& k) const
 {
+    ++reads_;
     auto const iter = items_.find(k.key);
     if (iter == items_.end())
         return base.read(k);
@@ -348,6 +350,7 @@ ApplyStateTable::read(ReadView const& base, Keylet const& k) const
 std::shared_ptr<SLE>
 ApplyStateTable::peek(ReadView const& base, Keylet const& k)
 {
+    ++reads_;
     auto iter = items_.lower_bound(k.key);
     if (iter == items_.end() || iter->first != k.key)
     {
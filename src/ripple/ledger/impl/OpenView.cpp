@@ -184,21 +184,20 @@ OpenView::txsEnd() const -> std::unique_ptr<txs_type::iter_base>
 bool
 OpenView::txExists(key_type const& key) const
 {
-    return txs_.find(key) != txs_.end();
+    return txs_.count(key) != 0;
 }
 
 auto
 OpenView::txRead(key_type const& key) const -> tx_type
 {
-    auto const iter = txs_.find(key);
-    if (iter == txs_.end())
+    auto const item = txs_.lookup(key);
+    if (!item)
         return base_->txRead(key);
-    auto const& item = iter->second;
-    auto stx = std::make_shared<STTx const>(SerialIter{item.first->slice()});
+    auto stx = std::make_shared<STTx const>(SerialIter{item->first->slice()});
     decltype(tx_type::second) sto;
-    if (item.second)
+    if (item->second)
         sto = std::make_shared<STObject const>(
-            SerialIter{item.second->slice()}, sfMetadata);
+            SerialIter{item->second->slice()}, sfMetadata);
     else
         sto = nullptr;
     return {std::move(stx), std::move(sto)};
@@ -240,8 +239,7 @@ OpenView::rawTxInsert(
     std::shared_ptr<Serializer const> const& txn,
     std::shared_ptr<Serializer const> const& metaData)
 {
-    auto const result = txs_.emplace(key, std::make_pair(txn, metaData));
-    if (!result.second)
+    if (!txs_.insert(key, std::make_pair(txn, metaData)))
         LogicError("rawTxInsert: duplicate TX id" + to_string(key));
 }
 
@@ -251,6 +251,79 @@ PaymentSandbox::adjustOwnerCountHook(
     tab_.ownerCount(account, cur, next);
 }
 
+bool
+PaymentSandbox::exists(Keylet const& k) const
+{
+    if (reads_)
+        reads_->keys.push_back(k.key);
+    return ApplyViewBase::exists(k);
+}
+
+auto
+PaymentSandbox::succ(key_type const& key, boost::optional<key_type> const& last)
+    const -> boost::optional<key_type>
+{
+    if (reads_)
+        reads_->ranges.emplace_back(key, last);
+    return ApplyViewBase::succ(key, last);
+}
+
+std::shared_ptr<SLE const>
+PaymentSandbox::read(Keylet const& k) const
+{
+    if (reads_)
+        reads_->keys.push_back(k.key);
+    return ApplyViewBase::read(k);
+}
+
+void
+PaymentSandbox::erase(std::shared_ptr<SLE> const& sle)
+{
+    if (writes_)
+        writes_->keys.push_back(sle->key());
+    ApplyViewBase::erase(sle);
+}
+
+void
+PaymentSandbox::insert(std::shared_ptr<SLE> const& sle)
+{
+    if (writes_)
+        writes_->keys.push_back(sle->key());
+    ApplyViewBase::insert(sle);
+}
+
+void
+PaymentSandbox::update(std::shared_ptr<SLE> const& sle)
+{
+    if (writes_)
+        writes_->keys.push_back(sle->key());
+    ApplyViewBase::update(sle);
+}
+
+void
+PaymentSandbox::rawErase(std::shared_ptr<SLE> const& sle)
+{
+    if (writes_)
+        writes_->keys.push_back(sle->key());
+    ApplyViewBase::rawErase(sle);
+}
+
+void
+PaymentSandbox::rawInsert(std::shared_ptr<SLE> const& sle)
+{
+    if (writes_)
+        writes_->keys.push_back(sle->key());
+    ApplyViewBase::rawInsert(sle);
+}
+
+void
+PaymentSandbox::rawReplace(std::shared_ptr<SLE> const& sle)
+{
+    if (writes_)
+        writes_->keys.push_back(sle->key());
+    ApplyViewBase::rawReplace(sle);
+}
+
 void
 PaymentSandbox::apply(RawView& to)
 {
@@ -176,13 +176,12 @@ bool
 RawStateTable::exists(ReadView const& base, Keylet const& k) const
 {
     assert(k.key.isNonZero());
-    auto const iter = items_.find(k.key);
-    if (iter == items_.end())
+    auto const item = items_.lookup(k.key);
+    if (!item)
         return base.exists(k);
-    auto const& item = iter->second;
-    if (item.first == Action::erase)
+    if (item->first == Action::erase)
         return false;
-    if (!k.check(*item.second))
+    if (!k.check(*item->second))
         return false;
     return true;
 }
@@ -198,18 +197,19 @@ RawStateTable::succ(
     boost::optional<key_type> const& last) const -> boost::optional<key_type>
 {
     boost::optional<key_type> next = key;
-    items_t::const_iterator iter;
     // Find base successor that is
     // not also deleted in our list
-    do
+    for (;;)
     {
         next = base.succ(*next, last);
         if (!next)
             break;
-        iter = items_.find(*next);
-    } while (iter != items_.end() && iter->second.first == Action::erase);
+        auto const item = items_.lookup(*next);
+        if (!item || item->first != Action::erase)
+            break;
+    }
     // Find non-deleted successor in our list
-    for (iter = items_.upper_bound(key); iter != items_.end(); ++iter)
+    for (auto iter = items_.upper_bound(key); iter != items_.end(); ++iter)
     {
         if (iter->second.first != Action::erase)
         {
@@ -230,24 +230,22 @@ void
 RawStateTable::erase(std::shared_ptr<SLE> const& sle)
 {
     // The base invariant is checked during apply
-    auto const result = items_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(sle->key()),
-        std::forward_as_tuple(Action::erase, sle));
-    if (result.second)
+    auto const item = items_.lookup(sle->key());
+    if (!item)
+    {
+        items_.insert(sle->key(), {Action::erase, sle});
         return;
-    auto& item = result.first->second;
-    switch (item.first)
+    }
+    switch (item->first)
     {
         case Action::erase:
             LogicError("RawStateTable::erase: already erased");
             break;
         case Action::insert:
-            items_.erase(result.first);
+            items_.erase(sle->key());
             break;
         case Action::replace:
-            item.first = Action::erase;
-            item.second = sle;
+            items_.insert_or_assign(sle->key(), {Action::erase, sle});
             break;
     }
 }
@@ -255,18 +253,16 @@ RawStateTable::erase(std::shared_ptr<SLE> const& sle)
 void
 RawStateTable::insert(std::shared_ptr<SLE> const& sle)
 {
-    auto const result = items_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(sle->key()),
-        std::forward_as_tuple(Action::insert, sle));
-    if (result.second)
+    auto const item = items_.lookup(sle->key());
+    if (!item)
+    {
+        items_.insert(sle->key(), {Action::insert, sle});
         return;
-    auto& item = result.first->second;
-    switch (item.first)
+    }
+    switch (item->first)
     {
         case Action::erase:
-            item.first = Action::replace;
-            item.second = sle;
+            items_.insert_or_assign(sle->key(), {Action::replace, sle});
             break;
         case Action::insert:
             LogicError("RawStateTable::insert: already inserted");
@@ -280,21 +276,20 @@ RawStateTable::insert(std::shared_ptr<SLE> const& sle)
 void
 RawStateTable::replace(std::shared_ptr<SLE> const& sle)
 {
-    auto const result = items_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(sle->key()),
-        std::forward_as_tuple(Action::replace, sle));
-    if (result.second)
+    auto const item = items_.lookup(sle->key());
+    if (!item)
+    {
+        items_.insert(sle->key(), {Action::replace, sle});
         return;
-    auto& item = result.first->second;
-    switch (item.first)
+    }
+    switch (item->first)
     {
         case Action::erase:
             LogicError("RawStateTable::replace: was erased");
             break;
         case Action::insert:
         case Action::replace:
-            item.second = sle;
+            items_.insert_or_assign(sle->key(), {item->first, sle});
             break;
     }
 }
@@ -302,14 +297,13 @@ RawStateTable::replace(std::shared_ptr<SLE> const& sle)
 std::shared_ptr<SLE const>
 RawStateTable::read(ReadView const& base, Keylet const& k) const
 {
-    auto const iter = items_.find(k.key);
-    if (iter == items_.end())
+    auto const item = items_.lookup(k.key);
+    if (!item)
         return base.read(k);
-    auto const& item = iter->second;
-    if (item.first == Action::erase)
+    if (item->first == Action::erase)
         return nullptr;
     // Convert to SLE const
-    std::shared_ptr<SLE const> sle = item.second;
+    std::shared_ptr<SLE const> sle = item->second;
     if (!k.check(*sle))
         return nullptr;
     return sle;
@@ -24,6 +24,7 @@
 #include <ripple/basics/CountedObject.h>
 #include <ripple/core/Stoppable.h>
 #include <ripple/json/json_value.h>
+#include <ripple/net/StreamMessage.h>
 #include <ripple/protocol/Book.h>
 #include <ripple/resource/Consumer.h>
 #include <mutex>
@@ -164,6 +165,17 @@ public:
     virtual void
     send(Json::Value const& jvObj, bool broadcast) = 0;
 
+    /** Send a message which is published to many subscribers.
+
+        Subscribers which write the message out as text use the text the
+        message keeps, rather than rendering the JSON again.
+    */
+    virtual void
+    send(std::shared_ptr<StreamMessage const> const& msg, bool broadcast)
+    {
+        send(msg->json(), broadcast);
+    }
+
     std::uint64_t
     getSeq();
 
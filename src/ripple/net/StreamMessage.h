@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NET_STREAMMESSAGE_H_INCLUDED
+#define RIPPLE_NET_STREAMMESSAGE_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <ripple/json/json_writer.h>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace ripple {
+
+/** A message published to every subscriber of a stream.
+
+    The JSON is rendered the first time a subscriber asks for the text,
+    and every other subscriber is handed the same text. A message is never
+    changed once it is made, so it is shared between threads freely.
+*/
+class StreamMessage
+{
+public:
+    explicit StreamMessage(Json::Value json) : json_(std::move(json))
+    {
+    }
+
+    StreamMessage(StreamMessage const&) = delete;
+    StreamMessage&
+    operator=(StreamMessage const&) = delete;
+
+    Json::Value const&
+    json() const
+    {
+        return json_;
+    }
+
+    /** The JSON as Json::stream writes it. */
+    std::string const&
+    text() const
+    {
+        std::call_once(rendered_, [this] {
+            Json::stream(json_, [this](void const* data, std::size_t n) {
+                text_.append(static_cast<char const*>(data), n);
+            });
+        });
+        return text_;
+    }
+
+private:
+    Json::Value const json_;
+    mutable std::once_flag rendered_;
+    mutable std::string text_;
+};
+
+}  // namespace ripple
+
+#endif
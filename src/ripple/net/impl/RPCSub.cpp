@@ -73,6 +73,8 @@ public:
 
     ~RPCSubImp() = default;
 
+    using InfoSub::send;
+
     void
     send(Json::Value const& jvObj, bool broadcast) override
     {
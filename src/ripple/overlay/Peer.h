@@ -61,6 +61,14 @@ public:
     virtual void
     send(std::shared_ptr<Message> const& m) = 0;
 
+    /** Returns the number of messages waiting to be written to the peer.
+
+        Messages passed to send() from any thread are counted as soon as
+        send() returns.
+    */
+    virtual std::size_t
+    sendQueueSize() const = 0;
+
     virtual beast::IP::Endpoint
     getRemoteAddress() const = 0;
 
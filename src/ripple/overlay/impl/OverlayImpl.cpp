@@ -140,11 +140,13 @@ OverlayImpl::OverlayImpl(
     Resource::Manager& resourceManager,
     Resolver& resolver,
     boost::asio::io_service& io_service,
+    IOContextPool* peerIO,
     BasicConfig const& config,
     beast::insight::Collector::ptr const& collector)
     : Overlay(parent)
     , app_(app)
     , io_service_(io_service)
+    , peerIO_(peerIO)
     , work_(boost::in_place(std::ref(io_service_)))
     , strand_(io_service_)
     , setup_(setup)
@@ -158,6 +160,7 @@ OverlayImpl::OverlayImpl(
           app_.journal("PeerFinder"),
           config,
           collector))
+    , active_(std::make_shared<std::vector<std::weak_ptr<PeerImp>>>())
     , m_resolver(resolver)
     , next_id_(1)
     , timer_count_(0)
@@ -435,9 +438,10 @@ OverlayImpl::connect(beast::IP::Endpoint const& remote_endpoint)
         return;
     }
 
+    // The connection stays on this context once it becomes a peer.
     auto const p = std::make_shared<ConnectAttempt>(
         app_,
-        io_service_,
+        peerIO_ ? peerIO_->next() : io_service_,
         beast::IPAddressConversion::to_asio_endpoint(remote_endpoint),
         usage,
         setup_.context,
@@ -472,6 +476,7 @@ OverlayImpl::add_active(std::shared_ptr<PeerImp> const& peer)
             std::make_tuple(peer));
         assert(result.second);
         (void)result.second;
+        updateActive();
     }
 
     list_.emplace(peer.get(), peer);
@@ -672,6 +677,7 @@ OverlayImpl::activate(std::shared_ptr<PeerImp> const& peer)
             std::make_tuple(peer)));
         assert(result.second);
         (void)result.second;
+        updateActive();
     }
 
     JLOG(journal_.debug()) << "activated " << peer->getRemoteAddress() << " ("
@@ -689,6 +695,20 @@ OverlayImpl::onPeerDeactivate(Peer::id_t id)
 {
     std::lock_guard lock(mutex_);
     ids_.erase(id);
+    updateActive();
+}
+
+void
+OverlayImpl::updateActive()
+{
+    auto next = std::make_shared<std::vector<std::weak_ptr<PeerImp>>>();
+    next->reserve(ids_.size());
+    for (auto const& x : ids_)
+        next->push_back(x.second);
+    std::atomic_store(
+        &active_,
+        std::shared_ptr<std::vector<std::weak_ptr<PeerImp>> const>(
+            std::move(next)));
 }
 
 void
@@ -1442,6 +1462,7 @@ make_Overlay(
     Resource::Manager& resourceManager,
     Resolver& resolver,
     boost::asio::io_service& io_service,
+    IOContextPool* peerIO,
     BasicConfig const& config,
     beast::insight::Collector::ptr const& collector)
 {
@@ -1453,6 +1474,7 @@ make_Overlay(
         resourceManager,
         resolver,
         io_service,
+        peerIO,
         config,
         collector);
 }
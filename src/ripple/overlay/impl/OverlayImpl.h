@@ -24,6 +24,7 @@
 #include <ripple/basics/Resolver.h>
 #include <ripple/basics/UnorderedContainers.h>
 #include <ripple/basics/chrono.h>
+#include <ripple/core/IOContextPool.h>
 #include <ripple/core/Job.h>
 #include <ripple/overlay/Overlay.h>
 #include <ripple/overlay/impl/Handshake.h>
@@ -96,6 +97,8 @@ private:
 
     Application& app_;
     boost::asio::io_service& io_service_;
+    // Contexts peer connections are spread over, if configured
+    IOContextPool* const peerIO_;
     boost::optional<boost::asio::io_service::work> work_;
     boost::asio::io_service::strand strand_;
     std::recursive_mutex mutex_;  // VFALCO use std::mutex
@@ -110,6 +113,8 @@ private:
     TrafficCount m_traffic;
     hash_map<std::shared_ptr<PeerFinder::Slot>, std::weak_ptr<PeerImp>> m_peers;
     hash_map<Peer::id_t, std::weak_ptr<PeerImp>> ids_;
+    // Copy of ids_ for lock-free iteration, replaced whenever ids_ changes
+    std::shared_ptr<std::vector<std::weak_ptr<PeerImp>> const> active_;
     Resolver& m_resolver;
     std::atomic<Peer::id_t> next_id_;
     int timer_count_;
@@ -137,6 +142,7 @@ public:
         Resource::Manager& resourceManager,
         Resolver& resolver,
         boost::asio::io_service& io_service,
+        IOContextPool* peerIO,
         BasicConfig const& config,
         beast::insight::Collector::ptr const& collector);
 
@@ -237,6 +243,10 @@ public:
     void
     onPeerDeactivate(Peer::id_t id);
 
+    // Called with mutex_ held whenever ids_ changes.
+    void
+    updateActive();
+
     // UnaryFunc will be called as
     //  void(std::shared_ptr<PeerImp>&&)
     //
@@ -244,19 +254,11 @@ public:
     void
     for_each(UnaryFunc&& f)
     {
-        std::vector<std::weak_ptr<PeerImp>> wp;
-        {
-            std::lock_guard lock(mutex_);
-
-            // Iterate over a copy of the peer list because peer
-            // destruction can invalidate iterators.
-            wp.reserve(ids_.size());
-
-            for (auto& x : ids_)
-                wp.push_back(x.second);
-        }
+        // The snapshot is immutable, so peers on any io_context can relay
+        // to each other without contending on mutex_.
+        auto const wp = std::atomic_load(&active_);
 
-        for (auto& w : wp)
+        for (auto& w : *wp)
         {
             if (auto p = w.lock())
                 f(std::move(p));
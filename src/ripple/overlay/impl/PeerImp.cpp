@@ -220,7 +220,15 @@ void
 PeerImp::send(std::shared_ptr<Message> const& m)
 {
     if (!strand_.running_in_this_thread())
-        return post(strand_, std::bind(&PeerImp::send, shared_from_this(), m));
+    {
+        // Count the message now so that sendQueueSize() includes it while
+        // it waits for the strand.
+        send_queue_.defer();
+        return post(strand_, [self = shared_from_this(), m]() {
+            self->send_queue_.admit();
+            self->send(m);
+        });
+    }
     if (gracefulClose_)
         return;
     if (detaching_)
@@ -417,6 +425,8 @@ PeerImp::json()
     ret[jss::metrics][jss::avg_bps_sent] =
         std::to_string(metrics_.sent.average_bytes());
 
+    ret[jss::send_queue] = send_queue_.json();
+
     return ret;
 }
 
@@ -27,6 +27,7 @@
 #include <ripple/overlay/impl/OverlayImpl.h>
 #include <ripple/overlay/impl/ProtocolMessage.h>
 #include <ripple/overlay/impl/ProtocolVersion.h>
+#include <ripple/overlay/impl/SendQueue.h>
 #include <ripple/peerfinder/PeerfinderManager.h>
 #include <ripple/protocol/Protocol.h>
 #include <ripple/protocol/STTx.h>
@@ -38,7 +39,6 @@
 #include <boost/optional.hpp>
 #include <cstdint>
 #include <deque>
-#include <queue>
 #include <shared_mutex>
 
 namespace ripple {
@@ -182,7 +182,7 @@ private:
     http_response_type response_;
     boost::beast::http::fields const& headers_;
     boost::beast::multi_buffer write_buffer_;
-    std::queue<std::shared_ptr<Message>> send_queue_;
+    SendQueue send_queue_;
     bool gracefulClose_ = false;
     int large_sendq_ = 0;
     int no_ping_ = 0;
@@ -292,6 +292,12 @@ public:
     void
     send(std::shared_ptr<Message> const& m) override;
 
+    std::size_t
+    sendQueueSize() const override
+    {
+        return send_queue_.depth();
+    }
+
     /** Send a set of PeerFinder endpoints as a protocol message. */
     template <
         class FwdIt,
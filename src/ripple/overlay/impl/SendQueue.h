@@ -0,0 +1,340 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_OVERLAY_SENDQUEUE_H_INCLUDED
+#define RIPPLE_OVERLAY_SENDQUEUE_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <ripple/overlay/Message.h>
+#include <ripple/overlay/impl/TrafficCount.h>
+#include <ripple/overlay/impl/Tuning.h>
+#include <ripple/protocol/jss.h>
+#include <boost/optional.hpp>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <queue>
+
+namespace ripple {
+
+/** Outbound message queue of a single peer connection.
+
+    Messages are kept in one FIFO per priority class and the next message
+    to write is picked with a weighted round robin: within a round each
+    class may send up to its weight in messages, higher classes first. This
+    keeps proposals and validations from waiting behind a long backlog of
+    ledger data sent to a syncing peer, while lower classes still make
+    progress.
+
+    The queue itself is only touched from the peer's strand. The per-class
+    statistics are atomic so that they can be reported from other threads.
+*/
+class SendQueue
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    enum Priority : std::size_t {
+        consensus,    // proposals, validations, tx sets, pings
+        transaction,  // relayed transactions
+        ledgerData,   // ledger and object fetch replies
+        other         // must be last
+    };
+
+    static constexpr std::size_t priorities = other + 1;
+
+    /** Map a traffic category onto a send priority class */
+    static Priority
+    classify(TrafficCount::category cat)
+    {
+        using category = TrafficCount::category;
+
+        switch (cat)
+        {
+            case category::base:
+            case category::cluster:
+            case category::proposal:
+            case category::validation:
+            case category::get_set:
+            case category::share_set:
+            case category::ld_tsc_get:
+            case category::ld_tsc_share:
+            case category::gl_tsc_share:
+            case category::gl_tsc_get:
+                return consensus;
+
+            case category::transaction:
+            case category::share_hash_tx:
+            case category::get_hash_tx:
+                return transaction;
+
+            case category::ld_txn_get:
+            case category::ld_txn_share:
+            case category::ld_asn_get:
+            case category::ld_asn_share:
+            case category::ld_get:
+            case category::ld_share:
+            case category::gl_txn_share:
+            case category::gl_txn_get:
+            case category::gl_asn_share:
+            case category::gl_asn_get:
+            case category::gl_share:
+            case category::gl_get:
+            case category::share_hash_ledger:
+            case category::get_hash_ledger:
+            case category::share_hash_txnode:
+            case category::get_hash_txnode:
+            case category::share_hash_asnode:
+            case category::get_hash_asnode:
+            case category::share_cas_object:
+            case category::get_cas_object:
+            case category::share_fetch_pack:
+            case category::get_fetch_pack:
+            case category::share_hash:
+            case category::get_hash:
+            case category::shards:
+                return ledgerData;
+
+            default:
+                break;
+        }
+
+        return other;
+    }
+
+    static char const*
+    name(Priority p)
+    {
+        switch (p)
+        {
+            case consensus:
+                return "consensus";
+            case transaction:
+                return "transaction";
+            case ledgerData:
+                return "ledger_data";
+            case other:
+                break;
+        }
+        return "other";
+    }
+
+    SendQueue()
+        : weights_{
+              {Tuning::sendWeightConsensus,
+               Tuning::sendWeightTransaction,
+               Tuning::sendWeightLedgerData,
+               Tuning::sendWeightOther}}
+    {
+        credits_ = weights_;
+    }
+
+    SendQueue(SendQueue const&) = delete;
+    SendQueue&
+    operator=(SendQueue const&) = delete;
+
+    /** Number of queued messages, including the one being written */
+    std::size_t
+    size() const
+    {
+        return size_;
+    }
+
+    bool
+    empty() const
+    {
+        return size_ == 0;
+    }
+
+    /** Number of queued messages.
+
+        This includes messages counted by defer() that have not reached the
+        strand yet. Unlike size(), may be called from any thread.
+    */
+    std::size_t
+    depth() const
+    {
+        std::size_t ret = deferred_.load(std::memory_order_relaxed);
+        for (auto const& s : stats_)
+            ret += s.depth.load(std::memory_order_relaxed);
+        return ret;
+    }
+
+    /** Number of queued messages in one priority class */
+    std::size_t
+    size(Priority p) const
+    {
+        return stats_[p].depth.load(std::memory_order_relaxed);
+    }
+
+    /** Count a message that is on its way to the strand.
+
+        May be called from any thread. Each call must be matched by a call
+        to admit() once the message reaches the strand, whether or not it
+        is pushed then.
+    */
+    void
+    defer()
+    {
+        ++deferred_;
+    }
+
+    void
+    admit()
+    {
+        assert(deferred_ != 0);
+        --deferred_;
+    }
+
+    /** Queue a message for sending */
+    void
+    push(std::shared_ptr<Message> const& m)
+    {
+        auto const p = classify(
+            static_cast<TrafficCount::category>(m->getCategory()));
+        queues_[p].push({m, clock_type::now()});
+        ++stats_[p].depth;
+        ++size_;
+    }
+
+    /** The message to write next.
+
+        The first call after a pop() selects the message according to the
+        schedule; it then stays at the front until it is popped, so the
+        buffer handed to the socket remains valid for the whole write.
+
+        @note The queue must not be empty.
+    */
+    std::shared_ptr<Message> const&
+    front()
+    {
+        assert(!empty());
+        if (!current_)
+            current_ = select();
+        return queues_[*current_].front().message;
+    }
+
+    /** Remove the message returned by front() once it has been written */
+    void
+    pop()
+    {
+        assert(current_);
+        auto const p = *current_;
+        current_.reset();
+
+        auto& q = queues_[p];
+        auto const waited = std::chrono::duration_cast<
+            std::chrono::microseconds>(clock_type::now() - q.front().queued);
+        q.pop();
+        --size_;
+
+        auto& s = stats_[p];
+        --s.depth;
+        ++s.sent;
+
+        auto const us = static_cast<std::uint64_t>(waited.count());
+        auto const avg = s.avgLatency.load(std::memory_order_relaxed);
+        s.avgLatency.store(
+            avg == 0 ? us : (avg * 7 + us) / 8, std::memory_order_relaxed);
+        if (us > s.maxLatency.load(std::memory_order_relaxed))
+            s.maxLatency.store(us, std::memory_order_relaxed);
+    }
+
+    /** Report depth, latency and throughput of each priority class.
+
+        May be called from any thread.
+    */
+    Json::Value
+    json() const
+    {
+        Json::Value ret(Json::objectValue);
+        for (std::size_t i = 0; i < priorities; ++i)
+        {
+            auto const& s = stats_[i];
+            auto& entry = ret[name(static_cast<Priority>(i))];
+            entry[jss::depth] = static_cast<Json::UInt>(s.depth.load());
+            entry[jss::sent] = std::to_string(s.sent.load());
+            entry[jss::avg_latency_us] =
+                static_cast<Json::UInt>(s.avgLatency.load());
+            entry[jss::max_latency_us] =
+                static_cast<Json::UInt>(s.maxLatency.load());
+        }
+        return ret;
+    }
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<Message> message;
+        clock_type::time_point queued;
+    };
+
+    struct Stats
+    {
+        std::atomic<std::size_t> depth{0};
+        std::atomic<std::uint64_t> sent{0};
+        // Exponentially weighted, in microseconds, from push to written
+        std::atomic<std::uint64_t> avgLatency{0};
+        std::atomic<std::uint64_t> maxLatency{0};
+    };
+
+    Priority
+    select()
+    {
+        // Two passes at most: if every non-empty class has used up its
+        // share of the current round, start a new round.
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (std::size_t i = 0; i < priorities; ++i)
+            {
+                if (!queues_[i].empty() && credits_[i] != 0)
+                {
+                    --credits_[i];
+                    return static_cast<Priority>(i);
+                }
+            }
+            credits_ = weights_;
+        }
+
+        // Unreachable while the queue is non-empty and every weight is
+        // non-zero.
+        assert(false);
+        for (std::size_t i = 0; i < priorities; ++i)
+        {
+            if (!queues_[i].empty())
+                return static_cast<Priority>(i);
+        }
+        return other;
+    }
+
+    std::array<std::queue<Entry>, priorities> queues_;
+    std::array<std::size_t, priorities> const weights_;
+    std::array<std::size_t, priorities> credits_;
+    std::array<Stats, priorities> stats_;
+    std::size_t size_ = 0;
+    std::atomic<std::size_t> deferred_{0};
+    boost::optional<Priority> current_;
+};
+
+}  // namespace ripple
+
+#endif
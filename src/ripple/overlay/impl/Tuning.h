@@ -71,6 +71,13 @@ enum {
 
     /** How often to log send queue size */
     sendQueueLogFreq = 64,
+
+    /** How many messages of each send priority class may be written in one
+        round of the send scheduler */
+    sendWeightConsensus = 8,
+    sendWeightTransaction = 4,
+    sendWeightLedgerData = 2,
+    sendWeightOther = 1,
 };
 
 /** The threshold above which we treat a peer connection as high latency */
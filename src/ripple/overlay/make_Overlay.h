@@ -21,6 +21,7 @@
 #define RIPPLE_OVERLAY_MAKE_OVERLAY_H_INCLUDED
 
 #include <ripple/basics/Resolver.h>
+#include <ripple/core/IOContextPool.h>
 #include <ripple/core/Stoppable.h>
 #include <ripple/overlay/Overlay.h>
 #include <ripple/resource/ResourceManager.h>
@@ -33,7 +34,11 @@ namespace ripple {
 Overlay::Setup
 setup_Overlay(BasicConfig const& config);
 
-/** Creates the implementation of Overlay. */
+/** Creates the implementation of Overlay.
+
+    @param peerIO If not null, outbound peer connections are spread over
+                  these contexts instead of using io_service.
+*/
 std::unique_ptr<Overlay>
 make_Overlay(
     Application& app,
@@ -43,6 +48,7 @@ make_Overlay(
     Resource::Manager& resourceManager,
     Resolver& resolver,
     boost::asio::io_service& io_service,
+    IOContextPool* peerIO,
     BasicConfig const& config,
     beast::insight::Collector::ptr const& collector);
 
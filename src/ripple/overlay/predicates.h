@@ -157,11 +157,12 @@ struct peer_in_cluster
 //------------------------------------------------------------------------------
 
 /** Select all peers that are in the specified set */
+template <class Set>
 struct peer_in_set
 {
-    std::set<Peer::id_t> const& peerSet;
+    Set const& peerSet;
 
-    peer_in_set(std::set<Peer::id_t> const& peers) : peerSet(peers)
+    peer_in_set(Set const& peers) : peerSet(peers)
     {
     }
 
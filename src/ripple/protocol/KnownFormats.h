@@ -130,6 +130,20 @@ public:
         return itr->second;
     }
 
+    /** Iterate over all the known formats.
+     */
+    typename std::forward_list<Item>::const_iterator
+    begin() const
+    {
+        return formats_.begin();
+    }
+
+    typename std::forward_list<Item>::const_iterator
+    end() const
+    {
+        return formats_.end();
+    }
+
 protected:
     /** Retrieve a format based on its name.
      */
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/FixedPoint.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/safe_cast.h>
@@ -26,8 +27,8 @@
 #include <ripple/protocol/UintTypes.h>
 #include <ripple/protocol/jss.h>
 #include <boost/algorithm/string.hpp>
-#include <boost/multiprecision/cpp_int.hpp>
 #include <boost/regex.hpp>
+#include <algorithm>
 #include <iostream>
 #include <iterator>
 #include <memory>
@@ -378,16 +379,15 @@ operator+(STAmount const& v1, STAmount const& v2)
     if (v2.negative())
         vv2 = -vv2;
 
-    while (ov1 < ov2)
+    if (ov1 < ov2)
     {
-        vv1 /= 10;
-        ++ov1;
+        vv1 = detail::divPow10(vv1, ov2 - ov1);
+        ov1 = ov2;
     }
-
-    while (ov2 < ov1)
+    else if (ov2 < ov1)
     {
-        vv2 /= 10;
-        ++ov2;
+        vv2 = detail::divPow10(vv2, ov1 - ov2);
+        ov2 = ov1;
     }
 
     // This addition cannot overflow an std::int64_t. It can overflow an
@@ -669,17 +669,11 @@ STAmount::canonicalize()
             return;
         }
 
-        while (mOffset < 0)
-        {
-            mValue /= 10;
-            ++mOffset;
-        }
-
-        while (mOffset > 0)
-        {
-            mValue *= 10;
-            --mOffset;
-        }
+        if (mOffset < 0)
+            mValue = detail::divPow10(mValue, -mOffset);
+        else if (mOffset > 0)
+            mValue = detail::mulPow10(mValue, mOffset);
+        mOffset = 0;
 
         if (mValue > cMaxNativeN)
             Throw<std::runtime_error>("Native currency amount out of range");
@@ -696,19 +690,23 @@ STAmount::canonicalize()
         return;
     }
 
-    while ((mValue < cMinValue) && (mOffset > cMinOffset))
+    // Scale by as many powers of ten at once as multiplying or dividing by
+    // ten one at a time until the value is in range would.
+    if ((mValue < cMinValue) && (mOffset > cMinOffset))
     {
-        mValue *= 10;
-        --mOffset;
+        int const shift =
+            std::min(16 - detail::digits10(mValue), mOffset - cMinOffset);
+        mValue *= detail::powerOfTen[shift];
+        mOffset -= shift;
     }
-
-    while (mValue > cMaxValue)
+    else if (mValue > cMaxValue)
     {
-        if (mOffset >= cMaxOffset)
+        int const shift = detail::digits10(mValue) - 16;
+        if (mOffset + shift > cMaxOffset)
             Throw<std::runtime_error>("value overflow");
 
-        mValue /= 10;
-        ++mOffset;
+        mValue /= detail::powerOfTen[shift];
+        mOffset += shift;
     }
 
     if ((mOffset < cMinOffset) || (mValue < cMinValue))
@@ -1012,6 +1010,19 @@ operator-(STAmount const& value)
 //
 //------------------------------------------------------------------------------
 
+// Bring the mantissa of a native amount, which is not zero, into the range
+// of the mantissas of IOU amounts.
+static void
+scaleNative(std::uint64_t& value, int& offset)
+{
+    if (value < STAmount::cMinValue)
+    {
+        int const shift = 16 - detail::digits10(value);
+        value *= detail::powerOfTen[shift];
+        offset -= shift;
+    }
+}
+
 // Calculate (a * b) / c when all three values are 64-bit
 // without loss of precision:
 static std::uint64_t
@@ -1020,10 +1031,8 @@ muldiv(
     std::uint64_t multiplicand,
     std::uint64_t divisor)
 {
-    boost::multiprecision::uint128_t ret;
-
-    boost::multiprecision::multiply(ret, multiplier, multiplicand);
-    ret /= divisor;
+    auto const ret =
+        detail::divide(detail::uint128(multiplier) * multiplicand, divisor);
 
     if (ret > std::numeric_limits<std::uint64_t>::max())
     {
@@ -1042,11 +1051,8 @@ muldiv_round(
     std::uint64_t divisor,
     std::uint64_t rounding)
 {
-    boost::multiprecision::uint128_t ret;
-
-    boost::multiprecision::multiply(ret, multiplier, multiplicand);
-    ret += rounding;
-    ret /= divisor;
+    auto const ret = detail::divide(
+        detail::uint128(multiplier) * multiplicand + rounding, divisor);
 
     if (ret > std::numeric_limits<std::uint64_t>::max())
     {
@@ -1074,23 +1080,10 @@ divide(STAmount const& num, STAmount const& den, Issue const& issue)
     int denOffset = den.exponent();
 
     if (num.native())
-    {
-        while (numVal < STAmount::cMinValue)
-        {
-            // Need to bring into range
-            numVal *= 10;
-            --numOffset;
-        }
-    }
+        scaleNative(numVal, numOffset);
 
     if (den.native())
-    {
-        while (denVal < STAmount::cMinValue)
-        {
-            denVal *= 10;
-            --denOffset;
-        }
-    }
+        scaleNative(denVal, denOffset);
 
     // We divide the two mantissas (each is between 10^15
     // and 10^16). To maintain precision, we multiply the
@@ -1132,22 +1125,10 @@ multiply(STAmount const& v1, STAmount const& v2, Issue const& issue)
     int offset2 = v2.exponent();
 
     if (v1.native())
-    {
-        while (value1 < STAmount::cMinValue)
-        {
-            value1 *= 10;
-            --offset1;
-        }
-    }
+        scaleNative(value1, offset1);
 
     if (v2.native())
-    {
-        while (value2 < STAmount::cMinValue)
-        {
-            value2 *= 10;
-            --offset2;
-        }
-    }
+        scaleNative(value2, offset2);
 
     // We multiply the two mantissas (each is between 10^15
     // and 10^16), so their product is in the 10^30 to 10^32
@@ -1167,14 +1148,9 @@ canonicalizeRound(bool native, std::uint64_t& value, int& offset)
     {
         if (offset < 0)
         {
-            int loops = 0;
-
-            while (offset < -1)
-            {
-                value /= 10;
-                ++offset;
-                ++loops;
-            }
+            int const loops = -1 - offset;
+            value = detail::divPow10(value, loops);
+            offset = -1;
 
             value += (loops >= 2) ? 9 : 10;  // add before last divide
             value /= 10;
@@ -1183,7 +1159,15 @@ canonicalizeRound(bool native, std::uint64_t& value, int& offset)
     }
     else if (value > STAmount::cMaxValue)
     {
-        while (value > (10 * STAmount::cMaxValue))
+        // Dividing by ten until the value has 17 digits may leave one
+        // above 10 * cMaxValue, which needs one more.
+        int shift = detail::digits10(value) - 17;
+        if (shift > 0)
+        {
+            value /= detail::powerOfTen[shift];
+            offset += shift;
+        }
+        if (value > (10 * STAmount::cMaxValue))
         {
             value /= 10;
             ++offset;
@@ -1227,22 +1211,10 @@ mulRound(
     int offset1 = v1.exponent(), offset2 = v2.exponent();
 
     if (v1.native())
-    {
-        while (value1 < STAmount::cMinValue)
-        {
-            value1 *= 10;
-            --offset1;
-        }
-    }
+        scaleNative(value1, offset1);
 
     if (v2.native())
-    {
-        while (value2 < STAmount::cMinValue)
-        {
-            value2 *= 10;
-            --offset2;
-        }
-    }
+        scaleNative(value2, offset2);
 
     bool const resultNegative = v1.negative() != v2.negative();
 
@@ -1298,22 +1270,10 @@ divRound(
     int numOffset = num.exponent(), denOffset = den.exponent();
 
     if (num.native())
-    {
-        while (numVal < STAmount::cMinValue)
-        {
-            numVal *= 10;
-            --numOffset;
-        }
-    }
+        scaleNative(numVal, numOffset);
 
     if (den.native())
-    {
-        while (denVal < STAmount::cMinValue)
-        {
-            denVal *= 10;
-            --denOffset;
-        }
-    }
+        scaleNative(denVal, denOffset);
 
     bool const resultNegative = (num.negative() != den.negative());
 
@@ -126,6 +126,7 @@ JSS(amount);                 // out: AccountChannels
 JSS(api_version);            // in: many, out: Version
 JSS(api_version_low);        // out: Version
 JSS(applied);                // out: SubmitTransaction
+JSS(apply);                  // out: NetworkOPs
 JSS(asks);                   // out: Subscribe
 JSS(assets);                 // out: GatewayBalances
 JSS(authorized);             // out: AccountLines
@@ -134,11 +135,13 @@ JSS(auth_change_queued);     // out: AccountInfo
 JSS(available);              // out: ValidatorList
 JSS(avg_bps_recv);           // out: Peers
 JSS(avg_bps_sent);           // out: Peers
+JSS(avg_latency_us);         // out: Peers
 JSS(balance);                // out: AccountLines
 JSS(balances);               // out: GatewayBalances
 JSS(base);                   // out: LogLevel
 JSS(base_fee);               // out: NetworkOPs
 JSS(base_fee_xrp);           // out: NetworkOPs
+JSS(batches);                // out: NetworkOPs
 JSS(bids);                   // out: Subscribe
 JSS(binary);                 // in: AccountTX, LedgerEntry,
                              //     AccountTxOld, Tx LedgerData
@@ -146,8 +149,10 @@ JSS(books);                  // in: Subscribe, Unsubscribe
 JSS(both);                   // in: Subscribe, Unsubscribe
 JSS(both_sides);             // in: Subscribe, Unsubscribe
 JSS(broadcast);              // out: SubmitTransaction
+JSS(build);                  // out: GetCounts
 JSS(build_path);             // in: TransactionSign
 JSS(build_version);          // out: NetworkOPs
+JSS(bytes);                  // out: GetCounts
 JSS(cancel_after);           // out: AccountChannels
 JSS(can_delete);             // out: CanDelete
 JSS(channel_id);             // out: AccountChannels
@@ -193,6 +198,7 @@ JSS(deletion_blockers_only);  // in: AccountObjects
 JSS(delivered_amount);        // out: insertDeliveredAmount
 JSS(deposit_authorized);      // out: deposit_authorized
 JSS(deposit_preauth);         // in: AccountObjects, LedgerData
+JSS(depth);                   // out: Peers
 JSS(deprecated);              // out
 JSS(descending);              // in: AccountTx*
 JSS(description);             // in/out: Reservations
@@ -239,6 +245,7 @@ JSS(fee_level);             // out: AccountInfo
 JSS(fee_mult_max);          // in: TransactionSign
 JSS(fee_ref);               // out: NetworkOPs
 JSS(fetch_pack);            // out: NetworkOPs
+JSS(fetch_pack_cache);      // out: GetCounts
 JSS(first);                 // out: rpc/Version
 JSS(finished);
 JSS(fix_txns);              // in: LedgerCleaner
@@ -260,6 +267,7 @@ JSS(have_state);            // out: InboundLedger
 JSS(have_transactions);     // out: InboundLedger
 JSS(highest_sequence);      // out: AccountInfo
 JSS(historical_perminute);  // historical_perminute.
+JSS(hits);                  // out: GetCounts
 JSS(hostid);                // out: NetworkOPs
 JSS(hotwallet);             // in: GatewayBalances
 JSS(id);                    // websocket.
@@ -275,6 +283,7 @@ JSS(info);                  // out: ServerInfo, ConsensusInfo, FetchInfo
 JSS(internal_command);      // in: Internal
 JSS(invalid_API_version);   // out: Many, when a request has an invalid
                             //      version
+JSS(invalidations);         // out: GetCounts
 JSS(io_latency_ms);         // out: NetworkOPs
 JSS(ip);                    // in: Connect, out: OverlayImpl
 JSS(issuer);                // in: RipplePathFind, Subscribe,
@@ -348,6 +357,7 @@ JSS(master_key);                  // out: WalletPropose, NetworkOPs,
 JSS(master_seed);                 // out: WalletPropose
 JSS(master_seed_hex);             // out: WalletPropose
 JSS(master_signature);            // out: pubManifest
+JSS(max_latency_us);              // out: Peers
 JSS(max_ledger);                  // in/out: LedgerCleaner
 JSS(max_queue_size);              // out: TxQ
 JSS(max_spend_drops);             // out: AccountInfo
@@ -355,6 +365,7 @@ JSS(max_spend_drops_total);       // out: AccountInfo
 JSS(median_fee);                  // out: TxQ
 JSS(median_level);                // out: TxQ
 JSS(message);                     // error.
+JSS(messages);                    // out: GetCounts
 JSS(meta);                        // out: NetworkOPs, AccountTx*, Tx
 JSS(metaData);
 JSS(metadata);  // out: TransactionEntry
@@ -365,6 +376,7 @@ JSS(min_count);                  // in: GetCounts
 JSS(min_ledger);                 // in: LedgerCleaner
 JSS(minimum_fee);                // out: TxQ
 JSS(minimum_level);              // out: TxQ
+JSS(misses);                     // out: GetCounts
 JSS(missingCommand);             // error
 JSS(name);                       // out: AmendmentTableImpl, PeerImp
 JSS(needed_state_hashes);        // out: InboundLedger
@@ -382,6 +394,8 @@ JSS(node_reads_hit);             // out: GetCounts
 JSS(node_reads_total);           // out: GetCounts
 JSS(node_writes);                // out: GetCounts
 JSS(node_written_bytes);         // out: GetCounts
+JSS(objects);                    // out: GetCounts
+JSS(objects_per_sec);            // out: GetCounts
 JSS(obligations);                // out: GatewayBalances
 JSS(offer);                      // in: LedgerEntry
 JSS(offers);                     // out: NetworkOPs, AccountOffers, Subscribe
@@ -411,6 +425,8 @@ JSS(peer_disconnects);           // Severed peer connection counter.
 JSS(peer_disconnects_resources);  // Severed peer connections because of
                                   // excess resource consumption.
 JSS(port);                        // in: Connect
+JSS(preclaim_cache);              // out: GetCounts
+JSS(preflight);                   // out: NetworkOPs
 JSS(previous);                    // out: Reservations
 JSS(previous_ledger);             // out: LedgerPropose
 JSS(proof);                       // in: BookOffers
@@ -436,6 +452,7 @@ JSS(queued);                      // out: SubmitTransaction
 JSS(queued_duration_us);
 JSS(random);                // out: Random
 JSS(raw_meta);              // out: AcceptedLedgerTx
+JSS(reads);                 // out: PerfLog
 JSS(receive_currencies);    // out: AccountCurrencies
 JSS(reference_level);       // out: TxQ
 JSS(refresh_interval_min);  // out: ValidatorSites
@@ -465,12 +482,16 @@ JSS(secret);                    // in: TransactionSign,
                                 //     channel_authorize
 JSS(seed);                      //
 JSS(seed_hex);                  // in: WalletPropose, TransactionSign
+JSS(segments);                  // out: GetCounts
 JSS(send_currencies);           // out: AccountCurrencies
 JSS(send_max);                  // in: PathRequest, RipplePathFind
+JSS(send_queue);                // out: Peers
+JSS(sent);                      // out: Peers
 JSS(seq);                       // in: LedgerEntry;
                                 // out: NetworkOPs, RPCSub, AccountOffers,
                                 //      ValidatorList, ValidatorInfo, Manifest
 JSS(seqNum);                    // out: LedgerToJson
+JSS(serve);                     // out: GetCounts
 JSS(server_state);              // out: NetworkOPs
 JSS(server_state_duration_us);  // out: NetworkOPs
 JSS(server_status);             // out: NetworkOPs
@@ -484,6 +505,7 @@ JSS(signing_keys);              // out: ValidatorList
 JSS(signing_time);              // out: NetworkOPs
 JSS(signer_list);               // in: AccountObjects
 JSS(signer_lists);              // in/out: AccountInfo
+JSS(size);                      // out: GetCounts
 JSS(snapshot);                  // in: Subscribe
 JSS(source_account);            // in: PathRequest, RipplePathFind
 JSS(source_amount);             // in: PathRequest, RipplePathFind
@@ -513,6 +535,7 @@ JSS(taker_pays_funded);   // out: NetworkOPs
 JSS(threshold);           // in: Blacklist
 JSS(ticket);              // in: AccountObjects
 JSS(time);
+JSS(time_us);                 // out: GetCounts
 JSS(timeouts);                // out: InboundLedger
 JSS(traffic);                 // out: Overlay
 JSS(total);                   // out: counters
@@ -520,6 +543,7 @@ JSS(totalCoins);              // out: LedgerToJson
 JSS(total_bytes_recv);        // out: Peers
 JSS(total_bytes_sent);        // out: Peers
 JSS(total_coins);             // out: LedgerToJson
+JSS(transaction_pipeline);    // out: NetworkOPs
 JSS(transTreeHash);           // out: ledger/Ledger.cpp
 JSS(transaction);             // in: Tx
                               // out: NetworkOPs, AcceptedLedgerTx,
@@ -577,6 +601,7 @@ JSS(warning);                 // rpc:
 JSS(warnings);                // out: server_info, server_state
 JSS(workers);
 JSS(write_load);  // out: GetCounts
+JSS(writes);      // out: PerfLog
 
 #undef JSS
 
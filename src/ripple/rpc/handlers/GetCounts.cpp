@@ -22,6 +22,7 @@
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/tx/PreclaimCache.h>
 #include <ripple/basics/UptimeClock.h>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/json/json_value.h>
@@ -101,11 +102,14 @@ getCountsJson(Application& app, int minObjectCount)
     ret[jss::node_hit_rate] = app.getNodeStore().getCacheHitRate();
     ret[jss::ledger_hit_rate] = app.getLedgerMaster().getCacheHitRate();
     ret[jss::AL_hit_rate] = app.getAcceptedLedgerCache().getHitRate();
+    ret[jss::preclaim_cache] = app.getPreclaimCache().getJson();
 
     ret[jss::fullbelow_size] =
         static_cast<int>(app.family().fullbelow().size());
     ret[jss::treenode_cache_size] = app.family().treecache().getCacheSize();
     ret[jss::treenode_track_size] = app.family().treecache().getTrackSize();
+    ret[jss::fetch_pack_cache] =
+        app.getLedgerMaster().getPrebuiltFetchPacks().getJson();
 
     std::string uptime;
     auto s = UptimeClock::now();
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/paths/PathRequests.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/resource/Fees.h>
@@ -158,12 +159,54 @@ doRipplePathFind(RPC::JsonContext& context)
     if (!lpLedger)
         return jvResult;
 
-    RPC::LegacyPathFind lpf(isUnlimited(context.role), context.app);
-    if (!lpf.isOk())
-        return rpcError(rpcTOO_BUSY);
+    auto& pathRequests = context.app.getPathRequests();
+    Json::Value result;
+    if (pathRequests.queueEnabled() && context.coro)
+    {
+        // The search runs on a path finding thread, while this coroutine
+        // waits without holding a JobQueue thread. As above, the coroutine
+        // is posted again when the search is done, or resumed on the path
+        // finding thread if the JobQueue is stopping.
+        if (!isUnlimited(context.role) &&
+            context.app.getFeeTrack().isLoadedLocal())
+            return rpcError(rpcTOO_BUSY);
+
+        // A ledger asked for by its kind, rather than by its hash or
+        // sequence, is stale once a newer ledger closes.
+        Json::Value const& params = context.params;
+        auto const& index = params.isMember(jss::ledger_index)
+            ? params[jss::ledger_index]
+            : params[jss::ledger];
+        bool const followsLedger = !params.isMember(jss::ledger_hash) &&
+            (index.isNull() || index == "current" || index == "closed" ||
+             index == "validated");
+
+        std::shared_ptr<JobQueue::Coro> coro{context.coro};
+        if (!pathRequests.queueLegacyPathRequest(
+                context.consumer,
+                !isUnlimited(context.role),
+                followsLedger,
+                lpLedger,
+                context.params,
+                [&result, coro](Json::Value found) {
+                    result = std::move(found);
+                    if (!coro->post())
+                        coro->resume();
+                }))
+        {
+            return rpcError(rpcTOO_BUSY);
+        }
+        context.coro->yield();
+    }
+    else
+    {
+        RPC::LegacyPathFind lpf(isUnlimited(context.role), context.app);
+        if (!lpf.isOk())
+            return rpcError(rpcTOO_BUSY);
 
-    auto result = context.app.getPathRequests().doLegacyPathRequest(
-        context.consumer, lpLedger, context.params);
+        result = pathRequests.doLegacyPathRequest(
+            context.consumer, lpLedger, context.params);
+    }
 
     for (auto& fieldName : jvResult.getMemberNames())
         result[fieldName] = std::move(jvResult[fieldName]);
@@ -48,6 +48,9 @@ static LimitRange constexpr accountOffers = {10, 200, 400};
 /** Limits for the book_offers command. */
 static LimitRange constexpr bookOffers = {0, 300, 400};
 
+/** The most books whose top offers are kept for each closed ledger. */
+static std::size_t constexpr bookOffersCached = 256;
+
 /** Limits for the no_ripple_check command. */
 static LimitRange constexpr noRippleCheck = {10, 300, 400};
 
@@ -80,6 +80,17 @@ public:
         auto m = std::make_shared<StreambufWSMsg<decltype(sb)>>(std::move(sb));
         sp->send(m);
     }
+
+    void
+    send(std::shared_ptr<StreamMessage const> const& msg, bool) override
+    {
+        auto sp = ws_.lock();
+        if (!sp)
+            return;
+        auto const& text = msg->text();
+        sp->send(std::make_shared<SharedWSMsg>(
+            msg, boost::asio::const_buffer(text.data(), text.size())));
+    }
 };
 
 }  // namespace ripple
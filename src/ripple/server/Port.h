@@ -26,12 +26,14 @@
 #include <boost/beast/core/string.hpp>
 #include <boost/beast/websocket/option.hpp>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
 
 namespace boost {
 namespace asio {
+class io_context;
 namespace ssl {
 class context;
 }
@@ -62,6 +64,10 @@ struct Port
     boost::beast::websocket::permessage_deflate pmd_options;
     std::shared_ptr<boost::asio::ssl::context> context;
 
+    // If set, chooses the io_context that each accepted connection is
+    // served on. Otherwise connections use the server's io_context.
+    std::function<boost::asio::io_context&()> io_context;
+
     // How many incoming connections are allowed on this
     // port in the range [0, 65535] where 0 means unlimited.
     int limit = 0;
@@ -104,6 +104,38 @@ public:
     }
 };
 
+/** A message whose bytes are shared with the other sessions it is sent to.
+
+    Only the position reached belongs to the session. The owner keeps the
+    bytes alive, and unchanged, for as long as any session holds the
+    message.
+*/
+class SharedWSMsg : public WSMsg
+{
+    std::shared_ptr<void const> owner_;
+    boost::asio::const_buffer data_;
+    std::size_t n_ = 0;
+
+public:
+    SharedWSMsg(
+        std::shared_ptr<void const> owner,
+        boost::asio::const_buffer data)
+        : owner_(std::move(owner)), data_(data)
+    {
+    }
+
+    std::pair<boost::tribool, std::vector<boost::asio::const_buffer>>
+    prepare(std::size_t bytes, std::function<void(void)>) override
+    {
+        data_ += n_;
+        if (data_.size() == 0)
+            return {true, {}};
+        n_ = std::min(bytes, data_.size());
+        boost::tribool const done = n_ == data_.size();
+        return {done, {boost::asio::const_buffer(data_.data(), n_)}};
+    }
+};
+
 struct WSSession
 {
     std::shared_ptr<void> appDefined;
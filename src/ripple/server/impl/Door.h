@@ -130,6 +130,7 @@ private:
     void
     create(
         bool ssl,
+        boost::asio::io_context& ioc,
         ConstBufferSequence const& buffers,
         stream_type&& stream,
         endpoint_type remote_address);
@@ -309,6 +310,7 @@ template <class ConstBufferSequence>
 void
 Door<Handler>::create(
     bool ssl,
+    boost::asio::io_context& ioc,
     ConstBufferSequence const& buffers,
     stream_type&& stream,
     endpoint_type remote_address)
@@ -318,7 +320,7 @@ Door<Handler>::create(
         if (auto sp = ios().template emplace<SSLHTTPPeer<Handler>>(
                 port_,
                 handler_,
-                ioc_,
+                ioc,
                 j_,
                 remote_address,
                 buffers,
@@ -329,7 +331,7 @@ Door<Handler>::create(
     if (auto sp = ios().template emplace<PlainHTTPPeer<Handler>>(
             port_,
             handler_,
-            ioc_,
+            ioc,
             j_,
             remote_address,
             buffers,
@@ -345,7 +347,10 @@ Door<Handler>::do_accept(boost::asio::yield_context do_yield)
     {
         error_code ec;
         endpoint_type remote_address;
-        stream_type stream(ioc_);
+
+        // The connection is served on this context from here on
+        auto& ioc = port_.io_context ? port_.io_context() : ioc_;
+        stream_type stream(ioc);
         socket_type& socket = stream.socket();
         acceptor_.async_accept(socket, remote_address, do_yield[ec]);
         if (ec && ec != boost::asio::error::operation_aborted)
@@ -362,7 +367,7 @@ Door<Handler>::do_accept(boost::asio::yield_context do_yield)
             if (auto sp = ios().template emplace<Detector>(
                     port_,
                     handler_,
-                    ioc_,
+                    ioc,
                     std::move(stream),
                     remote_address,
                     j_))
@@ -372,6 +377,7 @@ Door<Handler>::do_accept(boost::asio::yield_context do_yield)
         {
             create(
                 ssl_,
+                ioc,
                 boost::asio::null_buffers{},
                 std::move(stream),
                 remote_address);
@@ -0,0 +1,335 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/AccountTxIndex.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class AccountTxIndex_test : public beast::unit_test::suite
+{
+    using Position = AccountTxIndex::Position;
+    using Result = std::vector<std::pair<Position, uint256>>;
+
+    // Opens a store, which holds what it held when last closed
+    using Open = std::function<std::unique_ptr<AccountTxIndex::Backend>()>;
+
+    // Creates an empty store, returning how to open it
+    using Create = std::function<Open()>;
+
+    // Hands each index the same store, as reopening a database would
+    class SharedBackend : public AccountTxIndex::Backend
+    {
+        std::shared_ptr<Backend> backend_;
+
+    public:
+        explicit SharedBackend(std::shared_ptr<Backend> backend)
+            : backend_(std::move(backend))
+        {
+        }
+
+        boost::optional<std::string>
+        get(std::string const& key) override
+        {
+            return backend_->get(key);
+        }
+
+        void
+        write(Batch const& batch) override
+        {
+            backend_->write(batch);
+        }
+
+        void
+        scan(
+            std::string const& first,
+            std::string const& last,
+            bool forward,
+            std::function<bool(Slice key, Slice value)> const& f) override
+        {
+            backend_->scan(first, last, forward, f);
+        }
+    };
+
+    static AccountID
+    account(int n)
+    {
+        AccountID id;
+        id.data()[0] = static_cast<std::uint8_t>(n);
+        return id;
+    }
+
+    static uint256
+    txID(LedgerIndex seq, std::uint32_t txnSeq)
+    {
+        return uint256((std::uint64_t{seq} << 32) | txnSeq);
+    }
+
+    static Result
+    read(
+        AccountTxIndex const& index,
+        AccountID const& account,
+        LedgerIndex minLedger,
+        LedgerIndex maxLedger,
+        bool forward,
+        boost::optional<Position> const& start = boost::none,
+        std::size_t limit = 1000000)
+    {
+        Result result;
+        index.forEach(
+            account,
+            minLedger,
+            maxLedger,
+            forward,
+            start,
+            [&](Position const& position, uint256 const& id) {
+                if (result.size() == limit)
+                    return false;
+                result.emplace_back(position, id);
+                return true;
+            });
+        return result;
+    }
+
+    void
+    testPaging(std::string const& name, Create const& create)
+    {
+        testcase("paging " + name);
+
+        SuiteJournal journal("AccountTxIndex_test", *this);
+        AccountTxIndex index(create()(), journal);
+
+        // What the AccountTransactions table would hold
+        std::map<AccountID, std::set<Position>> expected;
+        beast::xor_shift_engine rng(7);
+        for (LedgerIndex seq = 10; seq < 60; ++seq)
+        {
+            std::vector<AccountTxIndex::Entry> entries;
+            auto const txns = std::uniform_int_distribution<>(0, 6)(rng);
+            for (std::uint32_t txnSeq = 0; txnSeq < txns; ++txnSeq)
+            {
+                for (int n = 1; n <= 4; ++n)
+                {
+                    if (std::uniform_int_distribution<>(0, 1)(rng))
+                    {
+                        entries.push_back(
+                            {account(n), txnSeq, txID(seq, txnSeq)});
+                        expected[account(n)].emplace(seq, txnSeq);
+                    }
+                }
+            }
+            index.saveLedger(seq, entries);
+        }
+
+        auto const reference = [&](AccountID const& account,
+                                   LedgerIndex minLedger,
+                                   LedgerIndex maxLedger,
+                                   bool forward) {
+            Result result;
+            for (auto const& position : expected[account])
+            {
+                if (position.first >= minLedger && position.first <= maxLedger)
+                    result.emplace_back(
+                        position, txID(position.first, position.second));
+            }
+            if (!forward)
+                std::reverse(result.begin(), result.end());
+            return result;
+        };
+
+        for (int n = 1; n <= 5; ++n)
+        {
+            for (auto const forward : {true, false})
+            {
+                for (auto const& [minLedger, maxLedger] :
+                     {std::make_pair(0u, ~0u),
+                      std::make_pair(20u, 40u),
+                      std::make_pair(33u, 33u),
+                      std::make_pair(70u, 80u)})
+                {
+                    auto const want =
+                        reference(account(n), minLedger, maxLedger, forward);
+                    auto const all =
+                        read(index, account(n), minLedger, maxLedger, forward);
+                    BEAST_EXPECT(all == want);
+
+                    // Reading pages from each marker finds the same
+                    for (std::size_t const limit : {1, 3, 7})
+                    {
+                        Result pages;
+                        boost::optional<Position> marker;
+                        do
+                        {
+                            auto page = read(
+                                index,
+                                account(n),
+                                minLedger,
+                                maxLedger,
+                                forward,
+                                marker,
+                                limit + 1);
+                            marker.reset();
+                            if (page.size() > limit)
+                            {
+                                marker = page.back().first;
+                                page.pop_back();
+                            }
+                            pages.insert(pages.end(), page.begin(), page.end());
+                        } while (marker);
+                        BEAST_EXPECT(pages == want);
+                    }
+                }
+            }
+        }
+
+        // A ledger saved again is replaced
+        index.saveLedger(30, {{account(5), 9, txID(30, 9)}});
+        BEAST_EXPECT(
+            (read(index, account(5), 0, 100, true) ==
+             Result{{{30, 9}, txID(30, 9)}}));
+        for (int n = 1; n <= 4; ++n)
+        {
+            auto const result = read(index, account(n), 30, 30, true);
+            BEAST_EXPECT(result.empty());
+        }
+
+        // Old ledgers are deleted
+        index.deleteBefore(45);
+        for (int n = 1; n <= 5; ++n)
+        {
+            auto const result = read(index, account(n), 0, ~0u, true);
+            BEAST_EXPECT(result == reference(account(n), 45, ~0u, true));
+        }
+        index.saveLedger(30, {});
+        index.deleteBefore(100);
+        for (int n = 1; n <= 5; ++n)
+            BEAST_EXPECT(read(index, account(n), 0, ~0u, false).empty());
+    }
+
+    void
+    testSaved(std::string const& name, Create const& create)
+    {
+        testcase("saved ledgers " + name);
+
+        SuiteJournal journal("AccountTxIndex_test", *this);
+
+        // Closes the store before it is opened again
+        auto const reopen = [&](std::unique_ptr<AccountTxIndex>& index,
+                                Open const& open) {
+            index.reset();
+            index = std::make_unique<AccountTxIndex>(open(), journal);
+        };
+
+        auto const open = create();
+        std::unique_ptr<AccountTxIndex> index;
+        reopen(index, open);
+        BEAST_EXPECT(index->saved().empty() && !index->cutover());
+
+        // Ledgers saved as they close are held
+        index->saveLedger(101, {{account(1), 0, txID(101, 0)}});
+        index->saveLedger(103, {{account(1), 0, txID(103, 0)}});
+        BEAST_EXPECT(to_string(index->saved()) == "101,103");
+
+        // A copy keeps the ledgers saved since the table was read, and
+        // holds those the table has nothing of with nothing
+        index->saveCopied(
+            98,
+            103,
+            {{100, {{account(1), 1, txID(100, 1)}}},
+             {101, {{account(1), 1, txID(101, 1)}}},
+             {102, {{account(1), 2, txID(102, 2)}}}});
+        BEAST_EXPECT(to_string(index->saved()) == "98-103");
+
+        // What the index holds survives reopening
+        reopen(index, open);
+        BEAST_EXPECT(to_string(index->saved()) == "98-103");
+        BEAST_EXPECT(
+            (read(*index, account(1), 0, ~0u, true) ==
+             Result{
+                 {{100, 1}, txID(100, 1)},
+                 {{101, 0}, txID(101, 0)},
+                 {{102, 2}, txID(102, 2)},
+                 {{103, 0}, txID(103, 0)}}));
+
+        // Deleted ledgers are no longer held
+        index->deleteBefore(101);
+        reopen(index, open);
+        BEAST_EXPECT(to_string(index->saved()) == "101-103");
+        BEAST_EXPECT(read(*index, account(1), 0, 100, true).empty());
+
+        // The cutover survives reopening, and does not by itself make the
+        // index used in place of the table
+        index->setCutover(103);
+        reopen(index, open);
+        BEAST_EXPECT(index->cutover() == 103u);
+        BEAST_EXPECT(!index->ready());
+        index->markReady();
+        BEAST_EXPECT(index->ready());
+
+        // Everything may be deleted
+        index->deleteBefore(200);
+        reopen(index, open);
+        BEAST_EXPECT(index->saved().empty());
+    }
+
+public:
+    void
+    run() override
+    {
+        Create const memory = []() -> Open {
+            std::shared_ptr<AccountTxIndex::Backend> const backend =
+                make_MemoryAccountTxBackend();
+            return [backend]() {
+                return std::make_unique<SharedBackend>(backend);
+            };
+        };
+        testPaging("in memory", memory);
+        testSaved("in memory", memory);
+
+#if RIPPLE_ROCKSDB_AVAILABLE
+        auto const dir = std::make_shared<beast::temp_dir>();
+        SuiteJournal journal("AccountTxIndex_test", *this);
+        Create const rocksdb = [dir, &journal, n = 0]() mutable -> Open {
+            Section section("account_tx_index");
+            section.set("type", "rocksdb");
+            section.set("path", dir->file("store" + std::to_string(n++)));
+            return [section, &journal]() {
+                return make_AccountTxBackend(section, journal);
+            };
+        };
+        testPaging("in RocksDB", rocksdb);
+        testSaved("in RocksDB", rocksdb);
+#endif
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AccountTxIndex, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
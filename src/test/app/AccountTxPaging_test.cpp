@@ -16,11 +16,17 @@
     OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 //==============================================================================
+#include <ripple/app/misc/AccountTxIndex.h>
+#include <ripple/app/misc/impl/AccountTxPaging.h>
 #include <ripple/beast/unit_test.h>
+#include <ripple/core/DatabaseCon.h>
 #include <ripple/protocol/SField.h>
 #include <ripple/protocol/jss.h>
+#include <chrono>
 #include <cstdlib>
+#include <thread>
 #include <test/jtx.h>
+#include <test/unit_test/SuiteJournal.h>
 
 #include <ripple/rpc/GRPCHandlers.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
@@ -61,12 +67,31 @@ class AccountTxPaging_test : public beast::unit_test::suite
     }
 
     void
-    testAccountTxPaging()
+    testAccountTxPaging(bool indexed)
     {
-        testcase("Paging for Single Account");
+        testcase(
+            std::string("Paging for Single Account") +
+            (indexed ? " from the account transaction index" : ""));
         using namespace test::jtx;
 
-        Env env(*this);
+        Env env(*this, envconfig([indexed](std::unique_ptr<Config> cfg) {
+            if (indexed)
+                cfg->section("account_tx_index").set("type", "memory");
+            return cfg;
+        }));
+        if (indexed)
+        {
+            // Nothing is left to copy from an empty table
+            using namespace std::chrono_literals;
+            auto const index = env.app().getAccountTxIndex();
+            if (!BEAST_EXPECT(index))
+                return;
+            for (int i = 0; i < 1000 && !index->ready(); ++i)
+                std::this_thread::sleep_for(5ms);
+            if (!BEAST_EXPECT(index->ready()))
+                return;
+        }
+
         Account A1{"A1"};
         Account A2{"A2"};
         Account A3{"A3"};
@@ -2163,11 +2188,150 @@ class AccountTxPaging_test : public beast::unit_test::suite
         }
     }
 
+    void
+    testCopyFromTable()
+    {
+        testcase("Copy from the AccountTransactions table");
+        using namespace test::jtx;
+
+        Env env(*this);
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, alice, bob);
+        env.close();
+        env.trust(USD(1000), alice, bob);
+        env.close();
+        for (auto i = 0; i < 6; ++i)
+        {
+            env(pay(gw, alice, USD(10)));
+            env(pay(alice, bob, USD(5)));
+            env(pay(bob, gw, XRP(10)));
+            env.close();
+        }
+
+        auto& txnDB = env.app().getTxnDB();
+        BEAST_EXPECT(!accountTxIndexCutover(txnDB));
+
+        using Entries =
+            std::vector<std::pair<AccountTxIndex::Position, std::string>>;
+
+        // What the table holds of an account
+        auto const fromTable = [&txnDB](AccountID const& account) {
+            Entries entries;
+            auto db = txnDB.checkoutDb();
+            std::uint64_t ledgerSeq;
+            std::uint32_t txnSeq;
+            std::string txID;
+            std::string const id = toBase58(account);
+            soci::statement st =
+                (db->prepare << "SELECT LedgerSeq,TxnSeq,TransID "
+                                "FROM AccountTransactions "
+                                "WHERE Account = :account "
+                                "ORDER BY LedgerSeq,TxnSeq;",
+                 soci::into(ledgerSeq),
+                 soci::into(txnSeq),
+                 soci::into(txID),
+                 soci::use(id));
+            st.execute();
+            while (st.fetch())
+                entries.emplace_back(
+                    AccountTxIndex::Position(ledgerSeq, txnSeq), txID);
+            return entries;
+        };
+
+        // What the index holds of an account
+        auto const fromIndex = [](AccountTxIndex const& index,
+                                  AccountID const& account) {
+            Entries entries;
+            index.forEach(
+                account,
+                0,
+                ~0u,
+                true,
+                boost::none,
+                [&](AccountTxIndex::Position const& position,
+                    uint256 const& txID) {
+                    entries.emplace_back(position, to_string(txID));
+                    return true;
+                });
+            return entries;
+        };
+
+        test::SuiteJournal journal("AccountTxPaging_test", *this);
+        AccountTxIndex index(make_MemoryAccountTxBackend(), journal);
+        BEAST_EXPECT(openAccountTxIndex(index, txnDB, journal));
+        BEAST_EXPECT(!index.ready());
+
+        // A ledger in the middle was saved to the index as it closed, and
+        // those around it were saved while the server ran without it
+        auto const newest = env.closed()->info().seq;
+        {
+            std::vector<AccountTxIndex::Entry> entries;
+            for (auto const& account : {gw, alice, bob})
+            {
+                for (auto const& [position, txID] : fromTable(account))
+                {
+                    uint256 id;
+                    if (position.first == newest - 2 && id.SetHexExact(txID))
+                        entries.push_back({account.id(), position.second, id});
+                }
+            }
+            BEAST_EXPECT(!entries.empty());
+            index.saveLedger(newest - 2, entries);
+        }
+
+        // Copy two ledgers at a time
+        int chunks = 1;
+        while (copyAccountTransactions(index, txnDB, 2, journal))
+            ++chunks;
+        BEAST_EXPECT(chunks > 1);
+        BEAST_EXPECT(index.ready());
+        BEAST_EXPECT(accountTxIndexCutover(txnDB) == newest);
+        BEAST_EXPECT(index.cutover() == newest);
+
+        // The index holds exactly what the table holds
+        for (auto const& account : {gw, alice, bob})
+        {
+            auto const table = fromTable(account.id());
+            BEAST_EXPECT(!table.empty());
+            BEAST_EXPECT(fromIndex(index, account.id()) == table);
+        }
+
+        // A ledger saved to the table, but not the index, as the cutover
+        // was recorded is copied when the index is next opened
+        {
+            auto db = txnDB.checkoutDb();
+            std::string const txID(64, 'A');
+            std::string const account = alice.human();
+            std::uint64_t const ledgerSeq = newest + 1;
+            *db << "INSERT INTO AccountTransactions "
+                   "(TransID, Account, LedgerSeq, TxnSeq) "
+                   "VALUES (:id, :account, :seq, 0);",
+                soci::use(txID), soci::use(account), soci::use(ledgerSeq);
+        }
+        BEAST_EXPECT(openAccountTxIndex(index, txnDB, journal));
+        BEAST_EXPECT(index.ready());
+        BEAST_EXPECT(
+            fromIndex(index, alice.id()).back() ==
+            Entries::value_type({newest + 1, 0}, std::string(64, 'A')));
+        BEAST_EXPECT(fromIndex(index, alice.id()) == fromTable(alice.id()));
+
+        // Once the table is replaced, no other index can be used
+        AccountTxIndex empty(make_MemoryAccountTxBackend(), journal);
+        BEAST_EXPECT(!openAccountTxIndex(empty, txnDB, journal));
+        BEAST_EXPECT(!empty.ready());
+    }
+
 public:
     void
     run() override
     {
-        testAccountTxPaging();
+        testAccountTxPaging(false);
+        testAccountTxPaging(true);
+        testCopyFromTable();
         testAccountTxPagingGrpc();
         testAccountTxParametersGrpc();
         testAccountTxContentsGrpc();
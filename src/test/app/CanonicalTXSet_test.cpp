@@ -0,0 +1,311 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/CanonicalTXSet.h>
+#include <ripple/basics/random.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <tuple>
+
+namespace ripple {
+namespace test {
+
+class CanonicalTXSet_test : public beast::unit_test::suite
+{
+    using Txs = std::vector<std::shared_ptr<STTx const>>;
+
+    static std::shared_ptr<STTx const>
+    makeTx(std::uint64_t account, std::uint32_t seq, std::uint32_t flags = 0)
+    {
+        return std::make_shared<STTx const>(ttACCOUNT_SET, [&](auto& obj) {
+            obj.setAccountID(sfAccount, AccountID(account));
+            obj.setFieldU32(sfSequence, seq);
+            obj.setFieldU32(sfFlags, flags);
+        });
+    }
+
+    // The canonical order, worked out the slow way
+    static Txs
+    canonical(Txs txs, uint256 const& salt)
+    {
+        auto const key = [&salt](std::shared_ptr<STTx const> const& tx) {
+            uint256 account = beast::zero;
+            auto const id = tx->getAccountID(sfAccount);
+            memcpy(account.begin(), id.begin(), id.size());
+            account ^= salt;
+            return std::make_tuple(
+                account, tx->getSequence(), tx->getTransactionID());
+        };
+        std::sort(txs.begin(), txs.end(), [&key](auto const& a, auto const& b) {
+            return key(a) < key(b);
+        });
+        return txs;
+    }
+
+    static Txs
+    contents(CanonicalTXSet const& set)
+    {
+        Txs ret;
+        for (auto const& item : set)
+        {
+            if (item.first.getTXID() != item.second->getTransactionID())
+                return {};
+            ret.push_back(item.second);
+        }
+        return ret;
+    }
+
+    static Txs
+    makeTxs(std::size_t accounts, std::uint32_t seqs)
+    {
+        Txs txs;
+        txs.reserve(accounts * seqs);
+        for (std::uint64_t a = 1; a <= accounts; ++a)
+            for (std::uint32_t s = 1; s <= seqs; ++s)
+                txs.push_back(makeTx(a * 0x9e3779b97f4a7c15ull, s));
+        return txs;
+    }
+
+    void
+    testOrder()
+    {
+        testcase("order");
+
+        uint256 const salt{rand_int<std::uint64_t>()};
+        auto txs = makeTxs(20, 10);
+
+        // Transactions which only differ in their ids
+        txs.push_back(makeTx(7, 3, 1));
+        txs.push_back(makeTx(7, 3, 2));
+        txs.push_back(makeTx(7, 3, 3));
+
+        beast::xor_shift_engine rng(7);
+        std::shuffle(txs.begin(), txs.end(), rng);
+
+        CanonicalTXSet set(salt);
+        BEAST_EXPECT(set.empty());
+        BEAST_EXPECT(set.begin() == set.end());
+        for (auto const& tx : txs)
+            set.insert(tx);
+
+        BEAST_EXPECT(set.size() == txs.size());
+        BEAST_EXPECT(contents(set) == canonical(txs, salt));
+        BEAST_EXPECT(set.key() == salt);
+
+        // Inserting again is not a no-op, but the set keeps one copy
+        set.insert(txs[5]);
+        set.insert(std::make_shared<STTx const>(*txs[6]));
+        BEAST_EXPECT(set.size() == txs.size());
+        BEAST_EXPECT(contents(set) == canonical(txs, salt));
+
+        set.reset(uint256{});
+        BEAST_EXPECT(set.empty());
+        for (auto const& tx : txs)
+            set.insert(tx);
+        BEAST_EXPECT(contents(set) == canonical(txs, uint256{}));
+    }
+
+    void
+    testErase()
+    {
+        testcase("erase");
+
+        CanonicalTXSet set(uint256{42});
+        auto const txs = makeTxs(10, 10);
+        for (auto const& tx : txs)
+            set.insert(tx);
+
+        std::vector<CanonicalTXSet::const_iterator> kept;
+        Txs expected;
+        std::size_t n = 0;
+        for (auto it = set.begin(); it != set.end(); ++n)
+        {
+            if (n % 3 == 0)
+            {
+                it = set.erase(it);
+                continue;
+            }
+            expected.push_back(it->second);
+            kept.push_back(it++);
+        }
+        BEAST_EXPECT(n == txs.size());
+        BEAST_EXPECT(set.size() == expected.size());
+        BEAST_EXPECT(contents(set) == expected);
+
+        // Erasing leaves the other iterators valid
+        for (std::size_t i = 0; i < kept.size(); i += 2)
+            set.erase(kept[i]);
+        bool same = true;
+        for (std::size_t i = 1; i < kept.size(); i += 2)
+            same &= kept[i]->second == expected[i];
+        BEAST_EXPECT(same);
+
+        Txs left;
+        for (std::size_t i = 1; i < expected.size(); i += 2)
+            left.push_back(expected[i]);
+        BEAST_EXPECT(set.size() == left.size());
+        BEAST_EXPECT(contents(set) == left);
+
+        // Erased transactions may be inserted again
+        for (auto const& tx : txs)
+            set.insert(tx);
+        BEAST_EXPECT(set.size() == txs.size());
+        BEAST_EXPECT(contents(set) == canonical(txs, uint256{42}));
+
+        for (auto it = set.begin(); it != set.end();)
+            it = set.erase(it);
+        BEAST_EXPECT(set.empty());
+        BEAST_EXPECT(set.begin() == set.end());
+    }
+
+    void
+    testPrune()
+    {
+        testcase("prune");
+
+        CanonicalTXSet set(uint256{});
+        auto const a = makeTx(1, 5);
+        auto const b = makeTx(1, 5, 1);
+        auto const c = makeTx(1, 6);
+        auto const d = makeTx(2, 5);
+        for (auto const& tx : {a, b, c, d})
+            set.insert(tx);
+
+        auto pruned = set.prune(AccountID(1), 5);
+        BEAST_EXPECT(pruned.size() == 2);
+        BEAST_EXPECT(
+            std::count(pruned.begin(), pruned.end(), a) == 1 &&
+            std::count(pruned.begin(), pruned.end(), b) == 1);
+        BEAST_EXPECT(set.size() == 2);
+        BEAST_EXPECT(contents(set) == canonical({c, d}, uint256{}));
+
+        BEAST_EXPECT(set.prune(AccountID(1), 5).empty());
+        BEAST_EXPECT(set.prune(AccountID(3), 5).empty());
+        BEAST_EXPECT(set.prune(AccountID(2), 5) == Txs{d});
+        BEAST_EXPECT(set.size() == 1);
+    }
+
+protected:
+    /** Time what consensus does with a set: fill it, apply it in passes
+        in which some transactions are retried, then hold back the rest.
+        The same work on a std::map is timed for comparison.
+    */
+    void
+    testLarge(std::size_t accounts, std::uint32_t seqs)
+    {
+        using namespace std::chrono;
+        using clock_type = steady_clock;
+
+        auto txs = makeTxs(accounts, seqs);
+        testcase(std::to_string(txs.size()) + " transactions");
+
+        beast::xor_shift_engine rng(11);
+        std::shuffle(txs.begin(), txs.end(), rng);
+        uint256 const salt{rng()};
+
+        // One transaction in ten is retried in every pass but the last
+        auto const retry = [](std::size_t pass, std::size_t n) {
+            return pass < 2 && n % 10 == 0;
+        };
+
+        auto start = clock_type::now();
+        CanonicalTXSet set(salt);
+        for (auto const& tx : txs)
+            set.insert(tx);
+        std::size_t applied = 0;
+        for (std::size_t pass = 0; pass < 3; ++pass)
+        {
+            std::size_t n = 0;
+            for (auto it = set.begin(); it != set.end(); ++n)
+            {
+                if (retry(pass, n))
+                {
+                    ++it;
+                    continue;
+                }
+                ++applied;
+                it = set.erase(it);
+            }
+        }
+        auto const flat =
+            duration_cast<microseconds>(clock_type::now() - start);
+        BEAST_EXPECT(set.empty());
+        BEAST_EXPECT(applied == txs.size());
+
+        using Key = std::tuple<uint256, std::uint32_t, uint256>;
+        start = clock_type::now();
+        std::map<Key, std::shared_ptr<STTx const>> map;
+        for (auto const& tx : txs)
+        {
+            uint256 account = beast::zero;
+            auto const id = tx->getAccountID(sfAccount);
+            memcpy(account.begin(), id.begin(), id.size());
+            account ^= salt;
+            map.emplace(
+                Key{account, tx->getSequence(), tx->getTransactionID()}, tx);
+        }
+        for (std::size_t pass = 0; pass < 3; ++pass)
+        {
+            std::size_t n = 0;
+            for (auto it = map.begin(); it != map.end(); ++n)
+            {
+                if (retry(pass, n))
+                    ++it;
+                else
+                    it = map.erase(it);
+            }
+        }
+        auto const tree =
+            duration_cast<microseconds>(clock_type::now() - start);
+        BEAST_EXPECT(map.empty());
+
+        log << txs.size() << " transactions: " << flat.count()
+            << "us, std::map " << tree.count() << "us" << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        testOrder();
+        testErase();
+        testPrune();
+        testLarge(100, 10);
+    }
+};
+
+class CanonicalTXSet_manual_test : public CanonicalTXSet_test
+{
+public:
+    void
+    run() override
+    {
+        testLarge(5000, 10);
+        testLarge(50000, 1);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(CanonicalTXSet, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(CanonicalTXSet_manual, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/FetchPackCache.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/protocol/jss.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class FetchPackCache_test : public beast::unit_test::suite
+{
+    static std::shared_ptr<FetchPackCache::Segment const>
+    makeSegment(LedgerIndex seq, std::size_t objects, std::size_t size)
+    {
+        auto segment = std::make_shared<FetchPackCache::Segment>(
+            seq, uint256(seq), uint256(seq - 1));
+        for (std::size_t i = 0; i < objects; ++i)
+        {
+            Blob const data(size, static_cast<std::uint8_t>(i));
+            segment->add(uint256(i + 1), data.data(), data.size());
+        }
+        return segment;
+    }
+
+    void
+    testSegment()
+    {
+        testcase("segment");
+
+        auto const segment = makeSegment(7, 10, 3);
+        BEAST_EXPECT(segment->size() == 10);
+        BEAST_EXPECT(segment->seq() == 7);
+        BEAST_EXPECT(segment->parent() == uint256(6));
+
+        // Objects come out in chunks, in order, with their contents intact
+        protocol::TMGetObjectByHash reply;
+        std::size_t next = 0;
+        next = segment->append(reply, next, 4);
+        BEAST_EXPECT(next == 4);
+        BEAST_EXPECT(reply.objects_size() == 4);
+        next = segment->append(reply, next, 4);
+        next = segment->append(reply, next, 4);
+        BEAST_EXPECT(next == 10);
+        BEAST_EXPECT(segment->append(reply, next, 4) == 10);
+        BEAST_EXPECT(reply.objects_size() == 10);
+
+        for (int i = 0; i < reply.objects_size(); ++i)
+        {
+            auto const& o = reply.objects(i);
+            BEAST_EXPECT(o.ledgerseq() == 7);
+            BEAST_EXPECT(uint256::fromVoid(o.hash().data()) == uint256(i + 1));
+            BEAST_EXPECT(o.data() == std::string(3, static_cast<char>(i)));
+        }
+    }
+
+    void
+    testCache()
+    {
+        testcase("cache");
+
+        using namespace std::chrono_literals;
+
+        FetchPackCache cache(4, 1000000);
+        BEAST_EXPECT(!cache.fetch(uint256(2)));
+        BEAST_EXPECT(!cache.recentlyServed(1h));
+
+        // Segments are keyed by the ledger the peer has
+        for (LedgerIndex seq = 1; seq <= 5; ++seq)
+            cache.insert(uint256(seq + 1), makeSegment(seq, 10, 8), 1ms);
+
+        // The oldest ledger was evicted
+        BEAST_EXPECT(cache.size() == 4);
+        BEAST_EXPECT(!cache.contains(uint256(2)));
+        BEAST_EXPECT(cache.contains(uint256(6)));
+        auto const segment = cache.fetch(uint256(4));
+        BEAST_EXPECT(segment && segment->seq() == 3);
+
+        // So are old ledgers when the cache is too big
+        FetchPackCache small(100, 3000);
+        for (LedgerIndex seq = 1; seq <= 5; ++seq)
+            small.insert(uint256(seq + 1), makeSegment(seq, 10, 100), 1ms);
+        BEAST_EXPECT(small.size() == 2);
+        BEAST_EXPECT(small.contains(uint256(6)));
+        BEAST_EXPECT(small.contains(uint256(5)));
+
+        cache.onServed(40, 2, 2ms);
+        BEAST_EXPECT(cache.recentlyServed(1h));
+
+        auto const jv = cache.getJson();
+        BEAST_EXPECT(jv[jss::segments].asUInt() == 4);
+        BEAST_EXPECT(jv[jss::hits].asString() == "1");
+        BEAST_EXPECT(jv[jss::misses].asString() == "1");
+        BEAST_EXPECT(jv[jss::build][jss::count].asString() == "5");
+        BEAST_EXPECT(jv[jss::build][jss::objects].asString() == "50");
+        BEAST_EXPECT(jv[jss::build][jss::time_us].asString() == "5000");
+        BEAST_EXPECT(
+            jv[jss::build][jss::objects_per_sec].asString() == "10000");
+        BEAST_EXPECT(jv[jss::serve][jss::objects].asString() == "40");
+        BEAST_EXPECT(jv[jss::serve][jss::messages].asString() == "2");
+        BEAST_EXPECT(
+            jv[jss::serve][jss::objects_per_sec].asString() == "20000");
+    }
+
+    void
+    testBuild()
+    {
+        testcase("build");
+
+        using namespace jtx;
+        Env env(*this);
+        Account const alice("alice");
+        Account const bob("bob");
+
+        env.fund(XRP(10000), alice, bob);
+        env.close();
+        env.trust(alice["USD"](1000), bob);
+        env(pay(bob, alice, XRP(5)));
+        env.close();
+
+        auto& lm = env.app().getLedgerMaster();
+        auto const have = lm.getClosedLedger();
+        auto const want = lm.getLedgerByHash(have->info().parentHash);
+        BEAST_EXPECT(want);
+        if (!want)
+            return;
+
+        auto const segment = FetchPackCache::build(*want, *have);
+        BEAST_EXPECT(segment->seq() == want->info().seq);
+        BEAST_EXPECT(segment->hash() == want->info().hash);
+        BEAST_EXPECT(segment->parent() == want->info().parentHash);
+        BEAST_EXPECT(segment->size() > 1);
+
+        // A peer checks every object against its hash before use
+        protocol::TMGetObjectByHash reply;
+        segment->append(reply, 0, segment->size());
+        BEAST_EXPECT(
+            static_cast<std::size_t>(reply.objects_size()) == segment->size());
+        for (auto const& o : reply.objects())
+        {
+            BEAST_EXPECT(
+                uint256::fromVoid(o.hash().data()) ==
+                sha512Half(makeSlice(o.data())));
+        }
+
+        // The ledger header comes first
+        BEAST_EXPECT(
+            uint256::fromVoid(reply.objects(0).hash().data()) ==
+            want->info().hash);
+    }
+
+public:
+    void
+    run() override
+    {
+        testSegment();
+        testCache();
+        testBuild();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FetchPackCache, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -19,6 +19,7 @@
 
 #include <ripple/app/paths/Flow.h>
 #include <ripple/app/paths/impl/Steps.h>
+#include <ripple/app/paths/impl/StrandFlow.h>
 #include <ripple/basics/contract.h>
 #include <ripple/core/Config.h>
 #include <ripple/ledger/ApplyViewImpl.h>
@@ -1239,6 +1240,154 @@ struct Flow_test : public beast::unit_test::suite
             txflags(tfPartialPayment));
     }
 
+    void
+    testQualityBoundReuse(FeatureBitset features)
+    {
+        testcase("Reuse of quality bounds while crossing");
+
+        using namespace jtx;
+
+        Env env(*this, features);
+
+        auto const gw = Account("gateway");
+        auto const alice = Account("alice");
+        auto const bob = Account("bob");
+        auto const carol = Account("carol");
+        auto const dan = Account("dan");
+        auto const erin = Account("erin");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+
+        env.fund(XRP(10000), gw, alice, bob, carol, dan, erin);
+        env.close();
+        env.trust(USD(1000), alice, bob, carol, dan, erin);
+        env.trust(EUR(1000), alice, bob, carol, erin);
+        env.close();
+        env(pay(gw, alice, USD(100)));
+        env(pay(gw, bob, EUR(15)));
+        env(pay(gw, carol, EUR(100)));
+        env(pay(gw, erin, EUR(100)));
+        env.close();
+
+        // Bob has EUR for only one of his offers, so taking one through
+        // the XRP bridge leaves his offer in the direct book underfunded,
+        // and the other way around.
+        env(offer(bob, XRP(100), EUR(10.5)));
+        env(offer(bob, USD(10), EUR(10)));
+        env(offer(carol, USD(11), EUR(10)));
+        env(offer(carol, XRP(100), EUR(9)));
+        env(offer(dan, USD(10), XRP(100)));
+        env(offer(dan, USD(10), XRP(95)));
+        env(offer(erin, USD(12), EUR(10)));
+        env.close();
+
+        // Cross alice's offer of up to 40 USD for 30 EUR, directly and
+        // through XRP, as CreateOffer does
+        STPathSet paths;
+        paths.emplace_back(STPath(
+            {STPathElement(boost::none, xrpCurrency(), boost::none)}));
+        Quality const limitQuality(Amounts(USD(40), EUR(30)));
+
+        auto const cross = [&](QualityBoundReuse& reuse) {
+            auto sb = std::make_unique<PaymentSandbox>(
+                env.current().get(), tapNONE);
+            auto const result = flow(
+                *sb,
+                EUR(30),
+                alice,
+                alice,
+                paths,
+                true,
+                true,
+                true,
+                true,
+                limitQuality,
+                STAmount(USD(40)),
+                env.journal,
+                nullptr,
+                &reuse);
+            return std::make_pair(result, std::move(sb));
+        };
+
+        QualityBoundReuse reused;
+        auto const [withCache, withSb] = cross(reused);
+        QualityBoundReuse evaluated;
+        evaluated.enabled = false;
+        auto const [withoutCache, withoutSb] = cross(evaluated);
+
+        BEAST_EXPECT(reused.evaluated > 0 && reused.reused > 0);
+        BEAST_EXPECT(evaluated.evaluated == 0 && evaluated.reused == 0);
+
+        BEAST_EXPECT(withCache.result() == tesSUCCESS);
+        BEAST_EXPECT(withCache.result() == withoutCache.result());
+        BEAST_EXPECT(withCache.actualAmountIn == withoutCache.actualAmountIn);
+        BEAST_EXPECT(
+            withCache.actualAmountOut == withoutCache.actualAmountOut);
+        BEAST_EXPECT(withCache.actualAmountOut > EUR(20));
+        BEAST_EXPECT(
+            withCache.removableOffers == withoutCache.removableOffers);
+
+        // Both leave every entry the same
+        std::size_t changed = 0;
+        for (auto const& sle : env.current()->sles)
+        {
+            auto const k = keylet::unchecked(sle->key());
+            auto const with = withSb->read(k);
+            auto const without = withoutSb->read(k);
+            if (!BEAST_EXPECT(!with == !without))
+                continue;
+            if (!with)
+            {
+                ++changed;
+                continue;
+            }
+            BEAST_EXPECT(
+                with->getSerializer().peekData() ==
+                without->getSerializer().peekData());
+            if (with->getSerializer().peekData() !=
+                sle->getSerializer().peekData())
+                ++changed;
+        }
+        BEAST_EXPECT(changed > 0);
+    }
+
+    void
+    testWrittenRanges()
+    {
+        testcase("Quality bounds invalidated by writes");
+
+        AccessedKeys reads;
+        reads.keys.push_back(uint256(5));
+        reads.ranges.emplace_back(uint256(10), uint256(20));
+        reads.ranges.emplace_back(uint256(30), boost::none);
+
+        auto const written = [&](std::vector<uint256> writes) {
+            std::sort(writes.begin(), writes.end());
+            return StepQualityCache::written(reads, writes);
+        };
+
+        BEAST_EXPECT(!written({}));
+        BEAST_EXPECT(written({uint256(5)}));
+        BEAST_EXPECT(!written({uint256(4), uint256(6)}));
+
+        // A key written within a range searched, which was not there to
+        // be found before
+        BEAST_EXPECT(written({uint256(15)}));
+        BEAST_EXPECT(written({uint256(11)}));
+        BEAST_EXPECT(written({uint256(19)}));
+        BEAST_EXPECT(written({uint256(2), uint256(12), uint256(25)}));
+
+        // A range excludes where it starts and ends
+        BEAST_EXPECT(!written({uint256(10)}));
+        BEAST_EXPECT(!written({uint256(20)}));
+        BEAST_EXPECT(!written({uint256(10), uint256(20), uint256(25)}));
+        BEAST_EXPECT(!written({uint256(30)}));
+
+        // A range searched to the end holds every key after its start
+        BEAST_EXPECT(written({uint256(31)}));
+        BEAST_EXPECT(written({~uint256()}));
+    }
+
     void
     testEmptyStrand(FeatureBitset features)
     {
@@ -1379,12 +1528,14 @@ struct Flow_test : public beast::unit_test::suite
         testXRPPathLoop();
         testRIPD1443();
         testRIPD1449();
+        testWrittenRanges();
 
         using namespace jtx;
         auto const sa = supported_amendments();
         testWithFeats(sa - featureFlowCross);
         testWithFeats(sa);
         testEmptyStrand(sa);
+        testQualityBoundReuse(sa);
     }
 };
 
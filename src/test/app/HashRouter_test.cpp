@@ -20,6 +20,9 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/beast/unit_test.h>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 namespace test {
@@ -191,7 +194,7 @@ class HashRouter_test : public beast::unit_test::suite
 
         uint256 const key1(1);
 
-        boost::optional<std::set<HashRouter::PeerShortID>> peers;
+        boost::optional<HashRouter::PeerShortIDSet> peers;
 
         peers = router.shouldRelay(key1);
         BEAST_EXPECT(peers && peers->empty());
@@ -277,6 +280,97 @@ class HashRouter_test : public beast::unit_test::suite
         BEAST_EXPECT(router.shouldProcess(key, peer, flags, 1s));
     }
 
+    void
+    testReclaim()
+    {
+        using namespace std::chrono_literals;
+        TestStopwatch stopwatch;
+        HashRouter router(stopwatch, 2s, 2);
+
+        for (int i = 1; i <= 1000; ++i)
+            router.addSuppression(uint256(i));
+        BEAST_EXPECT(router.size() == 1000);
+
+        // Keep some entries alive
+        ++stopwatch;
+        for (int i = 1; i <= 10; ++i)
+            router.addSuppressionPeer(uint256(i), 7);
+
+        // Inserting into every partition reclaims everything that expired
+        ++stopwatch;
+        for (int i = 1001; i <= 2000; ++i)
+            router.addSuppression(uint256(i));
+        BEAST_EXPECT(router.size() == 1010);
+
+        for (int i = 1; i <= 10; ++i)
+        {
+            int flags;
+            BEAST_EXPECT(!router.addSuppressionPeer(uint256(i), 7, flags));
+        }
+        BEAST_EXPECT(router.addSuppressionPeer(uint256(11), 7));
+    }
+
+    void
+    testPeerSet()
+    {
+        using namespace std::chrono_literals;
+        TestStopwatch stopwatch;
+        HashRouter router(stopwatch, 2s, 2);
+
+        uint256 const key(1);
+
+        // Peer 0 means "not from a peer" and is not tracked
+        std::vector<HashRouter::PeerShortID> const ids{
+            9, 3, 0, 27, 3, 1, 14, 9, 40, 2, 33, 5, 1, 6};
+        for (auto const id : ids)
+            router.addSuppressionPeer(key, id);
+
+        auto const peers = router.shouldRelay(key);
+        BEAST_EXPECT(peers);
+        if (!peers)
+            return;
+        BEAST_EXPECT(peers->size() == 10);
+        BEAST_EXPECT(peers->count(0) == 0);
+        for (auto const id : ids)
+            BEAST_EXPECT(id == 0 || peers->count(id) == 1);
+        BEAST_EXPECT(std::is_sorted(peers->begin(), peers->end()));
+    }
+
+    void
+    testConcurrency()
+    {
+        using namespace std::chrono_literals;
+        TestStopwatch stopwatch;
+        HashRouter router(stopwatch, 300s, 2);
+
+        std::size_t const keys = 4096;
+        std::size_t const threads = 8;
+
+        // Every thread is a peer sending us every key; each key must be
+        // created exactly once.
+        std::atomic<std::size_t> created{0};
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t] {
+                for (std::size_t i = 0; i < keys; ++i)
+                {
+                    if (router.addSuppressionPeer(
+                            uint256(i + 1),
+                            static_cast<HashRouter::PeerShortID>(t + 1)))
+                        ++created;
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+
+        BEAST_EXPECT(created == keys);
+        BEAST_EXPECT(router.size() == keys);
+        auto const peers = router.shouldRelay(uint256(keys / 2));
+        BEAST_EXPECT(peers && peers->size() == threads);
+    }
+
 public:
     void
     run() override
@@ -288,10 +382,81 @@ public:
         testRelay();
         testRecover();
         testProcess();
+        testReclaim();
+        testPeerSet();
+        testConcurrency();
+    }
+};
+
+class HashRouter_manual_test : public beast::unit_test::suite
+{
+    // Returns suppression operations per second
+    double
+    measure(std::size_t threads)
+    {
+        using namespace std::chrono;
+
+        // Roughly what a validator sees: every message arrives from
+        // several peers and is relayed once.
+        std::size_t const keysPerThread = 100000;
+        std::size_t const copies = 8;
+
+        HashRouter router(
+            stopwatch(),
+            HashRouter::getDefaultHoldTime(),
+            HashRouter::getDefaultRecoverLimit());
+
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t] {
+                while (!go)
+                    std::this_thread::yield();
+                for (std::size_t i = 0; i < keysPerThread; ++i)
+                {
+                    // Threads share half of their keys with a neighbour
+                    auto const n = (t * keysPerThread + i) / 2 + 1;
+                    uint256 const key(n);
+                    int flags;
+                    for (std::size_t c = 0; c < copies; ++c)
+                        router.addSuppressionPeer(
+                            key,
+                            static_cast<HashRouter::PeerShortID>(c + 1),
+                            flags);
+                    router.shouldRelay(key);
+                }
+            });
+        }
+
+        auto const start = steady_clock::now();
+        go = true;
+        for (auto& w : workers)
+            w.join();
+        auto const elapsed =
+            duration_cast<duration<double>>(steady_clock::now() - start);
+
+        return threads * keysPerThread * (copies + 1) / elapsed.count();
+    }
+
+public:
+    void
+    run() override
+    {
+        testcase("suppression throughput");
+
+        for (std::size_t threads = 1; threads <= 32; threads *= 2)
+        {
+            auto const ops = measure(threads);
+            log << threads << " threads: " << static_cast<std::uint64_t>(ops)
+                << " ops/s" << std::endl;
+        }
+        pass();
     }
 };
 
 BEAST_DEFINE_TESTSUITE(HashRouter, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(HashRouter_manual, app, ripple);
 
 }  // namespace test
 }  // namespace ripple
@@ -0,0 +1,372 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/BuildLedger.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerReplay.h>
+#include <ripple/basics/PerfLog.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/core/ConfigSections.h>
+#include <ripple/protocol/jss.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/predef.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <test/jtx.h>
+#include <thread>
+
+#if !BOOST_OS_WINDOWS
+#include <sys/resource.h>
+#endif
+
+namespace ripple {
+namespace test {
+
+/** Replays a range of ledgers, each from its parent and its transactions,
+    and reports how fast the transactions are applied.
+
+    The ledgers come from the databases of a node, or, with no databases
+    given, are made up first by the test itself. Each replayed ledger must
+    come out with the hash of the original. The cost of each transaction
+    type is taken from the PerfLog counters.
+
+    Usage:
+    --unittest-arg=db=<dir>,type=<type>,path=<path>,first=<seq>,last=<seq>
+
+    db:      database_path of the node, holding its ledger database
+    type:    type of its node store, such as NuDB or RocksDB
+    path:    path of its node store
+    first:   first ledger to replay
+    last:    last ledger to replay
+    threads: ledgers replayed at the same time (default 1)
+    ledgers: without db, the number of ledgers to make up (default 20)
+    txs:     without db, transactions in each of them (default 200)
+
+    Replayed ledgers are written back to the node store, so run this on a
+    copy of the databases. Ledgers kept only in a shard store cannot be
+    replayed: a ledger built on a parent from a finished shard would be
+    written to that shard.
+*/
+class LedgerReplayBench_test : public beast::unit_test::suite
+{
+    using Loader = std::function<std::shared_ptr<Ledger const>(LedgerIndex)>;
+
+    // Runs and total duration, in microseconds, of each stage
+    using Stages = std::array<
+        std::pair<std::uint64_t, std::uint64_t>,
+        perf::PerfLog::txStages>;
+
+    static std::map<std::string, std::string>
+    parseArgs(std::string const& s)
+    {
+        std::map<std::string, std::string> ret;
+        std::vector<std::string> items;
+        boost::split(items, s, boost::algorithm::is_any_of(","));
+        for (auto const& item : items)
+        {
+            auto const eq = item.find('=');
+            if (eq == std::string::npos)
+                continue;
+            ret[boost::trim_copy(item.substr(0, eq))] =
+                boost::trim_copy(item.substr(eq + 1));
+        }
+        return ret;
+    }
+
+    static std::map<std::string, Stages>
+    stageCounts(Application& app)
+    {
+        auto const txs = app.getPerfLog().countersJson()[jss::transactions];
+
+        std::map<std::string, Stages> ret;
+        for (auto it = txs.begin(); it != txs.end(); ++it)
+        {
+            auto& stages = ret[it.key().asString()];
+            for (std::size_t i = 0; i < stages.size(); ++i)
+            {
+                auto const& stage =
+                    (*it)[to_string(static_cast<perf::PerfLog::TxStage>(i))];
+                stages[i].first = std::stoull(stage[jss::count].asString());
+                stages[i].second =
+                    std::stoull(stage[jss::duration_us].asString());
+            }
+        }
+        return ret;
+    }
+
+    // Peak resident memory of the process in kilobytes, or 0 if unknown
+    static std::size_t
+    peakMemory()
+    {
+#if BOOST_OS_WINDOWS
+        return 0;
+#else
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+#if BOOST_OS_MACOS
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+#endif
+    }
+
+    void
+    replay(
+        Application& app,
+        LedgerIndex first,
+        LedgerIndex last,
+        std::size_t threads,
+        Loader const& load)
+    {
+        using namespace std::chrono;
+
+        testcase(
+            "replay ledgers " + std::to_string(first) + " to " +
+            std::to_string(last) + " on " + std::to_string(threads) +
+            " threads");
+
+        auto const before = stageCounts(app);
+        beast::Journal const j = app.journal("LedgerReplayBench");
+
+        std::atomic<LedgerIndex> next{first};
+        std::atomic<std::size_t> txns{0};
+        std::atomic<std::size_t> missing{0};
+        std::mutex mutex;
+        std::vector<LedgerIndex> mismatched;
+
+        auto work = [&]() {
+            for (auto seq = next++; seq <= last; seq = next++)
+            {
+                auto const parent = load(seq - 1);
+                auto const ledger = load(seq);
+                if (!parent || !ledger)
+                {
+                    ++missing;
+                    continue;
+                }
+
+                LedgerReplay const data(parent, ledger);
+                auto const built = buildLedger(data, tapNONE, app, j);
+                txns += data.orderedTxns().size();
+
+                if (!built || built->info().hash != ledger->info().hash)
+                {
+                    std::lock_guard lock(mutex);
+                    mismatched.push_back(seq);
+                }
+            }
+        };
+
+        auto const start = steady_clock::now();
+        {
+            std::vector<std::thread> workers;
+            for (std::size_t i = 1; i < threads; ++i)
+                workers.emplace_back(work);
+            work();
+            for (auto& t : workers)
+                t.join();
+        }
+        auto const elapsed =
+            duration_cast<microseconds>(steady_clock::now() - start);
+
+        BEAST_EXPECT(missing == 0);
+        BEAST_EXPECT(mismatched.empty());
+        for (auto const seq : mismatched)
+            log << "ledger " << seq << " replayed to a different hash"
+                << std::endl;
+
+        auto const seconds = std::max<double>(elapsed.count(), 1) / 1e6;
+        log << last - first + 1 - missing.load() << " ledgers, "
+            << txns.load() << " transactions in " << seconds
+            << "s: " << txns.load() / seconds
+            << " transactions/s, peak memory " << peakMemory() / 1024
+            << "MB" << std::endl;
+
+        for (auto const& [type, after] : stageCounts(app))
+        {
+            Stages stages = after;
+            if (auto const it = before.find(type); it != before.end())
+            {
+                for (std::size_t i = 0; i < stages.size(); ++i)
+                {
+                    stages[i].first -= it->second[i].first;
+                    stages[i].second -= it->second[i].second;
+                }
+            }
+
+            auto const count =
+                stages[static_cast<std::size_t>(
+                           perf::PerfLog::TxStage::apply)]
+                    .first;
+            if (count == 0)
+                continue;
+
+            log << "  " << type << ": " << count << " applied";
+            for (std::size_t i = 0; i < stages.size(); ++i)
+            {
+                log << ", "
+                    << to_string(static_cast<perf::PerfLog::TxStage>(i))
+                    << " " << stages[i].second / count << "us";
+            }
+            log << std::endl;
+        }
+    }
+
+    // Replays ledgers from the databases of a node
+    void
+    replayNode(std::map<std::string, std::string> const& args)
+    {
+        using namespace jtx;
+
+        for (auto const key : {"type", "path", "first", "last"})
+        {
+            if (args.count(key) == 0)
+            {
+                fail(std::string("Missing parameter: ") + key);
+                return;
+            }
+        }
+
+        LedgerIndex const first = std::stoul(args.at("first"));
+        LedgerIndex const last = std::stoul(args.at("last"));
+        std::size_t const threads =
+            args.count("threads") ? std::stoul(args.at("threads")) : 1;
+        if (!BEAST_EXPECT(first > 1 && first <= last && threads > 0))
+            return;
+
+        Env env{*this, envconfig([&args](std::unique_ptr<Config> cfg) {
+                    cfg->legacy("database_path", args.at("db"));
+                    cfg->overwrite(
+                        ConfigSection::nodeDatabase(), "type", args.at("type"));
+                    cfg->overwrite(
+                        ConfigSection::nodeDatabase(), "path", args.at("path"));
+                    return cfg;
+                })};
+
+        auto& app = env.app();
+        replay(app, first, last, threads, [&app](LedgerIndex seq) {
+            return loadByIndex(seq, app, false);
+        });
+    }
+
+    // Makes up ledgers of payments and offers, then replays them
+    void
+    replaySynthetic(std::map<std::string, std::string> const& args)
+    {
+        using namespace jtx;
+
+        std::size_t const ledgers =
+            args.count("ledgers") ? std::stoul(args.at("ledgers")) : 20;
+        std::size_t const perLedger =
+            args.count("txs") ? std::stoul(args.at("txs")) : 200;
+        std::size_t const threads =
+            args.count("threads") ? std::stoul(args.at("threads")) : 1;
+
+        Env env{*this, envconfig([](std::unique_ptr<Config> cfg) {
+                    cfg->section("transaction_queue")
+                        .set("minimum_txn_in_ledger_standalone", "100000");
+                    return cfg;
+                })};
+
+        Account const gw{"gateway"};
+        auto const USD = gw["USD"];
+        std::vector<Account> accounts;
+        for (std::size_t i = 0; i < 20; ++i)
+            accounts.emplace_back("account" + std::to_string(i));
+
+        env.fund(XRP(1000000), gw);
+        for (auto const& a : accounts)
+            env.fund(XRP(1000000), a);
+        env.close();
+        for (auto const& a : accounts)
+            env.trust(USD(1000000000), a);
+        env.close();
+        for (auto const& a : accounts)
+            env(pay(gw, a, USD(1000000)));
+        env.close();
+
+        std::map<LedgerIndex, std::shared_ptr<Ledger const>> closed;
+        auto& ledgerMaster = env.app().getLedgerMaster();
+        closed[ledgerMaster.getClosedLedger()->info().seq] =
+            ledgerMaster.getClosedLedger();
+
+        for (std::size_t l = 0; l < ledgers; ++l)
+        {
+            for (std::size_t i = 0; i < perLedger; ++i)
+            {
+                auto const& from = accounts[(l + i) % accounts.size()];
+                auto const& to = accounts[(l + 3 * i + 1) % accounts.size()];
+                switch (i % 4)
+                {
+                    case 0:
+                        env(pay(from, to, XRP(10)));
+                        break;
+                    case 1:
+                        env(pay(from, to, USD(10)));
+                        break;
+                    case 2:
+                        env(offer(from, XRP(10 + i % 7), USD(10)));
+                        break;
+                    default:
+                        env(offer(from, USD(10), XRP(10 + i % 5)));
+                        break;
+                }
+            }
+            env.close();
+            auto const ledger = ledgerMaster.getClosedLedger();
+            closed[ledger->info().seq] = ledger;
+        }
+
+        auto const last = closed.rbegin()->first;
+        replay(
+            env.app(),
+            last - ledgers + 1,
+            last,
+            threads,
+            [&closed](LedgerIndex seq) -> std::shared_ptr<Ledger const> {
+                auto const it = closed.find(seq);
+                if (it == closed.end())
+                    return nullptr;
+                return it->second;
+            });
+    }
+
+public:
+    void
+    run() override
+    {
+        auto const args = parseArgs(arg());
+        if (args.count("db"))
+            replayNode(args);
+        else
+            replaySynthetic(args);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(LedgerReplayBench, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/OpenLedger.h>
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/Transaction.h>
+#include <ripple/beast/unit_test.h>
+#include <chrono>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+/** Measures how long applying transactions to the open ledger takes as the
+    open ledger fills up.
+
+    Every transaction is submitted as a local transaction, so NetworkOPs
+    applies it in a batch of its own and OpenLedger::modify makes a new
+    copy of the open view each time. Reported per chunk of transactions,
+    the cost should stay flat rather than grow with the size of the open
+    ledger.
+*/
+class OpenLedgerApply_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono;
+        using namespace jtx;
+
+        std::size_t const senders = 100;
+        std::size_t const perSender = 50;
+        std::size_t const chunk = 500;
+
+        Env env{*this, envconfig([](std::unique_ptr<Config> cfg) {
+                    cfg->section("transaction_queue")
+                        .set("minimum_txn_in_ledger_standalone", "100000");
+                    return cfg;
+                })};
+
+        Account const dest{"dest"};
+        std::vector<Account> accounts;
+        for (std::size_t i = 0; i < senders; ++i)
+            accounts.emplace_back("sender" + std::to_string(i));
+
+        env.fund(XRP(100000), dest);
+        for (auto const& a : accounts)
+            env.fund(XRP(100000), a);
+        env.close();
+
+        // Sign everything up front so that only applying is timed
+        std::vector<std::shared_ptr<STTx const>> txns;
+        txns.reserve(senders * perSender);
+        for (std::size_t n = 0; n < perSender; ++n)
+        {
+            for (auto const& a : accounts)
+                txns.push_back(env.jt(
+                                      pay(a, dest, drops(1000)),
+                                      seq(env.seq(a) + n),
+                                      fee(drops(10)))
+                                   .stx);
+        }
+
+        auto& ops = env.app().getOPs();
+        std::vector<microseconds> chunks;
+        auto start = steady_clock::now();
+        for (std::size_t i = 0; i < txns.size(); ++i)
+        {
+            std::string reason;
+            auto tx = std::make_shared<Transaction>(txns[i], reason, env.app());
+            ops.processTransaction(tx, true, true, NetworkOPs::FailHard::no);
+
+            if ((i + 1) % chunk == 0)
+            {
+                auto const now = steady_clock::now();
+                chunks.push_back(duration_cast<microseconds>(now - start));
+                start = now;
+            }
+        }
+
+        BEAST_EXPECT(
+            env.app().openLedger().current()->txCount() == txns.size());
+
+        for (std::size_t i = 0; i < chunks.size(); ++i)
+        {
+            log << "transactions " << i * chunk << " to " << (i + 1) * chunk
+                << ": " << chunks[i].count() / chunk << "us per tx"
+                << std::endl;
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(OpenLedgerApply, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
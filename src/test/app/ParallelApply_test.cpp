@@ -0,0 +1,241 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/BuildLedger.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/misc/CanonicalTXSet.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/Feature.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/shamap/SHAMap.h>
+#include <test/jtx.h>
+#include <set>
+
+namespace ripple {
+namespace test {
+
+/** Builds the same ledgers with transactions applied serially and
+    speculatively in parallel, and checks that they come out identical:
+    side by side, and by rebuilding the ledgers a serial server closed.
+*/
+class ParallelApply_test : public beast::unit_test::suite
+{
+    static std::unique_ptr<Config>
+    makeConfig(std::size_t threads)
+    {
+        auto cfg = jtx::envconfig();
+        cfg->LEDGER_APPLY_THREADS = threads;
+        cfg->section("transaction_queue")
+            .set("minimum_txn_in_ledger_standalone", "10000");
+        return cfg;
+    }
+
+    // Submits the same transactions to every env
+    template <class... Args>
+    static void
+    submit(std::vector<jtx::Env*> const& envs, Args const&... args)
+    {
+        for (auto env : envs)
+            (*env)(args...);
+    }
+
+    void
+    expectSame(jtx::Env& serial, jtx::Env& parallel, std::string const& what)
+    {
+        serial.close();
+        parallel.close();
+
+        auto const a = serial.closed();
+        auto const b = parallel.closed();
+        BEAST_EXPECTS(a->info().seq == b->info().seq, what);
+        BEAST_EXPECTS(a->info().txHash == b->info().txHash, what);
+        BEAST_EXPECTS(a->info().accountHash == b->info().accountHash, what);
+        BEAST_EXPECTS(a->info().hash == b->info().hash, what);
+    }
+
+    // Runs the same transactions through every env. closed(what) is called
+    // whenever they should all close a ledger.
+    template <class Closed>
+    void
+    workload(std::vector<jtx::Env*> const& envs, Closed&& closed)
+    {
+        using namespace jtx;
+
+        Account const gw{"gateway"};
+        Account const hub{"hub"};
+        auto const USD = gw["USD"];
+
+        std::vector<Account> accounts;
+        for (int i = 0; i < 40; ++i)
+            accounts.emplace_back("account" + std::to_string(i));
+
+        for (auto env : envs)
+        {
+            env->fund(XRP(100000), gw, hub);
+            for (auto const& a : accounts)
+                env->fund(XRP(10000), a);
+        }
+        closed("fund");
+
+        // Independent payments between disjoint pairs
+        for (std::size_t i = 0; i + 1 < accounts.size(); i += 2)
+            submit(envs, pay(accounts[i], accounts[i + 1], XRP(10)));
+        closed("disjoint payments");
+
+        // Every transaction touches the same account
+        for (auto const& a : accounts)
+            submit(envs, pay(a, hub, XRP(1)));
+        for (auto const& a : accounts)
+            submit(envs, pay(hub, a, XRP(2)));
+        closed("shared account");
+
+        // Several transactions from each account in one ledger
+        for (int n = 0; n < 3; ++n)
+        {
+            for (std::size_t i = 0; i < accounts.size(); ++i)
+                submit(
+                    envs,
+                    pay(accounts[i],
+                        accounts[(i + 1 + n) % accounts.size()],
+                        drops(1000 + n)));
+        }
+        closed("chains of payments");
+
+        // Trust lines and issued currencies, which share the issuer's
+        // owner directory and account root
+        for (auto const& a : accounts)
+            submit(envs, trust(a, USD(1000)));
+        closed("trust lines");
+
+        for (auto const& a : accounts)
+            submit(envs, pay(gw, a, USD(100)));
+        for (std::size_t i = 0; i + 1 < accounts.size(); i += 2)
+            submit(envs, pay(accounts[i + 1], accounts[i], USD(5)));
+        closed("issued payments");
+
+        // Offers walk the order books, which is always done serially, and
+        // some of them cross
+        for (std::size_t i = 0; i < accounts.size(); ++i)
+        {
+            if (i % 2 == 0)
+                submit(envs, offer(accounts[i], XRP(10), USD(10)));
+            else
+                submit(envs, offer(accounts[i], USD(10), XRP(10)));
+        }
+        closed("offers");
+
+        // Successes and failures mixed in one ledger
+        for (auto const& a : accounts)
+        {
+            submit(envs, pay(a, hub, XRP(1)));
+            submit(envs, pay(a, gw, USD(1000)), ter(tecPATH_PARTIAL));
+        }
+        closed("mixed results");
+    }
+
+    void
+    testSameLedgers()
+    {
+        testcase("same ledgers");
+
+        using namespace jtx;
+
+        Env serial{*this, makeConfig(0)};
+        Env parallel{*this, makeConfig(4)};
+
+        workload({&serial, &parallel}, [&](std::string const& what) {
+            expectSame(serial, parallel, what);
+        });
+    }
+
+    void
+    testReplay()
+    {
+        testcase("replay closed ledgers");
+
+        using namespace jtx;
+
+        // Close ledgers on a server that applies transactions serially
+        Env serial{*this, makeConfig(0)};
+        auto const first = serial.closed()->info().seq + 1;
+        workload({&serial}, [&](std::string const&) { serial.close(); });
+        auto const last = serial.closed()->info().seq;
+
+        // and build each of them again from its consensus set, applying the
+        // transactions in parallel, as a validator would.
+        Env parallel{*this, makeConfig(4)};
+        auto& ledgerMaster = serial.app().getLedgerMaster();
+        for (auto seq = first; seq <= last; ++seq)
+        {
+            auto const parent = ledgerMaster.getLedgerBySeq(seq - 1);
+            auto const ledger = ledgerMaster.getLedgerBySeq(seq);
+            if (!BEAST_EXPECT(parent && ledger))
+                return;
+
+            // The set's hash salts the canonical order of the transactions
+            SHAMap set(SHAMapType::TRANSACTION, serial.app().family());
+            set.setUnbacked();
+            for (auto const& item : ledger->txs)
+            {
+                Serializer s;
+                item.first->add(s);
+                set.addItem(
+                    SHAMapItem{item.first->getTransactionID(), std::move(s)},
+                    true,
+                    false);
+            }
+
+            CanonicalTXSet txns{set.getHash().as_uint256()};
+            for (auto const& item : ledger->txs)
+                txns.insert(item.first);
+
+            auto const& info = ledger->info();
+            std::set<TxID> failed;
+            auto const built = buildLedger(
+                parent,
+                info.closeTime,
+                (info.closeFlags & sLCF_NoConsensusTime) == 0,
+                info.closeTimeResolution,
+                parallel.app(),
+                txns,
+                failed,
+                parallel.journal);
+
+            auto const what = "ledger " + std::to_string(seq);
+            BEAST_EXPECTS(txns.empty() && failed.empty(), what);
+            BEAST_EXPECTS(built->info().txHash == info.txHash, what);
+            BEAST_EXPECTS(built->info().accountHash == info.accountHash, what);
+            BEAST_EXPECTS(built->info().hash == info.hash, what);
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testSameLedgers();
+        testReplay();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ParallelApply, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,181 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/OpenLedger.h>
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/Transaction.h>
+#include <ripple/beast/unit_test.h>
+#include <chrono>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+/** Measures applying transactions that cross offers and take multi-step
+    paths, which create many payment sandboxes per transaction.
+
+    A few market makers fill XRP/USD and USD/EUR order books with offers at
+    a spread of qualities. Takers then submit crossing offers and payments
+    from XRP to EUR through both books. The cost per transaction is
+    reported for each kind, and for building the ledger that holds them.
+*/
+class PathApply_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // Apply pre-signed transactions one at a time, as local submissions,
+    // and return the average cost of each in microseconds.
+    static std::size_t
+    applyAll(
+        jtx::Env& env,
+        std::vector<std::shared_ptr<STTx const>> const& txns)
+    {
+        using namespace std::chrono;
+
+        auto& ops = env.app().getOPs();
+        auto const start = clock_type::now();
+        for (auto const& stx : txns)
+        {
+            std::string reason;
+            auto tx = std::make_shared<Transaction>(stx, reason, env.app());
+            ops.processTransaction(tx, true, true, NetworkOPs::FailHard::no);
+        }
+        auto const elapsed =
+            duration_cast<microseconds>(clock_type::now() - start);
+        return elapsed.count() / std::max<std::size_t>(txns.size(), 1);
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono;
+        using namespace jtx;
+
+        std::size_t const makers = 10;
+        std::size_t const offersPerMaker = 40;
+        std::size_t const takers = 50;
+        std::size_t const perTaker = 10;
+
+        Env env{*this, envconfig([](std::unique_ptr<Config> cfg) {
+                    cfg->section("transaction_queue")
+                        .set("minimum_txn_in_ledger_standalone", "100000");
+                    return cfg;
+                })};
+
+        Account const gw{"gateway"};
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+
+        std::vector<Account> makerAccounts;
+        for (std::size_t i = 0; i < makers; ++i)
+            makerAccounts.emplace_back("maker" + std::to_string(i));
+        std::vector<Account> takerAccounts;
+        for (std::size_t i = 0; i < takers; ++i)
+            takerAccounts.emplace_back("taker" + std::to_string(i));
+
+        env.fund(XRP(10000000), gw);
+        for (auto const& a : makerAccounts)
+            env.fund(XRP(1000000), a);
+        for (auto const& a : takerAccounts)
+            env.fund(XRP(1000000), a);
+        env.close();
+
+        for (auto const& a : makerAccounts)
+        {
+            env(trust(a, USD(10000000)));
+            env(trust(a, EUR(10000000)));
+        }
+        for (auto const& a : takerAccounts)
+        {
+            env(trust(a, USD(10000000)));
+            env(trust(a, EUR(10000000)));
+        }
+        env.close();
+
+        for (auto const& a : makerAccounts)
+        {
+            env(pay(gw, a, USD(1000000)));
+            env(pay(gw, a, EUR(1000000)));
+        }
+        env.close();
+
+        // Books with offers at slowly worsening qualities, so that takers
+        // consume several of them.
+        for (std::size_t n = 0; n < offersPerMaker; ++n)
+        {
+            for (auto const& a : makerAccounts)
+            {
+                env(offer(a, XRP(100), USD(100 - n % 20)));
+                env(offer(a, USD(100), EUR(100 - n % 20)));
+            }
+        }
+        env.close();
+
+        std::vector<std::shared_ptr<STTx const>> crossing;
+        std::vector<std::shared_ptr<STTx const>> payments;
+        for (std::size_t n = 0; n < perTaker; ++n)
+        {
+            for (auto const& a : takerAccounts)
+            {
+                crossing.push_back(
+                    env.jt(
+                           offer(a, USD(150), XRP(200)),
+                           seq(env.seq(a) + 2 * n),
+                           fee(drops(10)))
+                        .stx);
+                payments.push_back(
+                    env.jt(
+                           pay(a, a, EUR(150)),
+                           path(~USD, ~EUR),
+                           sendmax(XRP(300)),
+                           txflags(tfPartialPayment),
+                           seq(env.seq(a) + 2 * n + 1),
+                           fee(drops(10)))
+                        .stx);
+            }
+        }
+
+        // Interleave the two kinds, as they arrive from each taker
+        std::vector<std::shared_ptr<STTx const>> all;
+        for (std::size_t i = 0; i < crossing.size(); ++i)
+        {
+            all.push_back(crossing[i]);
+            all.push_back(payments[i]);
+        }
+
+        auto const perTx = applyAll(env, all);
+        BEAST_EXPECT(
+            env.app().openLedger().current()->txCount() == all.size());
+
+        auto const start = clock_type::now();
+        env.close();
+        auto const close =
+            duration_cast<milliseconds>(clock_type::now() - start);
+
+        log << all.size() << " offer crossings and path payments: " << perTx
+            << "us per tx in the open ledger, " << close.count()
+            << "ms to build the ledger" << std::endl;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(PathApply, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,214 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/paths/Pathfinder.h>
+#include <ripple/app/paths/RippleLineCache.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <boost/algorithm/string.hpp>
+#include <chrono>
+#include <map>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+/** Measures how long finding and ranking paths takes over a trust graph of
+    many gateways.
+
+    Every account trusts the USD of a few neighbouring gateways and holds
+    some of it, and market makers bridge each pair of neighbouring
+    gateways with offers, through XRP as well as directly. Payments are
+    then asked for between random accounts at each search level.
+
+    Usage:
+    --unittest-arg=gateways=<n>,accounts=<n>,searches=<n>,levels=<l1:l2:...>
+
+    gateways: number of gateways (default 6)
+    accounts: number of accounts holding balances (default 60)
+    searches: path searches at each level (default 40)
+    levels:   search levels to measure (default 2:4:7)
+*/
+class PathFindBench_test : public beast::unit_test::suite
+{
+    static std::map<std::string, std::string>
+    parseArgs(std::string const& s)
+    {
+        std::map<std::string, std::string> ret;
+        std::vector<std::string> items;
+        boost::split(items, s, boost::algorithm::is_any_of(","));
+        for (auto const& item : items)
+        {
+            auto const eq = item.find('=');
+            if (eq == std::string::npos)
+                continue;
+            ret[boost::trim_copy(item.substr(0, eq))] =
+                boost::trim_copy(item.substr(eq + 1));
+        }
+        return ret;
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono;
+        using namespace jtx;
+
+        auto const args = parseArgs(arg());
+        auto number = [&args](char const* key, std::size_t dflt) {
+            return args.count(key) ? std::stoul(args.at(key)) : dflt;
+        };
+        std::size_t const nGateways = number("gateways", 6);
+        std::size_t const nAccounts = number("accounts", 60);
+        std::size_t const searches = number("searches", 40);
+        std::vector<int> levels{2, 4, 7};
+        if (args.count("levels"))
+        {
+            std::vector<std::string> items;
+            boost::split(
+                items, args.at("levels"), boost::algorithm::is_any_of(":"));
+            levels.clear();
+            for (auto const& item : items)
+                levels.push_back(std::stoi(item));
+        }
+        if (!BEAST_EXPECT(nGateways > 2 && nAccounts > 1))
+            return;
+
+        Env env{*this, envconfig([](std::unique_ptr<Config> cfg) {
+                    cfg->section("transaction_queue")
+                        .set("minimum_txn_in_ledger_standalone", "100000");
+                    return cfg;
+                })};
+
+        std::vector<Account> gateways;
+        for (std::size_t i = 0; i < nGateways; ++i)
+            gateways.emplace_back("gateway" + std::to_string(i));
+        std::vector<Account> accounts;
+        for (std::size_t i = 0; i < nAccounts; ++i)
+            accounts.emplace_back("account" + std::to_string(i));
+        std::vector<Account> makers;
+        for (std::size_t i = 0; i < nGateways; ++i)
+            makers.emplace_back("maker" + std::to_string(i));
+
+        for (auto const& a : gateways)
+            env.fund(XRP(1000000), a);
+        for (auto const& a : accounts)
+            env.fund(XRP(100000), a);
+        for (auto const& a : makers)
+            env.fund(XRP(1000000), a);
+        env.close();
+
+        // Each account holds the USD of three neighbouring gateways, each
+        // maker that of two, and bridges them.
+        auto usd = [&gateways](std::size_t i) {
+            return gateways[i % gateways.size()]["USD"];
+        };
+        for (std::size_t i = 0; i < nAccounts; ++i)
+        {
+            for (std::size_t g = i; g < i + 3; ++g)
+                env(trust(accounts[i], usd(g)(100000)));
+        }
+        for (std::size_t i = 0; i < nGateways; ++i)
+        {
+            env(trust(makers[i], usd(i)(1000000)));
+            env(trust(makers[i], usd(i + 1)(1000000)));
+        }
+        env.close();
+
+        for (std::size_t i = 0; i < nAccounts; ++i)
+        {
+            for (std::size_t g = i; g < i + 3; ++g)
+                env(pay(gateways[g % nGateways], accounts[i], usd(g)(1000)));
+        }
+        for (std::size_t i = 0; i < nGateways; ++i)
+        {
+            env(pay(gateways[i], makers[i], usd(i)(100000)));
+            env(pay(
+                gateways[(i + 1) % nGateways], makers[i], usd(i + 1)(100000)));
+        }
+        env.close();
+
+        for (std::size_t i = 0; i < nGateways; ++i)
+        {
+            for (int n = 0; n < 5; ++n)
+            {
+                env(offer(makers[i], usd(i)(100 + n), usd(i + 1)(100)));
+                env(offer(makers[i], usd(i + 1)(100 + n), usd(i)(100)));
+                env(offer(makers[i], XRP(1000 + 10 * n), usd(i)(100)));
+                env(offer(makers[i], usd(i + 1)(100 + n), XRP(900)));
+            }
+        }
+        env.close();
+
+        auto& app = env.app();
+        beast::xor_shift_engine rng(1);
+        for (auto const level : levels)
+        {
+            testcase("search level " + std::to_string(level));
+
+            auto const cache = std::make_shared<RippleLineCache>(env.closed());
+            std::size_t found = 0;
+            std::size_t paths = 0;
+            microseconds elapsed{0};
+            for (std::size_t n = 0; n < searches; ++n)
+            {
+                auto const& src = accounts[rng() % nAccounts];
+                auto const& dst = accounts[rng() % nAccounts];
+                if (src.id() == dst.id())
+                    continue;
+
+                STAmount const dstAmount = dst["USD"](50);
+                auto const start = steady_clock::now();
+                Pathfinder pf(
+                    cache,
+                    src.id(),
+                    dst.id(),
+                    dstAmount.getCurrency(),
+                    boost::none,
+                    dstAmount,
+                    boost::none,
+                    app);
+                if (pf.findPaths(level))
+                {
+                    pf.computePathRanks(4);
+                    STPath fullLiquidityPath;
+                    auto const best =
+                        pf.getBestPaths(4, fullLiquidityPath, {}, src.id());
+                    if (!best.empty())
+                        ++found;
+                    paths += best.size();
+                }
+                elapsed +=
+                    duration_cast<microseconds>(steady_clock::now() - start);
+            }
+
+            log << searches << " searches at level " << level << ": "
+                << elapsed.count() / std::max<std::size_t>(searches, 1)
+                << "us per search, " << found << " found " << paths
+                << " paths" << std::endl;
+        }
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(PathFindBench, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
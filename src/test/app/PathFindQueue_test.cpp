@@ -0,0 +1,267 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/paths/PathFindQueue.h>
+#include <ripple/beast/insight/NullCollector.h>
+#include <ripple/beast/unit_test.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class PathFindQueue_test : public beast::unit_test::suite
+{
+    // Holds the threads of a queue until it is opened
+    class Gate
+    {
+        std::mutex mutex_;
+        std::condition_variable cond_;
+        bool open_ = false;
+
+    public:
+        void
+        wait()
+        {
+            std::unique_lock lock(mutex_);
+            cond_.wait(lock, [this] { return open_; });
+        }
+
+        void
+        open()
+        {
+            {
+                std::lock_guard lock(mutex_);
+                open_ = true;
+            }
+            cond_.notify_all();
+        }
+    };
+
+    // What each search was told, in the order the searches were run
+    struct Log
+    {
+        std::mutex mutex;
+        std::vector<std::pair<std::string, PathFindQueue::Status>> entries;
+
+        PathFindQueue::Work
+        work(std::string const& name)
+        {
+            return [this, name](PathFindQueue::Status status) {
+                std::lock_guard lock(mutex);
+                entries.emplace_back(name, status);
+            };
+        }
+    };
+
+    static PathFindQueue::Setup
+    setup(std::size_t threads)
+    {
+        PathFindQueue::Setup setup;
+        setup.threads = threads;
+        setup.maxQueued = 4;
+        setup.maxPerClient = 2;
+        return setup;
+    }
+
+    void
+    testDisabled()
+    {
+        testcase("disabled");
+
+        SuiteJournal journal("PathFindQueue_test", *this);
+        PathFindQueue queue(
+            setup(0),
+            [] { return 1; },
+            beast::insight::NullCollector::New(),
+            journal);
+        BEAST_EXPECT(!queue.enabled());
+        BEAST_EXPECT(!queue.post("a", true, false, [](auto) {}));
+    }
+
+    void
+    testFairness()
+    {
+        testcase("fairness and admission");
+
+        SuiteJournal journal("PathFindQueue_test", *this);
+        Log log;
+        Gate gate;
+        {
+            PathFindQueue queue(
+                setup(1),
+                [] { return 1; },
+                beast::insight::NullCollector::New(),
+                journal);
+            BEAST_EXPECT(queue.enabled());
+
+            // Keep the only thread busy while the others queue up
+            std::atomic<bool> started{false};
+            BEAST_EXPECT(queue.post("x", true, false, [&](auto) {
+                started = true;
+                gate.wait();
+            }));
+            while (!started)
+                std::this_thread::yield();
+
+            BEAST_EXPECT(queue.post("a", true, false, log.work("a1")));
+            BEAST_EXPECT(queue.post("a", true, false, log.work("a2")));
+            BEAST_EXPECT(!queue.post("a", true, false, log.work("a3")));
+            BEAST_EXPECT(queue.post("b", true, false, log.work("b1")));
+            BEAST_EXPECT(queue.post("c", true, false, log.work("c1")));
+            BEAST_EXPECT(queue.size() == 4);
+
+            // The queue is full, except for unlimited clients
+            BEAST_EXPECT(!queue.post("d", true, false, log.work("d1")));
+            BEAST_EXPECT(queue.post("a", false, false, log.work("a3")));
+            BEAST_EXPECT(queue.size() == 5);
+
+            gate.open();
+            while (queue.size() != 0)
+                std::this_thread::yield();
+        }
+
+        // Each client is served in turn
+        std::vector<std::string> order;
+        for (auto const& [name, status] : log.entries)
+        {
+            order.push_back(name);
+            BEAST_EXPECT(status == PathFindQueue::Status::run);
+        }
+        BEAST_EXPECT(
+            (order == std::vector<std::string>{"a1", "b1", "c1", "a2", "a3"}));
+    }
+
+    void
+    testExpiry()
+    {
+        testcase("expired and stale searches");
+
+        SuiteJournal journal("PathFindQueue_test", *this);
+        Log log;
+        Gate gate;
+        std::atomic<LedgerIndex> closed{10};
+        {
+            auto s = setup(1);
+            s.maxWait = std::chrono::milliseconds{50};
+            PathFindQueue queue(
+                s,
+                [&closed] { return closed.load(); },
+                beast::insight::NullCollector::New(),
+                journal);
+
+            std::atomic<bool> started{false};
+            BEAST_EXPECT(queue.post("x", true, false, [&](auto) {
+                started = true;
+                gate.wait();
+            }));
+            while (!started)
+                std::this_thread::yield();
+
+            BEAST_EXPECT(queue.post("a", true, true, log.work("follows")));
+            BEAST_EXPECT(queue.post("b", true, false, log.work("pinned")));
+            ++closed;
+            gate.open();
+            while (queue.size() != 0)
+                std::this_thread::yield();
+
+            // Nothing else is waiting, and the ledger is the same
+            BEAST_EXPECT(queue.post("a", true, true, log.work("fresh")));
+            while (queue.size() != 0)
+                std::this_thread::yield();
+
+            // A search that waits too long is not run
+            Gate second;
+            started = false;
+            BEAST_EXPECT(queue.post("x", true, false, [&](auto) {
+                started = true;
+                second.wait();
+            }));
+            while (!started)
+                std::this_thread::yield();
+            BEAST_EXPECT(queue.post("b", true, false, log.work("late")));
+            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+            second.open();
+        }
+
+        using Status = PathFindQueue::Status;
+        BEAST_EXPECT(
+            (log.entries ==
+             std::vector<std::pair<std::string, Status>>{
+                 {"follows", Status::stale},
+                 {"pinned", Status::run},
+                 {"fresh", Status::run},
+                 {"late", Status::expired}}));
+    }
+
+    void
+    testStop()
+    {
+        testcase("stop");
+
+        SuiteJournal journal("PathFindQueue_test", *this);
+        Log log;
+        Gate gate;
+        std::atomic<bool> started{false};
+        auto queue = std::make_unique<PathFindQueue>(
+            setup(1),
+            [] { return 1; },
+            beast::insight::NullCollector::New(),
+            journal);
+        BEAST_EXPECT(queue->post("x", true, false, [&](auto) {
+            started = true;
+            gate.wait();
+        }));
+        while (!started)
+            std::this_thread::yield();
+        BEAST_EXPECT(queue->post("a", true, false, log.work("a1")));
+        BEAST_EXPECT(queue->post("b", true, false, log.work("b1")));
+
+        // Every search still waiting is told the queue stopped
+        std::thread stopper([&queue] { queue.reset(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        gate.open();
+        stopper.join();
+
+        BEAST_EXPECT(log.entries.size() == 2);
+        for (auto const& [name, status] : log.entries)
+            BEAST_EXPECT(status == PathFindQueue::Status::stopped);
+    }
+
+public:
+    void
+    run() override
+    {
+        testDisabled();
+        testFairness();
+        testExpiry();
+        testStop();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(PathFindQueue, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
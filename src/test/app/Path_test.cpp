@@ -458,6 +458,65 @@ public:
         BEAST_EXPECT(equal(sa, Account("alice")["USD"](5)));
     }
 
+    void
+    path_find_parallel()
+    {
+        testcase("path find in parallel");
+        using namespace jtx;
+        Env env(*this, envconfig([](std::unique_ptr<Config> cfg) {
+                    cfg->PATH_SEARCH_THREADS = 4;
+                    return cfg;
+                }));
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), "alice", "bob", "carol", gw);
+        env.trust(USD(600), "alice", "bob", "carol");
+        env(pay(gw, "alice", USD(70)));
+        env(pay(gw, "bob", USD(50)));
+        env(offer("carol", XRP(100), USD(10)));
+        env(pay(gw, "carol", USD(50)));
+        env.close();
+
+        // Several clients asking for the same paths, and for others
+        std::vector<std::tuple<std::string, std::string, STAmount>> const
+            requests{
+                {"alice", "bob", Account("bob")["USD"](5)},
+                {"alice", "bob", Account("bob")["USD"](5)},
+                {"alice", "bob", Account("bob")["USD"](5)},
+                {"bob", "carol", Account("carol")["USD"](7)},
+                {"bob", "carol", Account("carol")["USD"](7)},
+                {"carol", "alice", Account("alice")["USD"](3)},
+                {"alice", "carol", XRP(10)}};
+
+        std::vector<std::tuple<STPathSet, STAmount, STAmount>> expected;
+        for (auto const& [src, dst, amount] : requests)
+            expected.push_back(find_paths(env, src, dst, amount));
+
+        std::vector<std::tuple<STPathSet, STAmount, STAmount>> found(
+            requests.size());
+        {
+            std::vector<std::thread> clients;
+            for (std::size_t i = 0; i < requests.size(); ++i)
+            {
+                clients.emplace_back([&, i]() {
+                    auto const& [src, dst, amount] = requests[i];
+                    found[i] = find_paths(env, src, dst, amount);
+                });
+            }
+            for (auto& t : clients)
+                t.join();
+        }
+
+        for (std::size_t i = 0; i < requests.size(); ++i)
+        {
+            auto const& [paths, sa, da] = found[i];
+            BEAST_EXPECT(paths == std::get<0>(expected[i]));
+            BEAST_EXPECT(equal(sa, std::get<1>(expected[i])));
+            BEAST_EXPECT(equal(da, std::get<2>(expected[i])));
+        }
+        BEAST_EXPECT(same(std::get<0>(found[0]), stpath("gateway")));
+    }
+
     void
     xrp_to_xrp()
     {
@@ -1307,6 +1366,7 @@ public:
         direct_path_no_intermediary();
         payment_auto_path_find();
         path_find();
+        path_find_parallel();
         path_find_consume_all();
         alternative_path_consume_both();
         alternative_paths_consume_best_transfer();
@@ -0,0 +1,334 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/PeerScoreboard.h>
+#include <ripple/beast/clock/manual_clock.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/messages.h>
+#include <functional>
+#include <map>
+
+namespace ripple {
+namespace test {
+
+class PeerScoreboard_test : public beast::unit_test::suite
+{
+    using clock_type = beast::manual_clock<std::chrono::steady_clock>;
+    using id_t = PeerScoreboard::id_t;
+    using Plan = std::vector<std::pair<id_t, std::size_t>>;
+
+    static constexpr int type = protocol::liAS_NODE;
+    static constexpr std::chrono::milliseconds timeout{2500};
+
+    // A peer in the simulated overlay: replies arrive one round trip after
+    // the peer has worked through everything queued ahead of the request.
+    struct SimPeer
+    {
+        id_t id;
+        std::chrono::milliseconds rtt;
+        std::chrono::microseconds perNode;
+        bool dead = false;
+
+        clock_type::time_point busyUntil{};
+        std::size_t served = 0;
+        std::size_t requested = 0;
+    };
+
+    struct Request
+    {
+        id_t peer;
+        std::size_t nodes;
+    };
+
+    using Strategy = std::function<
+        Plan(PeerScoreboard const&, std::vector<id_t> const&, std::size_t)>;
+
+    /** Fetch a number of nodes from the peers, returning how long it took.
+
+        Like InboundLedger, a new batch of at most batchSize nodes is
+        requested whenever a reply arrives, and requests are given up on
+        after a timeout.
+    */
+    std::chrono::milliseconds
+    simulate(
+        std::vector<SimPeer>& peers,
+        std::size_t total,
+        Strategy const& strategy)
+    {
+        std::size_t const batchSize = 128;
+
+        clock_type clock;
+        PeerScoreboard board(clock);
+        auto const start = clock.now();
+
+        std::vector<id_t> ids;
+        for (auto const& p : peers)
+            ids.push_back(p.id);
+
+        std::multimap<clock_type::time_point, Request> replies;
+        std::multimap<clock_type::time_point, Request> lost;
+        std::size_t unrequested = total;
+        std::size_t received = 0;
+
+        auto find = [&](id_t id) -> SimPeer& {
+            return *std::find_if(peers.begin(), peers.end(), [id](auto& p) {
+                return p.id == id;
+            });
+        };
+
+        auto issue = [&] {
+            auto const now = clock.now();
+            auto const want = std::min(unrequested, batchSize);
+            if (want == 0)
+                return;
+            for (auto const& [id, count] : strategy(board, ids, want))
+            {
+                auto& p = find(id);
+                board.onRequest(id, type, count);
+                p.requested += count;
+                unrequested -= count;
+                if (p.dead)
+                {
+                    lost.emplace(now + timeout, Request{id, count});
+                    continue;
+                }
+                p.busyUntil = std::max(p.busyUntil, now) +
+                    p.perNode * static_cast<int>(count);
+                replies.emplace(p.busyUntil + p.rtt, Request{id, count});
+            }
+        };
+
+        issue();
+        while (received < total)
+        {
+            if (replies.empty() && lost.empty())
+            {
+                // Nothing in flight; try again on the next timer tick
+                clock.advance(timeout);
+                issue();
+                continue;
+            }
+
+            bool const nextIsReply = !replies.empty() &&
+                (lost.empty() || replies.begin()->first <= lost.begin()->first);
+
+            if (nextIsReply)
+            {
+                auto const r = *replies.begin();
+                replies.erase(replies.begin());
+                clock.set(r.first);
+                board.onReply(
+                    r.second.peer, type, r.second.nodes, 400 * r.second.nodes);
+                find(r.second.peer).served += r.second.nodes;
+                received += r.second.nodes;
+            }
+            else
+            {
+                auto const r = *lost.begin();
+                lost.erase(lost.begin());
+                clock.set(r.first);
+                board.expire(timeout);
+                unrequested += r.second.nodes;
+            }
+
+            issue();
+        }
+
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            clock.now() - start);
+    }
+
+    static std::vector<SimPeer>
+    makeOverlay()
+    {
+        using namespace std::chrono_literals;
+        return {
+            {1, 20ms, 200us},
+            {2, 80ms, 1000us},
+            {3, 150ms, 4000us},
+            {4, 300ms, 20000us},
+            {5, 100ms, 1000us, true},
+        };
+    }
+
+    void
+    testWindows()
+    {
+        using namespace std::chrono_literals;
+        testcase("windows");
+
+        clock_type clock;
+        PeerScoreboard board(clock);
+
+        auto const initial = board.estimate(1, type).window;
+        BEAST_EXPECT(initial > 0);
+        BEAST_EXPECT(board.estimate(1, type).replies == 0);
+
+        // A timely reply opens the window and yields an estimate
+        board.onRequest(1, type, 16);
+        BEAST_EXPECT(board.estimate(1, type).inFlight == 16);
+        clock.advance(100ms);
+        board.onReply(1, type, 16, 16000);
+        auto est = board.estimate(1, type);
+        BEAST_EXPECT(est.inFlight == 0);
+        BEAST_EXPECT(est.replies == 1);
+        BEAST_EXPECT(est.latency == 100ms);
+        BEAST_EXPECT(est.bytesPerSecond == 160000);
+        BEAST_EXPECT(est.perNode == 6250);
+        BEAST_EXPECT(est.window > initial);
+
+        // Request types are tracked separately
+        BEAST_EXPECT(board.estimate(1, protocol::liTX_NODE).replies == 0);
+
+        // A lost request closes the window again
+        auto const open = est.window;
+        board.onRequest(1, type, 16);
+        clock.advance(timeout);
+        board.expire(timeout);
+        est = board.estimate(1, type);
+        BEAST_EXPECT(est.inFlight == 0);
+        BEAST_EXPECT(est.timeouts == 1);
+        BEAST_EXPECT(est.window < open);
+
+        // An unsolicited reply does not disturb the estimate
+        board.onReply(1, type, 4, 4000);
+        BEAST_EXPECT(board.estimate(1, type).replies == 1);
+
+        // Idle peers are forgotten
+        clock.advance(std::chrono::minutes(10));
+        board.sweep();
+        BEAST_EXPECT(board.estimate(1, type).replies == 0);
+    }
+
+    void
+    testSchedule()
+    {
+        using namespace std::chrono_literals;
+        testcase("schedule");
+
+        clock_type clock;
+        PeerScoreboard board(clock);
+
+        // Nothing to do
+        BEAST_EXPECT(board.schedule({}, type, 100).empty());
+        BEAST_EXPECT(board.schedule({1, 2}, type, 0).empty());
+
+        // With no history the work is spread evenly
+        {
+            auto const plan = board.schedule({1, 2, 3, 4}, type, 32);
+            BEAST_EXPECT(plan.size() == 4);
+            for (auto const& e : plan)
+                BEAST_EXPECT(e.second == 8);
+        }
+
+        // Peer 1 replies ten times faster than peer 2
+        for (int i = 0; i < 4; ++i)
+        {
+            board.onRequest(1, type, 16);
+            board.onRequest(2, type, 16);
+            clock.advance(10ms);
+            board.onReply(1, type, 16, 8000);
+            clock.advance(90ms);
+            board.onReply(2, type, 16, 8000);
+        }
+
+        auto const plan = board.schedule({2, 1}, type, 64);
+        BEAST_EXPECT(!plan.empty());
+        BEAST_EXPECT(plan.front().first == 1);
+        std::size_t fast = 0, slow = 0;
+        for (auto const& [id, count] : plan)
+            (id == 1 ? fast : slow) += count;
+        BEAST_EXPECT(fast + slow == 64);
+        BEAST_EXPECT(fast > 4 * slow);
+
+        // Windows cap the assignment but something is always requested
+        for (int i = 0; i < 8; ++i)
+            board.onRequest(2, type, 1024);
+        auto const full = board.schedule({2}, type, 64);
+        BEAST_EXPECT(full.size() == 1);
+        BEAST_EXPECT(full.front().second > 0);
+        BEAST_EXPECT(full.front().second < 64);
+    }
+
+    void
+    testSimulatedOverlay()
+    {
+        testcase("simulated overlay");
+
+        std::size_t const total = 20000;
+
+        // Split every batch evenly, regardless of how peers perform
+        auto even = [](PeerScoreboard const&,
+                       std::vector<id_t> const& ids,
+                       std::size_t nodes) {
+            Plan plan;
+            auto const share = std::max<std::size_t>(nodes / ids.size(), 1);
+            for (auto id : ids)
+            {
+                if (nodes == 0)
+                    break;
+                auto const n = std::min(share, nodes);
+                plan.emplace_back(id, n);
+                nodes -= n;
+            }
+            return plan;
+        };
+
+        auto scored = [](PeerScoreboard const& board,
+                         std::vector<id_t> const& ids,
+                         std::size_t nodes) {
+            return board.schedule(ids, type, nodes);
+        };
+
+        auto evenPeers = makeOverlay();
+        auto const evenTime = simulate(evenPeers, total, even);
+
+        auto scoredPeers = makeOverlay();
+        auto const scoredTime = simulate(scoredPeers, total, scored);
+
+        log << "even split: " << evenTime.count() << "ms, scored: "
+            << scoredTime.count() << "ms" << std::endl;
+
+        BEAST_EXPECT(scoredTime < evenTime);
+        BEAST_EXPECT(2 * scoredTime < evenTime);
+
+        // The fastest peer did most of the work and the unresponsive peer
+        // was quickly given up on.
+        auto const fastest = scoredPeers[0].served;
+        for (auto const& p : scoredPeers)
+            BEAST_EXPECT(p.served <= fastest);
+        BEAST_EXPECT(fastest > total / 2);
+        BEAST_EXPECT(scoredPeers[4].served == 0);
+        BEAST_EXPECT(scoredPeers[4].requested < evenPeers[4].requested);
+    }
+
+public:
+    void
+    run() override
+    {
+        testWindows();
+        testSchedule();
+        testSimulatedOverlay();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(PeerScoreboard, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
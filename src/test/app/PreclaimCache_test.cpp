@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/main/Application.h>
+#include <ripple/app/misc/LoadFeeTrack.h>
+#include <ripple/app/tx/PreclaimCache.h>
+#include <ripple/app/tx/applySteps.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/jss.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class PreclaimCache_test : public beast::unit_test::suite
+{
+    // The changes to the counts since before
+    static PreclaimCache::Counts
+    since(PreclaimCache::Counts const& before, PreclaimCache const& cache)
+    {
+        auto const now = cache.counts();
+        return {
+            now.hits - before.hits,
+            now.misses - before.misses,
+            now.invalidations - before.invalidations,
+            now.size};
+    }
+
+    static TER
+    check(
+        jtx::Env& env,
+        jtx::JTx const& jt,
+        OpenView const& view,
+        ApplyFlags flags = tapNONE)
+    {
+        auto const pf =
+            preflight(env.app(), view.rules(), *jt.stx, flags, env.journal);
+        return preclaim(pf, env.app(), view).ter;
+    }
+
+    void
+    testReuse()
+    {
+        testcase("reuse");
+
+        using namespace jtx;
+        Env env(*this);
+        Account const alice("alice");
+        Account const bob("bob");
+        env.fund(XRP(10000), alice, bob);
+        env.close();
+
+        auto& cache = env.app().getPreclaimCache();
+        auto const jt = env.jt(pay(alice, bob, XRP(10)));
+
+        // Checked once, then answered from the cache
+        auto before = cache.counts();
+        BEAST_EXPECT(check(env, jt, *env.current()) == tesSUCCESS);
+        BEAST_EXPECT(since(before, cache).misses == 1);
+        BEAST_EXPECT(check(env, jt, *env.current()) == tesSUCCESS);
+        auto c = since(before, cache);
+        BEAST_EXPECT(c.hits == 1);
+        BEAST_EXPECT(c.invalidations == 0);
+
+        // Other flags are another context
+        before = cache.counts();
+        BEAST_EXPECT(check(env, jt, *env.current(), tapRETRY) == tesSUCCESS);
+        BEAST_EXPECT(since(before, cache).invalidations == 1);
+
+        // A change to an account that was read is noticed
+        env(noop(bob));
+        before = cache.counts();
+        BEAST_EXPECT(check(env, jt, *env.current()) == tesSUCCESS);
+        c = since(before, cache);
+        BEAST_EXPECT(c.hits == 0);
+        BEAST_EXPECT(c.invalidations == 1);
+        BEAST_EXPECT(check(env, jt, *env.current()) == tesSUCCESS);
+        BEAST_EXPECT(since(before, cache).hits == 1);
+
+        // So is a new ledger
+        env.close();
+        before = cache.counts();
+        BEAST_EXPECT(check(env, jt, *env.current()) == tesSUCCESS);
+        BEAST_EXPECT(since(before, cache).invalidations == 1);
+
+        // Once the transaction is applied, checking it again needs to know
+        // whether it is in the ledger, which is not cached
+        env(jt);
+        before = cache.counts();
+        BEAST_EXPECT(check(env, jt, *env.current()) == tefALREADY);
+        BEAST_EXPECT(since(before, cache).invalidations == 1);
+        BEAST_EXPECT(check(env, jt, *env.current()) == tefALREADY);
+        c = since(before, cache);
+        BEAST_EXPECT(c.hits == 0);
+        BEAST_EXPECT(c.misses == 1);
+        BEAST_EXPECT(c.invalidations == 1);
+    }
+
+    void
+    testFailures()
+    {
+        testcase("failures");
+
+        using namespace jtx;
+        Env env(*this);
+        Account const alice("alice");
+        Account const bob("bob");
+        env.fund(XRP(10000), alice, bob);
+        env.close();
+
+        auto& cache = env.app().getPreclaimCache();
+
+        // A transaction waiting for an earlier sequence keeps its result
+        // until the account changes
+        auto const jt = env.jt(noop(alice), seq(env.seq(alice) + 1));
+        auto before = cache.counts();
+        BEAST_EXPECT(check(env, jt, *env.current()) == terPRE_SEQ);
+        BEAST_EXPECT(check(env, jt, *env.current()) == terPRE_SEQ);
+        BEAST_EXPECT(since(before, cache).hits == 1);
+
+        env(noop(alice));
+        before = cache.counts();
+        BEAST_EXPECT(check(env, jt, *env.current()) == tesSUCCESS);
+        BEAST_EXPECT(since(before, cache).invalidations == 1);
+
+        // The fee load is part of the context
+        auto const payment = env.jt(pay(bob, alice, XRP(1)), fee(drops(10)));
+        before = cache.counts();
+        BEAST_EXPECT(check(env, payment, *env.current()) == tesSUCCESS);
+        auto& feeTrack = env.app().getFeeTrack();
+        for (int i = 0; i < 20; ++i)
+            feeTrack.raiseLocalFee();
+        BEAST_EXPECT(check(env, payment, *env.current()) == telINSUF_FEE_P);
+        auto const c = since(before, cache);
+        BEAST_EXPECT(c.hits == 0);
+        BEAST_EXPECT(c.invalidations == 1);
+        while (feeTrack.lowerLocalFee())
+            ;
+    }
+
+    void
+    testRPC()
+    {
+        testcase("get_counts");
+
+        using namespace jtx;
+        Env env(*this);
+        env.fund(XRP(10000), "alice");
+        env.close();
+
+        auto const jv = env.rpc("get_counts")[jss::result];
+        BEAST_EXPECT(jv.isMember(jss::preclaim_cache));
+        auto const& pc = jv[jss::preclaim_cache];
+        BEAST_EXPECT(pc.isMember(jss::size));
+        BEAST_EXPECT(pc.isMember(jss::hits));
+        BEAST_EXPECT(pc.isMember(jss::misses));
+        BEAST_EXPECT(pc.isMember(jss::invalidations));
+    }
+
+public:
+    void
+    run() override
+    {
+        testReuse();
+        testFailures();
+        testRPC();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(PreclaimCache, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
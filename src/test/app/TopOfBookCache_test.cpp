@@ -0,0 +1,236 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/TopOfBookCache.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/jss.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class TopOfBookCache_test : public beast::unit_test::suite
+{
+    // The page as read from the ledger, without any cache
+    static bool
+    matches(BookPage const& page, ReadView const& ledger, Book const& book)
+    {
+        auto const expected = readBookPage(
+            ledger,
+            book,
+            noAccount(),
+            page.offers.size(),
+            beast::Journal{beast::Journal::getNullSink()});
+        return page.offers == expected.offers;
+    }
+
+    void
+    testCache()
+    {
+        testcase("cache");
+
+        using namespace jtx;
+        Env env(*this);
+
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        Account const carol{"carol"};
+        Account const dave{"dave"};
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+        Book const usd{xrpIssue(), USD.issue()};
+        Book const eur{xrpIssue(), EUR.issue()};
+
+        env.fund(XRP(10000), gw, alice, bob, carol, dave);
+        env.trust(USD(1000), alice, bob);
+        env.trust(EUR(1000), carol);
+        env(pay(gw, alice, USD(100)));
+        env(pay(gw, bob, USD(100)));
+        env(pay(gw, carol, EUR(100)));
+        env.close();
+
+        env(offer(alice, XRP(100), USD(50)));
+        env(offer(alice, XRP(200), USD(80)));
+        env(offer(bob, XRP(150), USD(60)));
+        env(offer(carol, XRP(100), EUR(10)));
+        env.close();
+
+        TopOfBookCache cache(400, 400, env.journal);
+        BEAST_EXPECT(!cache.get(env.current(), usd));
+
+        auto const first = cache.get(env.closed(), usd);
+        if (!BEAST_EXPECT(first))
+            return;
+        BEAST_EXPECT(first->complete);
+        BEAST_EXPECT(first->offers.size() == 3);
+        BEAST_EXPECT(matches(*first, *env.closed(), usd));
+        BEAST_EXPECT(cache.get(env.closed(), usd) == first);
+
+        // Alice's second offer is funded only by what her first leaves
+        BEAST_EXPECT(first->offers[0].isMember(jss::owner_funds));
+        BEAST_EXPECT(!first->offers[0].isMember(jss::taker_gets_funded));
+        BEAST_EXPECT(first->offers[1].isMember(jss::taker_gets_funded));
+        BEAST_EXPECT(!first->offers[1].isMember(jss::owner_funds));
+        BEAST_EXPECT(first->offers[2].isMember(jss::owner_funds));
+
+        auto const firstEur = cache.get(env.closed(), eur);
+        if (!BEAST_EXPECT(firstEur))
+            return;
+        BEAST_EXPECT(firstEur->offers.size() == 1);
+
+        // A ledger that touches neither the books nor their owners
+        env(pay(env.master, dave, XRP(10)));
+        env.close();
+        BEAST_EXPECT(cache.get(env.closed(), usd) == first);
+        BEAST_EXPECT(cache.get(env.closed(), eur) == firstEur);
+
+        // A change to the balance of an owner
+        env(pay(alice, carol, XRP(1)));
+        env.close();
+        auto const second = cache.get(env.closed(), usd);
+        if (!BEAST_EXPECT(second))
+            return;
+        BEAST_EXPECT(second != first);
+        BEAST_EXPECT(matches(*second, *env.closed(), usd));
+        BEAST_EXPECT(cache.get(env.closed(), eur) != firstEur);
+
+        // A new offer in one book leaves the other one alone
+        auto const secondEur = cache.get(env.closed(), eur);
+        env(offer(bob, XRP(300), USD(10)));
+        env.close();
+        auto const third = cache.get(env.closed(), usd);
+        if (!BEAST_EXPECT(third))
+            return;
+        BEAST_EXPECT(third != second);
+        BEAST_EXPECT(third->offers.size() == 4);
+        BEAST_EXPECT(matches(*third, *env.closed(), usd));
+        BEAST_EXPECT(cache.get(env.closed(), eur) == secondEur);
+
+        // A page not asked for in a ledger is not carried over from it
+        env(pay(env.master, dave, XRP(10)));
+        env.close();
+        BEAST_EXPECT(cache.get(env.closed(), usd) == third);
+        env(pay(env.master, dave, XRP(10)));
+        env.close();
+        BEAST_EXPECT(cache.get(env.closed(), usd) == third);
+        auto const thirdEur = cache.get(env.closed(), eur);
+        if (!BEAST_EXPECT(thirdEur))
+            return;
+        BEAST_EXPECT(thirdEur != secondEur);
+        BEAST_EXPECT(matches(*thirdEur, *env.closed(), eur));
+
+        // Books past the most kept for a ledger are read on every request
+        TopOfBookCache capped(400, 1, env.journal);
+        auto const kept = capped.get(env.closed(), usd);
+        auto const uncached = capped.get(env.closed(), eur);
+        if (!BEAST_EXPECT(kept && uncached))
+            return;
+        BEAST_EXPECT(capped.get(env.closed(), usd) == kept);
+        BEAST_EXPECT(capped.get(env.closed(), eur) != uncached);
+        BEAST_EXPECT(matches(*uncached, *env.closed(), eur));
+
+        // Pages read to a depth stop there
+        TopOfBookCache shallow(2, 400, env.journal);
+        auto const top = shallow.get(env.closed(), usd);
+        if (!BEAST_EXPECT(top))
+            return;
+        BEAST_EXPECT(!top->complete);
+        BEAST_EXPECT(top->offers.size() == 2);
+        BEAST_EXPECT(matches(*top, *env.closed(), usd));
+    }
+
+    void
+    testBookOffers()
+    {
+        testcase("book_offers");
+
+        using namespace jtx;
+        Env env(*this);
+
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        auto const USD = gw["USD"];
+        Book const book{xrpIssue(), USD.issue()};
+
+        env.fund(XRP(10000), gw, alice, bob);
+        env(rate(gw, 1.25));
+        env.trust(USD(1000), alice, bob);
+        env(pay(gw, alice, USD(100)));
+        env(pay(gw, bob, USD(30)));
+        env.close();
+
+        env(offer(alice, XRP(100), USD(50)));
+        env(offer(bob, XRP(100), USD(40)));
+        env(offer(alice, XRP(100), USD(50)));
+        env(offer(gw, XRP(100), USD(20)));
+        env.close();
+
+        auto bookOffers = [&](AccountID const& taker, unsigned int limit) {
+            Json::Value params;
+            params[jss::ledger_index] = "closed";
+            params[jss::taker] = to_string(taker);
+            params[jss::taker_pays][jss::currency] = "XRP";
+            params[jss::taker_gets][jss::currency] = "USD";
+            params[jss::taker_gets][jss::issuer] = gw.human();
+            params[jss::limit] = limit;
+            return env.rpc(
+                "json", "book_offers", to_string(params))[jss::result];
+        };
+
+        // The first request fills the cache, the others are served from it,
+        // the last one with fewer offers than the cache holds.
+        for (auto const limit : {10u, 10u, 3u})
+        {
+            auto const result = bookOffers(alice.id(), limit);
+            auto const expected = readBookPage(
+                *env.closed(), book, alice.id(), limit, env.journal);
+
+            Json::Value offers(Json::arrayValue);
+            for (auto const& offer : expected.offers)
+                offers.append(offer);
+            BEAST_EXPECT(result[jss::offers] == offers);
+            BEAST_EXPECT(result[jss::offers].size() == std::min(limit, 4u));
+        }
+
+        // The issuer taking its own IOUs pays no transfer fee, so its
+        // page is read from the ledger rather than from the cache.
+        auto const byIssuer = bookOffers(gw.id(), 10);
+        auto const byAlice = bookOffers(alice.id(), 10);
+        auto const expected =
+            readBookPage(*env.closed(), book, gw.id(), 10, env.journal);
+        BEAST_EXPECT(byIssuer[jss::offers].size() == 4);
+        BEAST_EXPECT(byIssuer[jss::offers][1u] == expected.offers[1]);
+        BEAST_EXPECT(byIssuer[jss::offers][1u] != byAlice[jss::offers][1u]);
+    }
+
+public:
+    void
+    run() override
+    {
+        testCache();
+        testBookOffers();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TopOfBookCache, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
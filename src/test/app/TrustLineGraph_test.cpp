@@ -0,0 +1,425 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/paths/AccountCurrencies.h>
+#include <ripple/app/paths/RippleLineCache.h>
+#include <ripple/app/paths/TrustLineGraph.h>
+#include <ripple/beast/unit_test.h>
+#include <chrono>
+#include <set>
+#include <test/jtx.h>
+#include <tuple>
+
+namespace ripple {
+namespace test {
+
+class TrustLineGraph_test : public beast::unit_test::suite
+{
+    using Line = std::tuple<uint256, Currency, AccountID>;
+
+    // The lines of an account as found from its owner directory
+    static std::set<Line>
+    fromLedger(ReadView const& ledger, AccountID const& account)
+    {
+        std::set<Line> ret;
+        for (auto const& item : getRippleStateItems(account, ledger))
+            ret.emplace(
+                item->key(),
+                item->getLimit().getCurrency(),
+                item->getAccountIDPeer());
+        return ret;
+    }
+
+    static std::set<Line>
+    fromGraph(TrustLineGraph::Snapshot const& graph, AccountID const& account)
+    {
+        std::set<Line> ret;
+        if (auto const lines = graph.lines(account))
+        {
+            for (auto const& [key, peer] : *lines)
+                ret.emplace(key.second, key.first, peer);
+        }
+        return ret;
+    }
+
+    bool
+    matches(
+        TrustLineGraph::Snapshot const& graph,
+        ReadView const& ledger,
+        std::vector<jtx::Account> const& accounts)
+    {
+        std::size_t lines = 0;
+        for (auto const& a : accounts)
+        {
+            auto const expected = fromLedger(ledger, a.id());
+            if (fromGraph(graph, a.id()) != expected)
+                return false;
+            lines += expected.size();
+        }
+        return graph.seq() == ledger.seq() &&
+            graph.hash() == ledger.info().hash && 2 * graph.size() == lines;
+    }
+
+    void
+    testUpdate()
+    {
+        testcase("update");
+
+        using namespace jtx;
+        Env env(*this);
+
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        Account const carol{"carol"};
+        std::vector<Account> const all{gw, alice, bob, carol};
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+
+        env.fund(XRP(10000), gw, alice, bob, carol);
+        env.trust(USD(1000), alice, bob);
+        env.trust(EUR(1000), alice);
+        env.trust(alice["USD"](100), bob);
+        env.close();
+
+        TrustLineGraph graph(env.app(), env.journal);
+        BEAST_EXPECT(!graph.current());
+        BEAST_EXPECT(!graph.update(env.current()));
+
+        auto const first = graph.update(env.closed());
+        auto const firstLedger = env.closed();
+        if (!BEAST_EXPECT(first))
+            return;
+        BEAST_EXPECT(matches(*first, *firstLedger, all));
+        BEAST_EXPECT(first->size() == 4);
+        BEAST_EXPECT(graph.current() == first);
+        BEAST_EXPECT(graph.update(env.closed()) == first);
+
+        // Create some lines and delete others
+        env.trust(USD(1000), carol);
+        env.trust(EUR(0), alice);
+        env.trust(alice["USD"](0), bob);
+        env(pay(gw, bob, USD(10)));
+        env.close();
+
+        auto const second = graph.update(env.closed());
+        if (!BEAST_EXPECT(second))
+            return;
+        BEAST_EXPECT(matches(*second, *env.closed(), all));
+        BEAST_EXPECT(second->size() == 3);
+
+        // The earlier snapshot did not change
+        BEAST_EXPECT(matches(*first, *firstLedger, all));
+
+        // Several ledgers at once
+        for (int i = 0; i < 3; ++i)
+        {
+            env.trust(gw["C" + std::to_string(i)](10), alice, carol);
+            env.close();
+        }
+        env.trust(USD(0), carol);
+        env.close();
+
+        auto const third = graph.update(env.closed());
+        if (!BEAST_EXPECT(third))
+            return;
+        BEAST_EXPECT(matches(*third, *env.closed(), all));
+        BEAST_EXPECT(third->size() == 8);
+    }
+
+    void
+    testLineCache()
+    {
+        testcase("line cache");
+
+        using namespace jtx;
+        Env env(*this);
+
+        Account const gw{"gateway"};
+        std::vector<Account> accounts{gw};
+        for (int i = 0; i < 10; ++i)
+            accounts.emplace_back("account" + std::to_string(i));
+        for (auto const& a : accounts)
+            env.fund(XRP(10000), a);
+        env.close();
+        for (std::size_t i = 1; i < accounts.size(); ++i)
+        {
+            env.trust(gw["USD"](1000), accounts[i]);
+            env.trust(accounts[i - 1]["USD"](100), accounts[i]);
+            env(offer(accounts[i], XRP(10), gw["USD"](10)));
+        }
+        env.close();
+
+        TrustLineGraph graph(env.app(), env.journal);
+        auto const snapshot = graph.update(env.closed());
+
+        // The same lines, with or without the graph
+        RippleLineCache withGraph(env.closed(), snapshot);
+        RippleLineCache without(env.closed());
+        for (auto const& a : accounts)
+        {
+            std::set<uint256> expected;
+            for (auto const& item : without.getRippleLines(a.id()))
+                expected.insert(item->key());
+            std::set<uint256> found;
+            for (auto const& item : withGraph.getRippleLines(a.id()))
+            {
+                BEAST_EXPECT(item->getAccountID() == a.id());
+                found.insert(item->key());
+            }
+            BEAST_EXPECT(found == expected);
+        }
+
+        // The graph is only used for the ledger it was made from
+        env.trust(gw["EUR"](10), accounts[1]);
+        env.close();
+        RippleLineCache stale(env.closed(), snapshot);
+        BEAST_EXPECT(
+            stale.getRippleLines(accounts[1].id()).size() ==
+            fromLedger(*env.closed(), accounts[1].id()).size());
+    }
+
+    // What the totals of an account should be, from its owner directory
+    struct Expected
+    {
+        std::set<Currency> currencies;
+        std::set<Currency> sendable;
+        std::set<Currency> receivable;
+    };
+
+    static Expected
+    expected(ReadView const& ledger, AccountID const& account)
+    {
+        Expected ret;
+        for (auto const& item : getRippleStateItems(account, ledger))
+        {
+            auto const& balance = item->getBalance();
+            auto const& currency = balance.getCurrency();
+            ret.currencies.insert(currency);
+            if (balance > beast::zero ||
+                (item->getLimitPeer() && -balance < item->getLimitPeer()))
+                ret.sendable.insert(currency);
+            if (balance < item->getLimit())
+                ret.receivable.insert(currency);
+        }
+        return ret;
+    }
+
+    static Expected
+    fromTotals(TrustLineGraph::Snapshot const& graph, AccountID const& account)
+    {
+        Expected ret;
+        graph.forEachCurrency(
+            account, [&](Currency const& currency, auto const& totals) {
+                ret.currencies.insert(currency);
+                if (totals.sendable != 0)
+                    ret.sendable.insert(currency);
+                if (totals.receivable != 0)
+                    ret.receivable.insert(currency);
+            });
+        return ret;
+    }
+
+    bool
+    totalsMatch(
+        TrustLineGraph::Snapshot const& graph,
+        ReadView const& ledger,
+        std::vector<jtx::Account> const& accounts)
+    {
+        for (auto const& a : accounts)
+        {
+            auto const want = expected(ledger, a.id());
+            auto const have = fromTotals(graph, a.id());
+            if (have.currencies != want.currencies ||
+                have.sendable != want.sendable ||
+                have.receivable != want.receivable)
+                return false;
+        }
+        return true;
+    }
+
+    void
+    testTotals()
+    {
+        testcase("totals");
+
+        using namespace jtx;
+        Env env(*this);
+
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        Account const carol{"carol"};
+        std::vector<Account> const all{gw, alice, bob, carol};
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+
+        env.fund(XRP(10000), gw, alice, bob, carol);
+        env.trust(USD(1000), alice, bob, carol);
+        env.trust(EUR(1000), alice);
+        env(pay(gw, alice, USD(100)));
+        env(pay(gw, bob, USD(50)));
+        env(pay(gw, alice, EUR(1)));
+        env.close();
+
+        TrustLineGraph graph(env.app(), env.journal);
+        auto snap = graph.update(env.closed());
+        if (!BEAST_EXPECT(snap))
+            return;
+        BEAST_EXPECT(totalsMatch(*snap, *env.closed(), all));
+
+        // Balances, limits and freezes change without any line being
+        // created or deleted
+        env(pay(alice, carol, USD(25)));
+        env(trust(gw, bob["USD"](0), tfSetFreeze));
+        env.trust(EUR(0.5), alice);
+        env.trust(gw["AUD"](10), alice);
+        env.trust(alice["AUD"](10), gw);
+        env(pay(alice, gw, alice["AUD"](3)));
+        env.close();
+
+        snap = graph.update(env.closed());
+        if (!BEAST_EXPECT(snap))
+            return;
+        BEAST_EXPECT(totalsMatch(*snap, *env.closed(), all));
+        BEAST_EXPECT(fromTotals(*snap, gw.id()).currencies.size() == 3);
+
+        // Lines go away, and the totals of their currencies with them
+        env(pay(alice, gw, EUR(1)));
+        env.trust(EUR(0), alice);
+        env(trust(gw, bob["USD"](0), tfClearFreeze));
+        env.close();
+        env(pay(carol, gw, USD(25)));
+        env.trust(USD(0), carol);
+        env.close();
+
+        snap = graph.update(env.closed());
+        if (!BEAST_EXPECT(snap))
+            return;
+        BEAST_EXPECT(totalsMatch(*snap, *env.closed(), all));
+        BEAST_EXPECT(fromTotals(*snap, carol.id()).currencies.empty());
+
+        // The currencies found for path finding are the same either way
+        auto without = std::make_shared<RippleLineCache>(env.closed());
+        auto const cache =
+            std::make_shared<RippleLineCache>(env.closed(), snap);
+        for (auto const& a : all)
+        {
+            BEAST_EXPECT(
+                accountSourceCurrencies(a.id(), cache, true) ==
+                accountSourceCurrencies(a.id(), without, true));
+            BEAST_EXPECT(
+                accountDestCurrencies(a.id(), cache, true) ==
+                accountDestCurrencies(a.id(), without, true));
+        }
+    }
+
+protected:
+    /** Time finding the lines of every account from the graph against
+        walking their owner directories, and report the size of the graph.
+    */
+    void
+    testLarge(std::size_t accounts, std::size_t currencies)
+    {
+        using namespace std::chrono;
+        using namespace jtx;
+
+        testcase(
+            std::to_string(accounts) + " accounts, " +
+            std::to_string(currencies) + " currencies");
+
+        Env env(*this, envconfig([](std::unique_ptr<Config> cfg) {
+                    cfg->section("transaction_queue")
+                        .set("minimum_txn_in_ledger_standalone", "100000");
+                    return cfg;
+                }));
+
+        Account const gw{"gateway"};
+        std::vector<Account> all;
+        for (std::size_t i = 0; i < accounts; ++i)
+            all.emplace_back("account" + std::to_string(i));
+        env.fund(XRP(100000), gw);
+        for (auto const& a : all)
+        {
+            env.fund(XRP(100000), a);
+            for (std::size_t c = 0; c < currencies; ++c)
+            {
+                env.trust(gw["C" + std::to_string(c)](1000), a);
+                env(offer(a, XRP(10), gw["C" + std::to_string(c)](10)));
+            }
+        }
+        env.close();
+
+        TrustLineGraph graph(env.app(), env.journal);
+        auto const start = steady_clock::now();
+        auto const snapshot = graph.update(env.closed());
+        auto const built =
+            duration_cast<milliseconds>(steady_clock::now() - start);
+        if (!BEAST_EXPECT(snapshot))
+            return;
+        BEAST_EXPECT(snapshot->size() == accounts * currencies);
+
+        auto const lookup = [&](RippleLineCache& cache) {
+            std::size_t lines = 0;
+            auto const begin = steady_clock::now();
+            for (auto const& a : all)
+                lines += cache.getRippleLines(a.id()).size();
+            lines += cache.getRippleLines(gw.id()).size();
+            BEAST_EXPECT(lines == 2 * accounts * currencies);
+            return duration_cast<microseconds>(steady_clock::now() - begin);
+        };
+
+        RippleLineCache withGraph(env.closed(), snapshot);
+        RippleLineCache without(env.closed());
+        auto const fast = lookup(withGraph);
+        auto const slow = lookup(without);
+
+        log << "graph built in " << built.count() << "ms, "
+            << snapshot->accounts() << " accounts, " << snapshot->size()
+            << " lines, about " << snapshot->bytes() / 1024 << "KB; lines of "
+            << "every account in " << fast.count() << "us, from the "
+            << "directories " << slow.count() << "us" << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        testUpdate();
+        testLineCache();
+        testTotals();
+        testLarge(50, 4);
+    }
+};
+
+class TrustLineGraph_manual_test : public TrustLineGraph_test
+{
+public:
+    void
+    run() override
+    {
+        testLarge(2000, 10);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TrustLineGraph, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(TrustLineGraph_manual, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
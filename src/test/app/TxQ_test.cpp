@@ -28,6 +28,7 @@
 #include <ripple/protocol/jss.h>
 #include <ripple/protocol/st.h>
 #include <boost/optional.hpp>
+#include <chrono>
 #include <test/jtx.h>
 #include <test/jtx/TestSuite.h>
 #include <test/jtx/WSClient.h>
@@ -3172,6 +3173,126 @@ public:
         }
     }
 
+    /** Measure the queue with many transactions in it.
+
+        Fills the queue with `perAccount` transactions from each of
+        `accounts` accounts, then reports how long queueing, reading
+        the metrics, listing the queue, and closing ledgers take. The
+        cost of each should not grow with the size of the queue,
+        except listing it.
+    */
+    void
+    testQueueScale(std::size_t accounts, std::size_t perAccount)
+    {
+        using namespace jtx;
+        using namespace std::chrono;
+        testcase(
+            std::to_string(accounts * perAccount) + " queued transactions");
+
+        std::size_t const perLedger = 1000;
+        Env env(
+            *this,
+            makeConfig(
+                {{"minimum_txn_in_ledger_standalone",
+                  std::to_string(perLedger)},
+                 {"minimum_queue_size",
+                  std::to_string(2 * accounts * perAccount)},
+                 {"maximum_txn_per_account", std::to_string(perAccount)}}));
+
+        std::vector<Account> senders;
+        senders.reserve(accounts);
+        for (std::size_t i = 0; i < accounts; ++i)
+        {
+            senders.emplace_back("sender" + std::to_string(i));
+            env.fund(XRP(100000), noripple(senders.back()));
+            if ((i + 1) % (perLedger / 2) == 0)
+                env.close();
+        }
+        env.close();
+
+        // Sign everything up front so that only the queue is timed. The
+        // fees vary, so that the queue is not in arrival order.
+        std::vector<std::shared_ptr<STTx const>> txns;
+        txns.reserve(accounts * perAccount);
+        for (std::size_t n = 0; n < perAccount; ++n)
+        {
+            for (std::size_t i = 0; i < accounts; ++i)
+            {
+                auto const& a = senders[i];
+                txns.push_back(
+                    env.jt(
+                           noop(a),
+                           seq(env.seq(a) + n),
+                           fee(drops(20 + (7 * i + 13 * n) % 80)))
+                        .stx);
+            }
+        }
+
+        auto& txq = env.app().getTxQ();
+        std::size_t const chunk = txns.size() / 10;
+        auto start = steady_clock::now();
+        for (std::size_t i = 0; i < txns.size(); ++i)
+        {
+            env.app().openLedger().modify(
+                [&](OpenView& view, beast::Journal j) {
+                    return txq.apply(env.app(), view, txns[i], tapNONE, j)
+                        .second;
+                });
+
+            if ((i + 1) % chunk == 0)
+            {
+                auto const now = steady_clock::now();
+                log << "queueing transactions " << i + 1 - chunk << " to "
+                    << i + 1 << ": "
+                    << duration_cast<nanoseconds>(now - start).count() /
+                        chunk
+                    << "ns per tx" << std::endl;
+                start = now;
+            }
+        }
+
+        auto const metrics = txq.getMetrics(*env.current());
+        BEAST_EXPECT(metrics.txCount + metrics.txInLedger == txns.size());
+        BEAST_EXPECT(metrics.txCount >= txns.size() - 2 * perLedger);
+
+        {
+            std::size_t const calls = 10000;
+            start = steady_clock::now();
+            for (std::size_t i = 0; i < calls; ++i)
+                txq.getMetrics(*env.current());
+            log << "getMetrics: "
+                << duration_cast<nanoseconds>(steady_clock::now() - start)
+                        .count() /
+                    calls
+                << "ns" << std::endl;
+        }
+
+        {
+            start = steady_clock::now();
+            auto const queued = txq.getTxs(*env.current());
+            log << "getTxs: "
+                << duration_cast<microseconds>(steady_clock::now() - start)
+                       .count()
+                << "us for " << queued.size() << " transactions"
+                << std::endl;
+            BEAST_EXPECT(queued.size() == metrics.txCount);
+        }
+
+        for (int i = 0; i < 5; ++i)
+        {
+            auto const before = txq.getMetrics(*env.current()).txCount;
+            start = steady_clock::now();
+            env.close();
+            auto const elapsed =
+                duration_cast<microseconds>(steady_clock::now() - start);
+            auto const after = txq.getMetrics(*env.current());
+            BEAST_EXPECT(after.txCount < before);
+            log << "close: " << elapsed.count() << "us, "
+                << before - after.txCount << " transactions out of the queue, "
+                << after.txCount << " left" << std::endl;
+        }
+    }
+
     void
     run() override
     {
@@ -3200,7 +3321,18 @@ public:
     }
 };
 
+class TxQ_manual_test : public TxQ_test
+{
+public:
+    void
+    run() override
+    {
+        testQueueScale(11000, 10);
+    }
+};
+
 BEAST_DEFINE_TESTSUITE_PRIO(TxQ, app, ripple, 1);
+BEAST_DEFINE_TESTSUITE_MANUAL(TxQ_manual, app, ripple);
 
 }  // namespace test
 }  // namespace ripple
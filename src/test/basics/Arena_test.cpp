@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Arena.h>
+#include <ripple/beast/unit_test.h>
+#include <boost/container/flat_map.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class Arena_test : public beast::unit_test::suite
+{
+    template <class T>
+    using vector_type = std::vector<T, ArenaAllocator<T>>;
+
+    void
+    testAllocate()
+    {
+        testcase("allocate");
+
+        Arena arena;
+
+        // Small allocations come from the inline buffer, suitably aligned
+        auto const a = arena.allocate(1, 1);
+        auto const b = arena.allocate(8, 8);
+        auto const c = arena.allocate(16, alignof(std::max_align_t));
+        BEAST_EXPECT(a && b && c);
+        BEAST_EXPECT(reinterpret_cast<std::uintptr_t>(b) % 8 == 0);
+        BEAST_EXPECT(
+            reinterpret_cast<std::uintptr_t>(c) % alignof(std::max_align_t) ==
+            0);
+        BEAST_EXPECT(static_cast<char*>(b) > static_cast<char*>(a));
+        BEAST_EXPECT(arena.heapBytes() == 0);
+
+        // Then from the heap, in growing blocks
+        arena.allocate(Arena::inlineSize, 8);
+        BEAST_EXPECT(arena.heapBytes() == Arena::blockSize);
+        arena.allocate(Arena::blockSize - 64, 8);
+        BEAST_EXPECT(arena.heapBytes() == 3 * Arena::blockSize);
+
+        // A request larger than the next block gets a block of its own
+        auto const big = arena.allocate(100000, 8);
+        BEAST_EXPECT(big);
+        BEAST_EXPECT(arena.heapBytes() >= 3 * Arena::blockSize + 100000);
+
+        // All of the memory is usable
+        std::fill_n(static_cast<char*>(big), 100000, 'x');
+    }
+
+    void
+    testContainers()
+    {
+        testcase("containers");
+
+        {
+            Arena arena;
+            vector_type<std::string> v{ArenaAllocator<std::string>(arena)};
+            for (int i = 0; i < 1000; ++i)
+                v.push_back(std::to_string(i));
+            BEAST_EXPECT(v.size() == 1000);
+            BEAST_EXPECT(v[999] == "999");
+            BEAST_EXPECT(arena.heapBytes() > 0);
+        }
+
+        {
+            // Small containers stay inside the arena
+            Arena arena;
+            vector_type<int> v{ArenaAllocator<int>(arena)};
+            v.reserve(100);
+            for (int i = 0; i < 100; ++i)
+                v.push_back(i);
+            BEAST_EXPECT(arena.heapBytes() == 0);
+        }
+
+        {
+            // Moving to another arena moves the elements over
+            Arena a1;
+            Arena a2;
+            vector_type<std::string> v1{ArenaAllocator<std::string>(a1)};
+            for (int i = 0; i < 10; ++i)
+                v1.push_back(std::string(100, 'a' + i));
+            auto const before = v1.data();
+
+            vector_type<std::string> v2{
+                std::move(v1), ArenaAllocator<std::string>(a2)};
+            BEAST_EXPECT(v2.size() == 10);
+            BEAST_EXPECT(v2.data() != before);
+            BEAST_EXPECT(v2[3] == std::string(100, 'd'));
+
+            // With the same arena, the memory is taken over
+            vector_type<std::string> v3{
+                std::move(v2), ArenaAllocator<std::string>(a2)};
+            BEAST_EXPECT(v3.size() == 10);
+            BEAST_EXPECT(ArenaAllocator<int>(a1) != ArenaAllocator<int>(a2));
+            BEAST_EXPECT(ArenaAllocator<int>(a1) == ArenaAllocator<char>(a1));
+        }
+
+        {
+            using map_type = boost::container::flat_map<
+                int,
+                std::string,
+                std::less<int>,
+                ArenaAllocator<std::pair<int, std::string>>>;
+
+            Arena arena;
+            map_type m{map_type::allocator_type(arena)};
+            for (int i = 0; i < 500; ++i)
+                m.emplace((i * 7919) % 500, std::to_string(i));
+            BEAST_EXPECT(m.size() == 500);
+
+            int prev = -1;
+            bool sorted = true;
+            for (auto const& e : m)
+            {
+                sorted &= e.first > prev;
+                prev = e.first;
+            }
+            BEAST_EXPECT(sorted);
+            BEAST_EXPECT(m.find(250) != m.end());
+            m.erase(250);
+            BEAST_EXPECT(m.find(250) == m.end());
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testAllocate();
+        testContainers();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Arena, basics, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -27,7 +27,7 @@
 #include <chrono>
 #include <random>
 #include <string>
-#include <test/jtx/Env.h>
+#include <test/jtx.h>
 #include <thread>
 
 //------------------------------------------------------------------------------
@@ -958,7 +958,7 @@ public:
                                   int queued_us,
                                   int running_us) {
             BEAST_EXPECT(countersJson.isObject());
-            BEAST_EXPECT(countersJson.size() == 2);
+            BEAST_EXPECT(countersJson.size() == 3);
 
             BEAST_EXPECT(countersJson.isMember(jss::rpc));
             BEAST_EXPECT(countersJson[jss::rpc].isObject());
@@ -967,6 +967,10 @@ public:
             BEAST_EXPECT(countersJson.isMember(jss::job_queue));
             BEAST_EXPECT(countersJson[jss::job_queue].isObject());
             BEAST_EXPECT(countersJson[jss::job_queue].size() == 1);
+
+            BEAST_EXPECT(countersJson.isMember(jss::transactions));
+            BEAST_EXPECT(countersJson[jss::transactions].isObject());
+            BEAST_EXPECT(countersJson[jss::transactions].size() == 0);
             {
                 Json::Value const& job{
                     countersJson[jss::job_queue][jobTypeName]};
@@ -1062,6 +1066,82 @@ public:
         }
     }
 
+    void
+    testTransactions()
+    {
+        using namespace std::chrono;
+        using Stage = perf::PerfLog::TxStage;
+
+        {
+            // Exercise the transaction interfaces of PerfLog.
+            PerfLogParent parent{j_};
+            auto perfLog{getPerfLog(parent, WithFile::no)};
+            parent.doStart();
+
+            BEAST_EXPECT(
+                perfLog->countersJson()[jss::transactions].size() == 0);
+
+            perfLog->txStage(ttPAYMENT, Stage::preflight, microseconds{3});
+            perfLog->txStage(ttPAYMENT, Stage::preflight, microseconds{5});
+            perfLog->txStage(ttPAYMENT, Stage::apply, microseconds{7});
+            perfLog->txAccess(ttPAYMENT, 4, 2);
+            perfLog->txStage(
+                ttOFFER_CREATE, Stage::invariants, microseconds{11});
+
+            Json::Value const txJson{
+                perfLog->countersJson()[jss::transactions]};
+            BEAST_EXPECT(txJson.size() == 2);
+
+            // Every stage is reported once a type has been seen.
+            Json::Value const& payment{txJson["Payment"]};
+            BEAST_EXPECT(payment.size() == perf::PerfLog::txStages + 2);
+            {
+                Json::Value const& preflight{
+                    payment[to_string(Stage::preflight)]};
+                BEAST_EXPECT(jsonToUint64(preflight[jss::count]) == 2);
+                BEAST_EXPECT(jsonToUint64(preflight[jss::duration_us]) == 8);
+
+                Json::Value const& preclaim{
+                    payment[to_string(Stage::preclaim)]};
+                BEAST_EXPECT(jsonToUint64(preclaim[jss::count]) == 0);
+                BEAST_EXPECT(jsonToUint64(preclaim[jss::duration_us]) == 0);
+
+                Json::Value const& apply{
+                    payment[to_string(Stage::apply)]};
+                BEAST_EXPECT(jsonToUint64(apply[jss::count]) == 1);
+                BEAST_EXPECT(jsonToUint64(apply[jss::duration_us]) == 7);
+            }
+            BEAST_EXPECT(jsonToUint64(payment[jss::reads]) == 4);
+            BEAST_EXPECT(jsonToUint64(payment[jss::writes]) == 2);
+
+            Json::Value const& invariants{
+                txJson["OfferCreate"][to_string(Stage::invariants)]};
+            BEAST_EXPECT(jsonToUint64(invariants[jss::count]) == 1);
+            BEAST_EXPECT(jsonToUint64(invariants[jss::duration_us]) == 11);
+
+            parent.doStop();
+        }
+        {
+            // Applying a transaction reports each of its stages.
+            using namespace test::jtx;
+            Env env{*this};
+            env.fund(XRP(10000), "alice");
+            env.close();
+
+            Json::Value const payment{
+                env.app()
+                    .getPerfLog()
+                    .countersJson()[jss::transactions]["Payment"]};
+            for (std::size_t i = 0; i < perf::PerfLog::txStages; ++i)
+            {
+                auto const stage = to_string(static_cast<Stage>(i));
+                BEAST_EXPECT(jsonToUint64(payment[stage][jss::count]) != 0);
+            }
+            BEAST_EXPECT(jsonToUint64(payment[jss::reads]) != 0);
+            BEAST_EXPECT(jsonToUint64(payment[jss::writes]) != 0);
+        }
+    }
+
     void
     testRotate(WithFile withFile)
     {
@@ -1131,6 +1211,7 @@ public:
         testJobs(WithFile::yes);
         testInvalidID(WithFile::no);
         testInvalidID(WithFile::yes);
+        testTransactions();
         testRotate(WithFile::no);
         testRotate(WithFile::yes);
     }
@@ -0,0 +1,255 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/PersistentMap.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class PersistentMap_test : public beast::unit_test::suite
+{
+    using map_type = PersistentMap<int, std::string>;
+    using reference_type = std::map<int, std::string>;
+
+    bool
+    same(map_type const& m, reference_type const& r)
+    {
+        if (m.size() != r.size())
+            return false;
+        auto it = m.begin();
+        for (auto const& [k, v] : r)
+        {
+            if (it == m.end() || it->first != k || it->second != v)
+                return false;
+            ++it;
+        }
+        return it == m.end();
+    }
+
+    void
+    testBasics()
+    {
+        testcase("basics");
+
+        map_type m;
+        BEAST_EXPECT(m.empty());
+        BEAST_EXPECT(m.begin() == m.end());
+        BEAST_EXPECT(m.find(1) == m.end());
+        BEAST_EXPECT(m.lookup(1) == nullptr);
+
+        BEAST_EXPECT(m.insert(2, "two"));
+        BEAST_EXPECT(m.insert(1, "one"));
+        BEAST_EXPECT(m.insert(3, "three"));
+        BEAST_EXPECT(!m.insert(2, "deux"));
+        BEAST_EXPECT(m.size() == 3);
+        BEAST_EXPECT(*m.lookup(2) == "two");
+
+        BEAST_EXPECT(!m.insert_or_assign(2, "deux"));
+        BEAST_EXPECT(*m.lookup(2) == "deux");
+        BEAST_EXPECT(m.insert_or_assign(4, "four"));
+        BEAST_EXPECT(m.size() == 4);
+
+        BEAST_EXPECT(m.lower_bound(2)->first == 2);
+        BEAST_EXPECT(m.upper_bound(2)->first == 3);
+        BEAST_EXPECT(m.lower_bound(0)->first == 1);
+        BEAST_EXPECT(m.upper_bound(4) == m.end());
+        BEAST_EXPECT(m.find(3)->second == "three");
+        BEAST_EXPECT(m.count(3) == 1);
+
+        BEAST_EXPECT(m.erase(3) == 1);
+        BEAST_EXPECT(m.erase(3) == 0);
+        BEAST_EXPECT(m.size() == 3);
+        BEAST_EXPECT(m.upper_bound(2)->first == 4);
+
+        std::vector<int> keys;
+        for (auto const& e : m)
+            keys.push_back(e.first);
+        BEAST_EXPECT((keys == std::vector<int>{1, 2, 4}));
+
+        m.clear();
+        BEAST_EXPECT(m.empty());
+        BEAST_EXPECT(m.begin() == m.end());
+    }
+
+    void
+    testRandom()
+    {
+        testcase("random operations");
+
+        beast::xor_shift_engine rng(42);
+        map_type m;
+        reference_type r;
+
+        // Keep some snapshots along the way, with what they should hold
+        std::vector<std::pair<map_type, reference_type>> snapshots;
+
+        bool ok = true;
+        for (int i = 0; i < 20000; ++i)
+        {
+            int const key = rng() % 2000;
+            auto const value = std::to_string(rng() % 1000);
+            switch (rng() % 4)
+            {
+                case 0:
+                    ok &= m.insert(key, value) == r.emplace(key, value).second;
+                    break;
+                case 1:
+                    ok &= m.insert_or_assign(key, value) ==
+                        r.insert_or_assign(key, value).second;
+                    break;
+                default:
+                    ok &= m.erase(key) == r.erase(key);
+                    break;
+            }
+
+            if (i % 1000 == 0)
+                snapshots.emplace_back(m, r);
+        }
+        BEAST_EXPECT(ok);
+        BEAST_EXPECT(same(m, r));
+
+        // Changes made after a copy was taken are not visible in it
+        for (auto const& [snap, ref] : snapshots)
+            BEAST_EXPECT(same(snap, ref));
+
+        for (int i = 0; i < 500; ++i)
+        {
+            int const key = rng() % 2100 - 50;
+            auto const lb = m.lower_bound(key);
+            auto const rlb = r.lower_bound(key);
+            ok &= (lb == m.end()) == (rlb == r.end());
+            if (lb != m.end() && rlb != r.end())
+                ok &= lb->first == rlb->first;
+
+            auto const ub = m.upper_bound(key);
+            auto const rub = r.upper_bound(key);
+            ok &= (ub == m.end()) == (rub == r.end());
+            if (ub != m.end() && rub != r.end())
+                ok &= ub->first == rub->first;
+        }
+        BEAST_EXPECT(ok);
+    }
+
+    void
+    testSharing()
+    {
+        testcase("structural sharing");
+
+        map_type m;
+        for (int i = 0; i < 1000; ++i)
+            m.insert(i, std::to_string(i));
+
+        // An unshared map is changed in place
+        std::vector<std::string const*> before;
+        for (int i = 0; i < 1000; ++i)
+            before.push_back(m.lookup(i));
+        for (int i = 1000; i < 1100; ++i)
+            m.insert(i, std::to_string(i));
+        m.insert_or_assign(500, "five hundred");
+        bool inPlace = true;
+        for (int i = 0; i < 1000; ++i)
+            inPlace &= m.lookup(i) == before[i];
+        BEAST_EXPECT(inPlace);
+        BEAST_EXPECT(*before[500] == "five hundred");
+
+        // A copy shares every node until one of them changes
+        auto copy = m;
+        bool shared = true;
+        for (int i = 0; i < 1100; ++i)
+            shared &= copy.lookup(i) == m.lookup(i);
+        BEAST_EXPECT(shared);
+
+        copy.insert_or_assign(7, "seven");
+        copy.erase(8);
+        BEAST_EXPECT(*m.lookup(7) == "7");
+        BEAST_EXPECT(m.count(8) == 1);
+        BEAST_EXPECT(*copy.lookup(7) == "seven");
+        BEAST_EXPECT(copy.count(8) == 0);
+        BEAST_EXPECT(m.size() == 1100);
+        BEAST_EXPECT(copy.size() == 1099);
+
+        // Only the nodes on the changed paths were copied
+        std::size_t copied = 0;
+        for (int i = 0; i < 1100; ++i)
+        {
+            if (i != 8 && copy.lookup(i) != m.lookup(i))
+                ++copied;
+        }
+        BEAST_EXPECT(copied >= 1);
+        BEAST_EXPECT(copied < 100);
+
+        // Once the original is gone the copy is unshared again
+        m.clear();
+        auto const p = copy.lookup(9);
+        copy.insert(2000, "2000");
+        BEAST_EXPECT(copy.lookup(9) == p);
+    }
+
+    void
+    testIterators()
+    {
+        testcase("iterators");
+
+        map_type m;
+        for (int i = 0; i < 100; ++i)
+            m.insert(i, std::to_string(i));
+
+        // Modifying the map while iterating does not disturb the iteration
+        int n = 0;
+        for (auto it = m.begin(); it != m.end(); ++it)
+        {
+            if (it->first != n++)
+                break;
+            if (it->first % 2 == 0)
+                m.erase(it->first);
+            m.insert(1000 + it->first, "x");
+        }
+        BEAST_EXPECT(n == 100);
+        BEAST_EXPECT(m.size() == 150);
+        BEAST_EXPECT(m.count(0) == 0);
+        BEAST_EXPECT(m.count(1) == 1);
+        BEAST_EXPECT(m.count(1099) == 1);
+
+        auto a = m.find(1);
+        auto b = a++;
+        BEAST_EXPECT(b->first == 1);
+        BEAST_EXPECT(a->first == 3);
+        BEAST_EXPECT(++b == a);
+    }
+
+public:
+    void
+    run() override
+    {
+        testBasics();
+        testRandom();
+        testSharing();
+        testIterators();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(PersistentMap, basics, ripple);
+
+}  // namespace test
+}  // namespace ripple
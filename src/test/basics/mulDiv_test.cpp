@@ -19,6 +19,7 @@
 
 #include <ripple/basics/mulDiv.h>
 #include <ripple/beast/unit_test.h>
+#include <stdexcept>
 
 namespace ripple {
 namespace test {
@@ -53,6 +54,17 @@ struct mulDiv_test : beast::unit_test::suite
         // Overflow
         result = mulDiv(max - 1, max - 2, 5);
         BEAST_EXPECT(!result.first && result.second == max);
+
+        // Division by zero throws rather than trapping
+        try
+        {
+            mulDiv(85, 20, 0);
+            fail();
+        }
+        catch (std::overflow_error const&)
+        {
+            pass();
+        }
     }
 };
 
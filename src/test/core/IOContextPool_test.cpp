@@ -0,0 +1,293 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/rfc2616.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/core/IOContextPool.h>
+#include <ripple/server/Server.h>
+#include <ripple/server/Session.h>
+#include <boost/asio.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/ssl/ssl_stream.hpp>
+#include <chrono>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <test/jtx/envconfig.h>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+class IOContextPool_test : public beast::unit_test::suite
+{
+    using stream_type =
+        boost::beast::ssl_stream<boost::beast::tcp_stream>;
+
+    // Answers every request and remembers which thread served it
+    struct Handler
+    {
+        std::mutex mutex;
+        std::map<std::thread::id, std::size_t> served;
+
+        bool
+        onAccept(Session&, boost::asio::ip::tcp::endpoint)
+        {
+            return true;
+        }
+
+        Handoff
+        onHandoff(
+            Session&,
+            std::unique_ptr<stream_type>&&,
+            http_request_type&&,
+            boost::asio::ip::tcp::endpoint)
+        {
+            return Handoff{};
+        }
+
+        Handoff
+        onHandoff(
+            Session&,
+            http_request_type&&,
+            boost::asio::ip::tcp::endpoint)
+        {
+            return Handoff{};
+        }
+
+        void
+        onRequest(Session& session)
+        {
+            {
+                std::lock_guard lock(mutex);
+                ++served[std::this_thread::get_id()];
+            }
+            session.write(std::string("Hello, world!\n"));
+            if (beast::rfc2616::is_keep_alive(session.request()))
+                session.complete();
+            else
+                session.close(true);
+        }
+
+        void
+        onWSMessage(
+            std::shared_ptr<WSSession>,
+            std::vector<boost::asio::const_buffer> const&)
+        {
+        }
+
+        void
+        onClose(Session&, boost::system::error_code const&)
+        {
+        }
+
+        void
+        onStopped(Server&)
+        {
+        }
+    };
+
+    // Collects the ids of the threads running a pool's contexts
+    static std::set<std::thread::id>
+    threadsOf(IOContextPool& pool)
+    {
+        std::mutex m;
+        std::set<std::thread::id> ids;
+        for (std::size_t i = 0; i < pool.size(); ++i)
+        {
+            std::promise<void> done;
+            boost::asio::post(pool[i], [&]() {
+                {
+                    std::lock_guard lock(m);
+                    ids.insert(std::this_thread::get_id());
+                }
+                done.set_value();
+            });
+            done.get_future().wait();
+        }
+        return ids;
+    }
+
+protected:
+    void
+    testPool()
+    {
+        testcase("pool");
+
+        IOContextPool pool(3, false, "test io");
+        BEAST_EXPECT(pool.size() == 3);
+
+        // Contexts are handed out round robin
+        BEAST_EXPECT(&pool.next() == &pool[0]);
+        BEAST_EXPECT(&pool.next() == &pool[1]);
+        BEAST_EXPECT(&pool.next() == &pool[2]);
+        BEAST_EXPECT(&pool.next() == &pool[0]);
+
+        // Every context has a thread of its own
+        auto const ids = threadsOf(pool);
+        BEAST_EXPECT(ids.size() == 3);
+        BEAST_EXPECT(ids.count(std::this_thread::get_id()) == 0);
+    }
+
+    /** Hold many loopback connections open at once on a server whose door
+        accepts onto the pool, and check every connection is served by a
+        pool thread with the load spread over all of them.
+    */
+    void
+    testConnections(std::size_t connections, std::size_t threads)
+    {
+        using namespace std::chrono;
+        using socket = boost::asio::ip::tcp::socket;
+
+        testcase(
+            std::to_string(connections) + " connections on " +
+            std::to_string(threads) + " contexts");
+
+        IOContextPool pool(threads, false, "test io");
+        auto const poolThreads = threadsOf(pool);
+
+        boost::asio::io_context acceptIO;
+        auto work = boost::asio::make_work_guard(acceptIO);
+        std::thread acceptThread([&]() { acceptIO.run(); });
+
+        Handler handler;
+        beast::Journal journal{beast::Journal::getNullSink()};
+        auto server = make_Server(handler, acceptIO, journal);
+
+        std::vector<Port> ports(1);
+        ports.back().ip =
+            beast::IP::Address::from_string(getEnvLocalhostAddr());
+        ports.back().port = 0;
+        ports.back().protocol.insert("http");
+        ports.back().limit = 0;
+        ports.back().io_context = [&pool]() -> auto& { return pool.next(); };
+        auto const ep = server->ports(ports)[0];
+
+        auto const start = steady_clock::now();
+
+        // Open every connection before sending anything, so that they are
+        // all established at the same time.
+        boost::asio::io_context clientIO;
+        std::vector<std::unique_ptr<socket>> clients;
+        clients.reserve(connections);
+        try
+        {
+            for (std::size_t i = 0; i < connections; ++i)
+            {
+                clients.push_back(std::make_unique<socket>(clientIO));
+                clients.back()->connect(ep);
+            }
+        }
+        catch (std::exception const& e)
+        {
+            fail(e.what(), __FILE__, __LINE__);
+        }
+
+        std::string const request =
+            "GET / HTTP/1.1\r\n"
+            "Connection: Keep-Alive\r\n"
+            "\r\n";
+        std::string const reply = "Hello, world!\n";
+
+        std::size_t answered = 0;
+        for (int round = 0; round < 2; ++round)
+        {
+            for (auto& c : clients)
+            {
+                boost::system::error_code ec;
+                boost::asio::write(*c, boost::asio::buffer(request), ec);
+            }
+
+            for (auto& c : clients)
+            {
+                boost::system::error_code ec;
+                boost::asio::streambuf b(1000);
+                auto const n = boost::asio::read_until(*c, b, '\n', ec);
+                if (!ec && n == reply.size())
+                    ++answered;
+            }
+        }
+
+        auto const elapsed =
+            duration_cast<milliseconds>(steady_clock::now() - start);
+
+        BEAST_EXPECT(clients.size() == connections);
+        BEAST_EXPECT(answered == 2 * connections);
+
+        std::map<std::thread::id, std::size_t> served;
+        {
+            std::lock_guard lock(handler.mutex);
+            served = handler.served;
+        }
+
+        std::size_t total = 0;
+        for (auto const& [id, count] : served)
+        {
+            BEAST_EXPECT(poolThreads.count(id) == 1);
+            total += count;
+        }
+        BEAST_EXPECT(total == 2 * connections);
+
+        // Connections are placed round robin, so no context should carry
+        // much more than its share.
+        BEAST_EXPECT(served.size() == threads);
+        for (auto const& e : served)
+            BEAST_EXPECT(e.second <= 2 * (2 * connections / threads + 1));
+
+        log << connections << " connections, " << answered
+            << " requests in " << elapsed.count() << "ms" << std::endl;
+
+        for (auto& c : clients)
+        {
+            boost::system::error_code ec;
+            c->shutdown(socket::shutdown_both, ec);
+            c->close(ec);
+        }
+
+        // The server waits for its sessions, which live on the pool
+        server.reset();
+        work.reset();
+        acceptThread.join();
+    }
+
+public:
+    void
+    run() override
+    {
+        testPool();
+        testConnections(64, 4);
+    }
+};
+
+class IOContextPool_manual_test : public IOContextPool_test
+{
+public:
+    void
+    run() override
+    {
+        testConnections(1000, 4);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(IOContextPool, core, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(IOContextPool_manual, core, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -20,6 +20,9 @@
 #include <ripple/beast/unit_test.h>
 #include <ripple/core/JobQueue.h>
 #include <test/jtx/Env.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
 
 namespace ripple {
 namespace test {
@@ -154,12 +157,67 @@ class JobQueue_test : public beast::unit_test::suite
         }
     }
 
+    void
+    testParallelFor()
+    {
+        jtx::Env env{*this};
+
+        JobQueue& jQueue = env.app().getJobQueue();
+        {
+            // Every index is visited exactly once.
+            std::vector<std::atomic<int>> visits(1000);
+            jQueue.parallelFor(
+                jtTXN_SPECULATE,
+                "ParallelForTest1",
+                visits.size(),
+                4,
+                [&visits](std::size_t i) { ++visits[i]; });
+            BEAST_EXPECT(std::all_of(
+                visits.begin(), visits.end(), [](auto const& v) {
+                    return v == 1;
+                }));
+        }
+        {
+            // Called from a job, it finishes even if no helper gets to run.
+            std::atomic<int> visits{0};
+            std::atomic<bool> done{false};
+            BEAST_EXPECT(jQueue.addJob(jtCLIENT, "ParallelForTest2", [&](Job&) {
+                jQueue.parallelFor(
+                    jtTXN_SPECULATE,
+                    "ParallelForTest2",
+                    100,
+                    64,
+                    [&visits](std::size_t) { ++visits; });
+                done = true;
+            }));
+            while (!done)
+                ;
+            BEAST_EXPECT(visits == 100);
+        }
+        {
+            // Once no more jobs may be added, the caller does all the work.
+            using namespace std::chrono_literals;
+            beast::Journal j{env.app().journal("JobQueue_test")};
+            jQueue.jobCounter().join("JobQueue_test", 1s, j);
+
+            std::size_t visits = 0;
+            jQueue.parallelFor(
+                jtTXN_SPECULATE,
+                "ParallelForTest3",
+                10,
+                4,
+                [&visits](std::size_t) { ++visits; });
+            BEAST_EXPECT(visits == 10);
+        }
+    }
+
 public:
     void
     run() override
     {
         testAddJob();
         testPostCoro();
+        testParallelFor();
     }
 };
 
@@ -74,6 +74,20 @@ class PerfLogTest : public PerfLog
     {
     }
 
+    void
+    txStage(
+        TxType const type,
+        TxStage const stage,
+        std::chrono::microseconds dur) override
+    {
+    }
+
+    void
+    txAccess(TxType const type, std::size_t reads, std::size_t writes)
+        override
+    {
+    }
+
     Json::Value
     countersJson() const override
     {
@@ -0,0 +1,278 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/json_writer.h>
+#include <ripple/net/StreamMessage.h>
+#include <ripple/server/WSSession.h>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+namespace {
+
+// Something like what the transactions stream publishes
+Json::Value
+makeTransaction(int i)
+{
+    Json::Value jv(Json::objectValue);
+    jv["type"] = "transaction";
+    jv["engine_result"] = "tesSUCCESS";
+    jv["engine_result_code"] = 0;
+    jv["ledger_index"] = 54321 + i;
+    jv["validated"] = true;
+    auto& tx = jv["transaction"];
+    tx["TransactionType"] = "OfferCreate";
+    tx["Account"] = "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh";
+    tx["Fee"] = "12";
+    tx["Sequence"] = 100 + i;
+    tx["TakerGets"] = "1000000";
+    tx["TakerPays"]["currency"] = "USD";
+    tx["TakerPays"]["issuer"] = "rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn";
+    tx["TakerPays"]["value"] = "1.23456789";
+    tx["hash"] = std::string(64, 'A' + i % 6);
+    auto& nodes = jv["meta"]["AffectedNodes"];
+    for (int n = 0; n < 6; ++n)
+    {
+        auto& node = nodes[n]["ModifiedNode"];
+        node["LedgerEntryType"] = "AccountRoot";
+        node["LedgerIndex"] = std::string(64, '0' + n);
+        node["FinalFields"]["Balance"] = std::to_string(1000000 * n + i);
+        node["PreviousFields"]["Balance"] = std::to_string(1000000 * n);
+    }
+    return jv;
+}
+
+std::string
+render(Json::Value const& jv)
+{
+    std::string s;
+    Json::stream(jv, [&s](void const* data, std::size_t n) {
+        s.append(static_cast<char const*>(data), n);
+    });
+    return s;
+}
+
+// A message queued to one session, the way WSInfoSub made them before
+std::shared_ptr<WSMsg>
+perSession(Json::Value const& jv)
+{
+    boost::beast::multi_buffer sb;
+    Json::stream(jv, [&](void const* data, std::size_t n) {
+        sb.commit(boost::asio::buffer_copy(
+            sb.prepare(n), boost::asio::buffer(data, n)));
+    });
+    return std::make_shared<StreambufWSMsg<decltype(sb)>>(std::move(sb));
+}
+
+std::shared_ptr<WSMsg>
+shared(std::shared_ptr<StreamMessage const> const& msg)
+{
+    auto const& text = msg->text();
+    return std::make_shared<SharedWSMsg>(
+        msg, boost::asio::const_buffer(text.data(), text.size()));
+}
+
+// Write a message out as a session does, chunk by chunk
+template <class F>
+void
+drain(WSMsg& m, std::size_t chunk, F&& f)
+{
+    for (;;)
+    {
+        auto const [done, buffers] = m.prepare(chunk, [] {});
+        for (auto const& b : buffers)
+            f(b);
+        if (done)
+            break;
+    }
+}
+
+std::string
+drain(WSMsg& m, std::size_t chunk)
+{
+    std::string s;
+    drain(m, chunk, [&s](boost::asio::const_buffer const& b) {
+        s.append(static_cast<char const*>(b.data()), b.size());
+    });
+    return s;
+}
+
+}  // namespace
+
+class StreamMessage_test : public beast::unit_test::suite
+{
+    void
+    testText()
+    {
+        testcase("text");
+
+        auto const jv = makeTransaction(1);
+        StreamMessage const msg(jv);
+        BEAST_EXPECT(msg.json() == jv);
+        BEAST_EXPECT(msg.text() == render(jv));
+        BEAST_EXPECT(&msg.text() == &msg.text());
+
+        Json::Value const none(Json::objectValue);
+        BEAST_EXPECT(StreamMessage(none).text() == render(none));
+    }
+
+    void
+    testShared()
+    {
+        testcase("shared bytes");
+
+        auto const jv = makeTransaction(2);
+        auto msg = std::make_shared<StreamMessage const>(jv);
+        for (std::size_t const chunk : {1, 7, 64, 65536})
+        {
+            auto const expected = drain(*perSession(jv), chunk);
+            BEAST_EXPECT(expected == msg->text());
+
+            // Each session has its own place in the same bytes
+            auto a = shared(msg);
+            auto b = shared(msg);
+            BEAST_EXPECT(drain(*a, chunk) == expected);
+            BEAST_EXPECT(drain(*b, chunk) == expected);
+        }
+
+        // A session keeps the bytes alive after the message is dropped
+        std::weak_ptr<StreamMessage const> weak = msg;
+        auto held = shared(msg);
+        msg.reset();
+        BEAST_EXPECT(!weak.expired());
+        BEAST_EXPECT(drain(*held, 100) == render(jv));
+        held.reset();
+        BEAST_EXPECT(weak.expired());
+
+        // Nothing to write
+        SharedWSMsg none(nullptr, boost::asio::const_buffer());
+        auto const [done, buffers] = none.prepare(100, [] {});
+        BEAST_EXPECT(done && buffers.empty());
+    }
+
+    void
+    testThreads()
+    {
+        testcase("threads");
+
+        auto const jv = makeTransaction(3);
+        auto const expected = render(jv);
+        for (int round = 0; round < 20; ++round)
+        {
+            StreamMessage const msg(jv);
+            std::vector<std::string const*> seen(8);
+            std::vector<std::thread> threads;
+            for (std::size_t i = 0; i < seen.size(); ++i)
+                threads.emplace_back(
+                    [&msg, &seen, i] { seen[i] = &msg.text(); });
+            for (auto& t : threads)
+                t.join();
+            for (auto const p : seen)
+                BEAST_EXPECT(p == &msg.text() && *p == expected);
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testText();
+        testShared();
+        testThreads();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(StreamMessage, net, ripple);
+
+//------------------------------------------------------------------------------
+
+/** Measures the cost of publishing a message to a number of subscribers,
+    rendering it for each of them against rendering it once.
+
+    Usage: --unittest-arg=<messages>, 200 by default
+*/
+class StreamMessageBench_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono;
+
+        std::size_t const n = arg().empty() ? 200 : std::stoul(arg());
+        std::vector<Json::Value> messages;
+        for (std::size_t i = 0; i < n; ++i)
+            messages.push_back(makeTransaction(static_cast<int>(i)));
+
+        std::size_t sink = 0;
+        auto const write = [&sink](boost::asio::const_buffer const& b) {
+            sink += b.size();
+        };
+
+        testcase("fan-out");
+        for (std::size_t const subscribers : {1, 10, 100, 1000, 2000})
+        {
+            std::vector<std::shared_ptr<WSMsg>> queued;
+            queued.reserve(subscribers);
+
+            auto start = steady_clock::now();
+            for (auto const& jv : messages)
+            {
+                for (std::size_t s = 0; s < subscribers; ++s)
+                    queued.push_back(perSession(jv));
+                for (auto& m : queued)
+                    drain(*m, 65536, write);
+                queued.clear();
+            }
+            auto const before =
+                duration_cast<microseconds>(steady_clock::now() - start) / n;
+
+            start = steady_clock::now();
+            for (auto const& jv : messages)
+            {
+                auto const msg = std::make_shared<StreamMessage const>(jv);
+                for (std::size_t s = 0; s < subscribers; ++s)
+                    queued.push_back(shared(msg));
+                for (auto& m : queued)
+                    drain(*m, 65536, write);
+                queued.clear();
+            }
+            auto const now =
+                duration_cast<microseconds>(steady_clock::now() - start) / n;
+
+            log << subscribers << " subscribers: " << now.count()
+                << "us per message, was " << before.count() << "us"
+                << std::endl;
+        }
+        log << "(" << sink % 10 << ")" << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(StreamMessageBench, net, ripple);
+
+}  // namespace test
+}  // namespace ripple
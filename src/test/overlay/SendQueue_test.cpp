@@ -0,0 +1,271 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/overlay/impl/SendQueue.h>
+#include <ripple/protocol/jss.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/strand.hpp>
+
+namespace ripple {
+namespace test {
+
+class SendQueue_test : public beast::unit_test::suite
+{
+    static std::shared_ptr<Message>
+    validation()
+    {
+        protocol::TMValidation v;
+        v.set_validation("validation");
+        return std::make_shared<Message>(v, protocol::mtVALIDATION);
+    }
+
+    static std::shared_ptr<Message>
+    transaction()
+    {
+        protocol::TMTransaction tx;
+        tx.set_rawtransaction("transaction");
+        tx.set_status(protocol::tsNEW);
+        return std::make_shared<Message>(tx, protocol::mtTRANSACTION);
+    }
+
+    static std::shared_ptr<Message>
+    ledgerData()
+    {
+        protocol::TMLedgerData ld;
+        ld.set_ledgerhash(std::string(32, 'x'));
+        ld.set_ledgerseq(3);
+        ld.set_type(protocol::liAS_NODE);
+        ld.set_requestcookie(1);
+        return std::make_shared<Message>(ld, protocol::mtLEDGER_DATA);
+    }
+
+    static std::shared_ptr<Message>
+    endpoints()
+    {
+        protocol::TMEndpoints ep;
+        ep.set_version(2);
+        return std::make_shared<Message>(ep, protocol::mtENDPOINTS);
+    }
+
+    static SendQueue::Priority
+    priority(std::shared_ptr<Message> const& m)
+    {
+        return SendQueue::classify(
+            static_cast<TrafficCount::category>(m->getCategory()));
+    }
+
+    void
+    testClassify()
+    {
+        testcase("classify");
+
+        BEAST_EXPECT(priority(validation()) == SendQueue::consensus);
+        BEAST_EXPECT(priority(transaction()) == SendQueue::transaction);
+        BEAST_EXPECT(priority(ledgerData()) == SendQueue::ledgerData);
+        BEAST_EXPECT(priority(endpoints()) == SendQueue::other);
+    }
+
+    void
+    testFrontIsStable()
+    {
+        testcase("front is stable");
+
+        SendQueue q;
+        q.push(ledgerData());
+        auto const first = q.front();
+        BEAST_EXPECT(priority(first) == SendQueue::ledgerData);
+
+        // A higher priority message must not replace a message that is
+        // already being written.
+        q.push(validation());
+        BEAST_EXPECT(q.front() == first);
+        BEAST_EXPECT(q.size() == 2);
+        q.pop();
+
+        BEAST_EXPECT(priority(q.front()) == SendQueue::consensus);
+        q.pop();
+        BEAST_EXPECT(q.empty());
+    }
+
+    void
+    testConsensusFirst()
+    {
+        testcase("consensus ahead of bulk data");
+
+        SendQueue q;
+        for (int i = 0; i < 500; ++i)
+            q.push(ledgerData());
+        q.push(validation());
+        BEAST_EXPECT(q.size(SendQueue::ledgerData) == 500);
+        BEAST_EXPECT(q.size(SendQueue::consensus) == 1);
+
+        // The validation goes out after at most one round worth of
+        // ledger data, not after the whole backlog.
+        std::size_t written = 0;
+        while (priority(q.front()) != SendQueue::consensus)
+        {
+            q.pop();
+            ++written;
+        }
+        BEAST_EXPECT(written <= Tuning::sendWeightLedgerData);
+        q.pop();
+        BEAST_EXPECT(q.size(SendQueue::consensus) == 0);
+        BEAST_EXPECT(q.size() == 500 - written);
+    }
+
+    void
+    testWeights()
+    {
+        testcase("weighted round robin");
+
+        SendQueue q;
+        std::size_t const rounds = 10;
+        std::size_t const total = Tuning::sendWeightConsensus +
+            Tuning::sendWeightTransaction + Tuning::sendWeightLedgerData +
+            Tuning::sendWeightOther;
+
+        for (std::size_t i = 0; i < 2 * rounds * total; ++i)
+        {
+            q.push(validation());
+            q.push(transaction());
+            q.push(ledgerData());
+            q.push(endpoints());
+        }
+
+        std::array<std::size_t, SendQueue::priorities> sent{};
+        for (std::size_t i = 0; i < rounds * total; ++i)
+        {
+            ++sent[priority(q.front())];
+            q.pop();
+        }
+
+        // With every class backlogged, each gets exactly its share.
+        BEAST_EXPECT(sent[SendQueue::consensus] ==
+            rounds * Tuning::sendWeightConsensus);
+        BEAST_EXPECT(sent[SendQueue::transaction] ==
+            rounds * Tuning::sendWeightTransaction);
+        BEAST_EXPECT(sent[SendQueue::ledgerData] ==
+            rounds * Tuning::sendWeightLedgerData);
+        BEAST_EXPECT(sent[SendQueue::other] ==
+            rounds * Tuning::sendWeightOther);
+
+        // A lone class is not held back by the others' unused credits.
+        SendQueue bulk;
+        for (int i = 0; i < 100; ++i)
+            bulk.push(ledgerData());
+        std::size_t drained = 0;
+        while (!bulk.empty())
+        {
+            bulk.front();
+            bulk.pop();
+            ++drained;
+        }
+        BEAST_EXPECT(drained == 100);
+    }
+
+    void
+    testJson()
+    {
+        testcase("json");
+
+        SendQueue q;
+        q.push(validation());
+        q.push(transaction());
+        q.push(transaction());
+        q.front();
+        q.pop();
+
+        auto const jv = q.json();
+        BEAST_EXPECT(jv.isMember("consensus"));
+        BEAST_EXPECT(jv.isMember("transaction"));
+        BEAST_EXPECT(jv.isMember("ledger_data"));
+        BEAST_EXPECT(jv.isMember("other"));
+        BEAST_EXPECT(jv["consensus"][jss::depth].asUInt() == 0);
+        BEAST_EXPECT(jv["consensus"][jss::sent].asString() == "1");
+        BEAST_EXPECT(jv["transaction"][jss::depth].asUInt() == 2);
+        BEAST_EXPECT(jv["transaction"][jss::sent].asString() == "0");
+    }
+
+    void
+    testDeferred()
+    {
+        testcase("deferred sends");
+
+        // Messages sent from off the strand are posted to it, as in
+        // PeerImp::send. They must be counted before they get there.
+        boost::asio::io_context ios;
+        boost::asio::strand<boost::asio::io_context::executor_type> strand{
+            ios.get_executor()};
+        SendQueue q;
+        bool closed = false;
+
+        auto send = [&](std::shared_ptr<Message> const& m) {
+            q.defer();
+            boost::asio::post(strand, [&q, &closed, m]() {
+                q.admit();
+                if (!closed)
+                    q.push(m);
+            });
+        };
+
+        for (int i = 0; i < 40; ++i)
+            send(ledgerData());
+        BEAST_EXPECT(q.depth() == 40);
+        BEAST_EXPECT(q.size() == 0);
+
+        ios.run();
+        BEAST_EXPECT(q.depth() == 40);
+        BEAST_EXPECT(q.size() == 40);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            q.front();
+            q.pop();
+        }
+        BEAST_EXPECT(q.depth() == 30);
+
+        // A message that is dropped on arrival is no longer counted.
+        closed = true;
+        send(validation());
+        BEAST_EXPECT(q.depth() == 31);
+        ios.restart();
+        ios.run();
+        BEAST_EXPECT(q.depth() == 30);
+        BEAST_EXPECT(q.size(SendQueue::consensus) == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testClassify();
+        testFrontIsStable();
+        testConsensusFirst();
+        testWeights();
+        testJson();
+        testDeferred();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SendQueue, overlay, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,909 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/FixedPoint.h>
+#include <ripple/basics/IOUAmount.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/protocol/STAmount.h>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+// The arithmetic on amounts as it was before it was given fixed point
+// kernels, one step at a time and through boost's 128 bit integers. The
+// kernels must give the same results, down to the last bit and to the
+// message of every exception.
+namespace reference {
+
+using uint128 = boost::multiprecision::uint128_t;
+
+static std::uint64_t const tenTo14 = 100000000000000ull;
+static std::uint64_t const tenTo14m1 = tenTo14 - 1;
+static std::uint64_t const tenTo17 = tenTo14 * 1000;
+
+static STAmount
+make(Issue const& issue, std::uint64_t value, int offset, bool negative)
+{
+    bool const native = isXRP(issue);
+    if (native)
+    {
+        if (value == 0)
+        {
+            offset = 0;
+            negative = false;
+        }
+        else
+        {
+            while (offset < 0)
+            {
+                value /= 10;
+                ++offset;
+            }
+
+            while (offset > 0)
+            {
+                value *= 10;
+                --offset;
+            }
+
+            if (value > STAmount::cMaxNativeN)
+                Throw<std::runtime_error>(
+                    "Native currency amount out of range");
+        }
+    }
+    else if (value == 0)
+    {
+        offset = -100;
+        negative = false;
+    }
+    else
+    {
+        while ((value < STAmount::cMinValue) &&
+               (offset > STAmount::cMinOffset))
+        {
+            value *= 10;
+            --offset;
+        }
+
+        while (value > STAmount::cMaxValue)
+        {
+            if (offset >= STAmount::cMaxOffset)
+                Throw<std::runtime_error>("value overflow");
+
+            value /= 10;
+            ++offset;
+        }
+
+        if ((offset < STAmount::cMinOffset) || (value < STAmount::cMinValue))
+        {
+            value = 0;
+            negative = false;
+            offset = -100;
+        }
+        else if (offset > STAmount::cMaxOffset)
+            Throw<std::runtime_error>("value overflow");
+    }
+
+    return STAmount(
+        issue, value, offset, native, negative, STAmount::unchecked{});
+}
+
+static std::int64_t
+getSNValue(STAmount const& amount)
+{
+    auto ret = static_cast<std::int64_t>(amount.mantissa());
+    return amount.negative() ? -ret : ret;
+}
+
+static std::uint64_t
+muldiv(
+    std::uint64_t multiplier,
+    std::uint64_t multiplicand,
+    std::uint64_t divisor)
+{
+    uint128 ret;
+
+    boost::multiprecision::multiply(ret, multiplier, multiplicand);
+    ret /= divisor;
+
+    if (ret > std::numeric_limits<std::uint64_t>::max())
+    {
+        Throw<std::overflow_error>(
+            "overflow: (" + std::to_string(multiplier) + " * " +
+            std::to_string(multiplicand) + ") / " + std::to_string(divisor));
+    }
+
+    return static_cast<uint64_t>(ret);
+}
+
+static std::uint64_t
+muldiv_round(
+    std::uint64_t multiplier,
+    std::uint64_t multiplicand,
+    std::uint64_t divisor,
+    std::uint64_t rounding)
+{
+    uint128 ret;
+
+    boost::multiprecision::multiply(ret, multiplier, multiplicand);
+    ret += rounding;
+    ret /= divisor;
+
+    if (ret > std::numeric_limits<std::uint64_t>::max())
+    {
+        Throw<std::overflow_error>(
+            "overflow: ((" + std::to_string(multiplier) + " * " +
+            std::to_string(multiplicand) + ") + " + std::to_string(rounding) +
+            ") / " + std::to_string(divisor));
+    }
+
+    return static_cast<uint64_t>(ret);
+}
+
+static void
+scaleNative(std::uint64_t& value, int& offset)
+{
+    while (value < STAmount::cMinValue)
+    {
+        value *= 10;
+        --offset;
+    }
+}
+
+static STAmount
+add(STAmount const& v1, STAmount const& v2)
+{
+    if (v2 == beast::zero)
+        return v1;
+
+    if (v1 == beast::zero)
+        return make(v1.issue(), v2.mantissa(), v2.exponent(), v2.negative());
+
+    if (v1.native())
+        return {v1.getFName(), getSNValue(v1) + getSNValue(v2)};
+
+    int ov1 = v1.exponent(), ov2 = v2.exponent();
+    std::int64_t vv1 = static_cast<std::int64_t>(v1.mantissa());
+    std::int64_t vv2 = static_cast<std::int64_t>(v2.mantissa());
+
+    if (v1.negative())
+        vv1 = -vv1;
+
+    if (v2.negative())
+        vv2 = -vv2;
+
+    while (ov1 < ov2)
+    {
+        vv1 /= 10;
+        ++ov1;
+    }
+
+    while (ov2 < ov1)
+    {
+        vv2 /= 10;
+        ++ov2;
+    }
+
+    std::int64_t fv = vv1 + vv2;
+
+    if ((fv >= -10) && (fv <= 10))
+        return make(v1.issue(), 0, 0, false);
+
+    if (fv >= 0)
+        return make(v1.issue(), static_cast<std::uint64_t>(fv), ov1, false);
+
+    return make(v1.issue(), static_cast<std::uint64_t>(-fv), ov1, true);
+}
+
+static STAmount
+divide(STAmount const& num, STAmount const& den, Issue const& issue)
+{
+    if (den == beast::zero)
+        Throw<std::runtime_error>("division by zero");
+
+    if (num == beast::zero)
+        return make(issue, 0, 0, false);
+
+    std::uint64_t numVal = num.mantissa();
+    std::uint64_t denVal = den.mantissa();
+    int numOffset = num.exponent();
+    int denOffset = den.exponent();
+
+    if (num.native())
+        scaleNative(numVal, numOffset);
+
+    if (den.native())
+        scaleNative(denVal, denOffset);
+
+    return make(
+        issue,
+        muldiv(numVal, tenTo17, denVal) + 5,
+        numOffset - denOffset - 17,
+        num.negative() != den.negative());
+}
+
+static STAmount
+multiply(STAmount const& v1, STAmount const& v2, Issue const& issue)
+{
+    if (v1 == beast::zero || v2 == beast::zero)
+        return make(issue, 0, 0, false);
+
+    if (v1.native() && v2.native() && isXRP(issue))
+        return ripple::multiply(v1, v2, issue);
+
+    std::uint64_t value1 = v1.mantissa();
+    std::uint64_t value2 = v2.mantissa();
+    int offset1 = v1.exponent();
+    int offset2 = v2.exponent();
+
+    if (v1.native())
+        scaleNative(value1, offset1);
+
+    if (v2.native())
+        scaleNative(value2, offset2);
+
+    return make(
+        issue,
+        muldiv(value1, value2, tenTo14) + 7,
+        offset1 + offset2 + 14,
+        v1.negative() != v2.negative());
+}
+
+static void
+canonicalizeRound(bool native, std::uint64_t& value, int& offset)
+{
+    if (native)
+    {
+        if (offset < 0)
+        {
+            int loops = 0;
+
+            while (offset < -1)
+            {
+                value /= 10;
+                ++offset;
+                ++loops;
+            }
+
+            value += (loops >= 2) ? 9 : 10;  // add before last divide
+            value /= 10;
+            ++offset;
+        }
+    }
+    else if (value > STAmount::cMaxValue)
+    {
+        while (value > (10 * STAmount::cMaxValue))
+        {
+            value /= 10;
+            ++offset;
+        }
+
+        value += 9;  // add before last divide
+        value /= 10;
+        ++offset;
+    }
+}
+
+static STAmount
+roundedUpFromZero(Issue const& issue)
+{
+    if (isXRP(issue))
+        return make(issue, 1, 0, false);
+    return make(issue, STAmount::cMinValue, STAmount::cMinOffset, false);
+}
+
+static STAmount
+mulRound(
+    STAmount const& v1,
+    STAmount const& v2,
+    Issue const& issue,
+    bool roundUp)
+{
+    if (v1 == beast::zero || v2 == beast::zero)
+        return make(issue, 0, 0, false);
+
+    bool const xrp = isXRP(issue);
+
+    if (v1.native() && v2.native() && xrp)
+        return ripple::mulRound(v1, v2, issue, roundUp);
+
+    std::uint64_t value1 = v1.mantissa(), value2 = v2.mantissa();
+    int offset1 = v1.exponent(), offset2 = v2.exponent();
+
+    if (v1.native())
+        scaleNative(value1, offset1);
+
+    if (v2.native())
+        scaleNative(value2, offset2);
+
+    bool const resultNegative = v1.negative() != v2.negative();
+
+    std::uint64_t amount = muldiv_round(
+        value1, value2, tenTo14, (resultNegative != roundUp) ? tenTo14m1 : 0);
+
+    int offset = offset1 + offset2 + 14;
+    if (resultNegative != roundUp)
+        canonicalizeRound(xrp, amount, offset);
+    STAmount result = make(issue, amount, offset, resultNegative);
+
+    if (roundUp && !resultNegative && !result)
+        return roundedUpFromZero(issue);
+    return result;
+}
+
+static STAmount
+divRound(
+    STAmount const& num,
+    STAmount const& den,
+    Issue const& issue,
+    bool roundUp)
+{
+    if (den == beast::zero)
+        Throw<std::runtime_error>("division by zero");
+
+    if (num == beast::zero)
+        return make(issue, 0, 0, false);
+
+    std::uint64_t numVal = num.mantissa(), denVal = den.mantissa();
+    int numOffset = num.exponent(), denOffset = den.exponent();
+
+    if (num.native())
+        scaleNative(numVal, numOffset);
+
+    if (den.native())
+        scaleNative(denVal, denOffset);
+
+    bool const resultNegative = (num.negative() != den.negative());
+
+    std::uint64_t amount = muldiv_round(
+        numVal, tenTo17, denVal, (resultNegative != roundUp) ? denVal - 1 : 0);
+
+    int offset = numOffset - denOffset - 17;
+
+    if (resultNegative != roundUp)
+        canonicalizeRound(isXRP(issue), amount, offset);
+
+    STAmount result = make(issue, amount, offset, resultNegative);
+    if (roundUp && !resultNegative && !result)
+        return roundedUpFromZero(issue);
+    return result;
+}
+
+// The mantissa and exponent an IOUAmount is normalized to
+static std::pair<std::int64_t, int>
+normalize(std::int64_t mantissa, int exponent)
+{
+    std::int64_t const minMantissa = 1000000000000000ull;
+    std::int64_t const maxMantissa = 9999999999999999ull;
+    int const minExponent = -96;
+    int const maxExponent = 80;
+
+    if (mantissa == 0)
+        return {0, -100};
+
+    bool const negative = (mantissa < 0);
+
+    if (negative)
+        mantissa = -mantissa;
+
+    while ((mantissa < minMantissa) && (exponent > minExponent))
+    {
+        mantissa *= 10;
+        --exponent;
+    }
+
+    while (mantissa > maxMantissa)
+    {
+        if (exponent >= maxExponent)
+            Throw<std::overflow_error>("IOUAmount::normalize");
+
+        mantissa /= 10;
+        ++exponent;
+    }
+
+    if ((exponent < minExponent) || (mantissa < minMantissa))
+        return {0, -100};
+
+    if (exponent > maxExponent)
+        Throw<std::overflow_error>("value overflow");
+
+    return {negative ? -mantissa : mantissa, exponent};
+}
+
+static std::pair<std::int64_t, int>
+add(IOUAmount const& lhs, IOUAmount const& rhs)
+{
+    if (rhs == beast::zero)
+        return {lhs.mantissa(), lhs.exponent()};
+
+    if (lhs == beast::zero)
+        return {rhs.mantissa(), rhs.exponent()};
+
+    auto mantissa = lhs.mantissa();
+    auto exponent = lhs.exponent();
+    auto m = rhs.mantissa();
+    auto e = rhs.exponent();
+
+    while (exponent < e)
+    {
+        mantissa /= 10;
+        ++exponent;
+    }
+
+    while (e < exponent)
+    {
+        m /= 10;
+        ++e;
+    }
+
+    mantissa += m;
+
+    if (mantissa >= -10 && mantissa <= 10)
+        return {0, -100};
+
+    return normalize(mantissa, exponent);
+}
+
+}  // namespace reference
+
+//------------------------------------------------------------------------------
+
+// What an operation gave: its result, or the exception it threw
+template <class F>
+static std::string
+outcome(F&& f)
+{
+    try
+    {
+        return f();
+    }
+    catch (std::exception const& e)
+    {
+        return std::string("threw ") + e.what();
+    }
+}
+
+static std::string
+describe(STAmount const& a)
+{
+    return (a.negative() ? "-" : "") + std::to_string(a.mantissa()) + "e" +
+        std::to_string(a.exponent()) + (a.native() ? " native" : "");
+}
+
+static std::string
+describe(std::pair<std::int64_t, int> const& a)
+{
+    return std::to_string(a.first) + "e" + std::to_string(a.second);
+}
+
+static std::string
+describe(IOUAmount const& a)
+{
+    return describe(std::make_pair(a.mantissa(), a.exponent()));
+}
+
+// Mantissas at and around every power of ten, and the largest of all
+static std::vector<std::uint64_t>
+edgeMantissas()
+{
+    std::vector<std::uint64_t> ret{
+        std::numeric_limits<std::uint64_t>::max(),
+        std::uint64_t(std::numeric_limits<std::int64_t>::max()),
+        10 * STAmount::cMaxValue,
+        10 * STAmount::cMaxValue + 1,
+        STAmount::cMaxNativeN,
+        STAmount::cMaxNativeN + 1};
+    for (auto const p : detail::powerOfTen)
+    {
+        for (auto const m : {p - 1, p, p + 1, 2 * p - 1, 5 * p, 9 * p + 1})
+        {
+            if (m != 0)
+                ret.push_back(m);
+        }
+    }
+    return ret;
+}
+
+class AmountArithmetic_test : public beast::unit_test::suite
+{
+    Issue const usd_{Currency(0x5553440000000000), AccountID(0x4985601)};
+
+    // An amount with a mantissa of random length, a random exponent and
+    // a random sign, native one time in four.
+    STAmount
+    randomAmount(beast::xor_shift_engine& rng)
+    {
+        bool const negative = rng() % 2;
+        if (rng() % 4 == 0)
+        {
+            auto const digits = 1 + rng() % 17;
+            auto const value = 1 + rng() % (detail::powerOfTen[digits] - 1);
+            return STAmount(std::min(value, STAmount::cMaxNativeN), negative);
+        }
+        auto const value = STAmount::cMinValue +
+            rng() % (STAmount::cMaxValue - STAmount::cMinValue + 1);
+        int const exponent = STAmount::cMinOffset +
+            rng() % (STAmount::cMaxOffset - STAmount::cMinOffset + 1);
+        return STAmount(usd_, value, exponent, negative);
+    }
+
+    void
+    testDigits()
+    {
+        testcase("digits");
+
+        auto count = [](std::uint64_t v) {
+            int n = 1;
+            while (v >= 10)
+            {
+                v /= 10;
+                ++n;
+            }
+            return n;
+        };
+
+        for (auto const m : edgeMantissas())
+            BEAST_EXPECT(detail::digits10(m) == count(m));
+        BEAST_EXPECT(detail::digits10(0) == 1);
+
+        // Every length of mantissa in bits
+        for (int bit = 0; bit < 64; ++bit)
+        {
+            std::uint64_t const v = std::uint64_t(1) << bit;
+            BEAST_EXPECT(detail::digits10(v) == count(v));
+            BEAST_EXPECT(detail::digits10(v - 1) == count(v - 1));
+            BEAST_EXPECT(detail::digits10(v | (v - 1)) == count(v | (v - 1)));
+        }
+
+        for (auto const m : edgeMantissas())
+        {
+            for (int n = 0; n < 25; ++n)
+            {
+                std::uint64_t expected = m;
+                for (int i = 0; i < n; ++i)
+                    expected /= 10;
+                BEAST_EXPECT(detail::divPow10(m, n) == expected);
+
+                std::int64_t const s = -static_cast<std::int64_t>(m >> 1);
+                std::int64_t se = s;
+                for (int i = 0; i < n; ++i)
+                    se /= 10;
+                BEAST_EXPECT(detail::divPow10(s, n) == se);
+
+                expected = m;
+                for (int i = 0; i < n; ++i)
+                    expected *= 10;
+                BEAST_EXPECT(detail::mulPow10(m, n) == expected);
+            }
+        }
+    }
+
+    // Every edge mantissa at every exponent where it could land in range
+    void
+    testCanonicalize()
+    {
+        testcase("canonicalize");
+
+        std::size_t mismatches = 0;
+        for (auto const& issue : {usd_, xrpIssue()})
+        {
+            for (auto const m : edgeMantissas())
+            {
+                for (int e = -140; e <= 120; ++e)
+                {
+                    for (bool const negative : {false, true})
+                    {
+                        auto const expected = outcome([&] {
+                            return describe(
+                                reference::make(issue, m, e, negative));
+                        });
+                        auto const actual = outcome([&] {
+                            return describe(STAmount(issue, m, e, negative));
+                        });
+                        if (actual != expected)
+                        {
+                            if (++mismatches < 10)
+                                log << m << "e" << e << ": " << actual
+                                    << " instead of " << expected << std::endl;
+                        }
+                    }
+                }
+            }
+        }
+        BEAST_EXPECT(mismatches == 0);
+    }
+
+    void
+    testIOUAmount()
+    {
+        testcase("IOUAmount");
+
+        std::size_t mismatches = 0;
+        auto check = [&](std::string const& actual,
+                         std::string const& expected) {
+            if (actual != expected && ++mismatches < 10)
+                log << actual << " instead of " << expected << std::endl;
+        };
+
+        std::uint64_t const largest = std::numeric_limits<std::int64_t>::max();
+        std::vector<std::int64_t> mantissas;
+        for (auto const m : edgeMantissas())
+        {
+            auto const s = static_cast<std::int64_t>(std::min(m, largest));
+            mantissas.push_back(s);
+            mantissas.push_back(-s);
+        }
+
+        for (auto const m : mantissas)
+        {
+            for (int e = -140; e <= 120; ++e)
+            {
+                check(
+                    outcome([&] { return describe(IOUAmount(m, e)); }),
+                    outcome([&] {
+                        return describe(reference::normalize(m, e));
+                    }));
+            }
+        }
+
+        beast::xor_shift_engine rng(46);
+        for (int i = 0; i < 200000; ++i)
+        {
+            auto const m1 = mantissas[rng() % mantissas.size()];
+            auto const m2 = mantissas[rng() % mantissas.size()];
+            int const e1 = static_cast<int>(rng() % 120) - 100;
+            int const e2 = e1 + static_cast<int>(rng() % 41) - 20;
+            check(
+                outcome([&] {
+                    IOUAmount a(m1, e1);
+                    IOUAmount const b(m2, e2);
+                    return describe(a += b);
+                }),
+                outcome([&] {
+                    return describe(
+                        reference::add(IOUAmount(m1, e1), IOUAmount(m2, e2)));
+                }));
+        }
+        BEAST_EXPECT(mismatches == 0);
+    }
+
+    void
+    testSTAmount()
+    {
+        testcase("STAmount");
+
+        std::size_t mismatches = 0;
+        auto check = [&](char const* op,
+                         std::string const& actual,
+                         std::string const& expected) {
+            if (actual != expected && ++mismatches < 10)
+                log << op << ": " << actual << " instead of " << expected
+                    << std::endl;
+        };
+
+        // Pairs of random amounts, and pairs of the amounts at the edges
+        // of the range of each kind.
+        beast::xor_shift_engine rng(46);
+        std::vector<STAmount> edges{
+            STAmount(1, false),
+            STAmount(9, true),
+            STAmount(STAmount::cMaxNativeN, false),
+            STAmount(usd_, STAmount::cMinValue, STAmount::cMinOffset),
+            STAmount(usd_, STAmount::cMaxValue, STAmount::cMinOffset),
+            STAmount(usd_, STAmount::cMinValue, STAmount::cMaxOffset),
+            STAmount(usd_, STAmount::cMaxValue, STAmount::cMaxOffset, true),
+            STAmount(usd_, STAmount::cMinValue, 0),
+            STAmount(usd_, STAmount::cMaxValue, -15)};
+        std::vector<std::pair<STAmount, STAmount>> pairs;
+        for (auto const& a : edges)
+        {
+            for (auto const& b : edges)
+                pairs.emplace_back(a, b);
+        }
+        for (int i = 0; i < 100000; ++i)
+            pairs.emplace_back(randomAmount(rng), randomAmount(rng));
+
+        for (auto const& [a, b] : pairs)
+        {
+            for (auto const& issue : {usd_, xrpIssue()})
+            {
+                check(
+                    "multiply",
+                    outcome([&] { return describe(multiply(a, b, issue)); }),
+                    outcome([&] {
+                        return describe(reference::multiply(a, b, issue));
+                    }));
+                check(
+                    "divide",
+                    outcome([&] { return describe(divide(a, b, issue)); }),
+                    outcome([&] {
+                        return describe(reference::divide(a, b, issue));
+                    }));
+                for (bool const roundUp : {false, true})
+                {
+                    check(
+                        "mulRound",
+                        outcome([&] {
+                            return describe(mulRound(a, b, issue, roundUp));
+                        }),
+                        outcome([&] {
+                            return describe(
+                                reference::mulRound(a, b, issue, roundUp));
+                        }));
+                    check(
+                        "divRound",
+                        outcome([&] {
+                            return describe(divRound(a, b, issue, roundUp));
+                        }),
+                        outcome([&] {
+                            return describe(
+                                reference::divRound(a, b, issue, roundUp));
+                        }));
+                }
+            }
+
+            if (a.native() == b.native())
+            {
+                // Amounts of one kind, at exponents near enough to matter
+                int const exponent = a.native()
+                    ? 0
+                    : std::clamp(
+                          a.exponent() - 20 + int(rng() % 41),
+                          int{STAmount::cMinOffset},
+                          int{STAmount::cMaxOffset});
+                STAmount const c(
+                    a.issue(), b.mantissa(), exponent, b.negative());
+                check(
+                    "add",
+                    outcome([&] { return describe(a + c); }),
+                    outcome([&] { return describe(reference::add(a, c)); }));
+            }
+        }
+        BEAST_EXPECT(mismatches == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testDigits();
+        testCanonicalize();
+        testIOUAmount();
+        testSTAmount();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AmountArithmetic, protocol, ripple);
+
+//------------------------------------------------------------------------------
+
+/** Measures the arithmetic on amounts, against the way it was done before.
+
+    Usage: --unittest-arg=<operations>, 1000000 by default
+*/
+class AmountArithmeticBench_test : public beast::unit_test::suite
+{
+    template <class F>
+    std::chrono::nanoseconds
+    time(std::size_t n, F&& f)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < n; ++i)
+            f(i);
+        return (std::chrono::steady_clock::now() - start) / n;
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t const n = arg().empty() ? 1000000 : std::stoul(arg());
+        Issue const usd{Currency(0x5553440000000000), AccountID(0x4985601)};
+
+        // Amounts like those of offers crossing: mostly IOUs, some XRP
+        beast::xor_shift_engine rng(46);
+        std::vector<STAmount> amounts;
+        std::vector<IOUAmount> ious;
+        for (std::size_t i = 0; i < 1024; ++i)
+        {
+            auto const value = STAmount::cMinValue +
+                rng() % (STAmount::cMaxValue - STAmount::cMinValue + 1);
+            int const exponent = static_cast<int>(rng() % 20) - 15;
+            if (i % 4 == 0)
+                amounts.emplace_back(value / 1000000, false);
+            else
+                amounts.emplace_back(usd, value, exponent);
+            ious.emplace_back(value, exponent);
+        }
+        auto a = [&](std::size_t i) { return amounts[i % 1024]; };
+        auto b = [&](std::size_t i) { return amounts[(i * 7 + 3) % 1024]; };
+
+        std::uint64_t sink = 0;
+        auto report = [&](char const* op,
+                          std::chrono::nanoseconds now,
+                          std::chrono::nanoseconds before) {
+            log << op << ": " << now.count() << "ns, was " << before.count()
+                << "ns" << std::endl;
+        };
+
+        testcase("STAmount");
+        report(
+            "mulRound",
+            time(n, [&](auto i) {
+                sink += mulRound(a(i), b(i), usd, i % 2).mantissa();
+            }),
+            time(n, [&](auto i) {
+                sink += reference::mulRound(a(i), b(i), usd, i % 2).mantissa();
+            }));
+        report(
+            "divRound",
+            time(n, [&](auto i) {
+                sink += divRound(a(i), b(i), usd, i % 2).mantissa();
+            }),
+            time(n, [&](auto i) {
+                sink += reference::divRound(a(i), b(i), usd, i % 2).mantissa();
+            }));
+        report(
+            "multiply",
+            time(n, [&](auto i) {
+                sink += multiply(a(i), b(i), usd).mantissa();
+            }),
+            time(n, [&](auto i) {
+                sink += reference::multiply(a(i), b(i), usd).mantissa();
+            }));
+        report(
+            "divide",
+            time(n, [&](auto i) {
+                sink += divide(a(i), b(i), usd).mantissa();
+            }),
+            time(n, [&](auto i) {
+                sink += reference::divide(a(i), b(i), usd).mantissa();
+            }));
+        pass();
+
+        testcase("IOUAmount");
+        auto x = [&](std::size_t i) { return ious[i % 1024]; };
+        auto y = [&](std::size_t i) { return ious[(i * 7 + 3) % 1024]; };
+        report(
+            "add",
+            time(n, [&](auto i) {
+                auto r = x(i);
+                sink += (r += y(i)).mantissa();
+            }),
+            time(n, [&](auto i) {
+                sink += reference::add(x(i), y(i)).first;
+            }));
+
+        log << "(" << sink % 10 << ")" << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(AmountArithmeticBench, protocol, ripple);
+
+}  // namespace test
+}  // namespace ripple
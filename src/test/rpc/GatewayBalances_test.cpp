@@ -15,11 +15,14 @@
 */
 //==============================================================================
 
+#include <ripple/app/paths/PathRequests.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/protocol/Feature.h>
 #include <ripple/protocol/jss.h>
 #include <test/jtx.h>
 #include <test/jtx/WSClient.h>
+#include <chrono>
+#include <thread>
 
 namespace ripple {
 namespace test {
@@ -148,6 +151,113 @@ public:
         }
     }
 
+    void
+    testGraph()
+    {
+        testcase("trust line graph");
+
+        using namespace std::chrono_literals;
+        using namespace jtx;
+        Env env(*this);
+
+        auto& pathRequests = env.app().getPathRequests();
+
+        // Waits for the graph to be brought up to the last closed ledger
+        auto const waitForGraph = [&]() {
+            auto const ledger = env.closed();
+            for (int i = 0; i < 1000; ++i)
+            {
+                if (pathRequests.getTrustLines(*ledger))
+                    return true;
+                std::this_thread::sleep_for(5ms);
+            }
+            return false;
+        };
+
+        Account const gw{"gw"};
+        Account const hot1{"hot1"};
+        Account const hot2{"hot2"};
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        Account const carol{"carol"};
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+        auto const JPY = gw["JPY"];
+        env.fund(XRP(10000), gw, hot1, hot2, alice, bob, carol);
+        env.close();
+
+        env.trust(USD(10000), hot1, hot2, alice);
+        env.trust(USD(100000), bob);
+        env.trust(EUR(10000), hot1, alice, carol);
+        env.trust(JPY(10000), hot2);
+        env.close();
+
+        env(pay(gw, hot1, USD(1000)));
+        env(pay(gw, hot2, USD(250.5)));
+        env(pay(gw, hot1, EUR(75)));
+        env(pay(gw, hot2, JPY(5000)));
+        env(pay(gw, alice, USD(12.25)));
+        env(pay(gw, alice, EUR(0.001)));
+        env(pay(gw, bob, USD(99999)));
+        env(pay(gw, carol, EUR(123.456)));
+
+        // Frozen lines, one of them to a hot wallet
+        env(trust(gw, bob["USD"](0), tfSetFreeze));
+        env(trust(gw, hot2["JPY"](0), tfSetFreeze));
+
+        // Assets the gateway holds
+        env(trust(gw, alice["CAD"](100)));
+        env(trust(gw, carol["USD"](100)));
+        env(pay(alice, gw, alice["CAD"](40)));
+        env(pay(carol, gw, carol["USD"](7)));
+        env.close();
+
+        Json::Value qry;
+        qry[jss::account] = gw.human();
+        std::vector<std::vector<Account>> const cases{
+            {}, {hot1}, {hot1, hot2}};
+        for (auto const& hotWallets : cases)
+        {
+            qry[jss::hotwallet] = Json::arrayValue;
+            for (auto const& hotWallet : hotWallets)
+                qry[jss::hotwallet].append(hotWallet.human());
+
+            // The result for a ledger does not depend on whether the
+            // trust line graph has been brought up to it
+            if (!BEAST_EXPECT(waitForGraph()))
+                return;
+            auto const ledger = env.closed();
+            qry[jss::ledger_index] = ledger->seq();
+            auto const withGraph = env.rpc(
+                "json", "gateway_balances", to_string(qry))[jss::result];
+            BEAST_EXPECT(pathRequests.getTrustLines(*ledger));
+
+            env.close();
+            if (!BEAST_EXPECT(waitForGraph()))
+                return;
+            auto const without = env.rpc(
+                "json", "gateway_balances", to_string(qry))[jss::result];
+            BEAST_EXPECT(!pathRequests.getTrustLines(*ledger));
+
+            BEAST_EXPECT(withGraph[jss::status] == "success");
+            BEAST_EXPECT(withGraph == without);
+        }
+
+        // Only the hot wallets hold JPY, and what is owed to bob is frozen
+        qry[jss::ledger_index] = env.closed()->seq();
+        auto const result =
+            env.rpc("json", "gateway_balances", to_string(qry))[jss::result];
+        auto const& obligations = result[jss::obligations];
+        BEAST_EXPECT(obligations.size() == 2);
+        BEAST_EXPECT(obligations["USD"] == "12.25");
+        BEAST_EXPECT(obligations["EUR"] == "123.457");
+        BEAST_EXPECT(result[jss::balances].size() == 2);
+        BEAST_EXPECT(
+            result[jss::frozen_balances][bob.human()][0u][jss::value] ==
+            "99999");
+        BEAST_EXPECT(result[jss::assets].size() == 2);
+    }
+
     void
     run() override
     {
@@ -155,6 +265,7 @@ public:
         auto const sa = supported_amendments();
         testGWB(sa - featureFlowCross);
         testGWB(sa);
+        testGraph();
     }
 };
 
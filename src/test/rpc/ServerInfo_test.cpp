@@ -89,10 +89,41 @@ public:
         }
     }
 
+    void
+    testTransactionPipeline()
+    {
+        using namespace test::jtx;
+
+        Env env(*this);
+        Account const alice{"alice"};
+        env.fund(XRP(10000), alice);
+        for (int i = 0; i < 10; ++i)
+            env(pay(env.master, alice, XRP(1)));
+        env.close();
+
+        auto const result = env.rpc("server_info");
+        auto const& info = result[jss::result][jss::info];
+        BEAST_EXPECT(info.isMember(jss::transaction_pipeline));
+
+        auto const& preflight = info[jss::transaction_pipeline][jss::preflight];
+        BEAST_EXPECT(preflight.isMember(jss::queued));
+        BEAST_EXPECT(preflight.isMember(jss::avg_latency_us));
+        BEAST_EXPECT(preflight.isMember(jss::max_latency_us));
+        BEAST_EXPECT(
+            std::stoull(preflight[jss::transactions].asString()) >= 10);
+
+        auto const& batch = info[jss::transaction_pipeline][jss::apply];
+        BEAST_EXPECT(batch[jss::queued] == 0);
+        BEAST_EXPECT(std::stoull(batch[jss::transactions].asString()) >= 10);
+        BEAST_EXPECT(std::stoull(batch[jss::batches].asString()) >= 1);
+        BEAST_EXPECT(batch.isMember(jss::avg_latency_us));
+    }
+
     void
     run() override
     {
         testServerInfo();
+        testTransactionPipeline();
     }
 };
 
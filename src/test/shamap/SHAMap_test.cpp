@@ -21,9 +21,14 @@
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/beast/utility/Journal.h>
+#include <ripple/protocol/digest.h>
 #include <ripple/shamap/SHAMap.h>
 #include <test/shamap/common.h>
 #include <test/unit_test/SuiteJournal.h>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 namespace tests {
@@ -129,6 +134,79 @@ public:
 
         run(true, journal);
         run(false, journal);
+        testConcurrentReads(journal);
+    }
+
+    void
+    testConcurrentReads(beast::Journal const& journal)
+    {
+        testcase("concurrent reads of a mutable map");
+
+        // A ledger being built is read from several threads while its
+        // transactions are applied speculatively. Its state map is a
+        // mutable snapshot of a stored map, which loads nodes as they are
+        // first reached.
+        tests::TestFamily f(journal);
+        std::map<uint256, int> expected;
+        SHAMapHash hash;
+        {
+            SHAMap map(SHAMapType::FREE, f);
+            for (int i = 0; i < 2000; ++i)
+            {
+                auto const key = sha512Half(i);
+                map.addItem(SHAMapItem{key, IntToVUC(i)}, false, false);
+                expected[key] = i;
+            }
+            map.flushDirty(hotACCOUNT_NODE, 1);
+            hash = map.getHash();
+        }
+
+        SHAMap stored(SHAMapType::FREE, hash.as_uint256(), f);
+        BEAST_EXPECT(stored.fetchRoot(hash, nullptr));
+        stored.setImmutable();
+        auto const map = stored.snapShot(true);
+
+        std::vector<uint256> erased;
+        for (int i = 0; i < 100; ++i)
+        {
+            auto const key = sha512Half(i);
+            BEAST_EXPECT(map->delItem(key));
+            expected.erase(key);
+            erased.push_back(key);
+
+            auto const added = sha512Half(i + 2000);
+            map->addItem(SHAMapItem{added, IntToVUC(i + 2000)}, false, false);
+            expected[added] = i + 2000;
+        }
+        f.reset();
+
+        std::atomic<int> wrong{0};
+        auto read = [&](std::size_t start) {
+            auto it = expected.begin();
+            std::advance(it, start % expected.size());
+            for (std::size_t n = 0; n < expected.size(); ++n)
+            {
+                auto const item = map->peekItem(it->first);
+                if (!item || item->peekData() != IntToVUC(it->second))
+                    ++wrong;
+                if (++it == expected.end())
+                    it = expected.begin();
+            }
+            for (auto const& key : erased)
+            {
+                if (map->hasItem(key))
+                    ++wrong;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < 8; ++t)
+            threads.emplace_back(read, t * 251);
+        for (auto& t : threads)
+            t.join();
+
+        BEAST_EXPECT(wrong == 0);
+        map->invariants();
     }
 
     void